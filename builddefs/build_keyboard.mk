@@ -506,6 +506,12 @@ top-symbols: build
 	echo "###########################################"
 endif
 
+ifeq ($(strip $(TOKENIZED_LOGGING_ENABLE)),yes)
+build: log-tokens
+log-tokens: elf
+	$(QMK_BIN) generate-log-tokens -q -o $(TARGET).tokens.json $(BUILD_DIR)/$(TARGET).elf
+endif
+
 include $(BUILDDEFS_PATH)/show_options.mk
 include $(BUILDDEFS_PATH)/common_rules.mk
 
@@ -44,6 +44,12 @@ else ifeq ($(strip $(DEBUG_MATRIX_SCAN_RATE_ENABLE)), api)
     OPT_DEFS += -DDEBUG_MATRIX_SCAN_RATE
 endif
 
+ifeq ($(strip $(TOKENIZED_LOGGING_ENABLE)), yes)
+    OPT_DEFS += -DTOKENIZED_LOGGING_ENABLE
+    CONSOLE_ENABLE = yes
+    QUANTUM_SRC += $(QUANTUM_DIR)/logging/tokenized_log.c
+endif
+
 AUDIO_ENABLE ?= no
 ifeq ($(strip $(AUDIO_ENABLE)), yes)
     ifeq ($(PLATFORM),CHIBIOS)
@@ -603,7 +609,11 @@ ifeq ($(strip $(VIA_ENABLE)), yes)
     DYNAMIC_KEYMAP_ENABLE := yes
     RAW_ENABLE := yes
     BOOTMAGIC_ENABLE := yes
-    SRC += $(QUANTUM_DIR)/via.c
+    CRC_ENABLE := yes
+    SRC += $(QUANTUM_DIR)/via.c \
+           $(QUANTUM_DIR)/via_bulk.c \
+           $(QUANTUM_DIR)/via_compress.c \
+           $(QUANTUM_DIR)/via_matrix_stream.c
     OPT_DEFS += -DVIA_ENABLE
 endif
 
@@ -665,7 +675,13 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
     # Determine which (if any) transport files are required
     ifneq ($(strip $(SPLIT_TRANSPORT)), custom)
         QUANTUM_SRC += $(QUANTUM_DIR)/split_common/transport.c \
-                       $(QUANTUM_DIR)/split_common/transactions.c
+                       $(QUANTUM_DIR)/split_common/transactions.c \
+                       $(QUANTUM_DIR)/split_common/transaction_batch.c \
+                       $(QUANTUM_DIR)/split_common/matrix_delta.c \
+                       $(QUANTUM_DIR)/split_common/input_queue.c \
+                       $(QUANTUM_DIR)/split_common/sync_scheduler.c \
+                       $(QUANTUM_DIR)/split_common/link_policy.c \
+                       $(QUANTUM_DIR)/split_common/transaction_stream.c
 
         OPT_DEFS += -DSPLIT_COMMON_TRANSACTIONS
 
@@ -683,15 +699,26 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
             QUANTUM_LIB_SRC += serial.c
         else
             QUANTUM_LIB_SRC += serial_protocol.c
+            QUANTUM_LIB_SRC += serial_frame.c
             QUANTUM_LIB_SRC += serial_$(strip $(SERIAL_DRIVER)).c
         endif
     endif
     COMMON_VPATH += $(QUANTUM_PATH)/split_common
 endif
 
+VALID_CRC_DRIVER_TYPES := software stm32
+
+CRC_DRIVER ?= software
 ifeq ($(strip $(CRC_ENABLE)), yes)
+    ifeq ($(filter $(CRC_DRIVER),$(VALID_CRC_DRIVER_TYPES)),)
+        $(call CATASTROPHIC_ERROR,Invalid CRC_DRIVER,CRC_DRIVER="$(CRC_DRIVER)" is not a valid CRC driver)
+    endif
     OPT_DEFS += -DCRC_ENABLE
     SRC += crc.c
+    ifneq ($(strip $(CRC_DRIVER)), software)
+        OPT_DEFS += -DCRC_DRIVER_$(strip $(shell echo $(CRC_DRIVER) | tr '[:lower:]' '[:upper:]'))
+        SRC += crc_$(strip $(CRC_DRIVER)).c
+    endif
 endif
 
 ifeq ($(strip $(FNV_ENABLE)), yes)
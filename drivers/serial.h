@@ -28,6 +28,12 @@ void soft_serial_target_init(void);
 
 bool soft_serial_transaction(int sstd_index);
 
+#ifdef SERIAL_USART_PIPELINE
+// transaction that made the last soft_serial_transaction() fail, which can be
+// a write posted earlier rather than the one that was started
+int8_t soft_serial_failed_transaction(void);
+#endif
+
 #ifdef SERIAL_DEBUG
 #    include <debug.h>
 #    include <print.h>
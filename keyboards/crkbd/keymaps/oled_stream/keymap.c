@@ -0,0 +1,129 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include QMK_KEYBOARD_H
+#include "transactions.h"
+
+enum crkbd_layers {
+    _BASE,
+    _LOWER,
+    _RAISE,
+    _ADJUST,
+};
+
+// clang-format off
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+  [_BASE] = LAYOUT_split_3x6_3(
+    KC_TAB,  KC_Q,    KC_W,    KC_E,    KC_R,    KC_T,                      KC_Y,    KC_U,    KC_I,    KC_O,    KC_P,    KC_BSPC,
+    KC_LCTL, KC_A,    KC_S,    KC_D,    KC_F,    KC_G,                      KC_H,    KC_J,    KC_K,    KC_L,    KC_SCLN, KC_QUOT,
+    KC_LSFT, KC_Z,    KC_X,    KC_C,    KC_V,    KC_B,                      KC_N,    KC_M,    KC_COMM, KC_DOT,  KC_SLSH, KC_ESC,
+                                        KC_LGUI, MO(_LOWER), KC_SPC, KC_ENT, MO(_RAISE), KC_RALT
+  ),
+
+  [_LOWER] = LAYOUT_split_3x6_3(
+    KC_TAB,  KC_1,    KC_2,    KC_3,    KC_4,    KC_5,                      KC_6,    KC_7,    KC_8,    KC_9,    KC_0,    KC_BSPC,
+    KC_LCTL, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,                   KC_LEFT, KC_DOWN, KC_UP,   KC_RGHT, XXXXXXX, XXXXXXX,
+    KC_LSFT, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,                   XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
+                                        KC_LGUI, _______, KC_SPC,  KC_ENT,  MO(_ADJUST), KC_RALT
+  ),
+
+  [_RAISE] = LAYOUT_split_3x6_3(
+    KC_TAB,  KC_EXLM, KC_AT,   KC_HASH, KC_DLR,  KC_PERC,                   KC_CIRC, KC_AMPR, KC_ASTR, KC_LPRN, KC_RPRN, KC_BSPC,
+    KC_LCTL, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,                   KC_MINS, KC_EQL,  KC_LBRC, KC_RBRC, KC_BSLS, KC_GRV,
+    KC_LSFT, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,                   KC_UNDS, KC_PLUS, KC_LCBR, KC_RCBR, KC_PIPE, KC_TILD,
+                                        KC_LGUI, MO(_ADJUST), KC_SPC, KC_ENT, _______, KC_RALT
+  ),
+
+  [_ADJUST] = LAYOUT_split_3x6_3(
+    QK_BOOT, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,                   XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
+    XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,                   XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
+    XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,                   XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
+                                        KC_LGUI, _______, KC_SPC,  KC_ENT,  _______, KC_RALT
+  ),
+};
+// clang-format on
+
+#ifdef OLED_ENABLE
+
+typedef struct {
+    uint8_t layer;
+    uint8_t mods;
+    bool    caps_lock;
+} oled_status_t;
+
+static oled_status_t shown;
+static bool          mirror_pending = true;
+
+// Slave: the master's buffer arrives in chunks, written as they come
+static bool oled_mirror_receive(uint16_t total, uint16_t offset, const uint8_t *data, uint8_t length) {
+    for (uint8_t i = 0; i < length && offset + i < OLED_MATRIX_SIZE; i++) {
+        oled_write_raw_byte(data[i], offset + i);
+    }
+    return true;
+}
+
+static void oled_mirror_done(int8_t transaction_id, bool success) {
+    if (!success) {
+        mirror_pending = true;
+    }
+}
+
+void keyboard_post_init_user(void) {
+    transaction_register_rpc_stream(USER_OLED_MIRROR, oled_mirror_receive);
+}
+
+static void render_status(const oled_status_t *status) {
+    static const char PROGMEM layer_names[][8] = {"Base", "Lower", "Raise", "Adjust"};
+
+    oled_write_P(PSTR("Layer: "), false);
+    oled_write_ln_P(layer_names[status->layer], false);
+    oled_write_P(PSTR("Mods:  "), false);
+    oled_write_P((status->mods & MOD_MASK_SHIFT) ? PSTR("S") : PSTR("-"), false);
+    oled_write_P((status->mods & MOD_MASK_CTRL) ? PSTR("C") : PSTR("-"), false);
+    oled_write_P((status->mods & MOD_MASK_ALT) ? PSTR("A") : PSTR("-"), false);
+    oled_write_ln_P((status->mods & MOD_MASK_GUI) ? PSTR("G") : PSTR("-"), false);
+    oled_write_ln_P(status->caps_lock ? PSTR("CAPS") : PSTR(""), false);
+}
+
+bool oled_task_user(void) {
+    if (!is_keyboard_master()) {
+        // Drawn by oled_mirror_receive
+        return false;
+    }
+
+    // The slave is sent the buffer itself, so it must not change until it has all of it
+    if (transaction_rpc_stream_busy()) {
+        return false;
+    }
+
+    oled_status_t status = {
+        .layer     = get_highest_layer(layer_state),
+        .mods      = get_mods(),
+        .caps_lock = host_keyboard_led_state().caps_lock,
+    };
+    if (status.layer != shown.layer || status.mods != shown.mods || status.caps_lock != shown.caps_lock) {
+        shown          = status;
+        mirror_pending = true;
+    }
+    render_status(&shown);
+
+    if (mirror_pending) {
+        mirror_pending = !transaction_rpc_stream(USER_OLED_MIRROR, oled_read_raw(0).current_element, OLED_MATRIX_SIZE, oled_mirror_done);
+    }
+    return false;
+}
+
+#endif // OLED_ENABLE
@@ -0,0 +1,3 @@
+OLED_ENABLE = yes
+OLED_DRIVER = SSD1306
+LTO_ENABLE  = yes
@@ -0,0 +1,36 @@
+"""Decode tokenized console output back into text.
+"""
+import json
+import sys
+
+from milc import cli
+
+from qmk.path import normpath
+from qmk.tokenized_log import LogDecoder, tokens_from_elf, tokens_from_json
+
+
+@cli.argument('-t', '--tokens', arg_only=True, type=normpath, required=True, help='Token table from `qmk generate-log-tokens`, or the firmware ELF itself.')
+@cli.argument('input', arg_only=True, nargs='?', type=normpath, help='File with the raw console output. Reads stdin if omitted.')
+@cli.subcommand('Decode tokenized console output.')
+def decode_log(cli):
+    """Decodes console output of firmware built with TOKENIZED_LOGGING_ENABLE.
+    """
+    if not cli.args.tokens.exists():
+        cli.log.error('File not found: %s', cli.args.tokens)
+        return False
+
+    data = cli.args.tokens.read_bytes()
+    if data[:4] == b'\x7fELF':
+        tokens = tokens_from_elf(data)
+    else:
+        tokens = tokens_from_json(json.loads(data))
+
+    decoder = LogDecoder(tokens)
+    source = cli.args.input.open('rb') if cli.args.input else sys.stdin.buffer
+    with source:
+        while True:
+            chunk = source.read1(4096)
+            if not chunk:
+                break
+            sys.stdout.write(decoder.feed(chunk))
+            sys.stdout.flush()
@@ -0,0 +1,28 @@
+"""Used by the make system to generate the tokenized logging table from a firmware ELF.
+"""
+import json
+
+from milc import cli
+
+from qmk.commands import dump_lines
+from qmk.path import normpath
+from qmk.tokenized_log import tokens_from_elf, tokens_to_json
+
+
+@cli.argument('-o', '--output', arg_only=True, type=normpath, help='File to write to')
+@cli.argument('-q', '--quiet', arg_only=True, action='store_true', help="Quiet mode, only output error messages")
+@cli.argument('elf', arg_only=True, type=normpath, help='Firmware ELF to read the log format strings from.')
+@cli.subcommand('Used by the make system to generate the tokenized logging table', hidden=True)
+def generate_log_tokens(cli):
+    """Generates the token table `qmk decode-log` uses.
+    """
+    if not cli.args.elf.exists():
+        cli.log.error('File not found: %s', cli.args.elf)
+        return False
+
+    tokens = tokens_from_elf(cli.args.elf.read_bytes())
+    for token, formats in sorted(tokens.items()):
+        if len(formats) > 1:
+            cli.log.warning('Log token 0x%04X is shared by %d format strings, records are matched by their arguments.', token, len(formats))
+
+    dump_lines(cli.args.output, json.dumps(tokens_to_json(tokens), indent=4).split('\n'), cli.args.quiet)
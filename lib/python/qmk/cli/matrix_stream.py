@@ -0,0 +1,73 @@
+"""Show switch events streamed live from a keyboard running VIA.
+"""
+import time
+
+from milc import cli
+
+from qmk.matrix_stream import RAW_USAGE_ID, RAW_USAGE_PAGE, PACKET_SIZE, MatrixStream, parse_subscription, subscribe_request, unsubscribe_request
+
+
+def _find_device(hid, device):
+    vid, pid = 0, 0
+    if device:
+        vid, pid = (int(part, 16) for part in device.split(':'))
+
+    for info in hid.enumerate(vid, pid):
+        if info['usage_page'] == RAW_USAGE_PAGE and info['usage'] == RAW_USAGE_ID:
+            return info
+
+    return None
+
+
+@cli.argument('-d', '--device', arg_only=True, help='USB ID of the keyboard, as VID:PID in hex. Defaults to the first raw HID interface found.')
+@cli.argument('-i', '--interval', arg_only=True, type=int, default=0, help='Milliseconds between event packets, 0 for the keyboard default.')
+@cli.subcommand('Stream switch events from a keyboard running VIA.')
+def matrix_stream(cli):
+    """Subscribes to the matrix stream of a VIA keyboard and prints every switch event with its keyboard timestamp.
+
+    Works for any matrix size, split halves included, as long as the firmware has VIA enabled.
+    """
+    try:
+        import hid
+    except ImportError:
+        cli.log.error('The hid module is required, install it with `python3 -m pip install hid`.')
+        return False
+
+    info = _find_device(hid, cli.args.device)
+    if not info:
+        cli.log.error('No raw HID interface found%s.', f' for {cli.args.device}' if cli.args.device else '')
+        return False
+
+    device = hid.Device(path=info['path'])
+    stream = MatrixStream()
+    renew_every = None
+    renewed = 0
+
+    try:
+        while True:
+            if renew_every is None or time.monotonic() - renewed > renew_every:
+                device.write(b'\0' + subscribe_request(cli.args.interval))
+                renewed = time.monotonic()
+
+            packet = device.read(PACKET_SIZE, 100)
+            if not packet:
+                continue
+
+            subscription = parse_subscription(packet)
+            if subscription:
+                if renew_every is None:
+                    cli.log.info('Streaming a %dx%d matrix every %d ms from {fg_cyan}%s{fg_reset}', subscription.rows, subscription.cols, subscription.interval, info['product_string'])
+                renew_every = subscription.timeout / 3000
+                continue
+
+            lost, overflows = stream.lost_packets, stream.overflows
+            for event in stream.feed(packet):
+                print(f'{event.time / 1000:10.3f}  {"down" if event.pressed else "up  "}  row {event.row:3d}  col {event.col:3d}')
+            if stream.lost_packets != lost or stream.overflows != overflows:
+                cli.log.warning('Events were lost, the pressed keys may be out of date')
+
+    except KeyboardInterrupt:
+        device.write(b'\0' + unsubscribe_request())
+
+    finally:
+        device.close()
@@ -0,0 +1,91 @@
+"""Host side of the VIA matrix stream, see quantum/via_matrix_stream.h.
+"""
+from collections import namedtuple
+
+PACKET_SIZE = 32
+HEADER_SIZE = 4
+EVENT_SIZE = 4
+
+RAW_USAGE_PAGE = 0xFF60
+RAW_USAGE_ID = 0x61
+
+ID_MATRIX_STREAM = 0x19
+ID_SUBSCRIBE = 0x01
+ID_UNSUBSCRIBE = 0x02
+ID_EVENTS = 0x81
+
+PRESSED = 0x80
+DROPPED = 0x80
+
+MatrixEvent = namedtuple('MatrixEvent', ['row', 'col', 'pressed', 'time'])
+Subscription = namedtuple('Subscription', ['interval', 'rows', 'cols', 'timeout'])
+
+
+def subscribe_request(interval=0):
+    return bytes([ID_MATRIX_STREAM, ID_SUBSCRIBE, interval]).ljust(PACKET_SIZE, b'\0')
+
+
+def unsubscribe_request():
+    return bytes([ID_MATRIX_STREAM, ID_UNSUBSCRIBE]).ljust(PACKET_SIZE, b'\0')
+
+
+def parse_subscription(packet):
+    """Returns the Subscription of a subscribe response, or None for any other packet.
+    """
+    if len(packet) < 7 or packet[0] != ID_MATRIX_STREAM or packet[1] != ID_SUBSCRIBE:
+        return None
+
+    return Subscription(packet[2], packet[3], packet[4], packet[5] << 8 | packet[6])
+
+
+class MatrixStream:
+    """Follows the matrix through streamed event packets.
+
+    Timestamps are unwrapped from the 16-bit keyboard timer into milliseconds since the first event. Packets missed on the way, seen as gaps in the sequence number, and events the keyboard had to drop are counted, since either leaves `pressed` out of date until the keys change again.
+    """
+    def __init__(self):
+        self.pressed = set()
+        self.lost_packets = 0
+        self.overflows = 0
+        self._seq = None
+        self._first_time = None
+        self._last_time = 0
+        self._time_base = 0
+
+    def _unwrap(self, time):
+        if self._first_time is None:
+            self._first_time = time
+            self._last_time = time
+        if time < self._last_time and self._last_time - time > 0x8000:
+            self._time_base += 0x10000
+        self._last_time = time
+        return self._time_base + time - self._first_time
+
+    def feed(self, packet):
+        """Returns the events of a packet. Packets other than stream events give none.
+        """
+        if len(packet) < HEADER_SIZE or packet[0] != ID_MATRIX_STREAM or packet[1] != ID_EVENTS:
+            return []
+
+        seq = packet[2]
+        if self._seq is not None:
+            self.lost_packets += (seq - self._seq - 1) & 0xFF
+        self._seq = seq
+
+        if packet[3] & DROPPED:
+            self.overflows += 1
+
+        events = []
+        for i in range(packet[3] & 0x7F):
+            offset = HEADER_SIZE + i * EVENT_SIZE
+            if offset + EVENT_SIZE > len(packet):
+                break
+            row, col, time = packet[offset], packet[offset + 1], packet[offset + 2] << 8 | packet[offset + 3]
+            event = MatrixEvent(row, col & ~PRESSED, bool(col & PRESSED), self._unwrap(time))
+            if event.pressed:
+                self.pressed.add((event.row, event.col))
+            else:
+                self.pressed.discard((event.row, event.col))
+            events.append(event)
+
+        return events
@@ -0,0 +1,50 @@
+from qmk.matrix_stream import ID_EVENTS, ID_MATRIX_STREAM, ID_SUBSCRIBE, MatrixEvent, MatrixStream, Subscription, parse_subscription, subscribe_request
+
+
+def _packet(seq, events, dropped=False):
+    """Builds an events packet the way quantum/via_matrix_stream.c does.
+    """
+    packet = bytearray([ID_MATRIX_STREAM, ID_EVENTS, seq, len(events) | (0x80 if dropped else 0)])
+    for row, col, pressed, time in events:
+        packet += bytes([row, col | (0x80 if pressed else 0), time >> 8, time & 0xFF])
+    return bytes(packet.ljust(32, b'\0'))
+
+
+def test_subscription():
+    assert subscribe_request(20)[:3] == bytes([ID_MATRIX_STREAM, ID_SUBSCRIBE, 20])
+    assert parse_subscription(bytes([ID_MATRIX_STREAM, ID_SUBSCRIBE, 10, 12, 20, 0x0B, 0xB8]).ljust(32, b'\0')) == Subscription(10, 12, 20, 3000)
+    assert parse_subscription(_packet(0, [])) is None
+
+
+def test_events_track_pressed_keys():
+    stream = MatrixStream()
+    assert stream.feed(_packet(0, [(5, 17, True, 1000), (11, 3, True, 1001)])) == [MatrixEvent(5, 17, True, 0), MatrixEvent(11, 3, True, 1)]
+    assert stream.pressed == {(5, 17), (11, 3)}
+
+    assert stream.feed(_packet(1, [(5, 17, False, 1010)])) == [MatrixEvent(5, 17, False, 10)]
+    assert stream.pressed == {(11, 3)}
+    assert stream.lost_packets == 0
+    assert stream.overflows == 0
+
+
+def test_other_packets_are_ignored():
+    stream = MatrixStream()
+    assert stream.feed(bytes([ID_MATRIX_STREAM, ID_SUBSCRIBE, 10, 12, 20, 0x0B, 0xB8]).ljust(32, b'\0')) == []
+    assert stream.feed(bytes([0x12, 0, 0, 28]).ljust(32, b'\0')) == []
+
+
+def test_lost_packets_and_overflow():
+    stream = MatrixStream()
+    stream.feed(_packet(254, [(0, 0, True, 0)]))
+    stream.feed(_packet(255, [(0, 0, False, 5)]))
+    stream.feed(_packet(2, [(0, 1, True, 9)], dropped=True))
+    assert stream.lost_packets == 2
+    assert stream.overflows == 1
+
+
+def test_timestamps_unwrap():
+    stream = MatrixStream()
+    events = stream.feed(_packet(0, [(0, 0, True, 0xFFF0), (0, 0, False, 0x0010)]))
+    events += stream.feed(_packet(1, [(0, 0, True, 0xA000)]))
+    events += stream.feed(_packet(2, [(0, 0, False, 0x1000)]))
+    assert [event.time for event in events] == [0, 0x20, 0xA010, 0x11010]
@@ -0,0 +1,106 @@
+import struct
+
+from qmk.tokenized_log import LogDecoder, format_record, token_hash, tokens_from_elf, tokens_from_json, tokens_to_json
+
+
+def _varint(value):
+    value += 1
+    out = bytearray()
+    while value >= 0x80:
+        out.append(value & 0x7F | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+
+def _record(fmt, *args):
+    payload = bytearray(struct.pack('<H', token_hash(fmt)))
+    for arg in args:
+        if isinstance(arg, str):
+            payload += _varint(len(arg)) + arg.encode('utf-8')
+        else:
+            payload += _varint(arg & 0xFFFFFFFF)
+    return bytes([0xFF, len(payload)]) + payload
+
+
+def _elf32(sections):
+    """Minimal little endian ELF32 with the given (name, data) sections.
+    """
+    names = b'\0' + b''.join(name.encode() + b'\0' for name, _ in sections) + b'.shstrtab\0'
+    body = b''.join(data for _, data in sections) + names
+    shoff = 52 + len(body)
+
+    headers = [b'\0' * 40]
+    offset, name_offset = 52, 1
+    for name, data in sections:
+        headers.append(struct.pack('<IIIIIIIIII', name_offset, 1, 0, 0, offset, len(data), 0, 0, 1, 0))
+        offset += len(data)
+        name_offset += len(name) + 1
+    headers.append(struct.pack('<IIIIIIIIII', name_offset, 3, 0, 0, offset, len(names), 0, 0, 1, 0))
+
+    ident = b'\x7fELF' + bytes([1, 1, 1]) + b'\0' * 9
+    header = ident + struct.pack('<HHIIIIIHHHHHH', 2, 40, 1, 0, 0, shoff, 0, 52, 0, 0, 40, len(headers), len(headers) - 1)
+    return header + body + b''.join(headers)
+
+
+def test_token_hash():
+    # Same values as quantum/logging/tests/tokenized_log_tests.cpp
+    assert token_hash('hello\n') == 0xA279
+    assert token_hash('%d %u %lX\n') == 0x8170
+    assert token_hash('x' * 70) == 0x18BA
+
+
+def test_token_hash_has_no_zero_bytes():
+    for i in range(5000):
+        token = token_hash(f'format {i}')
+        assert token & 0xFF and token >> 8
+
+
+def test_tokens_from_elf():
+    elf = _elf32([('.text', b'\x00' * 16), ('.qmk_log_tokens', b'hello\n\0%s=%d\n\0hello\n\0')])
+    tokens = tokens_from_elf(elf)
+    assert tokens == {token_hash('hello\n'): ['hello\n'], token_hash('%s=%d\n'): ['%s=%d\n']}
+    assert tokens_from_json(tokens_to_json(tokens)) == tokens
+
+
+def test_tokens_from_elf_without_section():
+    assert tokens_from_elf(_elf32([('.text', b'\x00' * 16)])) == {}
+
+
+def test_format_record():
+    assert format_record('%d %u %lX %s %c%%', [0xFFFFFFFF, 0xFFFFFFFF, 0x12C, 'abc', 0x41]) == '-1 4294967295 12C abc A%'
+    assert format_record('%02X %04x %5s|%-3d|', [0xA, 0xBEEF, 'ab', 7]) == '0A beef    ab|7  |'
+    assert format_record('%08b %016b', [5, 0x8001]) == '00000101 1000000000000001'
+    assert format_record('%hd %hhu', [0xFFFF, 0x1FF]) == '-1 255'
+    assert format_record('%*d', [4, 7]) == '   7'
+
+
+def test_decoder():
+    tokens = {token_hash('%s=%d\n'): ['%s=%d\n'], token_hash('hello\n'): ['hello\n']}
+    decoder = LogDecoder(tokens)
+    data = b'plain ' + _record('hello\n') + _record('%s=%d\n', 'layer', -2) + 'é\n'.encode('utf-8')
+    assert decoder.feed(data) == 'plain hello\nlayer=-2\né\n'
+
+
+def test_decoder_split_and_padded():
+    tokens = {token_hash('%s=%d\n'): ['%s=%d\n']}
+    decoder = LogDecoder(tokens)
+    data = _record('%s=%d\n', 'matrix', 300) * 3
+
+    # Split into 8 byte reports, zero padded to 32 like the console endpoint
+    output = ''
+    for i in range(0, len(data), 8):
+        output += decoder.feed(data[i:i + 8].ljust(32, b'\0'))
+    assert output == 'matrix=300\n' * 3
+
+
+def test_decoder_collision_picks_matching_arguments():
+    token = token_hash('%d\n')
+    decoder = LogDecoder({token: ['%s %s\n', '%d\n']})
+    assert decoder.feed(_record('%d\n', 42)) == '42\n'
+
+
+def test_decoder_unknown_token():
+    token = token_hash('missing\n')
+    decoder = LogDecoder({})
+    assert decoder.feed(_record('missing\n', 1)) == f'<unknown log token 0x{token:04X}: 02>\n'
@@ -0,0 +1,89 @@
+import random
+
+import pytest
+
+from qmk.via_compress import HEADER_SIZE, ID_GET_COMPRESSED, ID_SET_COMPRESSED, KC_NO, KC_TRNS, PACKET_SIZE, decode, encode, read_keymap, write_keymap
+
+
+class FakeKeyboard:
+    """Answers compressed keymap commands the way quantum/via_compress.c does.
+    """
+    def __init__(self, keycodes):
+        self.keycodes = list(keycodes)
+        self.requests = 0
+
+    def transfer(self, packet):
+        self.requests += 1
+        packet = bytearray(packet)
+        index = packet[1] << 8 | packet[2]
+        count = min(packet[3] << 8 | packet[4], max(len(self.keycodes) - index, 0))
+
+        if packet[0] == ID_GET_COMPRESSED:
+            count, stream = encode(self.keycodes[index:index + count])[0] if count else (0, b'')
+            packet[5] = len(stream)
+            packet[HEADER_SIZE:] = stream.ljust(PACKET_SIZE - HEADER_SIZE, b'\0')
+        elif packet[0] == ID_SET_COMPRESSED:
+            try:
+                keycodes = decode(packet[HEADER_SIZE:HEADER_SIZE + packet[5]])
+            except ValueError:
+                keycodes = []
+            if len(keycodes) == count:
+                self.keycodes[index:index + count] = keycodes
+            else:
+                count = 0
+
+        packet[3:5] = count.to_bytes(2, 'big')
+        return bytes(packet)
+
+
+def _random_keycodes(seed, length=300):
+    rng = random.Random(seed)
+    return [rng.choice([KC_NO, KC_TRNS, rng.randrange(0x100), rng.randrange(0x10000)]) for _ in range(length)]
+
+
+def test_reference_stream():
+    # Same stream as quantum/via_compress/tests/via_compress_tests.cpp
+    keycodes = [KC_NO] * 3 + [0x04, 0x05, KC_TRNS, 0x5221, 0x7C00, 0x06] + [KC_TRNS] * 71
+    assert encode(keycodes) == [(80, bytes([0x02, 0x81, 0x04, 0x05, 0x40, 0xC1, 0x52, 0x21, 0x7C, 0x00, 0x80, 0x06, 0x7F, 0x46]))]
+    assert decode(encode(keycodes)[0][1]) == keycodes
+
+
+def test_streams_fit_packets():
+    for seed in range(50):
+        keycodes = _random_keycodes(seed)
+        streams = encode(keycodes)
+        assert all(len(stream) <= PACKET_SIZE - HEADER_SIZE for _, stream in streams)
+        assert sum(count for count, _ in streams) == len(keycodes)
+        assert [kc for _, stream in streams for kc in decode(stream)] == keycodes
+
+
+def test_decode_rejects_truncated_literal():
+    with pytest.raises(ValueError):
+        decode(bytes([0x82, 0x04, 0x05]))
+    with pytest.raises(ValueError):
+        decode(bytes([0xC1, 0x52, 0x21, 0x7C]))
+
+
+def test_keyboard_round_trip():
+    keyboard = FakeKeyboard([0xFFFF] * 300)
+    for seed in range(20):
+        keycodes = _random_keycodes(seed)
+        write_keymap(keyboard.transfer, 0, keycodes)
+        assert keyboard.keycodes == keycodes
+        assert read_keymap(keyboard.transfer, 0, len(keycodes)) == keycodes
+
+
+def test_mostly_transparent_layers_compress():
+    base = [0x04 + i % 0x60 for i in range(75)]
+    upper = [KC_TRNS] * 60 + [0x3A + i for i in range(12)] + [KC_NO] * 3
+    keyboard = FakeKeyboard(base + upper * 3)
+
+    assert read_keymap(keyboard.transfer, 0, 300) == base + upper * 3
+    # id_dynamic_keymap_get_buffer needs 22 requests of 28 bytes
+    assert keyboard.requests * 3 <= 22
+
+
+def test_read_past_end():
+    keyboard = FakeKeyboard([KC_TRNS] * 10)
+    with pytest.raises(ValueError):
+        read_keymap(keyboard.transfer, 5, 10)
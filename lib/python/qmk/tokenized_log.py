@@ -0,0 +1,233 @@
+"""Host side of tokenized logging, see quantum/logging/tokenized_log.h.
+
+Builds the token table from the `.qmk_log_tokens` section of a firmware ELF and turns console output back into text.
+"""
+import codecs
+import re
+import struct
+
+RECORD_START = 0xFF
+SECTION_NAME = '.qmk_log_tokens'
+HASH_LENGTH = 64
+HASH_MULTIPLIER = 65599
+
+FORMAT_RE = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|z|j|t)?([diuxXobcsp%])')
+
+
+def token_hash(fmt):
+    """Returns the token of a format string, the same value TOKENIZED_LOG_TOKEN() computes at compile time.
+    """
+    if isinstance(fmt, str):
+        fmt = fmt.encode('utf-8')
+
+    result = len(fmt) & 0xFFFFFFFF
+    coefficient = 1
+    for c in fmt[:HASH_LENGTH]:
+        coefficient = (coefficient * HASH_MULTIPLIER) & 0xFFFFFFFF
+        result = (result + coefficient * c) & 0xFFFFFFFF
+
+    token = (result ^ (result >> 16)) & 0xFFFF
+    if not token & 0x00FF:
+        token |= 0x0001
+    if not token & 0xFF00:
+        token |= 0x0100
+
+    return token
+
+
+def read_elf_section(data, name):
+    """Returns the contents of the named section of an ELF image, or None if there is no such section.
+    """
+    if data[:4] != b'\x7fELF':
+        raise ValueError('Not an ELF file')
+
+    is_64 = data[4] == 2
+    endian = '<' if data[5] == 1 else '>'
+
+    if is_64:
+        shoff, = struct.unpack_from(endian + 'Q', data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', data, 0x3A)
+        header = endian + 'IIQQQQIIQQ'
+    else:
+        shoff, = struct.unpack_from(endian + 'I', data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', data, 0x2E)
+        header = endian + 'IIIIIIIIII'
+
+    sections = [struct.unpack_from(header, data, shoff + i * shentsize) for i in range(shnum)]
+    if shstrndx >= len(sections):
+        return None
+
+    strtab = sections[shstrndx]
+    names = data[strtab[4]:strtab[4] + strtab[5]]
+    for section in sections:
+        end = names.find(b'\0', section[0])
+        if names[section[0]:end].decode('utf-8', 'replace') == name:
+            return data[section[4]:section[4] + section[5]]
+
+    return None
+
+
+def tokens_from_elf(data):
+    """Returns the token table, a dict of token to the list of format strings that hash to it.
+    """
+    section = read_elf_section(data, SECTION_NAME)
+    if section is None:
+        return {}
+
+    tokens = {}
+    for entry in section.split(b'\0'):
+        if not entry:
+            continue
+        fmt = entry.decode('utf-8', 'replace')
+        formats = tokens.setdefault(token_hash(entry), [])
+        if fmt not in formats:
+            formats.append(fmt)
+
+    return tokens
+
+
+def tokens_to_json(tokens):
+    return {f'0x{token:04X}': sorted(formats) for token, formats in sorted(tokens.items())}
+
+
+def tokens_from_json(data):
+    return {int(token, 16): list(formats) for token, formats in data.items()}
+
+
+def _read_varint(payload, offset):
+    """Reads one argument varint, which holds the value plus one.
+    """
+    value = 0
+    shift = 0
+    while offset < len(payload) and shift <= 28:
+        byte = payload[offset]
+        offset += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value - 1, offset
+
+    raise ValueError('Truncated varint')
+
+
+def _decode_args(fmt, payload):
+    """Returns the arguments the format string expects, or None if the payload does not match it exactly.
+    """
+    args = []
+    offset = 0
+    try:
+        for match in FORMAT_RE.finditer(fmt):
+            width, precision, conversion = match.group(2), match.group(3), match.group(5)
+            if conversion == '%':
+                continue
+            for star in (width, precision):
+                if star == '*':
+                    value, offset = _read_varint(payload, offset)
+                    args.append(value)
+            value, offset = _read_varint(payload, offset)
+            if conversion == 's':
+                if offset + value > len(payload):
+                    return None
+                value, offset = payload[offset:offset + value].decode('utf-8', 'replace'), offset + value
+            args.append(value)
+
+    except ValueError:
+        return None
+
+    if offset != len(payload):
+        return None
+
+    return args
+
+
+def _signed(value, bits):
+    value &= (1 << bits) - 1
+    return value - (1 << bits) if value & (1 << (bits - 1)) else value
+
+
+def format_record(fmt, args):
+    """printf-style formatting of the subset lib/printf supports, with 32-bit integers.
+    """
+    args = list(args)
+
+    def replace(match):
+        flags, width, precision, length, conversion = match.groups()
+        if conversion == '%':
+            return '%'
+        if width == '*':
+            width = str(_signed(args.pop(0), 32))
+        if precision == '*':
+            precision = str(_signed(args.pop(0), 32))
+        value = args.pop(0)
+
+        bits = {'hh': 8, 'h': 16}.get(length, 32)
+        spec = '%' + flags + (width or '') + ('.' + precision if precision is not None else '')
+
+        if conversion in 'di':
+            return (spec + 'd') % _signed(value, bits)
+        if conversion in 'uxXo':
+            return (spec + conversion.replace('u', 'd')) % (value & ((1 << bits) - 1))
+        if conversion == 'c':
+            return (spec + 'c') % chr(value & 0xFF)
+        if conversion == 's':
+            return (spec + 's') % value
+        if conversion == 'p':
+            return (spec + 's') % f'0x{value:08x}'
+
+        # %b, which python's % operator does not have
+        digits = format(value & ((1 << bits) - 1), 'b')
+        if precision:
+            digits = digits.zfill(int(precision))
+        if width:
+            if '-' in flags:
+                digits = digits.ljust(int(width))
+            else:
+                digits = digits.rjust(int(width), '0' if '0' in flags else ' ')
+        return digits
+
+    return FORMAT_RE.sub(replace, fmt)
+
+
+def decode_record(tokens, token, payload):
+    for fmt in tokens.get(token, []):
+        args = _decode_args(fmt, payload)
+        if args is not None:
+            return format_record(fmt, args)
+
+    return f'<unknown log token 0x{token:04X}: {payload.hex()}>\n'
+
+
+class LogDecoder:
+    """Incrementally turns console output into text, decoding tokenized records on the way.
+
+    Zero bytes are dropped before decoding, as records never contain them but the padding of console reports does.
+    """
+    def __init__(self, tokens):
+        self.tokens = tokens
+        self.pending = bytearray()
+        self.text = codecs.getincrementaldecoder('utf-8')('replace')
+
+    def feed(self, data):
+        self.pending += bytes(data).replace(b'\0', b'')
+        output = []
+
+        while self.pending:
+            start = self.pending.find(RECORD_START)
+            if start != 0:
+                end = len(self.pending) if start < 0 else start
+                output.append(self.text.decode(bytes(self.pending[:end])))
+                del self.pending[:end]
+                continue
+
+            if len(self.pending) < 2 or len(self.pending) < 2 + self.pending[1]:
+                break
+
+            length = self.pending[1]
+            record = bytes(self.pending[2:2 + length])
+            del self.pending[:2 + length]
+            if length < 2:
+                continue
+
+            output.append(decode_record(self.tokens, record[0] | record[1] << 8, record[2:]))
+
+        return ''.join(output)
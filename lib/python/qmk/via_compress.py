@@ -0,0 +1,134 @@
+"""Host side of the VIA compressed keymap commands, see quantum/via_compress.h.
+
+Keycodes are addressed by index in dynamic keymap buffer order, layer by layer, row by row.
+"""
+PACKET_SIZE = 32
+HEADER_SIZE = 6
+MAX_RUN = 64
+
+ID_GET_COMPRESSED = 0x17
+ID_SET_COMPRESSED = 0x18
+
+TAG_NO = 0x00
+TAG_TRNS = 0x40
+TAG_BASIC = 0x80
+TAG_KEYCODE = 0xC0
+
+KC_NO = 0x0000
+KC_TRNS = 0x0001
+
+
+def _tokens(keycodes, size):
+    """Yields (keycode count, token bytes), a literal token being cut short so it fits in `size` bytes.
+    """
+    i = 0
+    while i < len(keycodes):
+        keycode = keycodes[i]
+        run = 1
+
+        if keycode in (KC_NO, KC_TRNS):
+            while run < MAX_RUN and i + run < len(keycodes) and keycodes[i + run] == keycode:
+                run += 1
+            yield run, bytes([(TAG_NO if keycode == KC_NO else TAG_TRNS) | (run - 1)])
+
+        else:
+            basic = keycode <= 0xFF
+            width = 1 if basic else 2
+            while run < MAX_RUN and i + run < len(keycodes) and 1 + (run + 1) * width <= size:
+                following = keycodes[i + run]
+                if following in (KC_NO, KC_TRNS) or (following <= 0xFF) != basic:
+                    break
+                run += 1
+
+            token = bytearray([(TAG_BASIC if basic else TAG_KEYCODE) | (run - 1)])
+            for literal in keycodes[i:i + run]:
+                token += literal.to_bytes(width, 'big')
+            yield run, bytes(token)
+
+        i += run
+
+
+def encode(keycodes, size=PACKET_SIZE - HEADER_SIZE):
+    """Splits keycodes into streams of at most `size` bytes. Returns a list of (keycode count, stream).
+    """
+    streams = [[0, bytearray()]]
+    for run, token in _tokens(list(keycodes), size):
+        if len(streams[-1][1]) + len(token) > size:
+            streams.append([0, bytearray()])
+        streams[-1][0] += run
+        streams[-1][1] += token
+
+    return [(count, bytes(stream)) for count, stream in streams if count]
+
+
+def decode(stream):
+    """Returns the keycodes of a stream, raises ValueError if it is malformed.
+    """
+    keycodes = []
+    pos = 0
+    while pos < len(stream):
+        tag = stream[pos] & 0xC0
+        run = (stream[pos] & 0x3F) + 1
+        pos += 1
+
+        if tag == TAG_NO:
+            keycodes += [KC_NO] * run
+        elif tag == TAG_TRNS:
+            keycodes += [KC_TRNS] * run
+        else:
+            width = 1 if tag == TAG_BASIC else 2
+            if pos + run * width > len(stream):
+                raise ValueError('Truncated literal')
+            keycodes += [int.from_bytes(stream[pos + j * width:pos + (j + 1) * width], 'big') for j in range(run)]
+            pos += run * width
+
+    return keycodes
+
+
+def get_request(index, count):
+    return bytes([ID_GET_COMPRESSED, index >> 8, index & 0xFF, count >> 8, count & 0xFF]).ljust(PACKET_SIZE, b'\0')
+
+
+def set_request(index, count, stream):
+    return bytes([ID_SET_COMPRESSED, index >> 8, index & 0xFF, count >> 8, count & 0xFF, len(stream)]).ljust(HEADER_SIZE, b'\0') + bytes(stream).ljust(PACKET_SIZE - HEADER_SIZE, b'\0')
+
+
+def parse_response(packet):
+    """Returns (first index, keycodes) of an id_dynamic_keymap_get_compressed response.
+    """
+    if packet[0] != ID_GET_COMPRESSED:
+        raise ValueError(f'Unexpected response 0x{packet[0]:02X}')
+
+    index = packet[1] << 8 | packet[2]
+    count = packet[3] << 8 | packet[4]
+    keycodes = decode(packet[HEADER_SIZE:HEADER_SIZE + packet[5]])
+    if len(keycodes) != count:
+        raise ValueError(f'Stream holds {len(keycodes)} keycodes, expected {count}')
+
+    return index, keycodes
+
+
+def read_keymap(transfer, index, count):
+    """Reads `count` keycodes from `index`. `transfer` sends a packet to the keyboard and returns its response.
+    """
+    keycodes = []
+    while len(keycodes) < count:
+        _, received = parse_response(transfer(get_request(index + len(keycodes), count - len(keycodes))))
+        if not received:
+            raise ValueError(f'Keymap ends at index {index + len(keycodes)}')
+        keycodes += received
+
+    return keycodes
+
+
+def write_keymap(transfer, index, keycodes):
+    """Writes keycodes from `index`, returns the number of packets it took.
+    """
+    streams = encode(keycodes)
+    for count, stream in streams:
+        response = transfer(set_request(index, count, stream))
+        if (response[3] << 8 | response[4]) != count:
+            raise ValueError(f'Keyboard rejected keycodes {index}-{index + count - 1}')
+        index += count
+
+    return len(streams)
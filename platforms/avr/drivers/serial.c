@@ -359,18 +359,27 @@ static void serial_send_packet(uint8_t *buffer, uint8_t size) {
     }
 }
 
-static uint8_t serial_recive_packet(uint8_t *buffer, uint8_t size) NO_INLINE;
-static uint8_t serial_recive_packet(uint8_t *buffer, uint8_t size) {
+static uint8_t serial_recive_packet(uint8_t *buffer, uint8_t size, bool length_prefixed) NO_INLINE;
+static uint8_t serial_recive_packet(uint8_t *buffer, uint8_t size, bool length_prefixed) {
     uint8_t pecount = 0;
     for (uint8_t i = 0; i < size; ++i) {
         uint8_t data;
         sync_recv();
         data      = serial_read_chunk(&pecount, 8);
         buffer[i] = data;
+        // a length prefixed buffer ends where its first byte says
+        if (length_prefixed && i == 0 && data > 0 && data < size) {
+            size = data;
+        }
     }
     return pecount == 0;
 }
 
+// Bytes of a transaction buffer that go over the wire, see serial_recive_packet()
+static inline uint8_t packet_size(split_transaction_desc_t *trans, uint8_t *buffer, uint8_t size) {
+    return (trans->length_prefixed && buffer[0] > 0 && buffer[0] < size) ? buffer[0] : size;
+}
+
 inline static void change_sender2reciver(void) {
     sync_send();                // 0
     serial_delay_half1();       // 1
@@ -419,13 +428,13 @@ ISR(SERIAL_PIN_INTERRUPT) {
     }
 
     // target send phase
-    if (trans->target2initiator_buffer_size > 0) serial_send_packet((uint8_t *)split_trans_target2initiator_buffer(trans), trans->target2initiator_buffer_size);
+    if (trans->target2initiator_buffer_size > 0) serial_send_packet((uint8_t *)split_trans_target2initiator_buffer(trans), packet_size(trans, split_trans_target2initiator_buffer(trans), trans->target2initiator_buffer_size));
     // target switch to input
     change_sender2reciver();
 
     // target recive phase
     if (trans->initiator2target_buffer_size > 0) {
-        serial_recive_packet((uint8_t *)split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size);
+        serial_recive_packet((uint8_t *)split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size, trans->length_prefixed);
     }
 
     sync_recv(); // weit initiator output to high
@@ -476,7 +485,7 @@ bool soft_serial_transaction(int sstd_index) {
     // initiator recive phase
     // if the target is present syncronize with it
     if (trans->target2initiator_buffer_size > 0) {
-        if (!serial_recive_packet((uint8_t *)split_trans_target2initiator_buffer(trans), trans->target2initiator_buffer_size)) {
+        if (!serial_recive_packet((uint8_t *)split_trans_target2initiator_buffer(trans), trans->target2initiator_buffer_size, trans->length_prefixed)) {
             serial_output();
             serial_high();
             sei();
@@ -489,7 +498,7 @@ bool soft_serial_transaction(int sstd_index) {
 
     // initiator send phase
     if (trans->initiator2target_buffer_size > 0) {
-        serial_send_packet((uint8_t *)split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size);
+        serial_send_packet((uint8_t *)split_trans_initiator2target_buffer(trans), packet_size(trans, split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size));
     }
 
     // always, release the line when not in use
@@ -0,0 +1,78 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef CRC_STM32_MOCKED
+#    include "crc_stm32_mock.h"
+#else
+#    include <hal.h>
+#endif
+
+#include "crc.h"
+
+/* The STM32 CRC unit shifts data in MSB first. Reversing every input byte
+ * and the output turns that into the reflected CRC-32, whose running value
+ * is then kept bit reversed in the unit, so it goes into CRC_INIT reversed.
+ * CRC-16/CCITT is MSB first already and only needs the polynomial. */
+
+#if !defined(CRC_CR_REV_IN)
+#    error "CRC_DRIVER = stm32 needs a CRC unit with configurable bit order, as found on STM32F0, F3, L4 and G4"
+#endif
+
+void crc_init(void) {
+    rccEnableCRC(true);
+}
+
+static void crc_start(uint32_t cr, uint32_t init) {
+    CRC->CR   = cr;
+    CRC->INIT = init;
+    CRC->CR   = cr | CRC_CR_RESET;
+}
+
+#ifndef CRC_STM32_MOCKED
+static inline void crc_write_dr8(uint8_t data) {
+    *(volatile uint8_t *)&CRC->DR = data;
+}
+
+static inline uint32_t crc_read_dr(void) {
+    return CRC->DR;
+}
+#endif
+
+static void crc_feed(const void *data, size_t data_len) {
+    const uint8_t *d = (const uint8_t *)data;
+
+    while (data_len--) {
+        crc_write_dr8(*d++);
+    }
+}
+
+uint32_t crc32_update(uint32_t crc, const void *data, size_t data_len) {
+#if defined(CRC_CR_POLYSIZE)
+    CRC->POL = 0x04C11DB7;
+#endif
+    crc_start(CRC_CR_REV_IN_0 | CRC_CR_REV_OUT, __RBIT(crc));
+    crc_feed(data, data_len);
+    return crc_read_dr();
+}
+
+#if defined(CRC_CR_POLYSIZE)
+uint16_t crc16_update(uint16_t crc, const void *data, size_t data_len) {
+    CRC->POL = 0x1021;
+    crc_start(CRC_CR_POLYSIZE_0, crc);
+    crc_feed(data, data_len);
+    return (uint16_t)crc_read_dr();
+}
+#endif // defined(CRC_CR_POLYSIZE)
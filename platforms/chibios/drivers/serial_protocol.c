@@ -9,9 +9,48 @@
 #include "printf.h"
 #include "synchronization_util.h"
 
+#if defined(SERIAL_USART_PIPELINE)
+#    include "serial_frame.h"
+
+#    if !defined(SERIAL_USART_FULL_DUPLEX)
+#        error SERIAL_USART_PIPELINE requires SERIAL_USART_FULL_DUPLEX
+#    endif
+
+#    ifndef SERIAL_USART_PIPELINE_DEPTH
+#        define SERIAL_USART_PIPELINE_DEPTH 4
+#    endif
+
+static uint8_t frame[SERIAL_FRAME_MAX_SIZE];
+static uint8_t posted[SERIAL_USART_PIPELINE_DEPTH]; // writes whose acknowledgement is still on the wire
+static uint8_t posted_head;                          // oldest of them
+static uint8_t posted_count;
+static bool    posted_lost;        // an acknowledgement failed, the posted writes have to be sent again
+static int8_t  failed_transaction; // the one to blame for the last failed transaction
+#endif
+
 static inline bool initiate_transaction(uint8_t transaction_id);
 static inline bool react_to_transaction(void);
 
+/**
+ * @brief Bytes of a transaction buffer that go over the wire. A length prefixed
+ * buffer ends where its first byte says, unless that is 0 or out of range.
+ */
+static inline uint8_t transaction_buffer_length(const split_transaction_desc_t* transaction, const uint8_t* buffer, uint8_t size) {
+    return (transaction->length_prefixed && buffer[0] > 0 && buffer[0] < size) ? buffer[0] : size;
+}
+
+static inline bool send_transaction_buffer(const split_transaction_desc_t* transaction, const uint8_t* source, uint8_t size) {
+    return serial_transport_send(source, transaction_buffer_length(transaction, source, size));
+}
+
+static inline bool receive_transaction_buffer(const split_transaction_desc_t* transaction, uint8_t* destination, uint8_t size) {
+    if (unlikely(!serial_transport_receive(destination, 1))) {
+        return false;
+    }
+    size = transaction_buffer_length(transaction, destination, size);
+    return size == 1 || serial_transport_receive(destination + 1, size - 1);
+}
+
 /**
  * @brief This thread runs on the slave and responds to transactions initiated
  * by the master.
@@ -47,6 +86,64 @@ void soft_serial_initiator_init(void) {
     serial_transport_driver_master_init();
 }
 
+#if defined(SERIAL_USART_PIPELINE)
+
+/**
+ * @brief Receive the rest of a frame whose ID is in, for a buffer of size bytes.
+ */
+static inline bool receive_frame(const split_transaction_desc_t* transaction, uint8_t size, uint8_t* length) {
+    *length = 0;
+    if (size) {
+        if (unlikely(!serial_transport_receive(frame + 1, 1))) {
+            return false;
+        }
+        *length = serial_frame_payload_length(frame, size, transaction->length_prefixed);
+    }
+    /* The rest of the payload and the checksum. */
+    return serial_transport_receive(frame + 1 + (size ? 1 : 0), *length + (size ? 0 : 1));
+}
+
+static inline bool send_frame(const split_transaction_desc_t* transaction, uint8_t id, const uint8_t* source, uint8_t size) {
+    uint8_t length = size ? transaction_buffer_length(transaction, source, size) : 0;
+    return serial_transport_send(frame, serial_frame_encode(frame, id, source, length));
+}
+
+/**
+ * @brief React to transactions started by the master. Each one is a single
+ * frame, answered by a single frame.
+ */
+static inline bool react_to_transaction(void) {
+    /* Wait until there is a transaction for us. */
+    if (unlikely(!serial_transport_receive_blocking(frame, 1))) {
+        return false;
+    }
+
+    /* Sanity check that we are actually responding to a valid transaction. */
+    uint8_t transaction_id = frame[0];
+    if (unlikely(transaction_id >= NUM_TOTAL_TRANSACTIONS)) {
+        return false;
+    }
+
+    split_shared_memory_lock_autounlock();
+
+    split_transaction_desc_t* transaction = &split_transaction_table[transaction_id];
+
+    uint8_t length;
+    if (unlikely(!receive_frame(transaction, transaction->initiator2target_buffer_size, &length) || !serial_frame_decode(frame, transaction_id, split_trans_initiator2target_buffer(transaction), length))) {
+        return false;
+    }
+
+    /* Allow any slave processing to occur. */
+    if (transaction->slave_callback) {
+        transaction->slave_callback(transaction->initiator2target_buffer_size, split_trans_initiator2target_buffer(transaction), transaction->initiator2target_buffer_size, split_trans_target2initiator_buffer(transaction));
+    }
+
+    /* The reply doubles as the acknowledgement. */
+    return send_frame(transaction, transaction_id ^ NUM_TOTAL_TRANSACTIONS, split_trans_target2initiator_buffer(transaction), transaction->target2initiator_buffer_size);
+}
+
+#else
+
 /**
  * @brief React to transactions started by the master.
  */
@@ -75,7 +172,7 @@ static inline bool react_to_transaction(void) {
 
     /* Receive transaction buffer from the master. If this transaction requires it.*/
     if (transaction->initiator2target_buffer_size) {
-        if (unlikely(!serial_transport_receive(split_trans_initiator2target_buffer(transaction), transaction->initiator2target_buffer_size))) {
+        if (unlikely(!receive_transaction_buffer(transaction, split_trans_initiator2target_buffer(transaction), transaction->initiator2target_buffer_size))) {
             return false;
         }
     }
@@ -87,7 +184,7 @@ static inline bool react_to_transaction(void) {
 
     /* Send transaction buffer to the master. If this transaction requires it. */
     if (transaction->target2initiator_buffer_size) {
-        if (unlikely(!serial_transport_send(split_trans_target2initiator_buffer(transaction), transaction->target2initiator_buffer_size))) {
+        if (unlikely(!send_transaction_buffer(transaction, split_trans_target2initiator_buffer(transaction), transaction->target2initiator_buffer_size))) {
             return false;
         }
     }
@@ -95,6 +192,8 @@ static inline bool react_to_transaction(void) {
     return true;
 }
 
+#endif
+
 /**
  * @brief Start transaction from the master half to the slave half.
  *
@@ -108,11 +207,146 @@ bool soft_serial_transaction(int index) {
         /* Clear the receive queue, to start with a clean slate.
          * Parts of failed transactions or spurious bytes could still be in it. */
         serial_transport_driver_clear();
+#if defined(SERIAL_USART_PIPELINE)
+        /* Acknowledgements still on the wire are gone with it. */
+        posted_lost = posted_count > 0;
+#endif
     }
 
     return result;
 }
 
+#if defined(SERIAL_USART_PIPELINE)
+
+/**
+ * @brief Receive the reply of a transaction into its target2initiator buffer.
+ */
+static inline bool receive_reply(uint8_t transaction_id) {
+    split_transaction_desc_t* transaction = &split_transaction_table[transaction_id];
+
+    uint8_t length;
+    if (unlikely(!serial_transport_receive(frame, 1) || !receive_frame(transaction, transaction->target2initiator_buffer_size, &length))) {
+        return false;
+    }
+    return serial_frame_decode(frame, transaction_id ^ NUM_TOTAL_TRANSACTIONS, split_trans_target2initiator_buffer(transaction), length);
+}
+
+/**
+ * @brief Collect the acknowledgements of posted writes, oldest first, until
+ * at most `keep` are left on the wire. A write whose acknowledgement failed
+ * stays posted, together with the ones after it.
+ */
+static inline bool collect_acknowledgements(uint8_t keep) {
+    while (posted_count > keep) {
+        uint8_t transaction_id = posted[posted_head];
+        if (unlikely(!receive_reply(transaction_id))) {
+            serial_dprintf("SPLIT: acknowledgement of %u failed\n", transaction_id);
+            posted_lost = true;
+            return false;
+        }
+        posted_head = (posted_head + 1) % SERIAL_USART_PIPELINE_DEPTH;
+        posted_count--;
+    }
+    return true;
+}
+
+/**
+ * @brief Send the writes left posted by a failed acknowledgement again, one
+ * at a time. The slave may already have some of them, but a write only
+ * stores its buffer, which holds the latest data by now.
+ */
+static inline bool resend_posted_writes(void) {
+    /* Let the acknowledgements still on their way arrive, until the line has
+     * been quiet for SERIAL_USART_TIMEOUT, then drop them, so they can't be
+     * taken for those of the writes sent again. */
+    (void)serial_transport_receive(frame, sizeof(frame));
+    serial_transport_driver_clear();
+
+    while (posted_count) {
+        uint8_t                   transaction_id = posted[posted_head];
+        split_transaction_desc_t* transaction    = &split_transaction_table[transaction_id];
+        if (unlikely(!send_frame(transaction, transaction_id, split_trans_initiator2target_buffer(transaction), transaction->initiator2target_buffer_size) || !receive_reply(transaction_id))) {
+            serial_dprintf("SPLIT: resending %u failed\n", transaction_id);
+            failed_transaction = transaction_id;
+            return false;
+        }
+        posted_head = (posted_head + 1) % SERIAL_USART_PIPELINE_DEPTH;
+        posted_count--;
+    }
+    posted_lost = false;
+    return true;
+}
+
+int8_t soft_serial_failed_transaction(void) {
+    return failed_transaction;
+}
+
+/**
+ * @brief Initiate transaction to slave half.
+ *
+ * Writes, which get nothing back but the acknowledgement, return as soon as
+ * their frame is queued, so up to SERIAL_USART_PIPELINE_DEPTH of them can be
+ * on the wire while the master carries on. Their acknowledgements are
+ * collected when a read needs its reply or the pipeline is full. If one of
+ * them fails, that write and the ones posted after it are sent again right
+ * away, one at a time. Should that fail too, the transaction being started
+ * fails, the write is blamed for it and the next transaction tries again
+ * first.
+ */
+static inline bool initiate_transaction(uint8_t transaction_id) {
+    failed_transaction = transaction_id;
+
+    /* Sanity check that we are actually starting a valid transaction. */
+    if (unlikely(transaction_id >= NUM_TOTAL_TRANSACTIONS)) {
+        serial_dprintf("SPLIT: illegal transaction id\n");
+        return false;
+    }
+
+    split_shared_memory_lock_autounlock();
+
+    split_transaction_desc_t* transaction = &split_transaction_table[transaction_id];
+    bool                      is_write    = !transaction->target2initiator_buffer_size;
+
+    if (unlikely(posted_lost && !resend_posted_writes())) {
+        return false;
+    }
+
+    if (is_write && unlikely(!collect_acknowledgements(SERIAL_USART_PIPELINE_DEPTH - 1) && !resend_posted_writes())) {
+        return false;
+    }
+
+    if (unlikely(!send_frame(transaction, transaction_id, split_trans_initiator2target_buffer(transaction), transaction->initiator2target_buffer_size))) {
+        serial_dprintf("SPLIT: sending frame failed\n");
+        return false;
+    }
+
+    if (is_write) {
+        posted[(posted_head + posted_count) % SERIAL_USART_PIPELINE_DEPTH] = transaction_id;
+        posted_count++;
+        return true;
+    }
+
+    /* The slave answers in order, so the acknowledgements come first. The
+     * reply is lost with a failed one, ask again once the writes are through. */
+    if (unlikely(!collect_acknowledgements(0))) {
+        if (!resend_posted_writes()) {
+            return false;
+        }
+        if (!send_frame(transaction, transaction_id, split_trans_initiator2target_buffer(transaction), transaction->initiator2target_buffer_size)) {
+            serial_dprintf("SPLIT: sending frame failed\n");
+            return false;
+        }
+    }
+    if (unlikely(!receive_reply(transaction_id))) {
+        serial_dprintf("SPLIT: receiving frame failed\n");
+        return false;
+    }
+
+    return true;
+}
+
+#else
+
 /**
  * @brief Initiate transaction to slave half.
  */
@@ -146,7 +380,7 @@ static inline bool initiate_transaction(uint8_t transaction_id) {
 
     /* Send transaction buffer to the slave. If this transaction requires it. */
     if (transaction->initiator2target_buffer_size) {
-        if (unlikely(!serial_transport_send(split_trans_initiator2target_buffer(transaction), transaction->initiator2target_buffer_size))) {
+        if (unlikely(!send_transaction_buffer(transaction, split_trans_initiator2target_buffer(transaction), transaction->initiator2target_buffer_size))) {
             serial_dprintf("SPLIT: sending buffer failed\n");
             return false;
         }
@@ -154,7 +388,7 @@ static inline bool initiate_transaction(uint8_t transaction_id) {
 
     /* Receive transaction buffer from the slave. If this transaction requires it. */
     if (transaction->target2initiator_buffer_size) {
-        if (unlikely(!serial_transport_receive(split_trans_target2initiator_buffer(transaction), transaction->target2initiator_buffer_size))) {
+        if (unlikely(!receive_transaction_buffer(transaction, split_trans_target2initiator_buffer(transaction), transaction->target2initiator_buffer_size))) {
             serial_dprintf("SPLIT: receiving buffer failed\n");
             return false;
         }
@@ -162,3 +396,5 @@ static inline bool initiate_transaction(uint8_t transaction_id) {
 
     return true;
 }
+
+#endif
@@ -0,0 +1,106 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "console_tx.h"
+}
+
+using Bytes = std::vector<uint8_t>;
+
+static Bytes read_all(uint16_t chunk = 32) {
+    Bytes    out;
+    uint8_t  data[64];
+    uint16_t n;
+    while ((n = console_tx_read(data, chunk)) > 0) {
+        out.insert(out.end(), data, data + n);
+    }
+    return out;
+}
+
+static Bytes sequence(int first, int count) {
+    Bytes out;
+    for (int i = 0; i < count; i++) {
+        out.push_back((uint8_t)(first + i));
+    }
+    return out;
+}
+
+class ConsoleTx : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        read_all();
+        console_tx_clear_stats();
+    }
+};
+
+TEST_F(ConsoleTx, ReadsInOrderAcrossTheWrap) {
+    // Enough rounds of odd sized chunks to wrap several times
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 45; i++) {
+            EXPECT_TRUE(console_tx_put((uint8_t)(round + i)));
+        }
+        EXPECT_EQ(console_tx_count(), 45);
+        EXPECT_EQ(read_all(7), sequence(round, 45));
+    }
+    EXPECT_EQ(console_tx_get_stats().queued, 450);
+    EXPECT_EQ(console_tx_get_stats().dropped, 0);
+}
+
+TEST_F(ConsoleTx, ReadStopsAtSize) {
+    for (int i = 0; i < 10; i++) {
+        console_tx_put(i);
+    }
+    uint8_t data[4];
+    EXPECT_EQ(console_tx_read(data, sizeof(data)), 4);
+    EXPECT_EQ(data[3], 3);
+    EXPECT_EQ(console_tx_count(), 6);
+}
+
+TEST_F(ConsoleTx, OverflowPolicy) {
+    for (int i = 0; i < CONSOLE_TX_BUFFER_SIZE + 10; i++) {
+        bool queued = console_tx_put(i);
+#ifdef CONSOLE_TX_DROP_OLDEST
+        EXPECT_TRUE(queued);
+#else
+        EXPECT_EQ(queued, i < CONSOLE_TX_BUFFER_SIZE);
+#endif
+    }
+
+    console_tx_stats_t stats = console_tx_get_stats();
+    EXPECT_EQ(stats.dropped, 10);
+#ifdef CONSOLE_TX_DROP_OLDEST
+    EXPECT_EQ(stats.queued, CONSOLE_TX_BUFFER_SIZE + 10);
+    EXPECT_EQ(read_all(), sequence(10, CONSOLE_TX_BUFFER_SIZE));
+#else
+    EXPECT_EQ(stats.queued, CONSOLE_TX_BUFFER_SIZE);
+    EXPECT_EQ(read_all(), sequence(0, CONSOLE_TX_BUFFER_SIZE));
+#endif
+}
+
+TEST_F(ConsoleTx, WriteTakesOnlyWhatFits) {
+    Bytes data = sequence(0, 40);
+    EXPECT_EQ(console_tx_write(data.data(), data.size()), 40);
+    EXPECT_EQ(console_tx_write(data.data(), data.size()), CONSOLE_TX_BUFFER_SIZE - 40);
+    EXPECT_EQ(console_tx_get_stats().dropped, 0);
+
+    Bytes expected = sequence(0, 40);
+    Bytes rest     = sequence(0, CONSOLE_TX_BUFFER_SIZE - 40);
+    expected.insert(expected.end(), rest.begin(), rest.end());
+    EXPECT_EQ(read_all(), expected);
+}
@@ -0,0 +1,67 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "crc_stm32_mock.h"
+
+crc_stm32_mock_t crc_stm32_mock;
+
+uint32_t __RBIT(uint32_t value) {
+    uint32_t result = 0;
+    for (uint8_t i = 0; i < 32; i++) {
+        result = (result << 1) | ((value >> i) & 1);
+    }
+    return result;
+}
+
+static uint8_t poly_size(void) {
+    static const uint8_t sizes[] = {32, 16, 8, 7};
+    return sizes[(CRC->CR & CRC_CR_POLYSIZE) >> 3];
+}
+
+static uint32_t poly_mask(void) {
+    return poly_size() == 32 ? UINT32_MAX : (1UL << poly_size()) - 1;
+}
+
+// RESET clears itself once the unit has loaded INIT
+static void reset_if_asked(void) {
+    if (CRC->CR & CRC_CR_RESET) {
+        CRC->DR = CRC->INIT & poly_mask();
+        CRC->CR &= ~CRC_CR_RESET;
+    }
+}
+
+void crc_write_dr8(uint8_t data) {
+    reset_if_asked();
+    if (CRC->CR & CRC_CR_REV_IN) {
+        // only the byte wise reversal crc_stm32.c uses is modelled
+        data = __RBIT(data) >> 24;
+    }
+
+    uint8_t  size = poly_size();
+    uint32_t crc  = CRC->DR ^ ((uint32_t)data << (size - 8));
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        crc = (crc & (1UL << (size - 1))) ? (crc << 1) ^ CRC->POL : crc << 1;
+    }
+    CRC->DR = crc & poly_mask();
+}
+
+uint32_t crc_read_dr(void) {
+    reset_if_asked();
+    if (CRC->CR & CRC_CR_REV_OUT) {
+        return __RBIT(CRC->DR) >> (32 - poly_size());
+    }
+    return CRC->DR;
+}
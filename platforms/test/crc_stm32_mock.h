@@ -0,0 +1,55 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Host model of the STM32 CRC unit found on F0, F3, L4 and G4, for testing
+ * crc_stm32.c. Writes to CR, INIT and POL go straight to the registers, data
+ * goes in and out through crc_write_dr8() and crc_read_dr(). */
+typedef struct {
+    uint32_t DR;
+    uint32_t CR;
+    uint32_t INIT;
+    uint32_t POL;
+} crc_stm32_mock_t;
+
+extern crc_stm32_mock_t crc_stm32_mock;
+
+#define CRC (&crc_stm32_mock)
+
+#define CRC_CR_RESET (1 << 0)
+#define CRC_CR_POLYSIZE (3 << 3)
+#define CRC_CR_POLYSIZE_0 (1 << 3)
+#define CRC_CR_REV_IN (3 << 5)
+#define CRC_CR_REV_IN_0 (1 << 5)
+#define CRC_CR_REV_OUT (1 << 7)
+
+#define rccEnableCRC(lp)
+
+uint32_t __RBIT(uint32_t value);
+
+void     crc_write_dr8(uint8_t data);
+uint32_t crc_read_dr(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,90 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "crc.h"
+#include "crc_stm32_mock.h"
+}
+
+static const uint8_t check[] = "123456789";
+
+// Bit at a time references, the split halves must agree with these whatever their backend
+static uint16_t reference_crc16(const uint8_t *data, size_t length) {
+    uint16_t crc = CRC16_INIT;
+    for (size_t i = 0; i < length * 8; i++) {
+        bool bit = ((crc >> 15) ^ (data[i / 8] >> (7 - i % 8))) & 1;
+        crc      = (uint16_t)(crc << 1) ^ (bit ? 0x1021 : 0);
+    }
+    return crc;
+}
+
+static uint32_t reference_crc32(const uint8_t *data, size_t length) {
+    uint32_t crc = CRC32_INIT;
+    for (size_t i = 0; i < length * 8; i++) {
+        bool bit = (crc ^ (data[i / 8] >> (i % 8))) & 1;
+        crc      = (crc >> 1) ^ (bit ? 0xEDB88320 : 0);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+static std::vector<uint8_t> random_data(size_t length) {
+    std::vector<uint8_t> data(length);
+    uint32_t             random = 7;
+    for (auto &byte : data) {
+        random = random * 1103515245 + 12345;
+        byte   = random >> 16;
+    }
+    return data;
+}
+
+class CrcStm32 : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        crc_stm32_mock = {};
+        crc_init();
+    }
+};
+
+TEST_F(CrcStm32, CheckValues) {
+    EXPECT_EQ(crc16(check, 9), 0x29B1);
+    EXPECT_EQ(crc32(check, 9), 0xCBF43926);
+    EXPECT_EQ(crc16(check, 0), CRC16_INIT);
+    EXPECT_EQ(crc32(check, 0), 0u);
+}
+
+TEST_F(CrcStm32, MatchesSoftwareAtAnyLength) {
+    auto data = random_data(80);
+    for (size_t length = 0; length <= data.size(); length++) {
+        EXPECT_EQ(crc16(data.data(), length), reference_crc16(data.data(), length)) << "length " << length;
+        EXPECT_EQ(crc32(data.data(), length), reference_crc32(data.data(), length)) << "length " << length;
+    }
+}
+
+TEST_F(CrcStm32, UpdateInPiecesAndInterleaved) {
+    auto data = random_data(64);
+    for (size_t split = 0; split <= data.size(); split++) {
+        // the unit is set up again for every call, so the two may take turns
+        uint16_t crc16_value = crc16_update(CRC16_INIT, data.data(), split);
+        uint32_t crc32_value = crc32_update(CRC32_INIT, data.data(), split);
+        crc16_value          = crc16_update(crc16_value, &data[split], data.size() - split);
+        crc32_value          = crc32_update(crc32_value, &data[split], data.size() - split);
+        EXPECT_EQ(crc16_value, reference_crc16(data.data(), data.size())) << "split " << split;
+        EXPECT_EQ(crc32_value ^ 0xFFFFFFFF, reference_crc32(data.data(), data.size())) << "split " << split;
+    }
+}
@@ -0,0 +1,303 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <map>
+#include <vector>
+
+extern "C" {
+#include "report.h"
+#include "keycode_config.h"
+#include "bitwise.h"
+
+uint8_t         keyboard_protocol = 1;
+keymap_config_t keymap_config;
+}
+
+// The report functions as they were before they kept an index of the
+// report, as the reference for what every operation must do.
+struct Reference {
+#ifdef NKRO_ENABLE
+    std::array<uint8_t, KEYBOARD_REPORT_BITS> bits{};
+#endif
+    std::array<uint8_t, KEYBOARD_REPORT_KEYS> keys{};
+    int8_t                                    head = 0, tail = 0, count = 0;
+
+    bool operator<(const Reference &other) const {
+#ifdef NKRO_ENABLE
+        if (bits != other.bits) return bits < other.bits;
+#endif
+        return std::tie(keys, head, tail, count) < std::tie(other.keys, other.head, other.tail, other.count);
+    }
+
+    static int8_t inc(int8_t a) {
+        return (a + 1) % KEYBOARD_REPORT_KEYS;
+    }
+    static int8_t dec(int8_t a) {
+        return (a - 1 + KEYBOARD_REPORT_KEYS) % KEYBOARD_REPORT_KEYS;
+    }
+
+#ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
+    void add(uint8_t code) {
+        int8_t i = head, empty = -1;
+        if (count) {
+            do {
+                if (keys[i] == code) return;
+                if (empty == -1 && keys[i] == 0) empty = i;
+                i = inc(i);
+            } while (i != tail);
+            if (tail == head) {
+                if (empty == -1) {
+                    head = inc(head);
+                    count--;
+                } else {
+                    uint8_t offset = 1;
+                    i              = inc(empty);
+                    do {
+                        if (keys[i] != 0) {
+                            keys[empty] = keys[i];
+                            keys[i]     = 0;
+                            empty       = inc(empty);
+                        } else {
+                            offset++;
+                        }
+                        i = inc(i);
+                    } while (i != tail);
+                    tail = (tail - offset + KEYBOARD_REPORT_KEYS) % KEYBOARD_REPORT_KEYS;
+                }
+            }
+        }
+        keys[tail] = code;
+        tail       = inc(tail);
+        count++;
+    }
+
+    void del(uint8_t code) {
+        int8_t i = head;
+        if (!count) return;
+        do {
+            if (keys[i] == code) {
+                keys[i] = 0;
+                if (--count == 0) tail = head = 0;
+                if (i == dec(tail)) {
+                    do {
+                        tail = dec(tail);
+                        if (keys[dec(tail)] != 0) break;
+                    } while (tail != head);
+                }
+                return;
+            }
+            i = inc(i);
+        } while (i != tail);
+    }
+
+    uint8_t first() const {
+        int8_t i = head;
+        do {
+            if (keys[i] != 0) break;
+            i = inc(i);
+        } while (i != tail);
+        return keys[i];
+    }
+#else
+    void add(uint8_t code) {
+        int8_t i = 0, empty = -1;
+        for (; i < KEYBOARD_REPORT_KEYS; i++) {
+            if (keys[i] == code) break;
+            if (empty == -1 && keys[i] == 0) empty = i;
+        }
+        if (i == KEYBOARD_REPORT_KEYS && empty != -1) keys[empty] = code;
+    }
+
+    void del(uint8_t code) {
+        for (auto &key : keys) {
+            if (key == code) key = 0;
+        }
+    }
+
+    uint8_t first() const {
+        return keys[0];
+    }
+#endif
+
+    uint8_t any() const {
+        uint8_t n = 0;
+        for (auto key : keys) n += key != 0;
+        return n;
+    }
+
+#ifdef NKRO_ENABLE
+    void add_bit(uint8_t code) {
+        if ((code >> 3) < KEYBOARD_REPORT_BITS) bits[code >> 3] |= 1 << (code & 7);
+    }
+
+    void del_bit(uint8_t code) {
+        if ((code >> 3) < KEYBOARD_REPORT_BITS) bits[code >> 3] &= ~(1 << (code & 7));
+    }
+
+    uint8_t any_bit() const {
+        uint8_t n = 0;
+        for (auto byte : bits) n += byte != 0;
+        return n;
+    }
+
+    uint8_t first_bit() const {
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_BITS; i++) {
+            if (bits[i]) return i << 3 | biton(bits[i]);
+        }
+        return 0;
+    }
+#endif
+};
+
+// An operation is a key to add, or the negated key to remove.
+using Path = std::vector<int>;
+
+static void apply(report_keyboard_t &report, int op) {
+    if (op > 0) {
+        add_key_to_report(&report, op);
+    } else {
+        del_key_from_report(&report, -op);
+    }
+}
+
+static void apply(Reference &reference, int op, bool nkro) {
+#ifdef NKRO_ENABLE
+    if (nkro) {
+        op > 0 ? reference.add_bit(op) : reference.del_bit(-op);
+        return;
+    }
+#endif
+    op > 0 ? reference.add(op) : reference.del(-op);
+}
+
+static void expect_same(report_keyboard_t &report, const Reference &reference, bool nkro, const std::vector<uint8_t> &alphabet) {
+#ifdef NKRO_ENABLE
+    if (nkro) {
+        ASSERT_TRUE(std::equal(reference.bits.begin(), reference.bits.end(), report.nkro.bits));
+        ASSERT_EQ(has_anykey(&report), reference.any_bit());
+        ASSERT_EQ(get_first_key(&report), reference.first_bit());
+        for (auto key : alphabet) {
+            ASSERT_EQ(is_key_pressed(&report, key), (key >> 3) < KEYBOARD_REPORT_BITS && (reference.bits[key >> 3] >> (key & 7) & 1));
+        }
+        return;
+    }
+#endif
+    ASSERT_TRUE(std::equal(reference.keys.begin(), reference.keys.end(), report.keys));
+    ASSERT_EQ(has_anykey(&report), reference.any());
+    ASSERT_EQ(get_first_key(&report), reference.first());
+    for (auto key : alphabet) {
+        ASSERT_EQ(is_key_pressed(&report, key), std::find(reference.keys.begin(), reference.keys.end(), key) != reference.keys.end());
+    }
+}
+
+// Walks every state the reference can reach with the keys of `alphabet`,
+// and checks that every operation from it does the same to the report.
+static size_t explore(bool nkro, const std::vector<uint8_t> &alphabet) {
+    keymap_config.nkro = nkro;
+
+    std::map<Reference, Path> seen;
+    std::deque<Reference>     queue;
+    seen[Reference()] = Path();
+    queue.push_back(Reference());
+
+    report_keyboard_t report;
+    while (!queue.empty()) {
+        Reference state = queue.front();
+        queue.pop_front();
+        const Path path = seen[state];
+
+        for (auto key : alphabet) {
+            for (int op : {(int)key, -(int)key}) {
+                clear_keys_from_report(&report);
+                for (int step : path) {
+                    apply(report, step);
+                }
+                apply(report, op);
+
+                Reference next = state;
+                apply(next, op, nkro);
+                expect_same(report, next, nkro, alphabet);
+                if (testing::Test::HasFatalFailure()) {
+                    ADD_FAILURE() << "after " << testing::PrintToString(path) << " then " << op;
+                    return seen.size();
+                }
+
+                if (seen.find(next) == seen.end()) {
+                    Path next_path = path;
+                    next_path.push_back(op);
+                    seen[next] = next_path;
+                    queue.push_back(next);
+                }
+            }
+        }
+    }
+    return seen.size();
+}
+
+TEST(Report, AllReachableKeyStates) {
+    // One key more than fits in the report
+    size_t states = explore(false, {KC_A, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G});
+#ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
+    EXPECT_EQ(states, 225793);
+#else
+    EXPECT_GT(states, 5040);
+#endif
+}
+
+#ifdef NKRO_ENABLE
+TEST(Report, AllReachableNkroStates) {
+    // Both ends of a few bytes, and the first key past the bitmap
+    const uint8_t past_end = KEYBOARD_REPORT_BITS << 3;
+    size_t        states   = explore(true, {KC_A, KC_E, KC_F, KC_ENTER, KC_SPACE, past_end - 1, past_end});
+    EXPECT_EQ(states, 64);
+}
+#endif
+
+TEST(Report, EmptyReport) {
+    report_keyboard_t report;
+    keymap_config.nkro = false;
+    clear_keys_from_report(&report);
+    EXPECT_EQ(has_anykey(&report), 0);
+    EXPECT_EQ(get_first_key(&report), KC_NO);
+
+    add_key_to_report(&report, KC_NO);
+    EXPECT_EQ(has_anykey(&report), 0);
+    del_key_from_report(&report, KC_A);
+    EXPECT_EQ(has_anykey(&report), 0);
+}
+
+TEST(Report, SwitchingReportsRebuildsIndex) {
+    report_keyboard_t first, second;
+    memset(&first, 0, sizeof(first));
+    memset(&second, 0, sizeof(second));
+    keymap_config.nkro = false;
+
+    add_key_to_report(&first, KC_A);
+    add_key_to_report(&second, KC_B);
+    add_key_to_report(&second, KC_C);
+    add_key_to_report(&first, KC_D);
+
+    EXPECT_EQ(has_anykey(&first), 2);
+    EXPECT_EQ(has_anykey(&second), 2);
+    del_key_from_report(&second, KC_B);
+    EXPECT_EQ(has_anykey(&second), 1);
+    EXPECT_EQ(has_anykey(&first), 2);
+    EXPECT_EQ(get_first_key(&first), KC_A);
+}
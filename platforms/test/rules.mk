@@ -23,3 +23,46 @@ eeprom_stm32_SRC := \
 	$(PLATFORM_PATH)/chibios/drivers/eeprom/eeprom_stm32.c
 eeprom_stm32_tiny_SRC := $(eeprom_stm32_SRC)
 eeprom_stm32_large_SRC := $(eeprom_stm32_SRC)
+
+usb_report_queue_DEFS := -DNKRO_ENABLE -DPROTOCOL_ARM_ATSAM
+
+usb_report_queue_INC := \
+	$(TMK_PATH)/protocol/chibios/
+
+usb_report_queue_SRC := \
+	$(TMK_PATH)/protocol/chibios/usb_report_queue.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/usb_report_queue_tests.cpp
+
+usb_sof_sync_INC := \
+	$(TMK_PATH)/protocol/chibios/
+
+usb_sof_sync_SRC := \
+	$(TMK_PATH)/protocol/chibios/usb_sof_sync.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/usb_sof_sync_tests.cpp
+
+console_tx_DEFS := -DIGNORE_ATOMIC_BLOCK -DCONSOLE_TX_BUFFER_SIZE=64
+console_tx_drop_oldest_DEFS := $(console_tx_DEFS) -DCONSOLE_TX_DROP_OLDEST
+
+console_tx_SRC := \
+	$(TMK_PATH)/protocol/console_tx.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/console_tx_tests.cpp
+console_tx_drop_oldest_SRC := $(console_tx_SRC)
+
+report_DEFS := -DNO_DEBUG
+report_ring_buffered_DEFS := $(report_DEFS) -DRING_BUFFERED_6KRO_REPORT_ENABLE
+report_nkro_DEFS := $(report_DEFS) -DNKRO_ENABLE -DPROTOCOL_ARM_ATSAM
+
+report_SRC := \
+	$(TMK_PATH)/protocol/report.c \
+	$(QUANTUM_PATH)/bitwise.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/report_tests.cpp
+report_ring_buffered_SRC := $(report_SRC)
+report_nkro_SRC := $(report_SRC)
+
+crc_stm32_DEFS := -DNO_DEBUG -DCRC_STM32_MOCKED
+
+crc_stm32_SRC := \
+	$(QUANTUM_PATH)/crc.c \
+	$(PLATFORM_PATH)/chibios/drivers/crc_stm32.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/crc_stm32_mock.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/crc_stm32_tests.cpp
@@ -1 +1 @@
-TEST_LIST += eeprom_stm32_tiny eeprom_stm32_large
+TEST_LIST += eeprom_stm32_tiny eeprom_stm32_large usb_report_queue usb_sof_sync console_tx console_tx_drop_oldest report report_ring_buffered report_nkro crc_stm32
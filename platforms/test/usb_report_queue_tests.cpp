@@ -0,0 +1,393 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "report.h"
+#include "usb_report_queue.h"
+}
+
+/* Stands in for the USB stack and the host: one report can be in flight per
+ * endpoint, and only a host poll completes it and lets the next one start. */
+template <typename T>
+class MockHost {
+   public:
+    MockHost(usb_report_merge_t merge) {
+        usb_report_queue_init(&queue, slots, sizeof(T), merge);
+    }
+
+    /* Firmware side, like send_keyboard(): queue and return, or wait for the
+     * host while the queue is full. */
+    void send(const T &report) {
+        while (!usb_report_queue_push(&queue, &report)) {
+            waits++;
+            poll();
+        }
+        flush();
+    }
+
+    /* The host polls the endpoint, completing the transfer in flight. */
+    void poll() {
+        if (in_flight) {
+            T report;
+            memcpy(&report, in_flight, sizeof(T));
+            received.push_back(report);
+            in_flight = nullptr;
+            usb_report_queue_complete(&queue);
+            flush();
+        }
+    }
+
+    void drain() {
+        while (in_flight) {
+            poll();
+        }
+    }
+
+    usb_report_queue_t queue;
+    std::vector<T>     received;
+    int                waits = 0;
+
+   private:
+    void flush() {
+        if (!in_flight) {
+            in_flight = static_cast<uint8_t *>(usb_report_queue_start(&queue));
+        }
+    }
+
+    uint8_t  slots[USB_REPORT_QUEUE_SLOTS(T)];
+    uint8_t *in_flight = nullptr;
+};
+
+static report_keyboard_t keyboard(uint8_t mods, std::initializer_list<uint8_t> keys) {
+    report_keyboard_t report = {};
+    uint8_t           i      = 0;
+
+    report.mods = mods;
+    for (auto key : keys) {
+        report.keys[i++] = key;
+    }
+    return report;
+}
+
+static report_mouse_t mouse(uint8_t buttons, int8_t x, int8_t y) {
+    report_mouse_t report = {};
+
+    report.buttons = buttons;
+    report.x       = x;
+    report.y       = y;
+    return report;
+}
+
+static bool same(const report_keyboard_t &a, const report_keyboard_t &b) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+TEST(UsbReportQueue, IdleEndpointSendsImmediately) {
+    MockHost<report_keyboard_t> host(usb_report_merge_keyboard);
+
+    host.send(keyboard(0, {KC_A}));
+    EXPECT_TRUE(host.queue.in_flight);
+    EXPECT_EQ(host.queue.count, 1);
+
+    host.poll();
+    ASSERT_EQ(host.received.size(), 1);
+    EXPECT_TRUE(same(host.received[0], keyboard(0, {KC_A})));
+    EXPECT_FALSE(host.queue.in_flight);
+    EXPECT_EQ(host.queue.count, 0);
+}
+
+TEST(UsbReportQueue, TapInsideOneIntervalIsNotLost) {
+    MockHost<report_keyboard_t> host(usb_report_merge_keyboard);
+
+    host.send(keyboard(0, {KC_A}));
+    host.send(keyboard(0, {KC_A, KC_B}));
+    host.send(keyboard(0, {KC_A}));
+    host.drain();
+
+    ASSERT_EQ(host.received.size(), 3);
+    EXPECT_TRUE(same(host.received[0], keyboard(0, {KC_A})));
+    EXPECT_TRUE(same(host.received[1], keyboard(0, {KC_A, KC_B})));
+    EXPECT_TRUE(same(host.received[2], keyboard(0, {KC_A})));
+    EXPECT_EQ(host.queue.coalesced, 0);
+}
+
+TEST(UsbReportQueue, PressesInsideOneIntervalAreMerged) {
+    MockHost<report_keyboard_t> host(usb_report_merge_keyboard);
+
+    host.send(keyboard(0, {KC_A}));
+    host.send(keyboard(MOD_BIT(KC_LSFT), {KC_A}));
+    host.send(keyboard(MOD_BIT(KC_LSFT), {KC_A, KC_B}));
+    host.send(keyboard(MOD_BIT(KC_LSFT), {KC_A, KC_B, KC_C}));
+    host.drain();
+
+    ASSERT_EQ(host.received.size(), 2);
+    EXPECT_TRUE(same(host.received[0], keyboard(0, {KC_A})));
+    EXPECT_TRUE(same(host.received[1], keyboard(MOD_BIT(KC_LSFT), {KC_A, KC_B, KC_C})));
+    EXPECT_EQ(host.queue.coalesced, 2);
+}
+
+TEST(UsbReportQueue, ReleaseAndPressOfOtherKeyAreMerged) {
+    MockHost<report_keyboard_t> host(usb_report_merge_keyboard);
+
+    host.send(keyboard(0, {KC_A}));
+    host.send(keyboard(0, {}));
+    host.send(keyboard(0, {KC_B}));
+    host.drain();
+
+    ASSERT_EQ(host.received.size(), 2);
+    EXPECT_TRUE(same(host.received[1], keyboard(0, {KC_B})));
+}
+
+TEST(UsbReportQueue, ModifierTapIsNotLost) {
+    MockHost<report_keyboard_t> host(usb_report_merge_keyboard);
+
+    host.send(keyboard(0, {KC_A}));
+    host.send(keyboard(MOD_BIT(KC_LCTL), {KC_A}));
+    host.send(keyboard(0, {KC_A}));
+    host.drain();
+
+    ASSERT_EQ(host.received.size(), 3);
+    EXPECT_TRUE(same(host.received[1], keyboard(MOD_BIT(KC_LCTL), {KC_A})));
+}
+
+TEST(UsbReportQueue, ModifierAfterKeyPressIsNotMerged) {
+    MockHost<report_keyboard_t> host(usb_report_merge_keyboard);
+
+    // `a` then Shift within one interval types "a", not "A"
+    host.send(keyboard(0, {}));
+    host.send(keyboard(0, {KC_A}));
+    host.send(keyboard(MOD_BIT(KC_LSFT), {KC_A}));
+    host.drain();
+
+    ASSERT_EQ(host.received.size(), 3);
+    EXPECT_TRUE(same(host.received[1], keyboard(0, {KC_A})));
+    EXPECT_TRUE(same(host.received[2], keyboard(MOD_BIT(KC_LSFT), {KC_A})));
+}
+
+TEST(UsbReportQueue, ModifierReleaseBeforeKeyPressIsNotMerged) {
+    MockHost<report_keyboard_t> host(usb_report_merge_keyboard);
+
+    host.send(keyboard(MOD_BIT(KC_LSFT), {}));
+    host.send(keyboard(0, {}));
+    host.send(keyboard(0, {KC_A}));
+    host.drain();
+
+    ASSERT_EQ(host.received.size(), 3);
+    EXPECT_TRUE(same(host.received[1], keyboard(0, {})));
+    EXPECT_TRUE(same(host.received[2], keyboard(0, {KC_A})));
+}
+
+TEST(UsbReportQueue, FullQueueWaitsInsteadOfDroppingTaps) {
+    MockHost<report_keyboard_t> host(usb_report_merge_keyboard);
+
+    // Like SEND_STRING with TAP_CODE_DELAY 0: taps far faster than polling
+    host.send(keyboard(0, {}));
+    for (int i = 0; i < USB_REPORT_QUEUE_DEPTH + 2; i++) {
+        host.send(keyboard(0, {KC_A}));
+        host.send(keyboard(0, {}));
+    }
+    EXPECT_GT(host.waits, 0);
+    EXPECT_EQ(host.queue.refused, host.waits);
+
+    host.drain();
+    ASSERT_EQ(host.received.size(), 1 + 2 * (USB_REPORT_QUEUE_DEPTH + 2));
+    for (int i = 0; i < USB_REPORT_QUEUE_DEPTH + 2; i++) {
+        EXPECT_TRUE(same(host.received[1 + 2 * i], keyboard(0, {KC_A})));
+        EXPECT_TRUE(same(host.received[2 + 2 * i], keyboard(0, {})));
+    }
+}
+
+TEST(UsbReportQueue, MergesAgainstLastReportSent) {
+    MockHost<report_keyboard_t> host(usb_report_merge_keyboard);
+
+    host.send(keyboard(0, {KC_A}));
+    host.poll();
+    // queued but not started, as when another report holds a shared endpoint
+    report_keyboard_t release = keyboard(0, {});
+    report_keyboard_t press   = keyboard(0, {KC_A});
+    usb_report_queue_push(&host.queue, &release);
+    usb_report_queue_push(&host.queue, &press);
+
+    EXPECT_EQ(host.queue.count, 2);
+    EXPECT_EQ(host.queue.coalesced, 0);
+}
+
+TEST(UsbReportQueue, ClearForgetsTransferInFlight) {
+    MockHost<report_keyboard_t> host(usb_report_merge_keyboard);
+
+    host.send(keyboard(0, {KC_A}));
+    host.send(keyboard(0, {}));
+    usb_report_queue_clear(&host.queue);
+
+    EXPECT_EQ(host.queue.count, 0);
+    EXPECT_FALSE(host.queue.in_flight);
+    EXPECT_EQ(usb_report_queue_start(&host.queue), nullptr);
+    EXPECT_FALSE(usb_report_queue_complete(&host.queue));
+}
+
+TEST(UsbReportQueue, NkroBitmapMerge) {
+    uint8_t previous[4] = {0x00, 0x01, 0x00, 0x00};
+    uint8_t pending[4]  = {0x02, 0x03, 0x00, 0x00};
+    uint8_t more[4]     = {0x02, 0x03, 0x80, 0x00};
+    uint8_t undo[4]     = {0x02, 0x01, 0x80, 0x00};
+
+    EXPECT_TRUE(usb_report_merge_bitmap(pending, previous, more, sizeof(pending)));
+    EXPECT_EQ(memcmp(pending, more, sizeof(pending)), 0);
+    EXPECT_FALSE(usb_report_merge_bitmap(pending, previous, undo, sizeof(pending)));
+    EXPECT_EQ(memcmp(pending, more, sizeof(pending)), 0);
+}
+
+TEST(UsbReportQueue, NkroModifierAfterKeyPressIsNotMerged) {
+    decltype(report_keyboard_t::nkro) previous = {}, pending = {}, next = {};
+
+    pending.bits[KC_A / 8] = 1 << (KC_A % 8);
+    next                   = pending;
+    next.mods              = MOD_BIT(KC_LSFT);
+    EXPECT_FALSE(usb_report_merge_nkro(&pending, &previous, &next, sizeof(pending)));
+
+    // and the reverse: a modifier release followed by a key press
+    previous.mods       = MOD_BIT(KC_LSFT);
+    pending             = {};
+    next                = {};
+    next.bits[KC_A / 8] = 1 << (KC_A % 8);
+    EXPECT_FALSE(usb_report_merge_nkro(&pending, &previous, &next, sizeof(pending)));
+
+    // a modifier press followed by a key press still merges
+    previous     = {};
+    pending      = {};
+    pending.mods = MOD_BIT(KC_LSFT);
+    next.mods    = MOD_BIT(KC_LSFT);
+    EXPECT_TRUE(usb_report_merge_nkro(&pending, &previous, &next, sizeof(pending)));
+    EXPECT_EQ(memcmp(&pending, &next, sizeof(pending)), 0);
+}
+
+TEST(UsbReportQueue, MouseMotionAccumulates) {
+    MockHost<report_mouse_t> host(usb_report_merge_mouse);
+
+    host.send(mouse(0, 1, 1));
+    host.send(mouse(0, 10, -5));
+    host.send(mouse(0, 20, -5));
+    host.send(mouse(0, 100, 0)); // would saturate x
+    host.drain();
+
+    ASSERT_EQ(host.received.size(), 3);
+    EXPECT_EQ(host.received[1].x, 30);
+    EXPECT_EQ(host.received[1].y, -10);
+    EXPECT_EQ(host.received[2].x, 100);
+}
+
+TEST(UsbReportQueue, MouseClickIsNotLost) {
+    MockHost<report_mouse_t> host(usb_report_merge_mouse);
+
+    host.send(mouse(0, 5, 0));
+    host.send(mouse(MOUSE_BTN1, 0, 0));
+    host.send(mouse(0, 0, 0));
+    host.drain();
+
+    ASSERT_EQ(host.received.size(), 3);
+    EXPECT_EQ(host.received[1].buttons, MOUSE_BTN1);
+    EXPECT_EQ(host.received[2].buttons, 0);
+}
+
+/* Three report IDs on one endpoint, served like shared_in_cb() does. */
+class SharedEndpoint {
+   public:
+    SharedEndpoint() {
+        for (uint8_t i = 0; i < 3; i++) {
+            usb_report_queue_init(&queues[i], slots[i], sizeof(report_extra_t), NULL);
+        }
+    }
+
+    void send(uint8_t index, uint16_t usage) {
+        report_extra_t report = {.report_id = index, .usage = usage};
+        usb_report_queue_push(&queues[index], &report);
+        flush();
+    }
+
+    void drain() {
+        while (in_flight) {
+            report_extra_t report;
+            memcpy(&report, in_flight, sizeof(report));
+            received.push_back(report);
+            in_flight = nullptr;
+            for (auto &queue : queues) {
+                usb_report_queue_complete(&queue);
+            }
+            flush();
+        }
+    }
+
+    usb_report_queue_t          queues[3];
+    std::vector<report_extra_t> received;
+
+   private:
+    void flush() {
+        if (in_flight) {
+            return;
+        }
+        int8_t i = usb_report_queue_arbitrate(queues, 3, 0x7, &last);
+        if (i >= 0) {
+            in_flight = static_cast<uint8_t *>(usb_report_queue_start(&queues[i]));
+        }
+    }
+
+    uint8_t  slots[3][USB_REPORT_QUEUE_SLOTS(report_extra_t)];
+    uint8_t *in_flight = nullptr;
+    uint8_t  last      = 0;
+};
+
+TEST(UsbReportQueue, SharedEndpointTakesTurns) {
+    SharedEndpoint ep;
+
+    // a burst of consumer reports must not hold back the other two
+    for (uint16_t usage = 1; usage <= 4; usage++) {
+        ep.send(1, usage);
+    }
+    ep.send(2, 10);
+    ep.send(0, 20);
+    ep.drain();
+
+    std::vector<uint8_t> order;
+    for (auto &report : ep.received) {
+        order.push_back(report.report_id);
+    }
+    EXPECT_EQ(order, (std::vector<uint8_t>{1, 2, 0, 1, 1, 1}));
+    EXPECT_EQ(ep.received.back().usage, 4);
+}
+
+TEST(UsbReportQueue, ArbiterSkipsOtherEndpoints) {
+    usb_report_queue_t queues[3];
+    uint8_t            slots[3][USB_REPORT_QUEUE_SLOTS(report_extra_t)];
+    report_extra_t     report = {};
+    uint8_t            last   = 2;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        usb_report_queue_init(&queues[i], slots[i], sizeof(report_extra_t), NULL);
+        usb_report_queue_push(&queues[i], &report);
+    }
+    EXPECT_EQ(usb_report_queue_arbitrate(queues, 3, 0x6, &last), 1);
+    EXPECT_EQ(last, 1);
+
+    usb_report_queue_start(&queues[1]);
+    EXPECT_EQ(usb_report_queue_arbitrate(queues, 3, 0x6, &last), 2);
+    usb_report_queue_start(&queues[2]);
+    EXPECT_EQ(usb_report_queue_arbitrate(queues, 3, 0x6, &last), -1);
+}
@@ -0,0 +1,134 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "usb_sof_sync.h"
+}
+
+/* Simulated clock in microseconds, SOFs at every multiple of the frame. */
+class UsbSofSync : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        usb_sof_sync_init();
+    }
+
+    uint16_t frame() const {
+        return now / USB_SOF_FRAME_US;
+    }
+
+    uint16_t since_sof() const {
+        return now % USB_SOF_FRAME_US;
+    }
+
+    /* One pass of the main loop; returns the scan start time. */
+    uint32_t scan(bool aligned, uint32_t work_us, bool report = true) {
+        if (aligned) {
+            now += usb_sof_sync_scan_delay(frame(), since_sof());
+        }
+        uint32_t start = now;
+        now += work_us;
+        if (report) {
+            usb_sof_sync_report_ready(since_sof(), now - start);
+        }
+        usb_sof_sync_scan_end(now - start);
+        return start;
+    }
+
+    /* Average time from a key press to the SOF after the report it caused. */
+    uint32_t key_to_wire_latency(bool aligned, uint32_t work_us) {
+        uint32_t lcg = 12345, total = 0, presses = 0;
+
+        for (uint32_t press = now + 500; presses < 500; presses++) {
+            uint32_t start;
+            do {
+                start = scan(aligned, work_us + lcg % 50, false);
+                lcg   = lcg * 1103515245 + 12345;
+            } while (start < press);
+            uint32_t wire = (now / USB_SOF_FRAME_US + 1) * USB_SOF_FRAME_US;
+            total += wire - press;
+            press = now + 1000 + (lcg >> 16) % 3000;
+        }
+        return total / presses;
+    }
+
+    uint32_t now = 0;
+};
+
+TEST_F(UsbSofSync, OffsetConvergesOnScanTime) {
+    for (int i = 0; i < 200; i++) {
+        scan(true, 300);
+    }
+    usb_sof_stats_t stats = usb_sof_sync_get_stats();
+    EXPECT_NEAR(stats.work_us, 300, 5);
+    EXPECT_NEAR(stats.scan_offset_us, USB_SOF_FRAME_US - USB_SOF_GUARD_US - 300, 5);
+}
+
+TEST_F(UsbSofSync, AlignedReportsLandJustBeforeSof) {
+    for (int i = 0; i < 200; i++) {
+        scan(true, 300);
+    }
+    usb_sof_sync_clear_stats();
+    for (int i = 0; i < 100; i++) {
+        scan(true, 300);
+    }
+
+    usb_sof_stats_t stats = usb_sof_sync_get_stats();
+    EXPECT_EQ(stats.reports, 100);
+    EXPECT_EQ(stats.late_reports, 0);
+    EXPECT_NEAR(stats.ready_avg_us, USB_SOF_FRAME_US - USB_SOF_GUARD_US, 5);
+    EXPECT_NEAR(stats.wire_avg_us, USB_SOF_GUARD_US, 5);
+    EXPECT_LE(stats.ready_max_us, USB_SOF_FRAME_US - USB_SOF_GUARD_US);
+}
+
+TEST_F(UsbSofSync, ScansOncePerFrame) {
+    std::vector<uint16_t> frames;
+
+    for (int i = 0; i < 50; i++) {
+        scan(true, 100);
+        frames.push_back(frame());
+    }
+    for (size_t i = 1; i < frames.size(); i++) {
+        EXPECT_GT(frames[i], frames[i - 1]);
+    }
+}
+
+TEST_F(UsbSofSync, LateScanStartsImmediately) {
+    usb_sof_stats_t stats = usb_sof_sync_get_stats();
+
+    EXPECT_EQ(usb_sof_sync_scan_delay(7, stats.scan_offset_us + 10), 0);
+    // the next scan in the same frame waits for the offset in the next one
+    EXPECT_EQ(usb_sof_sync_scan_delay(7, stats.scan_offset_us + 20), USB_SOF_FRAME_US - 20);
+}
+
+TEST_F(UsbSofSync, SlowScanMovesStartEarlier) {
+    for (int i = 0; i < 200; i++) {
+        scan(true, 300);
+    }
+    uint16_t offset = usb_sof_sync_get_stats().scan_offset_us;
+
+    scan(true, 600);
+    EXPECT_LT(usb_sof_sync_get_stats().scan_offset_us, offset - 150);
+}
+
+TEST_F(UsbSofSync, AlignmentLowersKeyToWireLatency) {
+    uint32_t free_running = key_to_wire_latency(false, 700);
+    uint32_t aligned      = key_to_wire_latency(true, 700);
+
+    EXPECT_LT(aligned + 200, free_running);
+}
@@ -470,6 +470,7 @@ void process_action(keyrecord_t *record, action_t action) {
                     } else {
                         if (tap_count > 0) {
                             dprint("MODS_TAP: Tap: unregister_code\n");
+                            host_keyboard_flush();
                             if (action.layer_tap.code == KC_CAPS_LOCK) {
                                 wait_ms(TAP_HOLD_CAPS_DELAY);
                             } else {
@@ -666,6 +667,7 @@ void process_action(keyrecord_t *record, action_t action) {
                     } else {
                         if (tap_count > 0) {
                             dprint("KEYMAP_TAP_KEY: Tap: unregister_code\n");
+                            host_keyboard_flush();
                             if (action.layer_tap.code == KC_CAPS_LOCK) {
                                 wait_ms(TAP_HOLD_CAPS_DELAY);
                             } else {
@@ -743,6 +745,7 @@ void process_action(keyrecord_t *record, action_t action) {
                         if (event.pressed) {
                             register_code(action.swap.code);
                         } else {
+                            host_keyboard_flush();
                             wait_ms(TAP_CODE_DELAY);
                             unregister_code(action.swap.code);
                             *record = (keyrecord_t){}; // hack: reset tap mode
@@ -844,6 +847,7 @@ __attribute__((weak)) void register_code(uint8_t code) {
 #    endif
         add_key(KC_CAPS_LOCK);
         send_keyboard_report();
+        host_keyboard_flush();
         wait_ms(TAP_HOLD_CAPS_DELAY);
         del_key(KC_CAPS_LOCK);
         send_keyboard_report();
@@ -855,6 +859,7 @@ __attribute__((weak)) void register_code(uint8_t code) {
 #    endif
         add_key(KC_NUM_LOCK);
         send_keyboard_report();
+        host_keyboard_flush();
         wait_ms(100);
         del_key(KC_NUM_LOCK);
         send_keyboard_report();
@@ -866,6 +871,7 @@ __attribute__((weak)) void register_code(uint8_t code) {
 #    endif
         add_key(KC_SCROLL_LOCK);
         send_keyboard_report();
+        host_keyboard_flush();
         wait_ms(100);
         del_key(KC_SCROLL_LOCK);
         send_keyboard_report();
@@ -988,6 +994,7 @@ __attribute__((weak)) void unregister_code(uint8_t code) {
  */
 __attribute__((weak)) void tap_code_delay(uint8_t code, uint16_t delay) {
     register_code(code);
+    host_keyboard_flush();
     for (uint16_t i = delay; i > 0; i--) {
         wait_ms(1);
     }
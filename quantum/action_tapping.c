@@ -11,6 +11,7 @@
 #include "action_layer.h"
 #include "action_tapping.h"
 #include "keycode.h"
+#include "matrix.h"
 #include "timer.h"
 
 #ifndef NO_ACTION_TAPPING
@@ -62,13 +63,29 @@ __attribute__((weak)) bool get_hold_on_other_key_press(uint16_t keycode, keyreco
 #        include "process_auto_shift.h"
 #    endif
 
+_Static_assert(WAITING_BUFFER_SIZE >= 2 && WAITING_BUFFER_SIZE <= UINT8_MAX, "WAITING_BUFFER_SIZE must be between 2 and 255");
+
 static keyrecord_t tapping_key                         = {};
 static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
 static uint8_t     waiting_buffer_head                 = 0;
 static uint8_t     waiting_buffer_tail                 = 0;
 
+/* Matrix keys that have a press/release queued in waiting_buffer. Kept in step
+ * with enq/deq so lookups don't have to walk the buffer. A key only shows up
+ * more than once per state on very fast repeats; those are counted in
+ * waiting_buffer_dups and are the only case where deq rescans the buffer.
+ */
+static matrix_row_t waiting_buffer_pressed[MATRIX_ROWS]  = {};
+static matrix_row_t waiting_buffer_released[MATRIX_ROWS] = {};
+static uint8_t      waiting_buffer_pressed_count         = 0;
+static uint8_t      waiting_buffer_offmatrix_count       = 0;
+static uint8_t      waiting_buffer_dups                  = 0;
+
+static waiting_buffer_stats_t waiting_buffer_stats = {};
+
 static bool process_tapping(keyrecord_t *record);
 static bool waiting_buffer_enq(keyrecord_t record);
+static void waiting_buffer_deq(void);
 static void waiting_buffer_clear(void);
 static bool waiting_buffer_typed(keyevent_t event);
 static bool waiting_buffer_has_anykey_pressed(void);
@@ -91,6 +108,7 @@ void action_tapping_process(keyrecord_t record) {
         if (!waiting_buffer_enq(record)) {
             // clear all in case of overflow.
             debug("OVERFLOW: CLEAR ALL STATES\n");
+            if (waiting_buffer_stats.overflows < UINT16_MAX) waiting_buffer_stats.overflows++;
             clear_keyboard();
             waiting_buffer_clear();
             tapping_key = (keyrecord_t){};
@@ -101,13 +119,14 @@ void action_tapping_process(keyrecord_t record) {
     if (!IS_NOEVENT(record.event) && waiting_buffer_head != waiting_buffer_tail) {
         debug("---- action_exec: process waiting_buffer -----\n");
     }
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
+    while (waiting_buffer_tail != waiting_buffer_head) {
         if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
             debug("processed: waiting_buffer[");
             debug_dec(waiting_buffer_tail);
             debug("] = ");
             debug_record(waiting_buffer[waiting_buffer_tail]);
             debug("\n\n");
+            waiting_buffer_deq();
         } else {
             break;
         }
@@ -456,25 +475,89 @@ bool waiting_buffer_enq(keyrecord_t record) {
     waiting_buffer[waiting_buffer_head] = record;
     waiting_buffer_head                 = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
 
+    if (record.event.pressed) {
+        waiting_buffer_pressed_count++;
+    }
+    if (IS_KEYEVENT(record.event)) {
+        matrix_row_t *map = record.event.pressed ? waiting_buffer_pressed : waiting_buffer_released;
+        matrix_row_t  bit = (matrix_row_t)1 << record.event.key.col;
+        if (map[record.event.key.row] & bit) {
+            waiting_buffer_dups++;
+        }
+        map[record.event.key.row] |= bit;
+    } else {
+        waiting_buffer_offmatrix_count++;
+    }
+
+    uint8_t depth = (waiting_buffer_head + WAITING_BUFFER_SIZE - waiting_buffer_tail) % WAITING_BUFFER_SIZE;
+    if (depth > waiting_buffer_stats.max_depth) {
+        waiting_buffer_stats.max_depth = depth;
+    }
+
     debug("waiting_buffer_enq: ");
     debug_waiting_buffer();
     return true;
 }
 
+/** \brief Waiting buffer deq
+ *
+ * Drops the oldest record and updates the per-key lookup state to match.
+ */
+static void waiting_buffer_deq(void) {
+    keyevent_t event    = waiting_buffer[waiting_buffer_tail].event;
+    waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE;
+
+    if (event.pressed) {
+        waiting_buffer_pressed_count--;
+    }
+    if (!IS_KEYEVENT(event)) {
+        waiting_buffer_offmatrix_count--;
+        return;
+    }
+
+    if (waiting_buffer_dups) {
+        for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+            if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed == waiting_buffer[i].event.pressed) {
+                // another record of the same key and state is still queued
+                waiting_buffer_dups--;
+                return;
+            }
+        }
+    }
+
+    matrix_row_t *map = event.pressed ? waiting_buffer_pressed : waiting_buffer_released;
+    map[event.key.row] &= ~((matrix_row_t)1 << event.key.col);
+}
+
 /** \brief Waiting buffer clear
  *
  * FIXME: Needs docs
  */
 void waiting_buffer_clear(void) {
-    waiting_buffer_head = 0;
-    waiting_buffer_tail = 0;
+    waiting_buffer_head            = 0;
+    waiting_buffer_tail            = 0;
+    waiting_buffer_pressed_count   = 0;
+    waiting_buffer_offmatrix_count = 0;
+    waiting_buffer_dups            = 0;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        waiting_buffer_pressed[row]  = 0;
+        waiting_buffer_released[row] = 0;
+    }
 }
 
 /** \brief Waiting buffer typed
  *
- * FIXME: Needs docs
+ * Returns true if the buffer holds the opposite transition of the given event's key.
  */
 bool waiting_buffer_typed(keyevent_t event) {
+    if (IS_KEYEVENT(event)) {
+        matrix_row_t *map = event.pressed ? waiting_buffer_released : waiting_buffer_pressed;
+        return map[event.key.row] & ((matrix_row_t)1 << event.key.col);
+    }
+
+    if (!waiting_buffer_offmatrix_count) {
+        return false;
+    }
     for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
         if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed != waiting_buffer[i].event.pressed) {
             return true;
@@ -488,10 +571,7 @@ bool waiting_buffer_typed(keyevent_t event) {
  * FIXME: Needs docs
  */
 __attribute__((unused)) bool waiting_buffer_has_anykey_pressed(void) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (waiting_buffer[i].event.pressed) return true;
-    }
-    return false;
+    return waiting_buffer_pressed_count > 0;
 }
 
 /** \brief Scan buffer for tapping
@@ -503,6 +583,8 @@ void waiting_buffer_scan_tap(void) {
     if (tapping_key.tap.count > 0) return;
     // invalid state: tapping_key released && tap.count == 0
     if (!tapping_key.event.pressed) return;
+    // release of the tapping key isn't queued yet
+    if (IS_KEYEVENT(tapping_key.event) && !(waiting_buffer_released[tapping_key.event.key.row] & ((matrix_row_t)1 << tapping_key.event.key.col))) return;
 
     for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
         if (IS_TAPPING_KEY(waiting_buffer[i].event.key) && !waiting_buffer[i].event.pressed && WITHIN_TAPPING_TERM(waiting_buffer[i].event)) {
@@ -519,6 +601,18 @@ void waiting_buffer_scan_tap(void) {
     }
 }
 
+/** \brief Waiting buffer statistics
+ *
+ * Overflow count and high-water mark, for sizing WAITING_BUFFER_SIZE.
+ */
+waiting_buffer_stats_t get_waiting_buffer_stats(void) {
+    return waiting_buffer_stats;
+}
+
+void clear_waiting_buffer_stats(void) {
+    waiting_buffer_stats = (waiting_buffer_stats_t){};
+}
+
 /** \brief Tapping key debug print
  *
  * FIXME: Needs docs
@@ -27,12 +27,22 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define TAPPING_TOGGLE 5
 #endif
 
-#define WAITING_BUFFER_SIZE 8
+/* number of key records held back while a tap/hold decision is pending */
+#ifndef WAITING_BUFFER_SIZE
+#    define WAITING_BUFFER_SIZE 8
+#endif
 
 #ifndef NO_ACTION_TAPPING
-uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache);
-uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache);
-void     action_tapping_process(keyrecord_t record);
+typedef struct {
+    uint16_t overflows; // times the buffer filled up and all tapping state was cleared
+    uint8_t  max_depth; // highest number of records queued at once
+} waiting_buffer_stats_t;
+
+uint16_t               get_record_keycode(keyrecord_t *record, bool update_layer_cache);
+uint16_t               get_event_keycode(keyevent_t event, bool update_layer_cache);
+void                   action_tapping_process(keyrecord_t record);
+waiting_buffer_stats_t get_waiting_buffer_stats(void);
+void                   clear_waiting_buffer_stats(void);
 #endif
 
 uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record);
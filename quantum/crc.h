@@ -16,7 +16,8 @@
 
 #pragma once
 
-#include "quantum.h"
+#include <stdint.h>
+#include <stddef.h>
 
 /**
  * The type of the CRC values.
@@ -31,8 +32,11 @@ typedef uint_least8_t crc_t;
 
 /**
  * Initialize crc subsystem.
+ *
+ * A hardware backend, picked with CRC_DRIVER in rules.mk, enables its CRC
+ * unit here and replaces the software crc16_update() and crc32_update().
  */
-__attribute__((weak)) void crc_init(void);
+void crc_init(void);
 
 /**
  * Generate CRC8 value from given data.
@@ -41,4 +45,59 @@ __attribute__((weak)) void crc_init(void);
  * \param[in] data_len Number of bytes in the \a data buffer.
  * \return             The calculated crc value.
  */
-__attribute__((weak)) uint8_t crc8(const void *data, size_t data_len);
\ No newline at end of file
+uint8_t crc8(const void *data, size_t data_len);
+
+/**
+ * Update a CRC-16/CCITT (polynomial 0x1021, MSB first) with given data.
+ *
+ * Define CRC16_USE_TABLE for a slicing-by-4 implementation, which trades
+ * 2 KiB of flash for a several times higher throughput.
+ *
+ * \param[in] crc      Running crc value, start with \ref CRC16_INIT.
+ * \param[in] data     Pointer to a buffer of \a data_len bytes.
+ * \param[in] data_len Number of bytes in the \a data buffer.
+ * \return             The updated crc value.
+ */
+uint16_t crc16_update(uint16_t crc, const void *data, size_t data_len);
+
+/**
+ * Initial value of a CRC-16/CCITT.
+ */
+#define CRC16_INIT 0xFFFF
+
+/**
+ * Generate CRC-16/CCITT value from given data.
+ *
+ * \param[in] data     Pointer to a buffer of \a data_len bytes.
+ * \param[in] data_len Number of bytes in the \a data buffer.
+ * \return             The calculated crc value.
+ */
+uint16_t crc16(const void *data, size_t data_len);
+
+/**
+ * Update a CRC-32 (polynomial 0x04C11DB7, reflected, as used by zlib and
+ * Ethernet) with given data. The value is not inverted, see \ref crc32.
+ *
+ * Define CRC32_USE_TABLE for a slicing-by-4 implementation, which trades
+ * 4 KiB of flash for a several times higher throughput.
+ *
+ * \param[in] crc      Running crc value, start with \ref CRC32_INIT.
+ * \param[in] data     Pointer to a buffer of \a data_len bytes.
+ * \param[in] data_len Number of bytes in the \a data buffer.
+ * \return             The updated crc value.
+ */
+uint32_t crc32_update(uint32_t crc, const void *data, size_t data_len);
+
+/**
+ * Initial value of a CRC-32.
+ */
+#define CRC32_INIT 0xFFFFFFFF
+
+/**
+ * Generate CRC-32 value from given data.
+ *
+ * \param[in] data     Pointer to a buffer of \a data_len bytes.
+ * \param[in] data_len Number of bytes in the \a data buffer.
+ * \return             The calculated crc value, inverted as the standard asks.
+ */
+uint32_t crc32(const void *data, size_t data_len);
@@ -0,0 +1,113 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <vector>
+
+extern "C" {
+#include "crc.h"
+}
+
+static const uint8_t check[] = "123456789";
+
+// Bit at a time references, independent of the implementation under test
+static uint16_t reference_crc16(const uint8_t *data, size_t length) {
+    uint16_t crc = CRC16_INIT;
+    for (size_t i = 0; i < length * 8; i++) {
+        bool bit = ((crc >> 15) ^ (data[i / 8] >> (7 - i % 8))) & 1;
+        crc      = (uint16_t)(crc << 1) ^ (bit ? 0x1021 : 0);
+    }
+    return crc;
+}
+
+static uint32_t reference_crc32(const uint8_t *data, size_t length) {
+    uint32_t crc = CRC32_INIT;
+    for (size_t i = 0; i < length * 8; i++) {
+        bool bit = (crc ^ (data[i / 8] >> (i % 8))) & 1;
+        crc      = (crc >> 1) ^ (bit ? 0xEDB88320 : 0);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+static std::vector<uint8_t> random_data(size_t length) {
+    std::vector<uint8_t> data(length);
+    uint32_t             random = 7;
+    for (auto &byte : data) {
+        random = random * 1103515245 + 12345;
+        byte   = random >> 16;
+    }
+    return data;
+}
+
+TEST(Crc, CheckValues) {
+    EXPECT_EQ(crc16(check, 9), 0x29B1);
+    EXPECT_EQ(crc32(check, 9), 0xCBF43926);
+    EXPECT_EQ(crc16(check, 0), CRC16_INIT);
+    EXPECT_EQ(crc32(check, 0), 0u);
+}
+
+TEST(Crc, MatchesReferenceAtAnyLengthAndAlignment) {
+    auto data = random_data(80);
+    for (size_t offset = 0; offset < 4; offset++) {
+        for (size_t length = 0; length + offset <= data.size(); length++) {
+            EXPECT_EQ(crc16(&data[offset], length), reference_crc16(&data[offset], length)) << "offset " << offset << " length " << length;
+            EXPECT_EQ(crc32(&data[offset], length), reference_crc32(&data[offset], length)) << "offset " << offset << " length " << length;
+        }
+    }
+}
+
+TEST(Crc, UpdateInPieces) {
+    auto data = random_data(64);
+    for (size_t split = 0; split <= data.size(); split++) {
+        uint16_t crc16_value = crc16_update(crc16_update(CRC16_INIT, data.data(), split), &data[split], data.size() - split);
+        uint32_t crc32_value = crc32_update(crc32_update(CRC32_INIT, data.data(), split), &data[split], data.size() - split);
+        EXPECT_EQ(crc16_value, crc16(data.data(), data.size())) << "split " << split;
+        EXPECT_EQ(crc32_value ^ 0xFFFFFFFF, crc32(data.data(), data.size())) << "split " << split;
+    }
+}
+
+TEST(Crc, Crc8DetectsSingleBitErrors) {
+    auto    data = random_data(32);
+    uint8_t crc  = crc8(data.data(), data.size());
+    for (size_t bit = 0; bit < data.size() * 8; bit++) {
+        data[bit / 8] ^= 1 << (bit % 8);
+        EXPECT_NE(crc8(data.data(), data.size()), crc) << "bit " << bit;
+        data[bit / 8] ^= 1 << (bit % 8);
+    }
+}
+
+/* Host throughput of each algorithm over split frame sized pieces, for
+ * comparing the bitwise and table implementations. Only reported. */
+TEST(Crc, Throughput) {
+    const size_t      frame = 64;
+    const size_t      total = 1 << 20;
+    auto              data  = random_data(frame);
+    volatile uint32_t sink  = 0;
+
+    auto measure = [&](const char *name, auto &&checksum) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t done = 0; done < total; done += frame) {
+            sink = sink + checksum();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        printf("%s: %.1f MB/s\n", name, total / elapsed.count() / 1e6);
+    };
+
+    measure("crc8", [&] { return crc8(data.data(), frame); });
+    measure("crc16", [&] { return crc16(data.data(), frame); });
+    measure("crc32", [&] { return crc32(data.data(), frame); });
+}
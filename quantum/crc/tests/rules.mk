@@ -0,0 +1,8 @@
+crc_DEFS := -DNO_DEBUG
+crc_table_DEFS := -DNO_DEBUG -DCRC8_USE_TABLE -DCRC16_USE_TABLE -DCRC32_USE_TABLE
+
+crc_SRC := \
+	$(QUANTUM_PATH)/crc/tests/crc_tests.cpp \
+	$(QUANTUM_PATH)/crc.c
+
+crc_table_SRC := $(crc_SRC)
@@ -221,34 +221,46 @@ void encoder_state_raw(uint8_t *slave_state) {
     memcpy(slave_state, &encoder_value[thisHand], sizeof(uint8_t) * thisCount);
 }
 
-void encoder_update_raw(uint8_t *slave_state) {
+static bool encoder_apply_steps(uint8_t index, int8_t delta) {
     bool changed = false;
-    for (uint8_t i = 0; i < thatCount; i++) { // Note inverted logic -- we want the opposite side
-        const uint8_t index = i + thatHand;
-        int8_t        delta = slave_state[i] - encoder_value[index];
-        while (delta > 0) {
-            delta--;
-            encoder_value[index]++;
-            changed = true;
+    while (delta > 0) {
+        delta--;
+        encoder_value[index]++;
+        changed = true;
 #    ifdef ENCODER_MAP_ENABLE
-            encoder_exec_mapping(index, ENCODER_COUNTER_CLOCKWISE);
+        encoder_exec_mapping(index, ENCODER_COUNTER_CLOCKWISE);
 #    else  // ENCODER_MAP_ENABLE
-            encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
+        encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
 #    endif // ENCODER_MAP_ENABLE
-        }
-        while (delta < 0) {
-            delta++;
-            encoder_value[index]--;
-            changed = true;
+    }
+    while (delta < 0) {
+        delta++;
+        encoder_value[index]--;
+        changed = true;
 #    ifdef ENCODER_MAP_ENABLE
-            encoder_exec_mapping(index, ENCODER_CLOCKWISE);
+        encoder_exec_mapping(index, ENCODER_CLOCKWISE);
 #    else  // ENCODER_MAP_ENABLE
-            encoder_update_kb(index, ENCODER_CLOCKWISE);
+        encoder_update_kb(index, ENCODER_CLOCKWISE);
 #    endif // ENCODER_MAP_ENABLE
-        }
+    }
+    return changed;
+}
+
+void encoder_update_raw(uint8_t *slave_state) {
+    bool changed = false;
+    for (uint8_t i = 0; i < thatCount; i++) { // Note inverted logic -- we want the opposite side
+        const uint8_t index = i + thatHand;
+        int8_t        delta = slave_state[i] - encoder_value[index];
+        changed |= encoder_apply_steps(index, delta);
     }
 
     // Update the last encoder input time -- handled external to encoder_read() when we're running a split
     if (changed) last_encoder_activity_trigger();
 }
+
+void encoder_steps_raw(uint8_t index, int8_t steps) {
+    if (index < thatCount && encoder_apply_steps(index + thatHand, steps)) {
+        last_encoder_activity_trigger();
+    }
+}
 #endif
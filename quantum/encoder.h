@@ -30,6 +30,8 @@ bool encoder_update_user(uint8_t index, bool clockwise);
 
 void encoder_state_raw(uint8_t* slave_state);
 void encoder_update_raw(uint8_t* slave_state);
+// Applies `steps` of encoder `index` on the other half, a signed change of its counter
+void encoder_steps_raw(uint8_t index, int8_t steps);
 
 #    if defined(ENCODERS_PAD_A_RIGHT)
 #        define NUM_ENCODERS_LEFT (sizeof(((pin_t[])ENCODERS_PAD_A)) / sizeof(pin_t))
@@ -83,6 +83,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #endif
 #ifdef VIA_ENABLE
 #    include "via.h"
+#    include "via_matrix_stream.h"
 #endif
 #ifdef DIP_SWITCH_ENABLE
 #    include "dip_switch.h"
@@ -170,14 +171,17 @@ uint32_t get_matrix_scan_rate(void) {
 #endif
 
 #ifdef MATRIX_HAS_GHOST
-extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
-static matrix_row_t   get_real_keys(uint8_t row, matrix_row_t rowdata) {
+static matrix_row_t ghost_raw_rows[MATRIX_ROWS];  // raw row state real_keys was last computed from
+static matrix_row_t ghost_real_keys[MATRIX_ROWS]; // pressed keys that exist in the keymap
+static uint8_t      ghost_multi_key_rows;         // rows with two or more real keys down
+
+static matrix_row_t get_real_keys(uint8_t row, matrix_row_t rowdata) {
     matrix_row_t out = 0;
-    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+    for (uint8_t col = 0; rowdata && col < MATRIX_COLS; col++, rowdata >>= 1) {
         // read each key in the row data and check if the keymap defines it as a real key
-        if (pgm_read_byte(&keymaps[0][row][col]) && (rowdata & (1 << col))) {
+        if ((rowdata & 1) && keymap_key_to_keycode(0, (keypos_t){.row = row, .col = col}) != KC_NO) {
             // this creates new row data, if a key is defined in the keymap, it will be set here
-            out |= 1 << col;
+            out |= (matrix_row_t)1 << col;
         }
     }
     return out;
@@ -188,13 +192,40 @@ static inline bool popcount_more_than_one(matrix_row_t rowdata) {
     return rowdata;
 }
 
+/** \brief Refresh the real key masks of rows that changed since the last call
+ *
+ * Only rows whose raw state moved are looked up in the keymap again.
+ */
+static void update_ghost_real_keys(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        const matrix_row_t current_row = matrix_get_row(row);
+        if (current_row == ghost_raw_rows[row]) {
+            continue;
+        }
+        ghost_raw_rows[row] = current_row;
+
+        const matrix_row_t real_keys = get_real_keys(row, current_row);
+        ghost_multi_key_rows -= popcount_more_than_one(ghost_real_keys[row]);
+        ghost_multi_key_rows += popcount_more_than_one(real_keys);
+        ghost_real_keys[row] = real_keys;
+    }
+}
+
 static inline bool has_ghost_in_row(uint8_t row, matrix_row_t rowdata) {
     /* No ghost exists when less than 2 keys are down on the row.
     If there are "active" blanks in the matrix, the key can't be pressed by the user,
     there is no doubt as to which keys are really being pressed.
-    The ghosts will be ignored, they are KC_NO.   */
-    rowdata = get_real_keys(row, rowdata);
-    if ((popcount_more_than_one(rowdata)) == 0) {
+    The ghosts will be ignored, they are KC_NO.
+    Real keys are a subset of the raw row, so check the raw row first.   */
+    if (!popcount_more_than_one(rowdata)) {
+        return false;
+    }
+    /* A ghost needs a second row with at least two real keys of its own. */
+    if (ghost_multi_key_rows < 2) {
+        return false;
+    }
+    const matrix_row_t real_keys = ghost_real_keys[row];
+    if (!popcount_more_than_one(real_keys)) {
         return false;
     }
     /* Ghost occurs when the row shares a column line with other row,
@@ -205,7 +236,7 @@ static inline bool has_ghost_in_row(uint8_t row, matrix_row_t rowdata) {
     we are checking one row at a time, not all of them at once.
     */
     for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
-        if (i != row && popcount_more_than_one(get_real_keys(i, matrix_get_row(i)) & rowdata)) {
+        if (i != row && popcount_more_than_one(ghost_real_keys[i] & real_keys)) {
             return true;
         }
     }
@@ -214,6 +245,8 @@ static inline bool has_ghost_in_row(uint8_t row, matrix_row_t rowdata) {
 
 #else
 
+#    define update_ghost_real_keys()
+
 static inline bool has_ghost_in_row(uint8_t row, matrix_row_t rowdata) {
     return false;
 }
@@ -430,6 +463,9 @@ void switch_events(uint8_t row, uint8_t col, bool pressed) {
 #if defined(RGB_MATRIX_ENABLE)
     process_rgb_matrix(row, col, pressed);
 #endif
+#if defined(VIA_ENABLE)
+    via_matrix_stream_event(row, col, pressed);
+#endif
 }
 
 /**
@@ -476,6 +512,8 @@ static bool matrix_task(void) {
 
     const bool process_keypress = should_process_keypress();
 
+    update_ghost_real_keys();
+
     for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
         const matrix_row_t current_row = matrix_get_row(row);
         const matrix_row_t row_changes = current_row ^ matrix_previous[row];
@@ -670,5 +708,8 @@ void keyboard_task(void) {
     programmable_button_send();
 #endif
 
+    // keyboard reports are coalesced at most within one scan
+    host_keyboard_flush();
+
     led_task();
 }
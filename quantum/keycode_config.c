@@ -18,12 +18,77 @@
 
 extern keymap_config_t keymap_config;
 
+// Every keycode compute_keycode_config() can rewrite. All of them, and their
+// replacements, are basic keycodes.
+static const uint8_t remappable_keycodes[] = {KC_CAPS_LOCK, KC_LOCKING_CAPS_LOCK, KC_LEFT_CTRL, KC_LEFT_ALT, KC_LEFT_GUI, KC_RIGHT_CTRL, KC_RIGHT_ALT, KC_RIGHT_GUI, KC_GRAVE, KC_ESCAPE, KC_BACKSLASH, KC_BACKSPACE};
+
+#define NUM_REMAPPABLE_KEYCODES (sizeof(remappable_keycodes) / sizeof(remappable_keycodes[0]))
+
+// Lookup tables for the keymap_config they were last built from
+static uint16_t remap_config_raw;
+static bool     remap_valid = false;
+static uint8_t  remapped_keycodes[NUM_REMAPPABLE_KEYCODES];
+static uint8_t  remapped_mask[256 / 8]; // basic keycodes changed by the current config
+static uint8_t  remapped_mods[32];
+
+static uint16_t compute_keycode_config(uint16_t keycode);
+static uint8_t  compute_mod_config(uint8_t mod);
+
+static void update_remap_tables(void) {
+    if (remap_valid && remap_config_raw == keymap_config.raw) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < sizeof(remapped_mask); i++) {
+        remapped_mask[i] = 0;
+    }
+    for (uint8_t i = 0; i < NUM_REMAPPABLE_KEYCODES; i++) {
+        uint8_t keycode      = remappable_keycodes[i];
+        remapped_keycodes[i] = compute_keycode_config(keycode);
+        if (remapped_keycodes[i] != keycode) {
+            remapped_mask[keycode / 8] |= 1 << (keycode % 8);
+        }
+    }
+    for (uint8_t mod = 0; mod < sizeof(remapped_mods); mod++) {
+        remapped_mods[mod] = compute_mod_config(mod);
+    }
+
+    remap_config_raw = keymap_config.raw;
+    remap_valid      = true;
+}
+
 /** \brief keycode_config
  *
  * This function is used to check a specific keycode against the bootmagic config,
  * and will return the corrected keycode, when appropriate.
  */
 uint16_t keycode_config(uint16_t keycode) {
+    update_remap_tables();
+
+    if (keycode > 0xFF || !(remapped_mask[keycode / 8] & (1 << (keycode % 8)))) {
+        return keycode;
+    }
+    for (uint8_t i = 0; i < NUM_REMAPPABLE_KEYCODES; i++) {
+        if (remappable_keycodes[i] == keycode) {
+            return remapped_keycodes[i];
+        }
+    }
+    return keycode;
+}
+
+/** \brief mod_config
+ *
+ *  This function checks the mods passed to it against the bootmagic config,
+ *  and will remove or replace mods, based on that.
+ */
+uint8_t mod_config(uint8_t mod) {
+    update_remap_tables();
+
+    // only the five bits of the MOD_* encoding are ever touched
+    return remapped_mods[mod & 0x1F] | (mod & ~0x1F);
+}
+
+static uint16_t compute_keycode_config(uint16_t keycode) {
     switch (keycode) {
         case KC_CAPS_LOCK:
         case KC_LOCKING_CAPS_LOCK:
@@ -117,13 +182,7 @@ uint16_t keycode_config(uint16_t keycode) {
     }
 }
 
-/** \brief mod_config
- *
- *  This function checks the mods passed to it against the bootmagic config,
- *  and will remove or replace mods, based on that.
- */
-
-uint8_t mod_config(uint8_t mod) {
+static uint8_t compute_mod_config(uint8_t mod) {
     if (keymap_config.swap_lalt_lgui) {
         if ((mod & MOD_RGUI) == MOD_LGUI) {
             mod &= ~MOD_LGUI;
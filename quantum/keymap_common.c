@@ -42,6 +42,102 @@ action_t action_for_key(uint8_t layer, keypos_t key) {
     return action_for_keycode(keycode);
 };
 
+// Decoders for each keycode range handled by action_for_keycode()
+enum keycode_decoder {
+    DECODE_NO = 0,
+    DECODE_BASIC_PAGE,
+    DECODE_KEY,
+    DECODE_TRANSPARENT,
+#ifdef EXTRAKEY_ENABLE
+    DECODE_SYSTEM,
+    DECODE_CONSUMER,
+#endif
+#ifdef MOUSEKEY_ENABLE
+    DECODE_MOUSEKEY,
+#endif
+    DECODE_MODS,
+#ifndef NO_ACTION_LAYER
+    DECODE_LAYER_TAP,
+    DECODE_TO,
+    DECODE_MOMENTARY,
+    DECODE_DEF_LAYER,
+    DECODE_TOGGLE_LAYER,
+    DECODE_LAYER_TAP_TOGGLE,
+    DECODE_LAYER_MOD,
+#endif
+#ifndef NO_ACTION_ONESHOT
+    DECODE_ONE_SHOT_LAYER,
+    DECODE_ONE_SHOT_MOD,
+#endif
+#ifndef NO_ACTION_TAPPING
+    DECODE_MOD_TAP,
+#endif
+#ifdef SWAP_HANDS_ENABLE
+    DECODE_SWAP_HANDS,
+#endif
+};
+
+// Every range above the basic page is aligned to 0x100, so the high byte picks
+// the decoder directly. Keycodes from 0x8000 up never have an action.
+// clang-format off
+static const uint8_t keycode_page_decoders[0x80] PROGMEM = {
+    [QK_BASIC >> 8]                                            = DECODE_BASIC_PAGE,
+    [QK_MODS >> 8 ... QK_MODS_MAX >> 8]                        = DECODE_MODS,
+#ifndef NO_ACTION_LAYER
+    [QK_LAYER_TAP >> 8 ... QK_LAYER_TAP_MAX >> 8]              = DECODE_LAYER_TAP,
+    [QK_TO >> 8]                                               = DECODE_TO,
+    [QK_MOMENTARY >> 8]                                        = DECODE_MOMENTARY,
+    [QK_DEF_LAYER >> 8]                                        = DECODE_DEF_LAYER,
+    [QK_TOGGLE_LAYER >> 8]                                     = DECODE_TOGGLE_LAYER,
+    [QK_LAYER_TAP_TOGGLE >> 8]                                 = DECODE_LAYER_TAP_TOGGLE,
+    [QK_LAYER_MOD >> 8]                                        = DECODE_LAYER_MOD,
+#endif
+#ifndef NO_ACTION_ONESHOT
+    [QK_ONE_SHOT_LAYER >> 8]                                   = DECODE_ONE_SHOT_LAYER,
+    [QK_ONE_SHOT_MOD >> 8]                                     = DECODE_ONE_SHOT_MOD,
+#endif
+#ifndef NO_ACTION_TAPPING
+    [QK_MOD_TAP >> 8 ... QK_MOD_TAP_MAX >> 8]                  = DECODE_MOD_TAP,
+#endif
+#ifdef SWAP_HANDS_ENABLE
+    [QK_SWAP_HANDS >> 8]                                       = DECODE_SWAP_HANDS,
+#endif
+};
+
+// Ranges within the basic page, sorted by first keycode. Gaps have no action.
+static const uint8_t basic_page_ranges[][3] PROGMEM = {
+    {KC_TRANSPARENT,  KC_TRANSPARENT,     DECODE_TRANSPARENT},
+    {KC_A,            KC_EXSEL,           DECODE_KEY},
+#ifdef EXTRAKEY_ENABLE
+    {KC_SYSTEM_POWER, KC_SYSTEM_WAKE,     DECODE_SYSTEM},
+    {KC_AUDIO_MUTE,   KC_BRIGHTNESS_DOWN, DECODE_CONSUMER},
+#endif
+    {KC_LEFT_CTRL,    KC_RIGHT_GUI,       DECODE_KEY},
+#ifdef MOUSEKEY_ENABLE
+    {KC_MS_UP,        KC_MS_ACCEL2,       DECODE_MOUSEKEY},
+#endif
+};
+// clang-format on
+
+#define NUM_BASIC_PAGE_RANGES (sizeof(basic_page_ranges) / sizeof(basic_page_ranges[0]))
+
+static uint8_t basic_page_decoder(uint8_t keycode) {
+    // find the last range starting at or before keycode
+    uint8_t lo = 0, hi = NUM_BASIC_PAGE_RANGES;
+    while (lo < hi) {
+        uint8_t mid = (lo + hi) / 2;
+        if (pgm_read_byte(&basic_page_ranges[mid][0]) <= keycode) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0 || keycode > pgm_read_byte(&basic_page_ranges[lo - 1][1])) {
+        return DECODE_NO;
+    }
+    return pgm_read_byte(&basic_page_ranges[lo - 1][2]);
+}
+
 action_t action_for_keycode(uint16_t keycode) {
     // keycode remapping
     keycode = keycode_config(keycode);
@@ -53,88 +149,95 @@ action_t action_for_keycode(uint16_t keycode) {
     (void)when;
     (void)mod;
 
-    switch (keycode) {
-        case KC_A ... KC_EXSEL:
-        case KC_LEFT_CTRL ... KC_RIGHT_GUI:
+    uint8_t decoder = DECODE_NO;
+    if (keycode < 0x8000) {
+        decoder = pgm_read_byte(&keycode_page_decoders[keycode >> 8]);
+        if (decoder == DECODE_BASIC_PAGE) {
+            decoder = basic_page_decoder(keycode);
+        }
+    }
+
+    switch (decoder) {
+        case DECODE_KEY:
             action.code = ACTION_KEY(keycode);
             break;
 #ifdef EXTRAKEY_ENABLE
-        case KC_SYSTEM_POWER ... KC_SYSTEM_WAKE:
+        case DECODE_SYSTEM:
             action.code = ACTION_USAGE_SYSTEM(KEYCODE2SYSTEM(keycode));
             break;
-        case KC_AUDIO_MUTE ... KC_BRIGHTNESS_DOWN:
+        case DECODE_CONSUMER:
             action.code = ACTION_USAGE_CONSUMER(KEYCODE2CONSUMER(keycode));
             break;
 #endif
 #ifdef MOUSEKEY_ENABLE
-        case KC_MS_UP ... KC_MS_ACCEL2:
+        case DECODE_MOUSEKEY:
             action.code = ACTION_MOUSEKEY(keycode);
             break;
 #endif
-        case KC_TRANSPARENT:
+        case DECODE_TRANSPARENT:
             action.code = ACTION_TRANSPARENT;
             break;
-        case QK_MODS ... QK_MODS_MAX:;
+        case DECODE_MODS:
             // Has a modifier
             // Split it up
             action.code = ACTION_MODS_KEY(keycode >> 8, keycode & 0xFF); // adds modifier to key
             break;
 #ifndef NO_ACTION_LAYER
-        case QK_LAYER_TAP ... QK_LAYER_TAP_MAX:
+        case DECODE_LAYER_TAP:
             action.code = ACTION_LAYER_TAP_KEY((keycode >> 0x8) & 0xF, keycode & 0xFF);
             break;
-        case QK_TO ... QK_TO_MAX:;
+        case DECODE_TO:
             // Layer set "GOTO"
             when         = (keycode >> 0x4) & 0x3;
             action_layer = keycode & 0xF;
             action.code  = ACTION_LAYER_SET(action_layer, when);
             break;
-        case QK_MOMENTARY ... QK_MOMENTARY_MAX:;
+        case DECODE_MOMENTARY:
             // Momentary action_layer
             action_layer = keycode & 0xFF;
             action.code  = ACTION_LAYER_MOMENTARY(action_layer);
             break;
-        case QK_DEF_LAYER ... QK_DEF_LAYER_MAX:;
+        case DECODE_DEF_LAYER:
             // Set default action_layer
             action_layer = keycode & 0xFF;
             action.code  = ACTION_DEFAULT_LAYER_SET(action_layer);
             break;
-        case QK_TOGGLE_LAYER ... QK_TOGGLE_LAYER_MAX:;
+        case DECODE_TOGGLE_LAYER:
             // Set toggle
             action_layer = keycode & 0xFF;
             action.code  = ACTION_LAYER_TOGGLE(action_layer);
             break;
 #endif
 #ifndef NO_ACTION_ONESHOT
-        case QK_ONE_SHOT_LAYER ... QK_ONE_SHOT_LAYER_MAX:;
+        case DECODE_ONE_SHOT_LAYER:
             // OSL(action_layer) - One-shot action_layer
             action_layer = keycode & 0xFF;
             action.code  = ACTION_LAYER_ONESHOT(action_layer);
             break;
-        case QK_ONE_SHOT_MOD ... QK_ONE_SHOT_MOD_MAX:;
+        case DECODE_ONE_SHOT_MOD:
             // OSM(mod) - One-shot mod
             mod         = mod_config(keycode & 0xFF);
             action.code = ACTION_MODS_ONESHOT(mod);
             break;
 #endif
 #ifndef NO_ACTION_LAYER
-        case QK_LAYER_TAP_TOGGLE ... QK_LAYER_TAP_TOGGLE_MAX:
+        case DECODE_LAYER_TAP_TOGGLE:
             action.code = ACTION_LAYER_TAP_TOGGLE(keycode & 0xFF);
             break;
-        case QK_LAYER_MOD ... QK_LAYER_MOD_MAX:
+        case DECODE_LAYER_MOD:
             mod          = mod_config(keycode & 0xF);
             action_layer = (keycode >> 4) & 0xF;
             action.code  = ACTION_LAYER_MODS(action_layer, mod);
             break;
 #endif
 #ifndef NO_ACTION_TAPPING
-        case QK_MOD_TAP ... QK_MOD_TAP_MAX:
+        case DECODE_MOD_TAP:
             mod         = mod_config((keycode >> 0x8) & 0x1F);
             action.code = ACTION_MODS_TAP_KEY(mod, keycode & 0xFF);
             break;
 #endif
 #ifdef SWAP_HANDS_ENABLE
-        case QK_SWAP_HANDS ... QK_SWAP_HANDS_MAX:
+        case DECODE_SWAP_HANDS:
             action.code = ACTION(ACT_SWAP_HANDS, keycode & 0xff);
             break;
 #endif
@@ -84,6 +84,15 @@ void print_set_sendchar(sendchar_func_t func);
 #    define print(s)
 #    define println(s)
 #    define xprintf(fmt, ...)
+#elif defined(TOKENIZED_LOGGING_ENABLE) && !defined(NO_PRINT) && !defined(__cplusplus)
+// Replace normal print defines with tokenized records, uprintf stays formatted
+#    include "tokenized_log.h"
+#    undef print
+#    undef println
+#    undef xprintf
+#    define print(s) tokenized_log(s)
+#    define println(s) tokenized_log(s "\r\n")
+#    define xprintf(fmt, ...) tokenized_log(fmt, ##__VA_ARGS__)
 #endif
 
 #define print_dec(i) xprintf("%u", i)
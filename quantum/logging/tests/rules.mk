@@ -0,0 +1,7 @@
+tokenized_log_DEFS := -DTOKENIZED_LOG_BUFFER_SIZE=64
+
+tokenized_log_SRC := \
+	$(QUANTUM_PATH)/logging/tests/tokenized_log_tests.cpp \
+	$(QUANTUM_PATH)/logging/tests/tokenized_log_calls.c \
+	$(QUANTUM_PATH)/logging/tokenized_log.c \
+	$(QUANTUM_PATH)/logging/sendchar.c
@@ -0,0 +1,43 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tokenized_log.h"
+
+// The logging macros are C only, the tests call them through these
+
+uint16_t token_hello(void) {
+    return TOKENIZED_LOG_TOKEN("hello\n");
+}
+
+uint16_t token_long(void) {
+    return TOKENIZED_LOG_TOKEN("xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
+}
+
+void log_hello(void) {
+    tokenized_log("hello\n");
+}
+
+void log_numbers(int a, uint8_t b, uint32_t c) {
+    tokenized_log("%d %u %lX\n", a, b, c);
+}
+
+void log_string(const char *s, int n) {
+    tokenized_log("%s=%d\n", s, n);
+}
+
+void log_pointer(void *p) {
+    tokenized_log("%p\n", p);
+}
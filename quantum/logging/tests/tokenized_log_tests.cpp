@@ -0,0 +1,164 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "tokenized_log.h"
+
+uint16_t token_hello(void);
+uint16_t token_long(void);
+void     log_hello(void);
+void     log_numbers(int a, uint8_t b, uint32_t c);
+void     log_string(const char *s, int n);
+void     log_pointer(void *p);
+}
+
+using Bytes = std::vector<uint8_t>;
+
+// Tokens computed by lib/python/qmk/tokenized_log.py
+static const uint16_t TOKEN_HELLO   = 0xA279;
+static const uint16_t TOKEN_NUMBERS = 0x8170;
+static const uint16_t TOKEN_STRING  = 0xE170;
+static const uint16_t TOKEN_POINTER = 0xF18B;
+static const uint16_t TOKEN_LONG    = 0x18BA;
+
+static Bytes    sent;
+static uint16_t send_limit;
+
+extern "C" uint16_t tokenized_log_send(const uint8_t *data, uint16_t length) {
+    if (length > send_limit) {
+        length = send_limit;
+    }
+    sent.insert(sent.end(), data, data + length);
+    send_limit -= length;
+    return length;
+}
+
+static Bytes drain(uint16_t limit = UINT16_MAX) {
+    sent.clear();
+    send_limit = limit;
+    tokenized_log_task();
+    return sent;
+}
+
+class TokenizedLog : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        drain();
+        tokenized_log_clear_stats();
+    }
+};
+
+TEST_F(TokenizedLog, TokensMatchHostHash) {
+    EXPECT_EQ(token_hello(), TOKEN_HELLO);
+    EXPECT_EQ(token_long(), TOKEN_LONG);
+}
+
+TEST_F(TokenizedLog, RecordWithoutArguments) {
+    log_hello();
+    EXPECT_EQ(drain(), (Bytes{0xFF, 0x02, TOKEN_HELLO & 0xFF, TOKEN_HELLO >> 8}));
+}
+
+TEST_F(TokenizedLog, IntegersAreVarintsOfValuePlusOne) {
+    log_numbers(-1, 0, 300);
+    EXPECT_EQ(drain(), (Bytes{0xFF, 0x0A, TOKEN_NUMBERS & 0xFF, TOKEN_NUMBERS >> 8, 0x80, 0x80, 0x80, 0x80, 0x10, 0x01, 0xAD, 0x02}));
+}
+
+TEST_F(TokenizedLog, StringsAreLengthPrefixed) {
+    log_string("abc", 1);
+    EXPECT_EQ(drain(), (Bytes{0xFF, 0x07, TOKEN_STRING & 0xFF, TOKEN_STRING >> 8, 0x04, 'a', 'b', 'c', 0x02}));
+}
+
+TEST_F(TokenizedLog, LongStringsAreTruncated) {
+    std::string long_string(TOKENIZED_LOG_MAX_STRING_LENGTH + 10, 'z');
+    log_string(long_string.c_str(), 0);
+    Bytes record = drain();
+    ASSERT_EQ(record.size(), 2 + 2 + 1 + TOKENIZED_LOG_MAX_STRING_LENGTH + 1);
+    EXPECT_EQ(record[1], 2 + 1 + TOKENIZED_LOG_MAX_STRING_LENGTH + 1);
+    EXPECT_EQ(record[4], TOKENIZED_LOG_MAX_STRING_LENGTH + 1);
+}
+
+TEST_F(TokenizedLog, NullStringIsEmpty) {
+    log_string(NULL, 0);
+    EXPECT_EQ(drain(), (Bytes{0xFF, 0x04, TOKEN_STRING & 0xFF, TOKEN_STRING >> 8, 0x01, 0x01}));
+}
+
+TEST_F(TokenizedLog, PointersAreIntegers) {
+    log_pointer((void *)0x1234);
+    EXPECT_EQ(drain(), (Bytes{0xFF, 0x04, TOKEN_POINTER & 0xFF, TOKEN_POINTER >> 8, 0xB5, 0x24}));
+}
+
+TEST_F(TokenizedLog, RecordsContainNoZeroBytes) {
+    const uint32_t values[] = {0, 1, 127, 128, 255, 256, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFE, 0xFFFFFFFF};
+    for (uint32_t value : values) {
+        log_numbers((int)value, value & 0xFF, value);
+        for (uint8_t byte : drain()) {
+            EXPECT_NE(byte, 0) << "value " << value;
+        }
+    }
+}
+
+TEST_F(TokenizedLog, FullRingDropsWholeRecords) {
+    // 4 byte records, 16 of them fill the 64 byte ring
+    for (int i = 0; i < 20; i++) {
+        log_hello();
+    }
+    tokenized_log_stats_t stats = tokenized_log_get_stats();
+    EXPECT_EQ(stats.records, 16);
+    EXPECT_EQ(stats.dropped, 4);
+    EXPECT_EQ(drain().size(), 64);
+
+    tokenized_log_clear_stats();
+    log_numbers(0, 0, 0);
+    EXPECT_EQ(tokenized_log_get_stats().records, 1);
+}
+
+TEST_F(TokenizedLog, PartialSendKeepsTheRest) {
+    log_hello();
+    log_string("abc", 1);
+    Bytes first = drain(5);
+    EXPECT_EQ(first.size(), 5);
+    Bytes rest = drain();
+    first.insert(first.end(), rest.begin(), rest.end());
+    EXPECT_EQ(first, (Bytes{0xFF, 0x02, TOKEN_HELLO & 0xFF, TOKEN_HELLO >> 8, 0xFF, 0x07, TOKEN_STRING & 0xFF, TOKEN_STRING >> 8, 0x04, 'a', 'b', 'c', 0x02}));
+}
+
+TEST_F(TokenizedLog, PeekWrapsAround) {
+    // Step through the ring until a run of records straddles its end
+    for (int i = 0; i < 16; i++) {
+        for (int j = 0; j < 3; j++) {
+            log_hello();
+        }
+
+        const uint8_t *data;
+        uint16_t       first = tokenized_log_peek(&data);
+        if (first == 12) {
+            drain();
+            continue;
+        }
+
+        ASSERT_LT(first, 12);
+        tokenized_log_consume(first);
+        EXPECT_EQ(tokenized_log_peek(&data), 12 - first);
+        tokenized_log_consume(12 - first);
+        EXPECT_EQ(tokenized_log_peek(&data), 0);
+        return;
+    }
+    FAIL() << "no wrap around";
+}
@@ -0,0 +1,152 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "tokenized_log.h"
+#include "sendchar.h"
+
+_Static_assert(TOKENIZED_LOG_BUFFER_SIZE >= 64 && TOKENIZED_LOG_BUFFER_SIZE <= 32768, "TOKENIZED_LOG_BUFFER_SIZE must be between 64 and 32768");
+_Static_assert(TOKENIZED_LOG_MAX_STRING_LENGTH < 127, "TOKENIZED_LOG_MAX_STRING_LENGTH must fit a single byte varint");
+
+static uint8_t               buffer[TOKENIZED_LOG_BUFFER_SIZE];
+static uint16_t              head  = 0; // next byte to write
+static uint16_t              tail  = 0; // next byte to send
+static uint16_t              count = 0;
+static tokenized_log_stats_t stats = {0};
+
+static uint8_t varint_size(uint32_t value) {
+    if (value == UINT32_MAX) {
+        return 5;
+    }
+    uint8_t size = 1;
+    for (value++; value >= 0x80; value >>= 7) {
+        size++;
+    }
+    return size;
+}
+
+static inline void put(uint8_t byte) {
+    buffer[head] = byte;
+    if (++head == TOKENIZED_LOG_BUFFER_SIZE) {
+        head = 0;
+    }
+    count++;
+}
+
+// Encodes value + 1 as up to 33 bits, which keeps the last byte non-zero
+static void put_varint(uint32_t value) {
+    uint32_t rest  = value + 1;
+    bool     carry = (rest == 0);
+    for (;;) {
+        uint8_t byte = rest & 0x7F;
+        rest         = (rest >> 7) | ((uint32_t)carry << 25);
+        carry        = false;
+        if (!rest) {
+            put(byte);
+            break;
+        }
+        put(byte | 0x80);
+    }
+}
+
+static uint8_t string_length(const char *string) {
+    uint8_t length = 0;
+    while (length < TOKENIZED_LOG_MAX_STRING_LENGTH && string[length]) {
+        length++;
+    }
+    return length;
+}
+
+void tokenized_log_write(uint16_t token, uint8_t argc, const tokenized_log_arg_t *args) {
+    // Size the record first so it is either queued whole or not at all
+    uint16_t length = 2;
+    for (uint8_t i = 0; i < argc; i++) {
+        if (args[i].string) {
+            length += 1 + string_length(args[i].string);
+        } else {
+            length += varint_size(args[i].value);
+        }
+    }
+
+    if (length > UINT8_MAX || length + 2 > TOKENIZED_LOG_BUFFER_SIZE - count) {
+        stats.dropped++;
+        return;
+    }
+
+    put(TOKENIZED_LOG_RECORD_START);
+    put((uint8_t)length);
+    put(token & 0xFF);
+    put(token >> 8);
+    for (uint8_t i = 0; i < argc; i++) {
+        if (args[i].string) {
+            uint8_t len = string_length(args[i].string);
+            put_varint(len);
+            for (uint8_t j = 0; j < len; j++) {
+                put(args[i].string[j]);
+            }
+        } else {
+            put_varint(args[i].value);
+        }
+    }
+    stats.records++;
+}
+
+uint16_t tokenized_log_peek(const uint8_t **data) {
+    *data = &buffer[tail];
+    if (count > TOKENIZED_LOG_BUFFER_SIZE - tail) {
+        return TOKENIZED_LOG_BUFFER_SIZE - tail;
+    }
+    return count;
+}
+
+void tokenized_log_consume(uint16_t length) {
+    if (length > count) {
+        length = count;
+    }
+    tail += length;
+    if (tail >= TOKENIZED_LOG_BUFFER_SIZE) {
+        tail -= TOKENIZED_LOG_BUFFER_SIZE;
+    }
+    count -= length;
+}
+
+__attribute__((weak)) uint16_t tokenized_log_send(const uint8_t *data, uint16_t length) {
+    uint16_t sent = 0;
+    while (sent < length && sendchar(data[sent]) == 0) {
+        sent++;
+    }
+    return sent;
+}
+
+void tokenized_log_task(void) {
+    const uint8_t *data;
+    uint16_t       length;
+    while ((length = tokenized_log_peek(&data)) > 0) {
+        uint16_t sent = tokenized_log_send(data, length);
+        tokenized_log_consume(sent);
+        if (sent < length) {
+            break;
+        }
+    }
+}
+
+tokenized_log_stats_t tokenized_log_get_stats(void) {
+    return stats;
+}
+
+void tokenized_log_clear_stats(void) {
+    memset(&stats, 0, sizeof(stats));
+}
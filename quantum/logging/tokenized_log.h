@@ -0,0 +1,185 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Tokenized logging
+ *
+ * Instead of formatting on the device, each log call is reduced to a 16-bit
+ * token computed at compile time from its format string, followed by its raw
+ * arguments. The format strings are collected in the `.qmk_log_tokens`
+ * section of the ELF, which is not loaded into flash, and
+ * `qmk generate-log-tokens` turns them into a table for the host decoder.
+ *
+ * Records are queued in a RAM ring and handed to the console in bulk by
+ * tokenized_log_task(). On the wire a record is:
+ *
+ *   0xFF | length | token (LE16) | arguments...
+ *
+ * where length counts the token and argument bytes. Integer arguments are
+ * LEB128 varints of their 32-bit value plus one, strings are a varint length
+ * followed by at most TOKENIZED_LOG_MAX_STRING_LENGTH bytes. Anything outside
+ * a record is plain console text.
+ *
+ * No byte of a record is ever zero, so the host can drop the zero padding of
+ * console reports even where a record spans two of them.
+ */
+
+#ifndef TOKENIZED_LOG_BUFFER_SIZE
+#    define TOKENIZED_LOG_BUFFER_SIZE 256
+#endif
+
+#ifndef TOKENIZED_LOG_MAX_STRING_LENGTH
+#    define TOKENIZED_LOG_MAX_STRING_LENGTH 32
+#endif
+
+#define TOKENIZED_LOG_RECORD_START 0xFF
+#define TOKENIZED_LOG_MAX_ARGS 8
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    const char *string; // NULL for integer arguments
+    uint32_t    value;
+} tokenized_log_arg_t;
+
+typedef struct {
+    uint32_t records; // records queued
+    uint32_t dropped; // records that did not fit the ring
+} tokenized_log_stats_t;
+
+void tokenized_log_write(uint16_t token, uint8_t argc, const tokenized_log_arg_t *args);
+
+/* Returns the oldest contiguous run of queued bytes, 0 if the ring is empty */
+uint16_t tokenized_log_peek(const uint8_t **data);
+void     tokenized_log_consume(uint16_t length);
+void     tokenized_log_task(void);
+
+/* Sends queued bytes to the console, returns how many were accepted. The
+ * default implementation goes through sendchar(), console_tx.c replaces it
+ * where there is a console buffer. */
+uint16_t tokenized_log_send(const uint8_t *data, uint16_t length);
+
+tokenized_log_stats_t tokenized_log_get_stats(void);
+void                  tokenized_log_clear_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifndef __cplusplus
+
+static inline tokenized_log_arg_t tokenized_log_arg_string(const char *s) {
+    return (tokenized_log_arg_t){.string = s ? s : "", .value = 0};
+}
+
+static inline tokenized_log_arg_t tokenized_log_arg_pointer(const void *p) {
+    return (tokenized_log_arg_t){.string = NULL, .value = (uint32_t)(uintptr_t)p};
+}
+
+static inline tokenized_log_arg_t tokenized_log_arg_integer(uint32_t v) {
+    return (tokenized_log_arg_t){.string = NULL, .value = v};
+}
+
+static inline uint16_t tokenized_log_fold(uint32_t hash) {
+    uint16_t token = (uint16_t)(hash ^ (hash >> 16));
+    if (!(token & 0x00FF)) token |= 0x0001;
+    if (!(token & 0xFF00)) token |= 0x0100;
+    return token;
+}
+
+#    define TOKENIZED_LOG_ARG(x) \
+        _Generic((x), char * : tokenized_log_arg_string, const char * : tokenized_log_arg_string, void * : tokenized_log_arg_pointer, const void * : tokenized_log_arg_pointer, default : tokenized_log_arg_integer)(x)
+
+/* 65599 string hash over the length and the first 64 characters, which
+ * lib/python/qmk/tokenized_log.py mirrors. Only works on string literals. */
+#    define TOKENIZED_LOG_C(s, i) ((uint32_t)((i) < sizeof(s) - 1 ? (uint8_t)(s)[(i) < sizeof(s) ? (i) : 0] : 0))
+// clang-format off
+#    define TOKENIZED_LOG_HASH(s) \
+        ((uint32_t)(sizeof(s) - 1) \
+     + 0x0001003FUL * TOKENIZED_LOG_C(s, 0) + 0x007E0F81UL * TOKENIZED_LOG_C(s, 1) \
+     + 0x2E86D0BFUL * TOKENIZED_LOG_C(s, 2) + 0x43EC5F01UL * TOKENIZED_LOG_C(s, 3) \
+     + 0x162C613FUL * TOKENIZED_LOG_C(s, 4) + 0xD62AEE81UL * TOKENIZED_LOG_C(s, 5) \
+     + 0xA311B1BFUL * TOKENIZED_LOG_C(s, 6) + 0xD319BE01UL * TOKENIZED_LOG_C(s, 7) \
+     + 0xB156C23FUL * TOKENIZED_LOG_C(s, 8) + 0x6698CD81UL * TOKENIZED_LOG_C(s, 9) \
+     + 0x0D1B92BFUL * TOKENIZED_LOG_C(s, 10) + 0xCC881D01UL * TOKENIZED_LOG_C(s, 11) \
+     + 0x7280233FUL * TOKENIZED_LOG_C(s, 12) + 0x50C7AC81UL * TOKENIZED_LOG_C(s, 13) \
+     + 0x8DA473BFUL * TOKENIZED_LOG_C(s, 14) + 0x4F377C01UL * TOKENIZED_LOG_C(s, 15) \
+     + 0xFAA8843FUL * TOKENIZED_LOG_C(s, 16) + 0x33B78B81UL * TOKENIZED_LOG_C(s, 17) \
+     + 0x45AC54BFUL * TOKENIZED_LOG_C(s, 18) + 0x7A27DB01UL * TOKENIZED_LOG_C(s, 19) \
+     + 0xEACFE53FUL * TOKENIZED_LOG_C(s, 20) + 0xAE686A81UL * TOKENIZED_LOG_C(s, 21) \
+     + 0x563335BFUL * TOKENIZED_LOG_C(s, 22) + 0x6C593A01UL * TOKENIZED_LOG_C(s, 23) \
+     + 0xE3F6463FUL * TOKENIZED_LOG_C(s, 24) + 0x5FDA4981UL * TOKENIZED_LOG_C(s, 25) \
+     + 0xE03916BFUL * TOKENIZED_LOG_C(s, 26) + 0x44CB9901UL * TOKENIZED_LOG_C(s, 27) \
+     + 0x871BA73FUL * TOKENIZED_LOG_C(s, 28) + 0xE70D2881UL * TOKENIZED_LOG_C(s, 29) \
+     + 0x04BDF7BFUL * TOKENIZED_LOG_C(s, 30) + 0x227EF801UL * TOKENIZED_LOG_C(s, 31) \
+     + 0x7540083FUL * TOKENIZED_LOG_C(s, 32) + 0xE3010781UL * TOKENIZED_LOG_C(s, 33) \
+     + 0xE4C1D8BFUL * TOKENIZED_LOG_C(s, 34) + 0x24735701UL * TOKENIZED_LOG_C(s, 35) \
+     + 0x4F63693FUL * TOKENIZED_LOG_C(s, 36) + 0xF2B5E681UL * TOKENIZED_LOG_C(s, 37) \
+     + 0xA144B9BFUL * TOKENIZED_LOG_C(s, 38) + 0x69A8B601UL * TOKENIZED_LOG_C(s, 39) \
+     + 0xB685CA3FUL * TOKENIZED_LOG_C(s, 40) + 0xB52BC581UL * TOKENIZED_LOG_C(s, 41) \
+     + 0x5B469ABFUL * TOKENIZED_LOG_C(s, 42) + 0x111F1501UL * TOKENIZED_LOG_C(s, 43) \
+     + 0x4BA72B3FUL * TOKENIZED_LOG_C(s, 44) + 0xC962A481UL * TOKENIZED_LOG_C(s, 45) \
+     + 0x33C77BBFUL * TOKENIZED_LOG_C(s, 46) + 0x39D67401UL * TOKENIZED_LOG_C(s, 47) \
+     + 0xAFC78C3FUL * TOKENIZED_LOG_C(s, 48) + 0xCE5A8381UL * TOKENIZED_LOG_C(s, 49) \
+     + 0x4BC75CBFUL * TOKENIZED_LOG_C(s, 50) + 0x02CED301UL * TOKENIZED_LOG_C(s, 51) \
+     + 0x83E6ED3FUL * TOKENIZED_LOG_C(s, 52) + 0x63136281UL * TOKENIZED_LOG_C(s, 53) \
+     + 0xC4463DBFUL * TOKENIZED_LOG_C(s, 54) + 0x8B083201UL * TOKENIZED_LOG_C(s, 55) \
+     + 0x69054E3FUL * TOKENIZED_LOG_C(s, 56) + 0x268D4181UL * TOKENIZED_LOG_C(s, 57) \
+     + 0xBE441EBFUL * TOKENIZED_LOG_C(s, 58) + 0xF1829101UL * TOKENIZED_LOG_C(s, 59) \
+     + 0x0022AF3FUL * TOKENIZED_LOG_C(s, 60) + 0xB7C82081UL * TOKENIZED_LOG_C(s, 61) \
+     + 0x5AC0FFBFUL * TOKENIZED_LOG_C(s, 62) + 0x553DF001UL * TOKENIZED_LOG_C(s, 63))
+// clang-format on
+#    define TOKENIZED_LOG_TOKEN(fmt) tokenized_log_fold(TOKENIZED_LOG_HASH("" fmt ""))
+
+#    if defined(__ELF__)
+#        define TOKENIZED_LOG_ENTRY(fmt) __asm__ volatile(".pushsection .qmk_log_tokens,\"\"\n\t.ascii " #fmt "\n\t.byte 0\n\t.popsection")
+#    else
+#        define TOKENIZED_LOG_ENTRY(fmt)
+#    endif
+
+#    define TOKENIZED_LOG_NARGS(...) TOKENIZED_LOG_NARGS_(_, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#    define TOKENIZED_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+
+#    define TOKENIZED_LOG_ARGS_0(...) NULL
+#    define TOKENIZED_LOG_ARGS_1(a) TOKENIZED_LOG_ARG(a)
+#    define TOKENIZED_LOG_ARGS_2(a, ...) TOKENIZED_LOG_ARG(a), TOKENIZED_LOG_ARGS_1(__VA_ARGS__)
+#    define TOKENIZED_LOG_ARGS_3(a, ...) TOKENIZED_LOG_ARG(a), TOKENIZED_LOG_ARGS_2(__VA_ARGS__)
+#    define TOKENIZED_LOG_ARGS_4(a, ...) TOKENIZED_LOG_ARG(a), TOKENIZED_LOG_ARGS_3(__VA_ARGS__)
+#    define TOKENIZED_LOG_ARGS_5(a, ...) TOKENIZED_LOG_ARG(a), TOKENIZED_LOG_ARGS_4(__VA_ARGS__)
+#    define TOKENIZED_LOG_ARGS_6(a, ...) TOKENIZED_LOG_ARG(a), TOKENIZED_LOG_ARGS_5(__VA_ARGS__)
+#    define TOKENIZED_LOG_ARGS_7(a, ...) TOKENIZED_LOG_ARG(a), TOKENIZED_LOG_ARGS_6(__VA_ARGS__)
+#    define TOKENIZED_LOG_ARGS_8(a, ...) TOKENIZED_LOG_ARG(a), TOKENIZED_LOG_ARGS_7(__VA_ARGS__)
+#    define TOKENIZED_LOG_ARRAY(n, ...) TOKENIZED_LOG_ARRAY_(n, __VA_ARGS__)
+#    define TOKENIZED_LOG_ARRAY_(n, ...) (n ? (const tokenized_log_arg_t[n + 1]){TOKENIZED_LOG_ARGS_##n(__VA_ARGS__)} : NULL)
+
+#    define TOKENIZED_LOG_CALL(fmt, n, ...)                                                        \
+        do {                                                                                       \
+            TOKENIZED_LOG_ENTRY(fmt);                                                              \
+            tokenized_log_write(TOKENIZED_LOG_TOKEN(fmt), n, TOKENIZED_LOG_ARRAY(n, __VA_ARGS__)); \
+        } while (0)
+
+/* Drop-in for xprintf(): the format must be a string literal, and at most
+ * TOKENIZED_LOG_MAX_ARGS arguments are supported. */
+#    define tokenized_log(fmt, ...) TOKENIZED_LOG_CALL(fmt, TOKENIZED_LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+
+#endif
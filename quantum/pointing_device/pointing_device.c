@@ -233,6 +233,17 @@ __attribute__((weak)) void pointing_device_task(void) {
     last_exec = timer_read32();
 #endif
 
+#if defined(SPLIT_POINTING_ENABLE) && defined(SPLIT_POINTING_QUEUE_ENABLE)
+#    if defined(POINTING_DEVICE_COMBINED)
+    split_pointing_queue_take(&shared_mouse_report);
+#    else
+    // The shared report is only the other half's motion if the device is over there
+    if (!(POINTING_DEVICE_THIS_SIDE)) {
+        split_pointing_queue_take(&shared_mouse_report);
+    }
+#    endif
+#endif
+
     // Gather report info
 #ifdef POINTING_DEVICE_MOTION_PIN
 #    if defined(SPLIT_POINTING_ENABLE)
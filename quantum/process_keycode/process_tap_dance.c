@@ -15,8 +15,52 @@
  */
 #include "quantum.h"
 
-static uint16_t active_td;
-static uint16_t last_tap_time;
+#ifndef TAP_DANCE_MAX_SIMULTANEOUS
+#    ifdef TAP_DANCE_CONCURRENT
+#        define TAP_DANCE_MAX_SIMULTANEOUS 4
+#    else
+#        define TAP_DANCE_MAX_SIMULTANEOUS 1
+#    endif
+#endif
+
+typedef struct {
+    uint8_t  index;
+    uint16_t deadline;
+} active_td_t;
+
+// Unfinished dances, oldest first
+static active_td_t active_tds[TAP_DANCE_MAX_SIMULTANEOUS];
+static uint8_t     active_td_count;
+static uint16_t    next_deadline;
+
+static void update_next_deadline(void) {
+    if (!active_td_count) return;
+
+    next_deadline = active_tds[0].deadline;
+    for (uint8_t i = 1; i < active_td_count; i++) {
+        if (timer_expired(next_deadline, active_tds[i].deadline)) {
+            next_deadline = active_tds[i].deadline;
+        }
+    }
+}
+
+static int8_t find_active_td(uint8_t index) {
+    for (uint8_t i = 0; i < active_td_count; i++) {
+        if (active_tds[i].index == index) return i;
+    }
+    return -1;
+}
+
+static void remove_active_td(uint8_t index) {
+    int8_t i = find_active_td(index);
+    if (i < 0) return;
+
+    active_td_count--;
+    for (; i < active_td_count; i++) {
+        active_tds[i] = active_tds[i + 1];
+    }
+    update_next_deadline();
+}
 
 void qk_tap_dance_pair_on_each_tap(qk_tap_dance_state_t *state, void *user_data) {
     qk_tap_dance_pair_t *pair = (qk_tap_dance_pair_t *)user_data;
@@ -108,24 +152,57 @@ static inline void process_tap_dance_action_on_dance_finished(qk_tap_dance_actio
         send_keyboard_report();
         _process_tap_dance_action_fn(&action->state, action->user_data, action->fn.on_dance_finished);
     }
-    active_td = 0;
+    remove_active_td(action - tap_dance_actions);
     if (!action->state.pressed) {
         // There will not be a key release event, so reset now.
         process_tap_dance_action_on_reset(action);
     }
 }
 
+static void add_active_td(uint8_t index, uint16_t deadline) {
+    int8_t i = find_active_td(index);
+
+    if (i < 0) {
+        if (active_td_count == TAP_DANCE_MAX_SIMULTANEOUS) {
+            // No room left, settle the oldest dance
+            qk_tap_dance_action_t *oldest      = &tap_dance_actions[active_tds[0].index];
+            oldest->state.interrupted          = true;
+            oldest->state.interrupting_keycode = TD(index);
+            process_tap_dance_action_on_dance_finished(oldest);
+        }
+        i = active_td_count++;
+    }
+    active_tds[i] = (active_td_t){.index = index, .deadline = deadline};
+    update_next_deadline();
+}
+
 void preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
     qk_tap_dance_action_t *action;
+    bool                   interrupted = false;
 
     if (!record->event.pressed) return;
 
-    if (!active_td || keycode == active_td) return;
+    for (uint8_t i = 0; i < active_td_count;) {
+        uint16_t active_keycode = TD(active_tds[i].index);
+#ifdef TAP_DANCE_CONCURRENT
+        // Dances on other keys run their course independently
+        if (keycode == active_keycode || (keycode >= QK_TAP_DANCE && keycode <= QK_TAP_DANCE_MAX)) {
+#else
+        if (keycode == active_keycode) {
+#endif
+            i++;
+            continue;
+        }
+
+        action                             = &tap_dance_actions[active_tds[i].index];
+        action->state.interrupted          = true;
+        action->state.interrupting_keycode = keycode;
+        // drops the dance from active_tds
+        process_tap_dance_action_on_dance_finished(action);
+        interrupted = true;
+    }
 
-    action                             = &tap_dance_actions[TD_INDEX(active_td)];
-    action->state.interrupted          = true;
-    action->state.interrupting_keycode = keycode;
-    process_tap_dance_action_on_dance_finished(action);
+    if (!interrupted) return;
 
     // Tap dance actions can leave some weak mods active (e.g., if the tap dance is mapped to a keycode with
     // modifiers), but these weak mods should not affect the keypress which interrupted the tap dance.
@@ -141,9 +218,13 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
 
             action->state.pressed = record->event.pressed;
             if (record->event.pressed) {
-                last_tap_time = timer_read();
+                uint16_t deadline = timer_read() + GET_TAPPING_TERM(keycode, &(keyrecord_t){}) + 1;
                 process_tap_dance_action_on_each_tap(action);
-                active_td = action->state.finished ? 0 : keycode;
+                if (action->state.finished) {
+                    remove_active_td(TD_INDEX(keycode));
+                } else {
+                    add_active_td(TD_INDEX(keycode), deadline);
+                }
             } else {
                 if (action->state.finished) {
                     process_tap_dance_action_on_reset(action);
@@ -156,18 +237,31 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
     return true;
 }
 
+bool tap_dance_get_next_deadline(uint16_t *deadline) {
+    if (!active_td_count) return false;
+
+    *deadline = next_deadline;
+    return true;
+}
+
 void tap_dance_task() {
     qk_tap_dance_action_t *action;
+    uint16_t               now = timer_read();
 
-    if (!active_td || timer_elapsed(last_tap_time) <= GET_TAPPING_TERM(active_td, &(keyrecord_t){})) return;
+    if (!active_td_count || !timer_expired(now, next_deadline)) return;
 
-    action = &tap_dance_actions[TD_INDEX(active_td)];
-    if (!action->state.interrupted) {
-        process_tap_dance_action_on_dance_finished(action);
+    for (uint8_t i = 0; i < active_td_count;) {
+        action = &tap_dance_actions[active_tds[i].index];
+        if (timer_expired(now, active_tds[i].deadline) && !action->state.interrupted) {
+            // drops the dance from active_tds
+            process_tap_dance_action_on_dance_finished(action);
+        } else {
+            i++;
+        }
     }
 }
 
 void reset_tap_dance(qk_tap_dance_state_t *state) {
-    active_td = 0;
+    remove_active_td((qk_tap_dance_action_t *)state - tap_dance_actions);
     process_tap_dance_action_on_reset((qk_tap_dance_action_t *)state);
 }
@@ -84,6 +84,7 @@ void reset_tap_dance(qk_tap_dance_state_t *state);
 void preprocess_tap_dance(uint16_t keycode, keyrecord_t *record);
 bool process_tap_dance(uint16_t keycode, keyrecord_t *record);
 void tap_dance_task(void);
+bool tap_dance_get_next_deadline(uint16_t *deadline);
 
 void qk_tap_dance_pair_on_each_tap(qk_tap_dance_state_t *state, void *user_data);
 void qk_tap_dance_pair_finished(qk_tap_dance_state_t *state, void *user_data);
@@ -110,6 +110,7 @@ __attribute__((weak)) void unicode_input_start(void) {
                 tap_code(KC_NUM_LOCK);
             }
             register_code(KC_LEFT_ALT);
+            host_keyboard_flush();
             wait_ms(UNICODE_TYPE_DELAY);
             tap_code(KC_KP_PLUS);
             break;
@@ -119,6 +120,7 @@ __attribute__((weak)) void unicode_input_start(void) {
             break;
     }
 
+    host_keyboard_flush();
     wait_ms(UNICODE_TYPE_DELAY);
 }
 
@@ -3,3 +3,8 @@
 void raw_hid_receive(uint8_t *data, uint8_t length);
 
 void raw_hid_send(uint8_t *data, uint8_t length);
+
+// Called from the protocol's raw HID task on every pass, after any received
+// packet has been handled, so that packets can be pushed to the host
+// without a request for each of them.
+void raw_hid_poll(void);
@@ -173,6 +173,7 @@ void send_string_with_delay(const char *string, uint8_t interval) {
                     ms += keycode - '0';
                     keycode = *(++string);
                 }
+                host_keyboard_flush();
                 while (ms--)
                     wait_ms(1);
             }
@@ -183,6 +184,7 @@ void send_string_with_delay(const char *string, uint8_t interval) {
         // interval
         {
             uint8_t ms = interval;
+            host_keyboard_flush();
             while (ms--)
                 wait_ms(1);
         }
@@ -306,6 +308,7 @@ void send_string_with_delay_P(const char *string, uint8_t interval) {
                     ms += keycode - '0';
                     keycode = pgm_read_byte(++string);
                 }
+                host_keyboard_flush();
                 while (ms--)
                     wait_ms(1);
             }
@@ -316,6 +319,7 @@ void send_string_with_delay_P(const char *string, uint8_t interval) {
         // interval
         {
             uint8_t ms = interval;
+            host_keyboard_flush();
             while (ms--)
                 wait_ms(1);
         }
@@ -0,0 +1,265 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "crc.h"
+#include "input_queue.h"
+
+static void record_depth(input_queue_metrics_t *metrics, uint8_t depth) {
+    metrics->depth = depth;
+    if (depth > metrics->max_depth) {
+        metrics->max_depth = depth;
+    }
+}
+
+static void record_full(input_queue_metrics_t *metrics) {
+    if (metrics->full < UINT16_MAX) {
+        metrics->full++;
+    }
+}
+
+// Returns the slot of a new newest event, or -1 if the queue is full
+static int8_t append(input_queue_t *queue, uint8_t capacity) {
+    if (queue->count == capacity) {
+        record_full(&queue->metrics);
+        return -1;
+    }
+    uint8_t slot = (queue->head + queue->count) % capacity;
+    queue->count++;
+    queue->seq++;
+    queue->sealed = false;
+    record_depth(&queue->metrics, queue->count);
+    return slot;
+}
+
+static uint8_t newest(const input_queue_t *queue, uint8_t capacity) {
+    return (queue->head + queue->count - 1) % capacity;
+}
+
+static void acknowledge(input_queue_t *queue, uint8_t capacity, uint8_t request) {
+    uint8_t unapplied = queue->seq - request;
+    // anything else is not an answer to this queue, e.g. after a restart
+    if (unapplied <= queue->count) {
+        queue->head  = (queue->head + queue->count - unapplied) % capacity;
+        queue->count = unapplied;
+        record_depth(&queue->metrics, queue->count);
+    }
+}
+
+static uint8_t finish_frame(input_queue_t *queue, uint8_t *frame, uint8_t length) {
+    queue->sealed = true;
+    frame[0]      = length + 1;
+    frame[1]      = queue->seq;
+    frame[length] = crc8(frame, length);
+    return length + 1;
+}
+
+// Checks the frame, returns how many of its events are newer than `applied`,
+// or -1, and where the first of them starts
+static int8_t check_frame(const uint8_t *frame, uint8_t size, uint8_t event_size, uint8_t capacity, uint8_t applied, uint8_t *start, input_queue_metrics_t *metrics) {
+    uint8_t length = frame[0];
+    if (length < INPUT_QUEUE_OVERHEAD || length > size || crc8(frame, length - 1) != frame[length - 1]) {
+        return -1;
+    }
+
+    uint8_t payload = length - INPUT_QUEUE_OVERHEAD;
+    if (payload % event_size != 0 || payload / event_size > capacity) {
+        return -1;
+    }
+
+    uint8_t held  = payload / event_size;
+    uint8_t fresh = frame[1] - applied;
+    record_depth(metrics, held);
+    if (fresh > held) {
+        fresh = held;
+    }
+    *start = 2 + (held - fresh) * event_size;
+    return fresh;
+}
+
+static int16_t read_int16(const uint8_t *data) {
+    return (int16_t)(data[0] | data[1] << 8);
+}
+
+static void write_int16(uint8_t *data, int16_t value) {
+    data[0] = (uint16_t)value & 0xFF;
+    data[1] = (uint16_t)value >> 8;
+}
+
+static int16_t add_saturated(int16_t a, int16_t b, bool *saturated) {
+    int32_t sum = (int32_t)a + b;
+    if (sum > INT16_MAX || sum < INT16_MIN) {
+        *saturated = true;
+        return sum > 0 ? INT16_MAX : INT16_MIN;
+    }
+    return sum;
+}
+
+static int16_t take_motion(int16_t *motion, int16_t limit) {
+    int16_t taken = *motion > limit ? limit : *motion < -limit ? -limit : *motion;
+    *motion -= taken;
+    return taken;
+}
+
+bool encoder_queue_push(encoder_queue_t *queue, uint8_t index, int8_t steps) {
+    if (queue->queue.count > 0 && !queue->queue.sealed) {
+        encoder_queue_event_t *event = &queue->events[newest(&queue->queue, SPLIT_ENCODER_QUEUE_SIZE)];
+        int16_t                sum   = event->steps + steps;
+        if (event->index == index && (event->steps < 0) == (steps < 0) && sum >= INT8_MIN && sum <= INT8_MAX) {
+            event->steps = sum;
+            return true;
+        }
+    }
+
+    int8_t slot = append(&queue->queue, SPLIT_ENCODER_QUEUE_SIZE);
+    if (slot < 0) {
+        return false;
+    }
+    queue->events[slot] = (encoder_queue_event_t){.index = index, .steps = steps};
+    return true;
+}
+
+bool pointing_queue_push(pointing_queue_t *queue, const pointing_queue_event_t *event) {
+    if (queue->queue.count > 0 && !queue->queue.sealed) {
+        pointing_queue_event_t *last   = &queue->events[newest(&queue->queue, SPLIT_POINTING_QUEUE_SIZE)];
+        pointing_queue_event_t  merged = *last;
+        if (last->buttons == event->buttons && pointing_queue_accumulate(&merged, event)) {
+            *last = merged;
+            return true;
+        }
+    }
+
+    int8_t slot = append(&queue->queue, SPLIT_POINTING_QUEUE_SIZE);
+    if (slot < 0) {
+        return false;
+    }
+    queue->events[slot] = *event;
+    return true;
+}
+
+bool pointing_queue_input(pointing_queue_t *queue, const pointing_queue_event_t *event) {
+    pointing_queue_event_t *pending = &queue->pending;
+    if (event) {
+        pointing_queue_accumulate(pending, event);
+    }
+    if ((pending->x || pending->y || pending->h || pending->v || pending->buttons != queue->buttons) && pointing_queue_push(queue, pending)) {
+        queue->buttons = pending->buttons;
+        *pending       = (pointing_queue_event_t){.buttons = queue->buttons};
+    }
+    return pending->buttons == queue->buttons;
+}
+
+bool pointing_queue_accumulate(pointing_queue_event_t *pending, const pointing_queue_event_t *event) {
+    bool saturated   = false;
+    pending->buttons = event->buttons;
+    pending->x       = add_saturated(pending->x, event->x, &saturated);
+    pending->y       = add_saturated(pending->y, event->y, &saturated);
+    pending->h       = add_saturated(pending->h, event->h, &saturated);
+    pending->v       = add_saturated(pending->v, event->v, &saturated);
+    return !saturated;
+}
+
+uint8_t encoder_queue_encode(encoder_queue_t *queue, uint8_t request, uint8_t *frame) {
+    acknowledge(&queue->queue, SPLIT_ENCODER_QUEUE_SIZE, request);
+
+    uint8_t length = 2;
+    for (uint8_t i = 0; i < queue->queue.count; i++) {
+        const encoder_queue_event_t *event = &queue->events[(queue->queue.head + i) % SPLIT_ENCODER_QUEUE_SIZE];
+        frame[length]                      = event->index;
+        frame[length + 1]                  = (uint8_t)event->steps;
+        length += ENCODER_QUEUE_EVENT_SIZE;
+    }
+    return finish_frame(&queue->queue, frame, length);
+}
+
+uint8_t pointing_queue_encode(pointing_queue_t *queue, uint8_t request, uint8_t *frame) {
+    acknowledge(&queue->queue, SPLIT_POINTING_QUEUE_SIZE, request);
+
+    uint8_t length = 2;
+    for (uint8_t i = 0; i < queue->queue.count; i++) {
+        const pointing_queue_event_t *event = &queue->events[(queue->queue.head + i) % SPLIT_POINTING_QUEUE_SIZE];
+        frame[length]                       = event->buttons;
+        write_int16(&frame[length + 1], event->x);
+        write_int16(&frame[length + 3], event->y);
+        write_int16(&frame[length + 5], event->h);
+        write_int16(&frame[length + 7], event->v);
+        length += POINTING_QUEUE_EVENT_SIZE;
+    }
+    return finish_frame(&queue->queue, frame, length);
+}
+
+int8_t encoder_queue_decode(const uint8_t *frame, uint8_t size, uint8_t *applied, encoder_queue_event_t *events, uint8_t max, input_queue_metrics_t *metrics) {
+    uint8_t start;
+    int8_t  fresh = check_frame(frame, size, ENCODER_QUEUE_EVENT_SIZE, SPLIT_ENCODER_QUEUE_SIZE, *applied, &start, metrics);
+    if (fresh < 0) {
+        return -1;
+    }
+
+    uint8_t stored = fresh;
+    if (stored > max) {
+        stored = max;
+        record_full(metrics);
+    }
+    for (uint8_t i = 0; i < stored; i++) {
+        const uint8_t *data = &frame[start + i * ENCODER_QUEUE_EVENT_SIZE];
+        events[i]           = (encoder_queue_event_t){.index = data[0], .steps = (int8_t)data[1]};
+    }
+    *applied = frame[1] - (fresh - stored);
+    return stored;
+}
+
+int8_t pointing_queue_decode(const uint8_t *frame, uint8_t size, uint8_t *applied, pointing_queue_event_t *events, uint8_t max, input_queue_metrics_t *metrics) {
+    uint8_t start;
+    int8_t  fresh = check_frame(frame, size, POINTING_QUEUE_EVENT_SIZE, SPLIT_POINTING_QUEUE_SIZE, *applied, &start, metrics);
+    if (fresh < 0) {
+        return -1;
+    }
+
+    uint8_t stored = fresh;
+    if (stored > max) {
+        stored = max;
+        record_full(metrics);
+    }
+    for (uint8_t i = 0; i < stored; i++) {
+        const uint8_t *data = &frame[start + i * POINTING_QUEUE_EVENT_SIZE];
+        events[i].buttons   = data[0];
+        events[i].x         = read_int16(&data[1]);
+        events[i].y         = read_int16(&data[3]);
+        events[i].h         = read_int16(&data[5]);
+        events[i].v         = read_int16(&data[7]);
+    }
+    *applied = frame[1] - (fresh - stored);
+    return stored;
+}
+
+bool pointing_queue_take(pointing_queue_t *queue, int16_t xy_limit, int16_t hv_limit, pointing_queue_event_t *event) {
+    if (queue->queue.count == 0) {
+        return false;
+    }
+
+    pointing_queue_event_t *oldest = &queue->events[queue->queue.head];
+    event->buttons                 = oldest->buttons;
+    event->x                       = take_motion(&oldest->x, xy_limit);
+    event->y                       = take_motion(&oldest->y, xy_limit);
+    event->h                       = take_motion(&oldest->h, hv_limit);
+    event->v                       = take_motion(&oldest->v, hv_limit);
+
+    if (!oldest->x && !oldest->y && !oldest->h && !oldest->v) {
+        queue->queue.head = (queue->queue.head + 1) % SPLIT_POINTING_QUEUE_SIZE;
+        queue->queue.count--;
+        record_depth(&queue->queue.metrics, queue->queue.count);
+    }
+    return true;
+}
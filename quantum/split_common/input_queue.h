@@ -0,0 +1,129 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef SPLIT_ENCODER_QUEUE_SIZE
+#    define SPLIT_ENCODER_QUEUE_SIZE 8
+#endif // SPLIT_ENCODER_QUEUE_SIZE
+
+#ifndef SPLIT_POINTING_QUEUE_SIZE
+#    define SPLIT_POINTING_QUEUE_SIZE 4
+#endif // SPLIT_POINTING_QUEUE_SIZE
+
+/* Slave input queues (SPLIT_ENCODER_QUEUE_ENABLE, SPLIT_POINTING_QUEUE_ENABLE).
+ *
+ * The slave numbers its input events with an 8 bit sequence and holds them
+ * until the master acknowledges them, so a lost exchange loses no input. Until
+ * it is first sent, the newest event absorbs more input of its kind: detents
+ * of the same encoder in the same direction, or motion with the same buttons.
+ *
+ * request  sequence of the newest event the master has applied
+ *
+ * [0]      frame length, including this byte and the checksum
+ * [1]      sequence of the newest event
+ * [2..]    every event the master has not acknowledged, oldest first
+ * [len-1]  crc8 of everything before it
+ *
+ * encoder event   (encoder index on the slave, signed change of its counter)
+ * pointing event  (buttons, x, y, h, v as signed 16 bit little endian)
+ */
+#define INPUT_QUEUE_OVERHEAD 3
+#define ENCODER_QUEUE_EVENT_SIZE 2
+#define POINTING_QUEUE_EVENT_SIZE 9
+#define ENCODER_QUEUE_FRAME_SIZE (INPUT_QUEUE_OVERHEAD + SPLIT_ENCODER_QUEUE_SIZE * ENCODER_QUEUE_EVENT_SIZE)
+#define POINTING_QUEUE_FRAME_SIZE (INPUT_QUEUE_OVERHEAD + SPLIT_POINTING_QUEUE_SIZE * POINTING_QUEUE_EVENT_SIZE)
+
+typedef struct {
+    uint8_t  depth;     // events held now
+    uint8_t  max_depth; // most events held at once
+    uint16_t full;      // input that had to wait for room
+} input_queue_metrics_t;
+
+typedef struct {
+    uint8_t               seq;    // sequence of the newest event
+    uint8_t               head;   // slot of the oldest event
+    uint8_t               count;  // events held
+    bool                  sealed; // the newest event has been sent and can no longer change
+    input_queue_metrics_t metrics;
+} input_queue_t;
+
+typedef struct {
+    uint8_t index;
+    int8_t  steps;
+} encoder_queue_event_t;
+
+typedef struct {
+    uint8_t buttons;
+    int16_t x;
+    int16_t y;
+    int16_t h;
+    int16_t v;
+} pointing_queue_event_t;
+
+typedef struct {
+    input_queue_t         queue;
+    encoder_queue_event_t events[SPLIT_ENCODER_QUEUE_SIZE];
+} encoder_queue_t;
+
+typedef struct {
+    input_queue_t          queue;
+    pointing_queue_event_t events[SPLIT_POINTING_QUEUE_SIZE];
+    pointing_queue_event_t pending; // input that found no room yet
+    uint8_t                buttons; // buttons of the newest queued event
+} pointing_queue_t;
+
+/* Queues `steps` of encoder `index`. Returns false, and queues nothing, if
+ * the steps neither fit the newest event nor find a free slot. */
+bool encoder_queue_push(encoder_queue_t *queue, uint8_t index, int8_t steps);
+
+/* Queues `event`, likewise. */
+bool pointing_queue_push(pointing_queue_t *queue, const pointing_queue_event_t *event);
+
+/* Queues driver input, or holds it in `pending` until there is room. Motion
+ * adds up meanwhile, but a change of buttons is held apart: returns false
+ * while one is waiting, and the caller must not read more input until a call
+ * with a NULL `event` has queued it, or a click made meanwhile would be lost. */
+bool pointing_queue_input(pointing_queue_t *queue, const pointing_queue_event_t *event);
+
+/* Adds the motion of `event` to `pending`, saturating, and takes its buttons.
+ * Returns false if any axis saturated. */
+bool pointing_queue_accumulate(pointing_queue_event_t *pending, const pointing_queue_event_t *event);
+
+/* Drops the events the master acknowledges with `request` and answers with
+ * the rest. Returns the frame length. */
+uint8_t encoder_queue_encode(encoder_queue_t *queue, uint8_t request, uint8_t *frame);
+uint8_t pointing_queue_encode(pointing_queue_t *queue, uint8_t request, uint8_t *frame);
+
+/* Checks `frame` and, only if it is intact, stores at most `max` of the events
+ * newer than `*applied` in `events` and advances `*applied` past them. If the
+ * frame does not reach back to `*applied`, as after either half restarted,
+ * every event in it counts as new. Records in `metrics` how many events the
+ * slave holds, and counts it as full if events had to be left for the next
+ * exchange. Returns how many events were stored, or -1 if the frame is
+ * damaged. */
+int8_t encoder_queue_decode(const uint8_t *frame, uint8_t size, uint8_t *applied, encoder_queue_event_t *events, uint8_t max, input_queue_metrics_t *metrics);
+int8_t pointing_queue_decode(const uint8_t *frame, uint8_t size, uint8_t *applied, pointing_queue_event_t *events, uint8_t max, input_queue_metrics_t *metrics);
+
+/* Takes the oldest queued event, with at most `xy_limit` of motion on x and y
+ * and `hv_limit` on h and v, and leaves the rest of its motion for the next
+ * take. An event is dropped once all of its motion is taken, so every button
+ * state is taken exactly once. Returns false if nothing is queued, the buttons
+ * then stay as last taken. */
+bool pointing_queue_take(pointing_queue_t *queue, int16_t xy_limit, int16_t hv_limit, pointing_queue_event_t *event);
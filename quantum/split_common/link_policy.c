@@ -0,0 +1,148 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "debug.h"
+#include "link_policy.h"
+#include "timer.h"
+#include "util.h"
+#include "wait.h"
+
+#define QUALITY_SMOOTHING 4 // each attempt moves the quality 1/16th of the way
+#define RECOVERY_MARGIN 5   // percent above the threshold before a tier comes back
+#define MAX_HOLD_SHIFT 5
+
+// Quality in percent a tier needs to be synced
+static const uint8_t keep_above[SPLIT_SYNC_PRIORITY_COUNT] = {
+    [SPLIT_SYNC_PRIORITY_CRITICAL] = 0,
+    [SPLIT_SYNC_PRIORITY_HIGH]     = 50,
+    [SPLIT_SYNC_PRIORITY_NORMAL]   = 75,
+    [SPLIT_SYNC_PRIORITY_LOW]      = 90,
+};
+
+void split_link_init(split_link_policy_t *link) {
+    memset(link, 0, sizeof(*link));
+    link->quality         = UINT16_MAX;
+    link->lowest_priority = SPLIT_SYNC_PRIORITY_LOW;
+}
+
+void split_link_record(split_link_policy_t *link, int8_t id, bool success) {
+    if (id < 0 || id >= NUM_TOTAL_TRANSACTIONS) {
+        return;
+    }
+    uint16_t *counter = success ? &link->counters[id].successes : &link->counters[id].failures;
+    if (*counter < UINT16_MAX) {
+        (*counter)++;
+    }
+    link->exchanges++;
+    link->last_id = id;
+}
+
+uint8_t split_link_quality_percent(const split_link_policy_t *link) {
+    return (uint32_t)link->quality * 100 / UINT16_MAX;
+}
+
+static void update_quality(split_link_policy_t *link, bool success) {
+    int32_t target = success ? UINT16_MAX : 0;
+    link->quality += (target - (int32_t)link->quality) / (1 << QUALITY_SMOOTHING);
+
+    uint8_t percent = split_link_quality_percent(link);
+    uint8_t lowest  = SPLIT_SYNC_PRIORITY_CRITICAL;
+    for (uint8_t tier = SPLIT_SYNC_PRIORITY_HIGH; tier < SPLIT_SYNC_PRIORITY_COUNT; tier++) {
+        uint8_t needed = keep_above[tier] + (tier > link->lowest_priority ? RECOVERY_MARGIN : 0);
+        if (percent < needed) {
+            break;
+        }
+        lowest = tier;
+    }
+
+    if (lowest != link->lowest_priority) {
+        link->lowest_priority = lowest;
+        dprintf("split link: quality %u%%, syncing priority %u and up\n", percent, lowest);
+    }
+}
+
+static bool is_allowed(const split_link_policy_t *link, uint8_t item, uint8_t priority) {
+    if (priority == SPLIT_SYNC_PRIORITY_CRITICAL) {
+        return true;
+    }
+    if (priority > link->lowest_priority) {
+        return false;
+    }
+    return item >= SPLIT_SYNC_ITEM_COUNT || link->strikes[item] == 0 || timer_expired(timer_read(), link->hold_until[item]);
+}
+
+static void finish(split_link_policy_t *link, uint8_t item, uint8_t priority, bool success) {
+    if (item >= SPLIT_SYNC_ITEM_COUNT || priority == SPLIT_SYNC_PRIORITY_CRITICAL) {
+        return;
+    }
+    if (success) {
+        link->strikes[item] = 0;
+        return;
+    }
+    if (link->strikes[item] < UINT8_MAX) {
+        link->strikes[item]++;
+    }
+    link->hold_until[item] = timer_read() + (SPLIT_LINK_HOLD_MS << MIN(link->strikes[item] - 1, MAX_HOLD_SHIFT));
+}
+
+bool split_link_run(split_link_policy_t *link, const char *name, uint8_t item, uint8_t priority, bool connected, split_link_handler_t handler, matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    if (!is_allowed(link, item, priority)) {
+        return true;
+    }
+
+    uint8_t attempts = 1;
+    if (connected) {
+        attempts = priority == SPLIT_SYNC_PRIORITY_CRITICAL ? SPLIT_LINK_CRITICAL_ATTEMPTS : (link->lowest_priority == SPLIT_SYNC_PRIORITY_LOW ? 2 : 1);
+    }
+
+    for (uint8_t attempt = 1; attempt <= attempts; attempt++) {
+        if (attempt > 1) {
+            if (link->counters[link->last_id].retries < UINT16_MAX) {
+                link->counters[link->last_id].retries++;
+            }
+            for (uint16_t i = 0; i < attempt * attempt; i++) {
+                wait_us(SPLIT_LINK_RETRY_DELAY_US);
+            }
+        }
+
+        uint16_t exchanges = link->exchanges;
+        bool     success   = handler(master_matrix, slave_matrix);
+        // runs that had nothing to send say nothing about the link
+        if (!success || link->exchanges != exchanges) {
+            update_quality(link, success);
+        }
+        if (success) {
+            finish(link, item, priority, true);
+            return true;
+        }
+    }
+
+    dprintf("Failed to execute %s\n", name);
+    finish(link, item, priority, false);
+    return priority != SPLIT_SYNC_PRIORITY_CRITICAL;
+}
+
+void split_link_print_stats(const split_link_policy_t *link) {
+    dprintf("split link: quality %u%%, syncing priority %u and up\n", split_link_quality_percent(link), link->lowest_priority);
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        const split_link_counters_t *counters = &link->counters[id];
+        if (counters->successes || counters->failures) {
+            dprintf("  %d: %u ok, %u failed, %u retries\n", id, counters->successes, counters->failures, counters->retries);
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "matrix.h"
+#include "transaction_id_define.h"
+#include "sync_scheduler.h"
+
+#ifndef SPLIT_LINK_CRITICAL_ATTEMPTS
+#    define SPLIT_LINK_CRITICAL_ATTEMPTS 5
+#endif // SPLIT_LINK_CRITICAL_ATTEMPTS
+
+#ifndef SPLIT_LINK_RETRY_DELAY_US
+#    define SPLIT_LINK_RETRY_DELAY_US 10
+#endif // SPLIT_LINK_RETRY_DELAY_US
+
+#ifndef SPLIT_LINK_HOLD_MS
+#    define SPLIT_LINK_HOLD_MS 8
+#endif // SPLIT_LINK_HOLD_MS
+
+/* Split link retry policy.
+ *
+ * Critical items get SPLIT_LINK_CRITICAL_ATTEMPTS attempts per run, the others
+ * two while the link is healthy and one otherwise. A non-critical item that
+ * fails is left alone for SPLIT_LINK_HOLD_MS, doubling with every further
+ * failure. As the link quality drops, whole tiers are shed starting with the
+ * lowest priority, until only critical items are left.
+ */
+typedef struct {
+    uint16_t successes;
+    uint16_t failures;
+    uint16_t retries;
+} split_link_counters_t;
+
+typedef struct {
+    split_link_counters_t counters[NUM_TOTAL_TRANSACTIONS];
+    uint16_t              exchanges;       // total, to tell whether a run touched the bus
+    int8_t                last_id;         // transaction ID of the last exchange
+    uint16_t              quality;         // moving average of attempt success, UINT16_MAX is perfect
+    uint8_t               lowest_priority; // lowest priority tier still synced
+    uint8_t               strikes[SPLIT_SYNC_ITEM_COUNT];
+    uint16_t              hold_until[SPLIT_SYNC_ITEM_COUNT];
+} split_link_policy_t;
+
+typedef bool (*split_link_handler_t)(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+
+void split_link_init(split_link_policy_t *link);
+
+/* Counts one exchange of transaction `id`. */
+void split_link_record(split_link_policy_t *link, int8_t id, bool success);
+
+/* Runs `handler` for sync item `item` (SPLIT_SYNC_ITEM_COUNT for none) as the
+ * policy allows. Returns false only when a critical item failed. */
+bool split_link_run(split_link_policy_t *link, const char *name, uint8_t item, uint8_t priority, bool connected, split_link_handler_t handler, matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+
+uint8_t split_link_quality_percent(const split_link_policy_t *link);
+
+void split_link_print_stats(const split_link_policy_t *link);
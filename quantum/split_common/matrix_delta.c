@@ -0,0 +1,92 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "crc.h"
+#include "matrix_delta.h"
+
+void matrix_delta_record(matrix_delta_log_t *log, const matrix_row_t matrix[]) {
+    for (uint8_t row = 0; row < MATRIX_DELTA_ROWS; row++) {
+        if (matrix[row] == log->matrix[row]) {
+            continue;
+        }
+        log->matrix[row]        = matrix[row];
+        log->seq                = (log->seq + 1) & MATRIX_DELTA_SEQ_MASK;
+        log->entries[log->head] = (matrix_delta_entry_t){.row = row, .value = matrix[row]};
+        log->head               = (log->head + 1) % SPLIT_MATRIX_DELTA_HISTORY;
+        if (log->count < SPLIT_MATRIX_DELTA_HISTORY) {
+            log->count++;
+        }
+    }
+}
+
+uint8_t matrix_delta_encode(const matrix_delta_log_t *log, uint8_t request, uint8_t *frame) {
+    uint8_t gap    = (log->seq - request) & MATRIX_DELTA_SEQ_MASK;
+    uint8_t length = 2;
+
+    if ((request & MATRIX_DELTA_RESYNC) || gap > log->count || gap * MATRIX_DELTA_ENTRY_SIZE >= MATRIX_DELTA_SNAPSHOT_SIZE) {
+        memcpy(&frame[length], log->matrix, MATRIX_DELTA_SNAPSHOT_SIZE);
+        length += MATRIX_DELTA_SNAPSHOT_SIZE;
+        frame[1] = log->seq | MATRIX_DELTA_FULL;
+    } else {
+        // oldest change the master is missing first
+        uint8_t index = (log->head + SPLIT_MATRIX_DELTA_HISTORY - gap) % SPLIT_MATRIX_DELTA_HISTORY;
+        for (uint8_t i = 0; i < gap; i++) {
+            frame[length] = log->entries[index].row;
+            memcpy(&frame[length + 1], &log->entries[index].value, sizeof(matrix_row_t));
+            length += MATRIX_DELTA_ENTRY_SIZE;
+            index = (index + 1) % SPLIT_MATRIX_DELTA_HISTORY;
+        }
+        frame[1] = log->seq;
+    }
+
+    frame[0]      = length + 1;
+    frame[length] = crc8(frame, length);
+    return length + 1;
+}
+
+bool matrix_delta_decode(const uint8_t *frame, uint8_t size, matrix_row_t matrix[], uint8_t *seq, bool *full) {
+    uint8_t length = frame[0];
+    if (length < MATRIX_DELTA_OVERHEAD || length > size || crc8(frame, length - 1) != frame[length - 1]) {
+        return false;
+    }
+
+    uint8_t payload = length - MATRIX_DELTA_OVERHEAD;
+    if (frame[1] & MATRIX_DELTA_FULL) {
+        if (payload != MATRIX_DELTA_SNAPSHOT_SIZE) {
+            return false;
+        }
+        memcpy(matrix, &frame[2], MATRIX_DELTA_SNAPSHOT_SIZE);
+    } else {
+        if (payload % MATRIX_DELTA_ENTRY_SIZE != 0) {
+            return false;
+        }
+        for (uint8_t i = 2; i < length - 1; i += MATRIX_DELTA_ENTRY_SIZE) {
+            if (frame[i] >= MATRIX_DELTA_ROWS) {
+                return false;
+            }
+        }
+        // later changes to the same row win
+        for (uint8_t i = 2; i < length - 1; i += MATRIX_DELTA_ENTRY_SIZE) {
+            memcpy(&matrix[frame[i]], &frame[i + 1], sizeof(matrix_row_t));
+        }
+    }
+
+    *seq  = frame[1] & MATRIX_DELTA_SEQ_MASK;
+    *full = frame[1] & MATRIX_DELTA_FULL;
+    return true;
+}
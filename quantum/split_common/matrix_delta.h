@@ -0,0 +1,75 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "matrix.h"
+#include "util.h"
+
+#ifndef SPLIT_MATRIX_DELTA_HISTORY
+#    define SPLIT_MATRIX_DELTA_HISTORY 8
+#endif // SPLIT_MATRIX_DELTA_HISTORY
+
+/* Slave matrix delta transfer (SPLIT_MATRIX_DELTA_ENABLE).
+ *
+ * The slave numbers every row change with a 7 bit sequence. The master sends
+ * the sequence it has applied, the slave answers with the changes since then:
+ *
+ * request  sequence the master has applied, | MATRIX_DELTA_RESYNC for a snapshot
+ *
+ * [0]      frame length, including this byte and the checksum
+ * [1]      sequence of the newest change, | MATRIX_DELTA_FULL for a snapshot
+ * [2..]    snapshot: every row of the half
+ *          delta: (row, new row value) per change, oldest first
+ * [len-1]  crc8 of everything before it
+ */
+#define MATRIX_DELTA_ROWS ((MATRIX_ROWS) / 2)
+#define MATRIX_DELTA_SEQ_MASK 0x7F
+#define MATRIX_DELTA_RESYNC 0x80
+#define MATRIX_DELTA_FULL 0x80
+
+#define MATRIX_DELTA_OVERHEAD 3
+#define MATRIX_DELTA_ENTRY_SIZE (1 + sizeof(matrix_row_t))
+#define MATRIX_DELTA_SNAPSHOT_SIZE (MATRIX_DELTA_ROWS * sizeof(matrix_row_t))
+#define MATRIX_DELTA_FRAME_SIZE (MATRIX_DELTA_OVERHEAD + MAX(MATRIX_DELTA_SNAPSHOT_SIZE, SPLIT_MATRIX_DELTA_HISTORY * MATRIX_DELTA_ENTRY_SIZE))
+
+typedef struct {
+    uint8_t      row;
+    matrix_row_t value;
+} matrix_delta_entry_t;
+
+typedef struct {
+    matrix_row_t         matrix[MATRIX_DELTA_ROWS]; // state after the newest change
+    uint8_t              seq;                       // sequence of the newest change
+    uint8_t              head;                      // where the next change goes
+    uint8_t              count;                     // changes still held
+    matrix_delta_entry_t entries[SPLIT_MATRIX_DELTA_HISTORY];
+} matrix_delta_log_t;
+
+/* Records every row of `matrix` that differs from the last recorded state. */
+void matrix_delta_record(matrix_delta_log_t *log, const matrix_row_t matrix[]);
+
+/* Answers a master request with the changes it has not applied yet, or with
+ * a snapshot if it asks for one or those changes are no longer held or would
+ * not be shorter. Returns the frame length. */
+uint8_t matrix_delta_encode(const matrix_delta_log_t *log, uint8_t request, uint8_t *frame);
+
+/* Checks `frame` and, only if it is intact, applies it to `matrix`. Stores the
+ * sequence it brings the matrix to and whether it was a snapshot. */
+bool matrix_delta_decode(const uint8_t *frame, uint8_t size, matrix_row_t matrix[], uint8_t *seq, bool *full);
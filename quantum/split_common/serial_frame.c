@@ -0,0 +1,43 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "crc.h"
+#include "serial_frame.h"
+
+uint16_t serial_frame_encode(uint8_t *frame, uint8_t id, const void *payload, uint8_t length) {
+    frame[0] = id;
+    if (length) {
+        memcpy(&frame[1], payload, length);
+    }
+    frame[1 + length] = crc8(frame, 1 + length);
+    return SERIAL_FRAME_OVERHEAD + length;
+}
+
+uint8_t serial_frame_payload_length(const uint8_t *frame, uint8_t size, bool length_prefixed) {
+    return (length_prefixed && frame[1] > 0 && frame[1] < size) ? frame[1] : size;
+}
+
+bool serial_frame_decode(const uint8_t *frame, uint8_t id, void *payload, uint8_t length) {
+    if (frame[0] != id || crc8(frame, 1 + length) != frame[1 + length]) {
+        return false;
+    }
+    if (length) {
+        memcpy(payload, &frame[1], length);
+    }
+    return true;
+}
@@ -0,0 +1,43 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Serial transaction frame (SERIAL_USART_PIPELINE), one per direction.
+ *
+ * [0]        transaction ID, XORed with NUM_TOTAL_TRANSACTIONS in replies
+ * [1..]      payload, as long as the transaction buffer, or as its first
+ *            byte says for a length prefixed buffer
+ * [length+1] crc8 of everything before it
+ *
+ * Both halves know the buffer sizes from split_transaction_table, so the
+ * frame does not carry a length of its own.
+ */
+#define SERIAL_FRAME_OVERHEAD 2
+#define SERIAL_FRAME_MAX_SIZE (UINT8_MAX + SERIAL_FRAME_OVERHEAD)
+
+/* Builds a frame carrying `length` bytes of `payload`. Returns the frame size. */
+uint16_t serial_frame_encode(uint8_t *frame, uint8_t id, const void *payload, uint8_t length);
+
+/* Payload length of a frame for a `size` byte buffer, once frame[1] is in. */
+uint8_t serial_frame_payload_length(const uint8_t *frame, uint8_t size, bool length_prefixed);
+
+/* Checks that `frame` is intact and for transaction `id`, then copies its
+ * `length` bytes of payload to `payload`. */
+bool serial_frame_decode(const uint8_t *frame, uint8_t id, void *payload, uint8_t length);
@@ -0,0 +1,84 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "sync_scheduler.h"
+#include "util.h"
+
+#define STATS_WINDOW_MS 1000
+
+void split_sync_scheduler_init(split_sync_scheduler_t *scheduler, const split_sync_schedule_t *schedule, uint16_t budget, uint32_t now) {
+    memset(scheduler, 0, sizeof(*scheduler));
+    scheduler->schedule     = schedule;
+    scheduler->budget       = budget;
+    scheduler->window_start = now;
+    for (uint8_t item = 0; item < SPLIT_SYNC_ITEM_COUNT; item++) {
+        // everything is due on the first scan
+        scheduler->last_run[item] = now - schedule[item].max_interval;
+    }
+}
+
+void split_sync_begin_scan(split_sync_scheduler_t *scheduler) {
+    scheduler->used = 0;
+    memcpy(scheduler->start, scheduler->next, sizeof(scheduler->start));
+}
+
+bool split_sync_in_turn(const split_sync_scheduler_t *scheduler, uint8_t item, uint8_t pass) {
+    return (item >= scheduler->start[scheduler->schedule[item].priority]) == (pass == 0);
+}
+
+bool split_sync_due(const split_sync_scheduler_t *scheduler, uint8_t item, uint32_t now) {
+    const split_sync_schedule_t *schedule = &scheduler->schedule[item];
+    if (schedule->priority == SPLIT_SYNC_PRIORITY_CRITICAL) {
+        return true;
+    }
+
+    uint32_t elapsed = now - scheduler->last_run[item];
+    if (elapsed < schedule->min_interval) {
+        return false;
+    }
+    // overdue items run even when the budget is spent, so nothing starves
+    return elapsed >= schedule->max_interval || scheduler->used < scheduler->budget;
+}
+
+void split_sync_done(split_sync_scheduler_t *scheduler, uint8_t item, uint16_t bytes, uint32_t now) {
+    const split_sync_schedule_t *schedule = &scheduler->schedule[item];
+    if (schedule->priority != SPLIT_SYNC_PRIORITY_CRITICAL) {
+        // critical items all run every scan, in their usual order
+        scheduler->next[schedule->priority] = item + 1;
+    }
+    scheduler->last_run[item] = now;
+    scheduler->runs[item]++;
+    scheduler->used += bytes;
+    scheduler->window_bytes += bytes;
+}
+
+bool split_sync_end_scan(split_sync_scheduler_t *scheduler, uint32_t now) {
+    scheduler->window_scans++;
+    if (now - scheduler->window_start < STATS_WINDOW_MS) {
+        return false;
+    }
+
+    memcpy(scheduler->rate, scheduler->runs, sizeof(scheduler->rate));
+    memset(scheduler->runs, 0, sizeof(scheduler->runs));
+    scheduler->bus_load        = scheduler->window_bytes;
+    scheduler->bus_utilization = scheduler->budget ? MIN(scheduler->window_bytes * 100 / ((uint32_t)scheduler->budget * scheduler->window_scans), UINT16_MAX) : 0;
+    scheduler->window_start    = now;
+    scheduler->window_bytes    = 0;
+    scheduler->window_scans    = 0;
+    return true;
+}
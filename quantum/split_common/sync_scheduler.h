@@ -0,0 +1,101 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef SPLIT_SYNC_BUS_BUDGET
+#    define SPLIT_SYNC_BUS_BUDGET 32
+#endif // SPLIT_SYNC_BUS_BUDGET
+
+/* Split sync scheduler (SPLIT_SYNC_SCHEDULER_ENABLE).
+ *
+ * Every scan the master runs the sync items tier by tier. Critical items run
+ * every scan. The others run at most every min_interval ms, and only while
+ * the bus bytes spent this scan are below the budget, unless they have not
+ * run for max_interval ms. max_interval is also how often an item resends
+ * unchanged data. A tier is run in two passes over its items, the first
+ * starting after the item that ran last, so the items the budget cut off go
+ * first on the next scan.
+ */
+typedef enum {
+    SPLIT_SYNC_PRIORITY_CRITICAL,
+    SPLIT_SYNC_PRIORITY_HIGH,
+    SPLIT_SYNC_PRIORITY_NORMAL,
+    SPLIT_SYNC_PRIORITY_LOW,
+    SPLIT_SYNC_PRIORITY_COUNT,
+} split_sync_priority_t;
+
+typedef enum {
+    SPLIT_SYNC_SLAVE_MATRIX,
+    SPLIT_SYNC_MASTER_MATRIX,
+    SPLIT_SYNC_ENCODERS,
+    SPLIT_SYNC_SYNC_TIMER,
+    SPLIT_SYNC_LAYER_STATE,
+    SPLIT_SYNC_LED_STATE,
+    SPLIT_SYNC_MODS,
+    SPLIT_SYNC_BACKLIGHT,
+    SPLIT_SYNC_RGBLIGHT,
+    SPLIT_SYNC_LED_MATRIX,
+    SPLIT_SYNC_RGB_MATRIX,
+    SPLIT_SYNC_WPM,
+    SPLIT_SYNC_OLED,
+    SPLIT_SYNC_ST7565,
+    SPLIT_SYNC_DISPLAY_STATE,
+    SPLIT_SYNC_POINTING,
+    SPLIT_SYNC_STREAM,
+    SPLIT_SYNC_ITEM_COUNT,
+} split_sync_item_t;
+
+typedef struct {
+    uint8_t  priority;
+    uint16_t min_interval;
+    uint16_t max_interval;
+} split_sync_schedule_t;
+
+typedef struct {
+    const split_sync_schedule_t *schedule; // SPLIT_SYNC_ITEM_COUNT entries
+    uint16_t                     budget;   // bus bytes per scan
+    uint16_t                     used;     // bus bytes spent this scan
+    uint8_t                      start[SPLIT_SYNC_PRIORITY_COUNT]; // first item of each tier's first pass this scan
+    uint8_t                      next[SPLIT_SYNC_PRIORITY_COUNT];  // the same for the next scan
+    uint32_t                     last_run[SPLIT_SYNC_ITEM_COUNT];
+    uint16_t                     runs[SPLIT_SYNC_ITEM_COUNT];
+    uint16_t                     rate[SPLIT_SYNC_ITEM_COUNT]; // runs in the last second
+    uint32_t                     window_start;
+    uint32_t                     window_bytes;
+    uint32_t                     window_scans;
+    uint32_t                     bus_load;        // bus bytes in the last second
+    uint16_t                     bus_utilization; // percent of the budget used per scan in the last second
+} split_sync_scheduler_t;
+
+void split_sync_scheduler_init(split_sync_scheduler_t *scheduler, const split_sync_schedule_t *schedule, uint16_t budget, uint32_t now);
+
+void split_sync_begin_scan(split_sync_scheduler_t *scheduler);
+
+/* Whether `item` comes up in `pass` (0 or 1) of its tier. */
+bool split_sync_in_turn(const split_sync_scheduler_t *scheduler, uint8_t item, uint8_t pass);
+
+/* Whether `item` should run now. */
+bool split_sync_due(const split_sync_scheduler_t *scheduler, uint8_t item, uint32_t now);
+
+/* Records that `item` ran and spent `bytes` of bus time. */
+void split_sync_done(split_sync_scheduler_t *scheduler, uint8_t item, uint16_t bytes, uint32_t now);
+
+/* Returns true once a second, when the rates and bus figures were updated. */
+bool split_sync_end_scan(split_sync_scheduler_t *scheduler, uint32_t now);
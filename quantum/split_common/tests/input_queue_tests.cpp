@@ -0,0 +1,367 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <cstdlib>
+#include <cstring>
+
+extern "C" {
+#include "input_queue.h"
+}
+
+class InputQueue : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        memset(&encoders, 0, sizeof(encoders));
+        memset(&pointing, 0, sizeof(pointing));
+        memset(&metrics, 0, sizeof(metrics));
+        memset(frame, 0, sizeof(frame));
+        applied = 0;
+    }
+
+    // Runs one encoder exchange, returns the number of events applied
+    int8_t exchange_encoders(uint8_t max = SPLIT_ENCODER_QUEUE_SIZE) {
+        encoder_queue_encode(&encoders, applied, frame);
+        return encoder_queue_decode(frame, sizeof(frame), &applied, encoder_events, max, &metrics);
+    }
+
+    int8_t exchange_pointing(uint8_t max = SPLIT_POINTING_QUEUE_SIZE) {
+        pointing_queue_encode(&pointing, applied, frame);
+        return pointing_queue_decode(frame, sizeof(frame), &applied, pointing_events, max, &metrics);
+    }
+
+    encoder_queue_t        encoders;
+    pointing_queue_t       pointing;
+    input_queue_metrics_t  metrics;
+    encoder_queue_event_t  encoder_events[SPLIT_ENCODER_QUEUE_SIZE];
+    pointing_queue_event_t pointing_events[SPLIT_POINTING_QUEUE_SIZE];
+    uint8_t                frame[POINTING_QUEUE_FRAME_SIZE];
+    uint8_t                applied;
+};
+
+TEST_F(InputQueue, EmptyQueueSendsEmptyFrame) {
+    EXPECT_EQ(encoder_queue_encode(&encoders, 0, frame), INPUT_QUEUE_OVERHEAD);
+    EXPECT_EQ(encoder_queue_decode(frame, sizeof(frame), &applied, encoder_events, SPLIT_ENCODER_QUEUE_SIZE, &metrics), 0);
+    EXPECT_EQ(applied, 0);
+}
+
+TEST_F(InputQueue, EncoderStepsArriveInOrder) {
+    EXPECT_TRUE(encoder_queue_push(&encoders, 0, 1));
+    EXPECT_TRUE(encoder_queue_push(&encoders, 1, -2));
+
+    ASSERT_EQ(exchange_encoders(), 2);
+    EXPECT_EQ(encoder_events[0].index, 0);
+    EXPECT_EQ(encoder_events[0].steps, 1);
+    EXPECT_EQ(encoder_events[1].index, 1);
+    EXPECT_EQ(encoder_events[1].steps, -2);
+    EXPECT_EQ(applied, 2);
+}
+
+TEST_F(InputQueue, NewestEventAbsorbsStepsUntilSent) {
+    encoder_queue_push(&encoders, 0, 1);
+    encoder_queue_push(&encoders, 0, 2);
+    EXPECT_EQ(encoders.queue.count, 1);
+    EXPECT_EQ(encoders.events[0].steps, 3);
+
+    // Reversing direction or sending the event ends it
+    encoder_queue_push(&encoders, 0, -1);
+    EXPECT_EQ(encoders.queue.count, 2);
+    encoder_queue_encode(&encoders, 0, frame);
+    encoder_queue_push(&encoders, 0, -1);
+    EXPECT_EQ(encoders.queue.count, 3);
+
+    // as does a sum that would not fit
+    encoder_queue_push(&encoders, 1, 100);
+    encoder_queue_push(&encoders, 1, 100);
+    EXPECT_EQ(encoders.queue.count, 5);
+}
+
+TEST_F(InputQueue, LostFramesAreSentAgain) {
+    encoder_queue_push(&encoders, 0, 1);
+    encoder_queue_encode(&encoders, applied, frame); // never arrives
+    encoder_queue_push(&encoders, 0, 1);
+
+    ASSERT_EQ(exchange_encoders(), 2);
+    EXPECT_EQ(encoder_events[0].steps, 1);
+    EXPECT_EQ(encoder_events[1].steps, 1);
+
+    // The acknowledgement frees the queue
+    encoder_queue_encode(&encoders, applied, frame);
+    EXPECT_EQ(encoders.queue.count, 0);
+}
+
+TEST_F(InputQueue, StaleRequestDoesNotApplyEventsTwice) {
+    encoder_queue_push(&encoders, 0, 1);
+    ASSERT_EQ(exchange_encoders(), 1);
+
+    // Answering a request from before the last exchange
+    encoder_queue_push(&encoders, 0, 1);
+    encoder_queue_encode(&encoders, 0, frame);
+    ASSERT_EQ(encoder_queue_decode(frame, sizeof(frame), &applied, encoder_events, SPLIT_ENCODER_QUEUE_SIZE, &metrics), 1);
+    EXPECT_EQ(applied, 2);
+}
+
+TEST_F(InputQueue, DamagedFrameIsRejected) {
+    encoder_queue_push(&encoders, 0, 1);
+    encoder_queue_encode(&encoders, applied, frame);
+    frame[2] ^= 0x04;
+
+    EXPECT_EQ(encoder_queue_decode(frame, sizeof(frame), &applied, encoder_events, SPLIT_ENCODER_QUEUE_SIZE, &metrics), -1);
+    EXPECT_EQ(applied, 0);
+}
+
+TEST_F(InputQueue, RestartedSlaveIsAppliedInFull) {
+    applied = 200;
+    encoder_queue_push(&encoders, 0, 1);
+    encoder_queue_push(&encoders, 1, 1);
+
+    EXPECT_EQ(exchange_encoders(), 2);
+    EXPECT_EQ(applied, 2);
+    EXPECT_EQ(exchange_encoders(), 0);
+}
+
+TEST_F(InputQueue, FullQueueRefusesAndCounts) {
+    for (uint8_t i = 0; i < SPLIT_ENCODER_QUEUE_SIZE; i++) {
+        EXPECT_TRUE(encoder_queue_push(&encoders, i % 2, 1));
+    }
+    EXPECT_FALSE(encoder_queue_push(&encoders, 0, 1));
+    EXPECT_EQ(encoders.queue.metrics.depth, SPLIT_ENCODER_QUEUE_SIZE);
+    EXPECT_EQ(encoders.queue.metrics.max_depth, SPLIT_ENCODER_QUEUE_SIZE);
+    EXPECT_EQ(encoders.queue.metrics.full, 1);
+
+    // The master sees the depth too, and can leave events for later
+    EXPECT_EQ(exchange_encoders(3), 3);
+    EXPECT_EQ(metrics.depth, SPLIT_ENCODER_QUEUE_SIZE);
+    EXPECT_EQ(metrics.full, 1);
+    EXPECT_EQ(exchange_encoders(), SPLIT_ENCODER_QUEUE_SIZE - 3);
+    EXPECT_EQ(encoders.queue.metrics.depth, SPLIT_ENCODER_QUEUE_SIZE - 3);
+    EXPECT_EQ(exchange_encoders(), 0);
+    EXPECT_EQ(encoders.queue.metrics.depth, 0);
+}
+
+TEST_F(InputQueue, FastSpinningEncodersLoseNoSteps) {
+    // The slave's counters keep steps that find no room, like the encoder handler
+    uint8_t counter[3]  = {0};
+    uint8_t queued[3]   = {0};
+    int32_t spun[3]     = {0};
+    int32_t received[3] = {0};
+    srand(7);
+
+    for (int scan = 0; scan < 20000; scan++) {
+        for (uint8_t i = 0; i < 3; i++) {
+            int8_t steps = rand() % 7 - 3;
+            counter[i] += steps;
+            spun[i] += steps;
+            int8_t pending = counter[i] - queued[i];
+            if (pending && encoder_queue_push(&encoders, i, pending)) {
+                queued[i] = counter[i];
+            }
+        }
+        // Syncs are skipped and frames lost now and then
+        if (rand() % 4 == 0) {
+            continue;
+        }
+        encoder_queue_encode(&encoders, applied, frame);
+        if (rand() % 5 == 0) {
+            frame[1 + rand() % (frame[0] - 1)] ^= 0x10;
+        }
+        int8_t count = encoder_queue_decode(frame, sizeof(frame), &applied, encoder_events, SPLIT_ENCODER_QUEUE_SIZE, &metrics);
+        for (int8_t e = 0; e < count; e++) {
+            received[encoder_events[e].index] += encoder_events[e].steps;
+        }
+    }
+    for (uint8_t i = 0; i < 20; i++) {
+        encoder_queue_encode(&encoders, applied, frame);
+        int8_t count = encoder_queue_decode(frame, sizeof(frame), &applied, encoder_events, SPLIT_ENCODER_QUEUE_SIZE, &metrics);
+        for (int8_t e = 0; e < count; e++) {
+            received[encoder_events[e].index] += encoder_events[e].steps;
+        }
+    }
+
+    for (uint8_t i = 0; i < 3; i++) {
+        EXPECT_EQ(received[i] + (int8_t)(counter[i] - queued[i]), spun[i]);
+    }
+    EXPECT_GT(encoders.queue.metrics.full, 0);
+    printf("max depth %u, full %u\n", encoders.queue.metrics.max_depth, encoders.queue.metrics.full);
+}
+
+TEST_F(InputQueue, PointingEventsKeepButtonsAndMotion) {
+    pointing_queue_event_t moved   = {.buttons = 0, .x = 300, .y = -2, .h = 0, .v = -1};
+    pointing_queue_event_t clicked = {.buttons = 1, .x = 0, .y = 0, .h = 0, .v = 0};
+    pointing_queue_push(&pointing, &moved);
+    pointing_queue_push(&pointing, &moved);
+    pointing_queue_push(&pointing, &clicked);
+
+    ASSERT_EQ(exchange_pointing(), 2);
+    EXPECT_EQ(pointing_events[0].buttons, 0);
+    EXPECT_EQ(pointing_events[0].x, 600);
+    EXPECT_EQ(pointing_events[0].y, -4);
+    EXPECT_EQ(pointing_events[0].v, -2);
+    EXPECT_EQ(pointing_events[1].buttons, 1);
+    EXPECT_EQ(pointing_events[1].x, 0);
+}
+
+TEST_F(InputQueue, PointingAccumulateSaturates) {
+    pointing_queue_event_t pending = {.buttons = 0, .x = INT16_MAX - 1, .y = INT16_MIN + 1, .h = 0, .v = 0};
+    pointing_queue_event_t event   = {.buttons = 2, .x = 5, .y = -5, .h = 1, .v = 0};
+
+    EXPECT_FALSE(pointing_queue_accumulate(&pending, &event));
+    EXPECT_EQ(pending.buttons, 2);
+    EXPECT_EQ(pending.x, INT16_MAX);
+    EXPECT_EQ(pending.y, INT16_MIN);
+    EXPECT_EQ(pending.h, 1);
+
+    // and the queue starts a new event rather than overflow
+    pointing_queue_push(&pointing, &pending);
+    pointing_queue_push(&pointing, &event);
+    EXPECT_EQ(pointing.queue.count, 2);
+}
+
+TEST_F(InputQueue, TakeSplitsMotionToReportSize) {
+    pointing_queue_event_t moved = {.buttons = 0, .x = 1000, .y = -300, .h = 0, .v = 200};
+    pointing_queue_event_t event;
+    pointing_queue_push(&pointing, &moved);
+
+    int32_t x = 0, y = 0, v = 0, takes = 0;
+    while (pointing_queue_take(&pointing, 127, 127, &event)) {
+        EXPECT_LE(abs(event.x), 127);
+        EXPECT_LE(abs(event.y), 127);
+        EXPECT_LE(abs(event.v), 127);
+        x += event.x;
+        y += event.y;
+        v += event.v;
+        takes++;
+    }
+    EXPECT_EQ(x, 1000);
+    EXPECT_EQ(y, -300);
+    EXPECT_EQ(v, 200);
+    EXPECT_EQ(takes, 8);
+}
+
+TEST_F(InputQueue, TakeReportsEveryButtonStateOnce) {
+    pointing_queue_event_t pressed  = {.buttons = 1, .x = 0, .y = 0, .h = 0, .v = 0};
+    pointing_queue_event_t released = {.buttons = 0, .x = 0, .y = 0, .h = 0, .v = 0};
+    pointing_queue_event_t event;
+    pointing_queue_push(&pointing, &pressed);
+    pointing_queue_push(&pointing, &released);
+
+    ASSERT_TRUE(pointing_queue_take(&pointing, 127, 127, &event));
+    EXPECT_EQ(event.buttons, 1);
+    ASSERT_TRUE(pointing_queue_take(&pointing, 127, 127, &event));
+    EXPECT_EQ(event.buttons, 0);
+    EXPECT_FALSE(pointing_queue_take(&pointing, 127, 127, &event));
+}
+
+TEST_F(InputQueue, ButtonChangeWaitsForRoom) {
+    pointing_queue_event_t event;
+    for (int16_t i = 0; i < SPLIT_POINTING_QUEUE_SIZE; i++) {
+        event = {.buttons = 0, .x = (int16_t)(i + 1), .y = 0, .h = 0, .v = 0};
+        EXPECT_TRUE(pointing_queue_input(&pointing, &event));
+        exchange_pointing(0); // sent, so the next input starts a new event
+    }
+    ASSERT_EQ(pointing.queue.count, SPLIT_POINTING_QUEUE_SIZE);
+
+    // Motion adds up while the queue is full, a click holds back the driver
+    event = {.buttons = 0, .x = 10, .y = 0, .h = 0, .v = 0};
+    EXPECT_TRUE(pointing_queue_input(&pointing, &event));
+    event = {.buttons = 1, .x = 5, .y = 0, .h = 0, .v = 0};
+    EXPECT_FALSE(pointing_queue_input(&pointing, &event));
+    EXPECT_FALSE(pointing_queue_input(&pointing, NULL));
+
+    // Once the master has the queue the click goes in before the release
+    ASSERT_EQ(exchange_pointing(), SPLIT_POINTING_QUEUE_SIZE);
+    pointing_queue_encode(&pointing, applied, frame);
+    EXPECT_TRUE(pointing_queue_input(&pointing, NULL));
+    event = {.buttons = 0, .x = 0, .y = 0, .h = 0, .v = 0};
+    EXPECT_TRUE(pointing_queue_input(&pointing, &event));
+
+    ASSERT_EQ(exchange_pointing(), 2);
+    EXPECT_EQ(pointing_events[0].buttons, 1);
+    EXPECT_EQ(pointing_events[0].x, 15);
+    EXPECT_EQ(pointing_events[1].buttons, 0);
+    EXPECT_EQ(pointing_events[1].x, 0);
+}
+
+TEST_F(InputQueue, FastMotionLosesNothing) {
+    // The master holds received motion in its own queue until reports take it
+    pointing_queue_t       master           = {};
+    pointing_queue_event_t event            = {};
+    int32_t                moved[2]         = {0};
+    int32_t                reported[2]      = {0};
+    uint8_t                buttons          = 0;
+    uint8_t                reported_buttons = 0;
+    uint16_t               clicks           = 0;
+    uint16_t               reported_clicks  = 0;
+    srand(11);
+
+    auto queue_pending = [&]() {
+        return pointing_queue_input(&pointing, NULL);
+    };
+    auto exchange = [&](bool damage) {
+        pointing_queue_encode(&pointing, applied, frame);
+        if (damage) {
+            frame[1 + rand() % (frame[0] - 1)] ^= 0x01;
+        }
+        int8_t count = pointing_queue_decode(frame, sizeof(frame), &applied, pointing_events, SPLIT_POINTING_QUEUE_SIZE - master.queue.count, &metrics);
+        for (int8_t e = 0; e < count; e++) {
+            EXPECT_TRUE(pointing_queue_push(&master, &pointing_events[e]));
+        }
+    };
+    auto report = [&]() {
+        if (pointing_queue_take(&master, 127, 127, &event)) {
+            EXPECT_LE(abs(event.x), 127);
+            reported[0] += event.x;
+            reported[1] += event.y;
+            if (event.buttons & ~reported_buttons & 1) {
+                reported_clicks++;
+            }
+            reported_buttons = event.buttons;
+        }
+    };
+
+    for (int scan = 0; scan < 20000; scan++) {
+        // The driver is not read while a button change waits for room
+        if (queue_pending()) {
+            if (rand() % 50 == 0) {
+                buttons ^= 1;
+                if (buttons & 1) {
+                    clicks++;
+                }
+            }
+            pointing_queue_event_t motion = {.buttons = buttons, .x = (int16_t)(rand() % 201 - 100), .y = (int16_t)(rand() % 41 - 20), .h = 0, .v = 0};
+            moved[0] += motion.x;
+            moved[1] += motion.y;
+            pointing_queue_input(&pointing, &motion);
+        }
+
+        // Syncs are skipped and frames damaged now and then
+        if (rand() % 3 != 0) {
+            exchange(rand() % 5 == 0);
+        }
+        report();
+    }
+    for (int i = 0; i < 1000; i++) {
+        queue_pending();
+        exchange(false);
+        report();
+    }
+
+    EXPECT_EQ(reported[0], moved[0]);
+    EXPECT_EQ(reported[1], moved[1]);
+    EXPECT_EQ(reported_clicks, clicks);
+    EXPECT_GT(clicks, 0);
+    printf("slave max depth %u, full %u, left for later by the master %u\n", pointing.queue.metrics.max_depth, pointing.queue.metrics.full, metrics.full);
+}
@@ -0,0 +1,203 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define _Static_assert static_assert
+
+extern "C" {
+#include "link_policy.h"
+#include "timer.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+// Mock transport: each handler call is one exchange of `mock_id`, failing while `mock_faults` lasts
+static split_link_policy_t policy;
+static int8_t              mock_id;
+static int                 mock_faults;
+static bool                mock_fail_always;
+static int                 mock_calls;
+
+static bool mock_handler(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    bool okay = !mock_fail_always && mock_faults == 0;
+    if (mock_faults > 0) {
+        mock_faults--;
+    }
+    mock_calls++;
+    split_link_record(&policy, mock_id, okay);
+    return okay;
+}
+
+// Nothing to send, so no exchange
+static bool idle_handler(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    mock_calls++;
+    return true;
+}
+
+class LinkPolicy : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(1000);
+        split_link_init(&policy);
+        mock_id          = 0;
+        mock_faults      = 0;
+        mock_fail_always = false;
+        mock_calls       = 0;
+    }
+
+    bool run(uint8_t item, uint8_t priority, bool connected = true, split_link_handler_t handler = mock_handler) {
+        return split_link_run(&policy, "test", item, priority, connected, handler, master_matrix, slave_matrix);
+    }
+
+    matrix_row_t master_matrix[MATRIX_ROWS] = {0};
+    matrix_row_t slave_matrix[MATRIX_ROWS]  = {0};
+};
+
+TEST_F(LinkPolicy, CountsPerTransaction) {
+    split_link_record(&policy, 0, true);
+    split_link_record(&policy, 0, true);
+    split_link_record(&policy, 1, false);
+    split_link_record(&policy, -1, true);
+    split_link_record(&policy, NUM_TOTAL_TRANSACTIONS, true);
+
+    EXPECT_EQ(policy.counters[0].successes, 2);
+    EXPECT_EQ(policy.counters[0].failures, 0);
+    EXPECT_EQ(policy.counters[1].successes, 0);
+    EXPECT_EQ(policy.counters[1].failures, 1);
+    EXPECT_EQ(policy.exchanges, 3);
+}
+
+TEST_F(LinkPolicy, CountersSaturate) {
+    policy.counters[0].successes = UINT16_MAX;
+    split_link_record(&policy, 0, true);
+    EXPECT_EQ(policy.counters[0].successes, UINT16_MAX);
+}
+
+TEST_F(LinkPolicy, CriticalItemsRetryUntilTheyGetThrough) {
+    mock_id     = 1;
+    mock_faults = SPLIT_LINK_CRITICAL_ATTEMPTS - 1;
+    EXPECT_TRUE(run(SPLIT_SYNC_SLAVE_MATRIX, SPLIT_SYNC_PRIORITY_CRITICAL));
+    EXPECT_EQ(mock_calls, SPLIT_LINK_CRITICAL_ATTEMPTS);
+    EXPECT_EQ(policy.counters[1].failures, SPLIT_LINK_CRITICAL_ATTEMPTS - 1);
+    EXPECT_EQ(policy.counters[1].retries, SPLIT_LINK_CRITICAL_ATTEMPTS - 1);
+    EXPECT_EQ(policy.counters[1].successes, 1);
+}
+
+TEST_F(LinkPolicy, CriticalFailureAbortsTheScan) {
+    mock_fail_always = true;
+    EXPECT_FALSE(run(SPLIT_SYNC_SLAVE_MATRIX, SPLIT_SYNC_PRIORITY_CRITICAL));
+    EXPECT_EQ(mock_calls, SPLIT_LINK_CRITICAL_ATTEMPTS);
+
+    // and is tried again on the next one
+    mock_calls = 0;
+    EXPECT_FALSE(run(SPLIT_SYNC_SLAVE_MATRIX, SPLIT_SYNC_PRIORITY_CRITICAL));
+    EXPECT_EQ(mock_calls, SPLIT_LINK_CRITICAL_ATTEMPTS);
+}
+
+TEST_F(LinkPolicy, DisconnectedTriesOnce) {
+    mock_fail_always = true;
+    EXPECT_FALSE(run(SPLIT_SYNC_SLAVE_MATRIX, SPLIT_SYNC_PRIORITY_CRITICAL, false));
+    EXPECT_EQ(mock_calls, 1);
+}
+
+TEST_F(LinkPolicy, NonCriticalFailureBacksOff) {
+    mock_fail_always = true;
+    EXPECT_TRUE(run(SPLIT_SYNC_OLED, SPLIT_SYNC_PRIORITY_HIGH));
+    EXPECT_EQ(mock_calls, 2);
+
+    // held off for SPLIT_LINK_HOLD_MS
+    mock_calls = 0;
+    advance_time(SPLIT_LINK_HOLD_MS - 1);
+    EXPECT_TRUE(run(SPLIT_SYNC_OLED, SPLIT_SYNC_PRIORITY_HIGH));
+    EXPECT_EQ(mock_calls, 0);
+
+    // other items are not affected
+    EXPECT_TRUE(run(SPLIT_SYNC_LAYER_STATE, SPLIT_SYNC_PRIORITY_HIGH));
+    EXPECT_GT(mock_calls, 0);
+
+    // a second failure doubles the hold
+    mock_calls = 0;
+    advance_time(1);
+    EXPECT_TRUE(run(SPLIT_SYNC_OLED, SPLIT_SYNC_PRIORITY_HIGH));
+    EXPECT_GT(mock_calls, 0);
+    mock_calls = 0;
+    advance_time(SPLIT_LINK_HOLD_MS);
+    EXPECT_TRUE(run(SPLIT_SYNC_OLED, SPLIT_SYNC_PRIORITY_HIGH));
+    EXPECT_EQ(mock_calls, 0);
+
+    // and a success clears it
+    mock_fail_always = false;
+    advance_time(SPLIT_LINK_HOLD_MS);
+    EXPECT_TRUE(run(SPLIT_SYNC_OLED, SPLIT_SYNC_PRIORITY_HIGH));
+    EXPECT_EQ(mock_calls, 1);
+    EXPECT_EQ(policy.strikes[SPLIT_SYNC_OLED], 0);
+}
+
+TEST_F(LinkPolicy, ShedsTiersFromTheLowestUp) {
+    mock_fail_always = true;
+
+    std::vector<uint8_t> levels = {policy.lowest_priority};
+    for (int i = 0; i < 100; i++) {
+        run(SPLIT_SYNC_SLAVE_MATRIX, SPLIT_SYNC_PRIORITY_CRITICAL, false);
+        if (policy.lowest_priority != levels.back()) {
+            levels.push_back(policy.lowest_priority);
+        }
+    }
+    std::vector<uint8_t> expected = {SPLIT_SYNC_PRIORITY_LOW, SPLIT_SYNC_PRIORITY_NORMAL, SPLIT_SYNC_PRIORITY_HIGH, SPLIT_SYNC_PRIORITY_CRITICAL};
+    EXPECT_EQ(levels, expected);
+
+    // shed items are skipped without touching the bus, critical ones still run
+    mock_calls = 0;
+    EXPECT_TRUE(run(SPLIT_SYNC_WPM, SPLIT_SYNC_PRIORITY_LOW));
+    EXPECT_TRUE(run(SPLIT_SYNC_LAYER_STATE, SPLIT_SYNC_PRIORITY_HIGH));
+    EXPECT_EQ(mock_calls, 0);
+    EXPECT_FALSE(run(SPLIT_SYNC_SLAVE_MATRIX, SPLIT_SYNC_PRIORITY_CRITICAL));
+    EXPECT_GT(mock_calls, 0);
+}
+
+TEST_F(LinkPolicy, RestoresTiersWithHysteresis) {
+    mock_fail_always = true;
+    while (policy.lowest_priority != SPLIT_SYNC_PRIORITY_CRITICAL) {
+        run(SPLIT_SYNC_SLAVE_MATRIX, SPLIT_SYNC_PRIORITY_CRITICAL, false);
+    }
+
+    mock_fail_always = false;
+    while (policy.lowest_priority == SPLIT_SYNC_PRIORITY_CRITICAL) {
+        EXPECT_LT(split_link_quality_percent(&policy), 55);
+        run(SPLIT_SYNC_SLAVE_MATRIX, SPLIT_SYNC_PRIORITY_CRITICAL);
+    }
+    EXPECT_GE(split_link_quality_percent(&policy), 55);
+
+    for (int i = 0; i < 200; i++) {
+        run(SPLIT_SYNC_SLAVE_MATRIX, SPLIT_SYNC_PRIORITY_CRITICAL);
+    }
+    EXPECT_EQ(policy.lowest_priority, SPLIT_SYNC_PRIORITY_LOW);
+}
+
+TEST_F(LinkPolicy, IdleRunsDoNotCountTowardsQuality) {
+    mock_fail_always = true;
+    run(SPLIT_SYNC_SLAVE_MATRIX, SPLIT_SYNC_PRIORITY_CRITICAL, false);
+    uint16_t quality = policy.quality;
+
+    for (int i = 0; i < 50; i++) {
+        EXPECT_TRUE(run(SPLIT_SYNC_SLAVE_MATRIX, SPLIT_SYNC_PRIORITY_CRITICAL, true, idle_handler));
+    }
+    EXPECT_EQ(policy.quality, quality);
+}
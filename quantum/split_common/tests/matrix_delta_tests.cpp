@@ -0,0 +1,166 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <cstring>
+
+extern "C" {
+#include "crc.h"
+#include "matrix_delta.h"
+}
+
+class MatrixDelta : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        memset(&log, 0, sizeof(log));
+        memset(slave, 0, sizeof(slave));
+        memset(master, 0, sizeof(master));
+        memset(frame, 0, sizeof(frame));
+    }
+
+    void press(uint8_t row, uint8_t col) {
+        slave[row] |= (matrix_row_t)1 << col;
+        matrix_delta_record(&log, slave);
+    }
+
+    void release(uint8_t row, uint8_t col) {
+        slave[row] &= ~((matrix_row_t)1 << col);
+        matrix_delta_record(&log, slave);
+    }
+
+    // Runs one exchange, returns the frame length
+    uint8_t exchange(uint8_t request) {
+        uint8_t length = matrix_delta_encode(&log, request, frame);
+        EXPECT_TRUE(matrix_delta_decode(frame, sizeof(frame), master, &seq, &full));
+        return length;
+    }
+
+    matrix_delta_log_t log;
+    matrix_row_t       slave[MATRIX_DELTA_ROWS];
+    matrix_row_t       master[MATRIX_DELTA_ROWS];
+    uint8_t            frame[MATRIX_DELTA_FRAME_SIZE];
+    uint8_t            seq  = 0xFF;
+    bool               full = true;
+};
+
+TEST_F(MatrixDelta, NoChangeSendsEmptyDelta) {
+    matrix_delta_record(&log, slave);
+
+    EXPECT_EQ(exchange(0), MATRIX_DELTA_OVERHEAD);
+    EXPECT_EQ(seq, 0);
+    EXPECT_FALSE(full);
+    EXPECT_EQ(memcmp(master, slave, sizeof(slave)), 0);
+}
+
+TEST_F(MatrixDelta, KeypressSendsOnlyTheChangedRow) {
+    press(2, 4);
+
+    EXPECT_EQ(exchange(0), MATRIX_DELTA_OVERHEAD + MATRIX_DELTA_ENTRY_SIZE);
+    EXPECT_EQ(seq, 1);
+    EXPECT_FALSE(full);
+    EXPECT_EQ(master[2], 1 << 4);
+    EXPECT_EQ(memcmp(master, slave, sizeof(slave)), 0);
+}
+
+TEST_F(MatrixDelta, SendsOnlyChangesSinceAcknowledgedSequence) {
+    press(2, 4);
+    exchange(0);
+    press(5, 11);
+    release(2, 4);
+
+    EXPECT_EQ(exchange(seq), MATRIX_DELTA_OVERHEAD + 2 * MATRIX_DELTA_ENTRY_SIZE);
+    EXPECT_EQ(seq, 3);
+    EXPECT_EQ(memcmp(master, slave, sizeof(slave)), 0);
+
+    EXPECT_EQ(exchange(seq), MATRIX_DELTA_OVERHEAD);
+    EXPECT_EQ(seq, 3);
+}
+
+TEST_F(MatrixDelta, ResyncRequestSendsSnapshot) {
+    press(0, 0);
+    press(7, 7);
+    exchange(0);
+
+    memset(master, 0xAA, sizeof(master));
+    EXPECT_EQ(exchange(seq | MATRIX_DELTA_RESYNC), MATRIX_DELTA_OVERHEAD + MATRIX_DELTA_SNAPSHOT_SIZE);
+    EXPECT_TRUE(full);
+    EXPECT_EQ(seq, 2);
+    EXPECT_EQ(memcmp(master, slave, sizeof(slave)), 0);
+}
+
+TEST_F(MatrixDelta, GapBeyondHistorySendsSnapshot) {
+    for (uint8_t i = 0; i < SPLIT_MATRIX_DELTA_HISTORY + 1; i++) {
+        press(i, i);
+    }
+
+    EXPECT_EQ(exchange(0), MATRIX_DELTA_OVERHEAD + MATRIX_DELTA_SNAPSHOT_SIZE);
+    EXPECT_TRUE(full);
+    EXPECT_EQ(seq, SPLIT_MATRIX_DELTA_HISTORY + 1);
+    EXPECT_EQ(memcmp(master, slave, sizeof(slave)), 0);
+}
+
+TEST_F(MatrixDelta, SequenceWraps) {
+    for (uint16_t i = 0; i < MATRIX_DELTA_SEQ_MASK; i++) {
+        press(1, 0);
+        release(1, 0);
+    }
+    exchange(MATRIX_DELTA_RESYNC);
+    EXPECT_EQ(seq, MATRIX_DELTA_SEQ_MASK - 1);
+
+    press(3, 3);
+    press(4, 4);
+    EXPECT_EQ(exchange(seq), MATRIX_DELTA_OVERHEAD + 2 * MATRIX_DELTA_ENTRY_SIZE);
+    EXPECT_EQ(seq, 0);
+    EXPECT_EQ(memcmp(master, slave, sizeof(slave)), 0);
+}
+
+TEST_F(MatrixDelta, StaleRequestStillConverges) {
+    // A driver that answers the previous request repeats changes already applied
+    press(2, 1);
+    uint8_t stale = seq = 0;
+    exchange(stale);
+    press(2, 2);
+    press(6, 0);
+
+    exchange(stale);
+    EXPECT_EQ(seq, 3);
+    EXPECT_EQ(memcmp(master, slave, sizeof(slave)), 0);
+}
+
+TEST_F(MatrixDelta, CorruptFrameIsNotApplied) {
+    press(2, 4);
+    matrix_delta_encode(&log, 0, frame);
+    frame[3] ^= 0x01;
+
+    EXPECT_FALSE(matrix_delta_decode(frame, sizeof(frame), master, &seq, &full));
+    EXPECT_EQ(master[2], 0);
+}
+
+TEST_F(MatrixDelta, RowOutOfRangeIsRejected) {
+    press(2, 4);
+    uint8_t length    = matrix_delta_encode(&log, 0, frame);
+    frame[2]          = MATRIX_DELTA_ROWS;
+    frame[length - 1] = crc8(frame, length - 1);
+
+    EXPECT_FALSE(matrix_delta_decode(frame, sizeof(frame), master, &seq, &full));
+}
+
+TEST_F(MatrixDelta, FrameLongerThanBufferIsRejected) {
+    press(2, 4);
+    uint8_t length = matrix_delta_encode(&log, MATRIX_DELTA_RESYNC, frame);
+
+    EXPECT_FALSE(matrix_delta_decode(frame, length - 1, master, &seq, &full));
+}
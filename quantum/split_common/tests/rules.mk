@@ -0,0 +1,92 @@
+transaction_batch_DEFS := -DNO_DEBUG -DSPLIT_BATCH_SYNC_ENABLE
+transaction_batch_INC := $(QUANTUM_PATH)/split_common
+transaction_batch_CONFIG := $(QUANTUM_PATH)/split_common/tests/config_mock.h
+
+transaction_batch_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/transaction_batch_tests.cpp \
+	$(QUANTUM_PATH)/split_common/transaction_batch.c \
+	$(QUANTUM_PATH)/crc.c
+
+matrix_delta_DEFS := -DNO_DEBUG -DSPLIT_MATRIX_DELTA_ENABLE
+matrix_delta_INC := $(QUANTUM_PATH)/split_common
+matrix_delta_CONFIG := $(QUANTUM_PATH)/split_common/tests/config_mock.h
+
+matrix_delta_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/matrix_delta_tests.cpp \
+	$(QUANTUM_PATH)/split_common/matrix_delta.c \
+	$(QUANTUM_PATH)/crc.c
+
+input_queue_DEFS := -DNO_DEBUG
+input_queue_INC := $(QUANTUM_PATH)/split_common
+
+input_queue_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/input_queue_tests.cpp \
+	$(QUANTUM_PATH)/split_common/input_queue.c \
+	$(QUANTUM_PATH)/crc.c
+
+sync_scheduler_DEFS := -DNO_DEBUG -DSPLIT_SYNC_SCHEDULER_ENABLE
+sync_scheduler_INC := $(QUANTUM_PATH)/split_common
+sync_scheduler_CONFIG := $(QUANTUM_PATH)/split_common/tests/config_mock.h
+
+sync_scheduler_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/sync_scheduler_tests.cpp \
+	$(QUANTUM_PATH)/split_common/sync_scheduler.c
+
+link_policy_DEFS := -DNO_DEBUG
+link_policy_INC := $(QUANTUM_PATH)/split_common
+link_policy_CONFIG := $(QUANTUM_PATH)/split_common/tests/config_mock.h
+
+link_policy_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/link_policy_tests.cpp \
+	$(QUANTUM_PATH)/split_common/link_policy.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+
+serial_frame_DEFS := -DNO_DEBUG
+serial_frame_INC := $(QUANTUM_PATH)/split_common
+
+serial_frame_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/serial_frame_tests.cpp \
+	$(QUANTUM_PATH)/split_common/serial_frame.c \
+	$(QUANTUM_PATH)/crc.c
+
+transaction_stream_DEFS := -DNO_DEBUG
+transaction_stream_INC := $(QUANTUM_PATH)/split_common
+
+transaction_stream_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/transaction_stream_tests.cpp \
+	$(QUANTUM_PATH)/split_common/transaction_stream.c \
+	$(QUANTUM_PATH)/crc.c
+
+split_sim_DEFS := -DNO_DEBUG -DSPLIT_KEYBOARD -DSPLIT_COMMON_TRANSACTIONS -DRGBLIGHT_ENABLE -DSPLIT_STREAM_ENABLE
+split_sim_matrix_delta_DEFS := $(split_sim_DEFS) -DSPLIT_MATRIX_DELTA_ENABLE
+split_sim_batch_DEFS := $(split_sim_DEFS) -DSPLIT_BATCH_SYNC_ENABLE -DSPLIT_BATCH_CRC16_ENABLE
+split_sim_scheduler_DEFS := $(split_sim_DEFS) -DSPLIT_SYNC_SCHEDULER_ENABLE
+
+split_sim_INC := \
+	$(QUANTUM_PATH)/split_common \
+	$(QUANTUM_PATH)/rgblight
+split_sim_matrix_delta_INC := $(split_sim_INC)
+split_sim_batch_INC := $(split_sim_INC)
+split_sim_scheduler_INC := $(split_sim_INC)
+
+split_sim_CONFIG := $(QUANTUM_PATH)/split_common/tests/config_mock_split_sim.h
+split_sim_matrix_delta_CONFIG := $(split_sim_CONFIG)
+split_sim_batch_CONFIG := $(split_sim_CONFIG)
+split_sim_scheduler_CONFIG := $(split_sim_CONFIG)
+
+split_sim_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/split_sim_tests.cpp \
+	$(QUANTUM_PATH)/split_common/tests/split_sim.c \
+	$(QUANTUM_PATH)/split_common/transport.c \
+	$(QUANTUM_PATH)/split_common/transactions.c \
+	$(QUANTUM_PATH)/split_common/transaction_batch.c \
+	$(QUANTUM_PATH)/split_common/matrix_delta.c \
+	$(QUANTUM_PATH)/split_common/sync_scheduler.c \
+	$(QUANTUM_PATH)/split_common/link_policy.c \
+	$(QUANTUM_PATH)/split_common/transaction_stream.c \
+	$(QUANTUM_PATH)/sync_timer.c \
+	$(QUANTUM_PATH)/crc.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+split_sim_matrix_delta_SRC := $(split_sim_SRC)
+split_sim_batch_SRC := $(split_sim_SRC)
+split_sim_scheduler_SRC := $(split_sim_SRC)
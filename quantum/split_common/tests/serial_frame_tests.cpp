@@ -0,0 +1,195 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "serial_frame.h"
+}
+
+TEST(SerialFrame, RoundTrip) {
+    uint8_t frame[SERIAL_FRAME_MAX_SIZE];
+    uint8_t payload[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint8_t received[8];
+
+    EXPECT_EQ(serial_frame_encode(frame, 5, payload, sizeof(payload)), sizeof(payload) + SERIAL_FRAME_OVERHEAD);
+    EXPECT_EQ(serial_frame_payload_length(frame, sizeof(received), false), sizeof(payload));
+    EXPECT_TRUE(serial_frame_decode(frame, 5, received, sizeof(payload)));
+    EXPECT_EQ(memcmp(payload, received, sizeof(payload)), 0);
+}
+
+TEST(SerialFrame, EmptyPayload) {
+    uint8_t frame[SERIAL_FRAME_MAX_SIZE];
+
+    EXPECT_EQ(serial_frame_encode(frame, 3, NULL, 0), SERIAL_FRAME_OVERHEAD);
+    EXPECT_TRUE(serial_frame_decode(frame, 3, NULL, 0));
+}
+
+TEST(SerialFrame, RejectsCorruption) {
+    uint8_t frame[SERIAL_FRAME_MAX_SIZE];
+    uint8_t payload[4] = {0x12, 0x34, 0x56, 0x78};
+    uint8_t received[4];
+    uint8_t size = serial_frame_encode(frame, 1, payload, sizeof(payload));
+
+    for (uint8_t i = 0; i < size; i++) {
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            frame[i] ^= 1 << bit;
+            EXPECT_FALSE(serial_frame_decode(frame, 1, received, sizeof(received))) << "byte " << (int)i << " bit " << (int)bit;
+            frame[i] ^= 1 << bit;
+        }
+    }
+    EXPECT_TRUE(serial_frame_decode(frame, 1, received, sizeof(received)));
+}
+
+TEST(SerialFrame, RejectsOtherTransaction) {
+    uint8_t frame[SERIAL_FRAME_MAX_SIZE];
+    uint8_t payload[4] = {0};
+    uint8_t received[4];
+
+    serial_frame_encode(frame, 2, payload, sizeof(payload));
+    EXPECT_FALSE(serial_frame_decode(frame, 3, received, sizeof(received)));
+    EXPECT_FALSE(serial_frame_decode(frame, 2 ^ 0x80, received, sizeof(received)));
+}
+
+TEST(SerialFrame, LengthPrefixedPayload) {
+    uint8_t frame[SERIAL_FRAME_MAX_SIZE];
+    uint8_t payload[16] = {3, 0xAA, 0xBB};
+
+    serial_frame_encode(frame, 4, payload, 3);
+    EXPECT_EQ(serial_frame_payload_length(frame, sizeof(payload), true), 3);
+    EXPECT_EQ(serial_frame_payload_length(frame, sizeof(payload), false), sizeof(payload));
+
+    // a prefix of 0 or one that does not fit means the whole buffer
+    payload[0] = 0;
+    serial_frame_encode(frame, 4, payload, sizeof(payload));
+    EXPECT_EQ(serial_frame_payload_length(frame, sizeof(payload), true), sizeof(payload));
+    payload[0] = sizeof(payload);
+    serial_frame_encode(frame, 4, payload, sizeof(payload));
+    EXPECT_EQ(serial_frame_payload_length(frame, sizeof(payload), true), sizeof(payload));
+}
+
+// Host loopback model of a full duplex link. Each direction carries a byte
+// every BYTE_US, the slave reacts SLAVE_US after a request is in and the
+// master spends MASTER_US on its own between transactions.
+namespace {
+const double BYTE_US        = 11 * 1e6 / 460800; // 8E2 at SELECT_SOFT_SERIAL_SPEED 0
+const double SLAVE_US       = 15;
+const double MASTER_US      = 20;
+const size_t PIPELINE_DEPTH = 4;
+
+struct Transaction {
+    uint8_t id, initiator2target, target2initiator;
+};
+
+// Idle scan: only the slave matrix checksum
+const std::vector<Transaction> idle_scan = {{0, 0, 1}};
+// Every core item being synced
+const std::vector<Transaction> full_scan = {
+    {0, 0, 1}, {1, 0, 12}, {2, 4, 0}, {3, 8, 0}, {4, 1, 0}, {5, 4, 0}, {6, 1, 0}, {7, 20, 0},
+};
+// Only state pushed to the slave, e.g. lighting and display updates
+const std::vector<Transaction> write_scan = {
+    {2, 4, 0}, {3, 8, 0}, {4, 1, 0}, {5, 4, 0}, {6, 1, 0}, {7, 20, 0},
+};
+
+struct Link {
+    double master   = 0, slave = 0;
+    double to_slave = 0, to_master = 0; // when each direction is idle again
+
+    // Puts `bytes` on a direction at `now`, returns when the last one has arrived
+    static double send(double &idle, double now, unsigned bytes) {
+        idle = std::max(idle, now) + bytes * BYTE_US;
+        return idle;
+    }
+};
+
+// The protocol without SERIAL_USART_PIPELINE: ID, handshake, then the buffers
+double run_legacy(const std::vector<Transaction> &scan, int scans) {
+    Link link;
+    for (int i = 0; i < scans; i++) {
+        for (const Transaction &t : scan) {
+            double id    = Link::send(link.to_slave, link.master, 1);
+            double shake = Link::send(link.to_master, std::max(link.slave, id) + SLAVE_US, 1);
+            link.master  = shake;
+            link.slave   = shake;
+            if (t.initiator2target) {
+                link.slave = Link::send(link.to_slave, link.master, t.initiator2target) + SLAVE_US;
+            }
+            if (t.target2initiator) {
+                link.slave  = Link::send(link.to_master, link.slave, t.target2initiator);
+                link.master = link.slave;
+            }
+            link.master += MASTER_US;
+        }
+    }
+    return link.master;
+}
+
+// SERIAL_USART_PIPELINE: one frame each way, with up to PIPELINE_DEPTH
+// writes on the wire before their acknowledgement is waited for
+double run_pipelined(const std::vector<Transaction> &scan, int scans) {
+    Link                link;
+    std::vector<double> posted; // arrival of the outstanding acknowledgements
+    uint8_t             frame[SERIAL_FRAME_MAX_SIZE];
+    uint8_t             buffer[UINT8_MAX] = {0};
+
+    for (int i = 0; i < scans; i++) {
+        for (const Transaction &t : scan) {
+            bool is_write = !t.target2initiator;
+            if (is_write && posted.size() == PIPELINE_DEPTH) {
+                link.master = std::max(link.master, posted.front());
+                posted.erase(posted.begin());
+            }
+
+            uint16_t size = serial_frame_encode(frame, t.id, buffer, t.initiator2target);
+            double   in   = Link::send(link.to_slave, link.master, size);
+            EXPECT_TRUE(serial_frame_decode(frame, t.id, buffer, t.initiator2target));
+
+            size       = serial_frame_encode(frame, t.id ^ 0x80, buffer, t.target2initiator);
+            link.slave = Link::send(link.to_master, std::max(link.slave, in) + SLAVE_US, size);
+            EXPECT_TRUE(serial_frame_decode(frame, t.id ^ 0x80, buffer, t.target2initiator));
+
+            if (is_write) {
+                posted.push_back(link.slave);
+            } else {
+                // the acknowledgements arrive before the reply
+                posted.clear();
+                link.master = link.slave;
+            }
+            link.master += MASTER_US;
+        }
+    }
+    return std::max(link.master, posted.empty() ? 0 : posted.back());
+}
+} // namespace
+
+TEST(SerialFrame, LoopbackThroughput) {
+    const int scans = 1000;
+
+    for (const auto &scan : {idle_scan, full_scan, write_scan}) {
+        double legacy    = run_legacy(scan, scans) / scans;
+        double pipelined = run_pipelined(scan, scans) / scans;
+        printf("split serial loopback, %zu transactions: %.0f us per scan, %.0f us pipelined\n", scan.size(), legacy, pipelined);
+    }
+
+    // Writes no longer wait for a handshake each
+    EXPECT_LT(run_pipelined(write_scan, scans), run_legacy(write_scan, scans));
+}
@@ -0,0 +1,272 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "split_sim.h"
+#include "serial.h"
+#include "timer.h"
+#include "transaction_id_define.h"
+
+split_sim_half_t split_sim_master;
+split_sim_half_t split_sim_slave;
+
+// Stand-ins for the state the halves keep in quantum, swapped in for the running half
+layer_state_t layer_state;
+layer_state_t default_layer_state;
+
+extern volatile int32_t sync_timer_ms;
+
+void advance_time(uint32_t ms);
+
+static split_sim_config_t sim_config;
+static split_sim_stats_t  sim_stats;
+static split_sim_half_t  *current;
+static uint32_t           rng;
+static uint32_t           now_us;
+static uint32_t           start_ms;
+
+// Link activity of the running scan
+static uint32_t scan_bytes;
+static uint32_t scan_transactions;
+static uint32_t scan_failures;
+
+static void load(split_sim_half_t *half) {
+    memcpy(split_shmem, &half->shmem, sizeof(split_shared_memory_t));
+    layer_state         = half->layer_state;
+    default_layer_state = half->default_layer_state;
+    sync_timer_ms       = half->sync_timer_ms;
+    current             = half;
+}
+
+static void save(void) {
+    if (!current) {
+        return;
+    }
+    memcpy(&current->shmem, split_shmem, sizeof(split_shared_memory_t));
+    current->layer_state         = layer_state;
+    current->default_layer_state = default_layer_state;
+    current->sync_timer_ms       = sync_timer_ms;
+    current                      = NULL;
+}
+
+static void switch_to(split_sim_half_t *half) {
+    save();
+    load(half);
+}
+
+static uint32_t next_random(void) {
+    // xorshift32
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static bool happens(uint32_t ppm) {
+    return ppm && next_random() % 1000000 < ppm;
+}
+
+// Puts bytes on the wire, flipping a bit of those that get corrupted. Returns false once a byte is dropped.
+static bool link_send(uint8_t *data, uint16_t length) {
+    for (uint16_t i = 0; i < length; i++) {
+        scan_bytes++;
+        if (happens(sim_config.drop_ppm)) {
+            sim_stats.dropped++;
+            return false;
+        }
+        if (happens(sim_config.corrupt_ppm)) {
+            data[i] ^= 1 << (next_random() % 8);
+            sim_stats.corrupted++;
+        }
+    }
+    return true;
+}
+
+// Bytes of a buffer that go over the wire, as in the serial drivers
+static uint8_t wire_length(const split_transaction_desc_t *trans, const uint8_t *buffer, uint8_t size) {
+    return (trans->length_prefixed && buffer[0] > 0 && buffer[0] < size) ? buffer[0] : size;
+}
+
+// Sends a transaction buffer, which fails if a corrupted length prefix leaves the receiver expecting a different length
+static bool link_send_buffer(const split_transaction_desc_t *trans, uint8_t *buffer, uint8_t size, uint8_t *length) {
+    *length = wire_length(trans, buffer, size);
+    return link_send(buffer, *length) && wire_length(trans, buffer, size) == *length;
+}
+
+// Same exchange as the serial drivers: transaction ID, handshake, then the buffers in both directions
+bool soft_serial_transaction(int sstd_index) {
+    split_transaction_desc_t *trans     = &split_transaction_table[sstd_index];
+    uint8_t                   header[2] = {sstd_index, sstd_index ^ NUM_TOTAL_TRANSACTIONS};
+    uint8_t                   initiator2target[UINT8_MAX];
+    uint8_t                   target2initiator[UINT8_MAX];
+    uint8_t                   length;
+
+    scan_transactions++;
+
+    // A mangled ID or handshake leaves the master waiting for an answer that does not come
+    bool okay = link_send(header, sizeof(header)) && header[0] == sstd_index && header[1] == (sstd_index ^ NUM_TOTAL_TRANSACTIONS);
+
+    memcpy(initiator2target, split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size);
+    okay = okay && link_send_buffer(trans, initiator2target, trans->initiator2target_buffer_size, &length);
+
+    if (okay) {
+        // The slave serves the transaction from its own shared memory, as from its serial interrupt
+        split_sim_half_t *initiator = current;
+        switch_to(&split_sim_slave);
+        memcpy(split_trans_initiator2target_buffer(trans), initiator2target, length);
+        if (trans->slave_callback) {
+            trans->slave_callback(trans->initiator2target_buffer_size, split_trans_initiator2target_buffer(trans), trans->target2initiator_buffer_size, split_trans_target2initiator_buffer(trans));
+        }
+        memcpy(target2initiator, split_trans_target2initiator_buffer(trans), trans->target2initiator_buffer_size);
+        switch_to(initiator);
+
+        okay = link_send_buffer(trans, target2initiator, trans->target2initiator_buffer_size, &length);
+        if (okay) {
+            memcpy(split_trans_target2initiator_buffer(trans), target2initiator, length);
+        }
+    }
+
+    if (!okay) {
+        scan_failures++;
+    }
+    return okay;
+}
+
+void soft_serial_initiator_init(void) {}
+
+void soft_serial_target_init(void) {}
+
+void split_sim_configure(const split_sim_config_t *config) {
+    sim_config = *config;
+    rng        = config->seed ? config->seed : 1;
+}
+
+// The transactions keep state of their own between simulations, so the shared memory it describes stays as well
+static void reset(split_sim_half_t *half) {
+    split_shared_memory_t shmem = half->shmem;
+    memset(half, 0, sizeof(split_sim_half_t));
+    half->shmem = shmem;
+}
+
+void split_sim_init(const split_sim_config_t *config) {
+    save();
+    reset(&split_sim_master);
+    reset(&split_sim_slave);
+    memset(&sim_stats, 0, sizeof(sim_stats));
+    split_sim_configure(config);
+    now_us   = 0;
+    start_ms = timer_read32();
+}
+
+bool split_sim_scan(void) {
+    scan_bytes        = 0;
+    scan_transactions = 0;
+    scan_failures     = 0;
+
+    // The slave scans its rows into its shared memory and applies what the master sent last scan
+    switch_to(&split_sim_slave);
+    transport_slave(split_sim_slave.matrix, split_sim_slave.matrix + SPLIT_SIM_ROWS_PER_HAND);
+
+    switch_to(&split_sim_master);
+    bool okay = transport_master(split_sim_master.matrix, split_sim_master.matrix + SPLIT_SIM_ROWS_PER_HAND);
+    save();
+
+    uint32_t bus_us = (uint32_t)(((uint64_t)scan_bytes * 10 * 1000000 + sim_config.baud / 2) / sim_config.baud);
+    bus_us += scan_transactions * sim_config.latency_us + scan_failures * sim_config.timeout_us;
+
+    sim_stats.scans++;
+    sim_stats.transactions += scan_transactions;
+    sim_stats.failures += scan_failures;
+    sim_stats.bytes += scan_bytes;
+    sim_stats.bus_us += bus_us;
+    sim_stats.scan_bus_us = bus_us;
+
+    // Keep the millisecond timer in step with the simulated time
+    now_us += sim_config.scan_us + bus_us;
+    advance_time(start_ms + now_us / 1000 - timer_read32());
+    return okay;
+}
+
+uint32_t split_sim_now_us(void) {
+    return now_us;
+}
+
+void split_sim_get_stats(split_sim_stats_t *stats) {
+    *stats = sim_stats;
+}
+
+////////////////////////////////////////////////////
+// Quantum, as seen by the running half
+
+bool is_keyboard_master(void) {
+    return current == &split_sim_master;
+}
+
+bool is_keyboard_left(void) {
+    return current == &split_sim_master;
+}
+
+bool is_transport_connected(void) {
+    return true;
+}
+
+uint8_t get_mods(void) {
+    return current->mods;
+}
+
+void set_mods(uint8_t mods) {
+    current->mods = mods;
+}
+
+uint8_t get_weak_mods(void) {
+    return current->weak_mods;
+}
+
+void set_weak_mods(uint8_t mods) {
+    current->weak_mods = mods;
+}
+
+uint8_t get_oneshot_mods(void) {
+    return current->oneshot_mods;
+}
+
+void set_oneshot_mods(uint8_t mods) {
+    current->oneshot_mods = mods;
+}
+
+uint8_t host_keyboard_leds(void) {
+    return current->led_state;
+}
+
+void set_split_host_keyboard_leds(uint8_t led_state) {
+    current->led_state = led_state;
+}
+
+#if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+void rgblight_get_syncinfo(rgblight_syncinfo_t *syncinfo) {
+    *syncinfo = current->rgblight;
+}
+
+void rgblight_clear_change_flags(void) {
+    current->rgblight.status.change_flags = 0;
+}
+
+void rgblight_update_sync(rgblight_syncinfo_t *syncinfo, bool write_to_eeprom) {
+    current->rgblight                     = *syncinfo;
+    current->rgblight.status.change_flags = 0;
+}
+#endif // defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
@@ -0,0 +1,80 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "transport.h"
+
+// Both halves of a split keyboard in one process, joined by a simulated serial link.
+//
+// Each half keeps its own copy of split_shmem and of the state the transactions sync. The
+// simulator loads a half into the globals while that half runs, so the master's
+// transactions_master() and the slave's transactions_slave() and slave callbacks run
+// unmodified. The master is the left half.
+
+#define SPLIT_SIM_ROWS_PER_HAND ((MATRIX_ROWS) / 2)
+
+typedef struct {
+    uint32_t baud;        // bits per second, each byte takes 10 bits on the wire
+    uint16_t latency_us;  // line turnarounds, added to every transaction
+    uint16_t timeout_us;  // spent by the master on a transaction that fails
+    uint16_t scan_us;     // matrix scan and processing of each half, outside the link
+    uint32_t corrupt_ppm; // bytes per million that arrive with a bit flipped
+    uint32_t drop_ppm;    // bytes per million that never arrive
+    uint32_t seed;
+} split_sim_config_t;
+
+typedef struct {
+    uint32_t scans;
+    uint32_t transactions;
+    uint32_t failures;
+    uint32_t bytes;
+    uint32_t corrupted;
+    uint32_t dropped;
+    uint32_t bus_us;      // time the link was busy, over all scans
+    uint32_t scan_bus_us; // time the link was busy during the last scan
+} split_sim_stats_t;
+
+typedef struct {
+    split_shared_memory_t shmem;
+    matrix_row_t          matrix[MATRIX_ROWS]; // left half rows first, as on the keyboard
+    layer_state_t         layer_state;
+    layer_state_t         default_layer_state;
+    uint8_t               mods;
+    uint8_t               weak_mods;
+    uint8_t               oneshot_mods;
+    uint8_t               led_state;
+    int32_t               sync_timer_ms;
+#if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+    rgblight_syncinfo_t rgblight;
+#endif // defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+} split_sim_half_t;
+
+// Only valid between scans, while neither half is loaded
+extern split_sim_half_t split_sim_master;
+extern split_sim_half_t split_sim_slave;
+
+void split_sim_init(const split_sim_config_t *config);
+void split_sim_configure(const split_sim_config_t *config);
+
+// Runs one matrix scan on both halves and advances the timer by its duration, returns what transport_master() did
+bool split_sim_scan(void);
+
+uint32_t split_sim_now_us(void);
+void     split_sim_get_stats(split_sim_stats_t *stats);
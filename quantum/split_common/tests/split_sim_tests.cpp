@@ -0,0 +1,372 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#define _Static_assert static_assert
+
+extern "C" {
+#include "split_sim.h"
+#include "transactions.h"
+#include "transaction_batch.h"
+#include "timer.h"
+}
+
+#define SLAVE_ROW(row) (SPLIT_SIM_ROWS_PER_HAND + (row))
+
+// FORCED_SYNC_MS of transactions.c, after which unchanged state is sent again
+#define FORCED_SYNC_MS 100
+
+#define STREAM_SIZE 512
+
+static uint8_t stream_received[STREAM_SIZE];
+static uint8_t stream_done_calls;
+static bool    stream_success;
+
+static bool stream_receive(uint16_t total, uint16_t offset, const uint8_t *data, uint8_t length) {
+    memcpy(&stream_received[offset], data, length);
+    return true;
+}
+
+static void stream_done(int8_t transaction_id, bool success) {
+    stream_done_calls++;
+    stream_success = success;
+}
+
+class SplitSim : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        config.baud        = 460800;
+        config.latency_us  = 20;
+        config.timeout_us  = 1000;
+        config.scan_us     = 500;
+        config.corrupt_ppm = 0;
+        config.drop_ppm    = 0;
+        config.seed        = 1;
+        split_sim_init(&config);
+        // Let both halves settle, as after the previous test the transactions have state to catch up on
+        scan_for(FORCED_SYNC_MS * 2);
+    }
+
+    // Scans for at least `ms` of simulated time
+    void scan_for(uint32_t ms) {
+        uint32_t end = split_sim_now_us() + ms * 1000;
+        while (split_sim_now_us() < end) {
+            split_sim_scan();
+        }
+    }
+
+    // Microseconds from pressing a key on the slave until the master's matrix has it
+    uint32_t slave_key_latency(uint8_t row, matrix_row_t col) {
+        uint32_t pressed = split_sim_now_us();
+        split_sim_slave.matrix[SLAVE_ROW(row)] ^= col;
+        while (split_sim_master.matrix[SLAVE_ROW(row)] != split_sim_slave.matrix[SLAVE_ROW(row)] && split_sim_now_us() - pressed < 1000000) {
+            split_sim_scan();
+        }
+        return split_sim_now_us() - pressed;
+    }
+
+    split_sim_config_t config;
+};
+
+TEST_F(SplitSim, SlaveKeyReachesMaster) {
+    split_sim_slave.matrix[SLAVE_ROW(2)] = 0b100;
+    split_sim_scan();
+    EXPECT_EQ(split_sim_master.matrix[SLAVE_ROW(2)], 0b100);
+
+    split_sim_slave.matrix[SLAVE_ROW(2)] = 0;
+    split_sim_scan();
+    EXPECT_EQ(split_sim_master.matrix[SLAVE_ROW(2)], 0);
+}
+
+TEST_F(SplitSim, MasterKeyStaysOnMaster) {
+    split_sim_master.matrix[1] = 0b10;
+    scan_for(10);
+    EXPECT_EQ(split_sim_slave.matrix[1], 0);
+}
+
+TEST_F(SplitSim, LayerStateSync) {
+    split_sim_master.layer_state         = 1 << 3;
+    split_sim_master.default_layer_state = 1 << 1;
+    scan_for(20);
+    EXPECT_EQ(split_sim_slave.layer_state, 1 << 3);
+    EXPECT_EQ(split_sim_slave.default_layer_state, 1 << 1);
+
+    split_sim_master.layer_state = 0;
+    scan_for(20);
+    EXPECT_EQ(split_sim_slave.layer_state, 0);
+}
+
+TEST_F(SplitSim, ModsSync) {
+    split_sim_master.mods         = 0x02;
+    split_sim_master.weak_mods    = 0x20;
+    split_sim_master.oneshot_mods = 0x04;
+    scan_for(20);
+    EXPECT_EQ(split_sim_slave.mods, 0x02);
+    EXPECT_EQ(split_sim_slave.weak_mods, 0x20);
+    EXPECT_EQ(split_sim_slave.oneshot_mods, 0x04);
+}
+
+TEST_F(SplitSim, LedStateSync) {
+    split_sim_master.led_state = 0x03;
+    scan_for(20);
+    EXPECT_EQ(split_sim_slave.led_state, 0x03);
+}
+
+TEST_F(SplitSim, RgblightSync) {
+    split_sim_master.rgblight.config.enable       = true;
+    split_sim_master.rgblight.config.mode         = 5;
+    split_sim_master.rgblight.config.hue          = 170;
+    split_sim_master.rgblight.status.change_flags = RGBLIGHT_STATUS_CHANGE_MODE | RGBLIGHT_STATUS_CHANGE_HSVS;
+    scan_for(50);
+    EXPECT_EQ(split_sim_slave.rgblight.config.raw, split_sim_master.rgblight.config.raw);
+    EXPECT_EQ(split_sim_master.rgblight.status.change_flags, 0);
+}
+
+TEST_F(SplitSim, SyncTimerFollowsMaster) {
+    // The slave powered up a while after the master
+    split_sim_slave.sync_timer_ms = 12345;
+    scan_for(FORCED_SYNC_MS * 2);
+    // Both halves share the simulated clock, so only the offset and the delay of applying it remain
+    EXPECT_LE(split_sim_slave.sync_timer_ms, 2);
+    EXPECT_GE(split_sim_slave.sync_timer_ms, 0);
+}
+
+TEST_F(SplitSim, BusTimeFollowsBaudRateAndLatency) {
+    scan_for(100);
+
+    split_sim_stats_t stats;
+    split_sim_get_stats(&stats);
+    double expected = stats.bytes * 10e6 / config.baud + stats.transactions * config.latency_us;
+    EXPECT_NEAR(stats.bus_us, expected, stats.scans);
+    EXPECT_EQ(stats.failures, 0);
+}
+
+TEST_F(SplitSim, DroppedBytesFailTransactionsButStateConverges) {
+    config.drop_ppm = 20000;
+    split_sim_configure(&config);
+    split_sim_master.layer_state = 1 << 2;
+    split_sim_master.mods        = 0x01;
+    scan_for(100);
+
+    split_sim_stats_t stats;
+    split_sim_get_stats(&stats);
+    EXPECT_GT(stats.dropped, 0);
+    EXPECT_GT(stats.failures, 0);
+
+    config.drop_ppm = 0;
+    split_sim_configure(&config);
+    scan_for(FORCED_SYNC_MS * 2);
+    EXPECT_EQ(split_sim_slave.layer_state, 1 << 2);
+    EXPECT_EQ(split_sim_slave.mods, 0x01);
+}
+
+TEST_F(SplitSim, CorruptionNeverShowsPhantomKeys) {
+    config.corrupt_ppm = 5000;
+    split_sim_configure(&config);
+    split_sim_slave.matrix[SLAVE_ROW(0)] = 0b1;
+    split_sim_slave.matrix[SLAVE_ROW(3)] = 0b100000;
+
+    for (int scan = 0; scan < 2000; scan++) {
+        split_sim_scan();
+        for (uint8_t row = 0; row < SPLIT_SIM_ROWS_PER_HAND; row++) {
+            matrix_row_t seen = split_sim_master.matrix[SLAVE_ROW(row)];
+            ASSERT_EQ(seen & ~split_sim_slave.matrix[SLAVE_ROW(row)], 0) << "scan " << scan << " row " << (int)row;
+        }
+    }
+
+    split_sim_stats_t stats;
+    split_sim_get_stats(&stats);
+    EXPECT_GT(stats.corrupted, 0);
+    EXPECT_EQ(split_sim_master.matrix[SLAVE_ROW(0)], 0b1);
+    EXPECT_EQ(split_sim_master.matrix[SLAVE_ROW(3)], 0b100000);
+}
+
+#if defined(SPLIT_BATCH_SYNC_ENABLE) && defined(SPLIT_BATCH_CRC16_ENABLE)
+TEST_F(SplitSim, BatchFramesSwitchToCrc16) {
+    // the slave's copy of the master's last frame, and the slave's last reply
+    EXPECT_TRUE(split_sim_slave.shmem.batch_m2s[1] & TRANSACTION_BATCH_CRC16);
+    EXPECT_TRUE(split_sim_slave.shmem.batch_s2m[1] & TRANSACTION_BATCH_CRC16);
+
+    split_sim_slave.matrix[SLAVE_ROW(1)] = 0b10;
+    split_sim_scan();
+    EXPECT_EQ(split_sim_master.matrix[SLAVE_ROW(1)], 0b10);
+}
+#endif // defined(SPLIT_BATCH_SYNC_ENABLE) && defined(SPLIT_BATCH_CRC16_ENABLE)
+
+TEST_F(SplitSim, ScanOverheadAndSlaveKeyLatency) {
+    split_sim_stats_t before, after;
+    split_sim_get_stats(&before);
+    scan_for(100);
+    split_sim_get_stats(&after);
+    uint32_t scans     = after.scans - before.scans;
+    double   idle_us   = (double)(after.bus_us - before.bus_us) / scans;
+    double   idle_txns = (double)(after.transactions - before.transactions) / scans;
+
+    uint32_t worst = 0;
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < 20; i++) {
+        uint32_t latency = slave_key_latency(i % SPLIT_SIM_ROWS_PER_HAND, 1 << (i % MATRIX_COLS));
+        worst            = latency > worst ? latency : worst;
+        total += latency;
+        scan_for(5);
+    }
+
+    printf("split sim at %lu baud: %.0f us and %.1f transactions per idle scan, slave key latency %lu us average, %lu us worst\n", (unsigned long)config.baud, idle_us, idle_txns, (unsigned long)(total / 20), (unsigned long)worst);
+
+    // A slave key is seen by the master in the first scan after it was pressed
+    EXPECT_LT(worst, 2 * (config.scan_us + idle_us));
+    EXPECT_LT(idle_us, config.scan_us);
+}
+
+static uint8_t               display_user_field;
+static split_display_state_t display_master_seen;
+static split_display_state_t display_slave_seen;
+static uint16_t              display_slave_changes;
+
+extern "C" void split_display_state_collect_user(split_display_state_t *state) {
+    state->user[0] = display_user_field;
+}
+
+extern "C" void split_display_state_changed_user(const split_display_state_t *state) {
+    if (is_keyboard_master()) {
+        display_master_seen = *state;
+    } else {
+        display_slave_seen = *state;
+        display_slave_changes++;
+    }
+}
+
+TEST_F(SplitSim, DisplayStateReachesSlave) {
+    split_sim_master.layer_state = 1 << 3;
+    split_sim_master.mods        = 0x02;
+    split_sim_master.led_state   = 0x02;
+    display_user_field           = 42;
+    scan_for(20);
+
+    EXPECT_EQ(display_slave_seen.layer_state, 1 << 3);
+    EXPECT_EQ(display_slave_seen.mods, 0x02);
+    EXPECT_TRUE(display_slave_seen.led_state.caps_lock);
+    EXPECT_EQ(display_slave_seen.user[0], 42);
+    EXPECT_EQ(memcmp(&display_master_seen, &display_slave_seen, sizeof(display_slave_seen)), 0);
+    display_user_field = 0;
+}
+
+TEST_F(SplitSim, DisplayStateCombinesMods) {
+    split_sim_master.mods         = 0x01;
+    split_sim_master.weak_mods    = 0x04;
+    split_sim_master.oneshot_mods = 0x10;
+    scan_for(20);
+    EXPECT_EQ(display_slave_seen.mods, 0x15);
+}
+
+TEST_F(SplitSim, UnchangedDisplayStateDoesNotNotify) {
+    split_sim_master.layer_state = 1 << 1;
+    scan_for(20);
+    uint16_t changes = display_slave_changes;
+
+    scan_for(FORCED_SYNC_MS * 3);
+    EXPECT_EQ(display_slave_changes, changes);
+
+    split_sim_master.layer_state = 1 << 2;
+    scan_for(20);
+    EXPECT_EQ(display_slave_changes, changes + 1);
+}
+
+class SplitSimStream : public SplitSim {
+   protected:
+    void SetUp() override {
+        SplitSim::SetUp();
+        for (uint16_t i = 0; i < STREAM_SIZE; i++) {
+            payload[i] = i ^ (i >> 8) ^ 0x5A;
+        }
+        memset(stream_received, 0, sizeof(stream_received));
+        stream_done_calls = 0;
+        stream_success    = false;
+        transaction_register_rpc_stream(USER_STREAM_SYNC, stream_receive);
+    }
+
+    // Scans until the stream is over, returns how many scans it took
+    uint32_t scan_stream(void) {
+        uint32_t scans = 0;
+        while (transaction_rpc_stream_busy() && scans < 10000) {
+            split_sim_scan();
+            scans++;
+        }
+        return scans;
+    }
+
+    uint8_t payload[STREAM_SIZE];
+};
+
+TEST_F(SplitSimStream, DeliversLargePayload) {
+    ASSERT_TRUE(transaction_rpc_stream(USER_STREAM_SYNC, payload, sizeof(payload), stream_done));
+    EXPECT_FALSE(transaction_rpc_stream(USER_STREAM_SYNC, payload, sizeof(payload), stream_done));
+
+    uint32_t scans = scan_stream();
+    EXPECT_EQ(stream_done_calls, 1);
+    EXPECT_TRUE(stream_success);
+    EXPECT_EQ(memcmp(stream_received, payload, sizeof(payload)), 0);
+    // one chunk per scan
+    EXPECT_EQ(scans, STREAM_SIZE / SPLIT_STREAM_CHUNK_SIZE);
+}
+
+TEST_F(SplitSimStream, SurvivesDroppedAndCorruptedBytes) {
+    config.drop_ppm    = 5000;
+    config.corrupt_ppm = 5000;
+    split_sim_configure(&config);
+
+    ASSERT_TRUE(transaction_rpc_stream(USER_STREAM_SYNC, payload, sizeof(payload), stream_done));
+    scan_stream();
+
+    split_sim_stats_t stats;
+    split_sim_get_stats(&stats);
+    EXPECT_GT(stats.failures, 0);
+    EXPECT_EQ(stream_done_calls, 1);
+    EXPECT_TRUE(stream_success);
+    EXPECT_EQ(memcmp(stream_received, payload, sizeof(payload)), 0);
+}
+
+TEST_F(SplitSimStream, UnregisteredStreamFails) {
+    transaction_register_rpc_stream(USER_STREAM_SYNC, NULL);
+    ASSERT_TRUE(transaction_rpc_stream(USER_STREAM_SYNC, payload, sizeof(payload), stream_done));
+    scan_stream();
+    EXPECT_EQ(stream_done_calls, 1);
+    EXPECT_FALSE(stream_success);
+}
+
+TEST_F(SplitSimStream, CoreTransactionsCannotBeStreamed) {
+    EXPECT_FALSE(transaction_rpc_stream(0, payload, sizeof(payload), stream_done));
+}
+
+TEST_F(SplitSimStream, SlaveKeysAreNotHeldUp) {
+    ASSERT_TRUE(transaction_rpc_stream(USER_STREAM_SYNC, payload, sizeof(payload), stream_done));
+
+    for (uint8_t i = 0; transaction_rpc_stream_busy() && i < 8; i++) {
+        uint8_t row = i % SPLIT_SIM_ROWS_PER_HAND;
+        split_sim_slave.matrix[SLAVE_ROW(row)] ^= 1 << (i % MATRIX_COLS);
+        split_sim_scan();
+        // still seen by the master in the first scan
+        EXPECT_EQ(split_sim_master.matrix[SLAVE_ROW(row)], split_sim_slave.matrix[SLAVE_ROW(row)]);
+    }
+
+    scan_stream();
+    EXPECT_TRUE(stream_success);
+    EXPECT_EQ(memcmp(stream_received, payload, sizeof(payload)), 0);
+}
@@ -0,0 +1,185 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "sync_scheduler.h"
+}
+
+class SyncScheduler : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        for (uint8_t item = 0; item < SPLIT_SYNC_ITEM_COUNT; item++) {
+            schedule[item] = {SPLIT_SYNC_PRIORITY_NORMAL, 10, 500};
+        }
+        schedule[SPLIT_SYNC_SLAVE_MATRIX] = {SPLIT_SYNC_PRIORITY_CRITICAL, 0, 100};
+        schedule[SPLIT_SYNC_LAYER_STATE]  = {SPLIT_SYNC_PRIORITY_HIGH, 0, 100};
+        schedule[SPLIT_SYNC_WPM]          = {SPLIT_SYNC_PRIORITY_LOW, 100, 1000};
+        split_sync_scheduler_init(&scheduler, schedule, 16, now);
+    }
+
+    // Runs `item` if it is due, returns whether it ran
+    bool run(uint8_t item, uint16_t bytes) {
+        if (!split_sync_due(&scheduler, item, now)) {
+            return false;
+        }
+        split_sync_done(&scheduler, item, bytes, now);
+        return true;
+    }
+
+    // Runs a scan the way the master does, tier by tier in two passes, returns the items that ran
+    std::vector<uint8_t> scan(uint16_t bytes) {
+        std::vector<uint8_t> ran;
+        split_sync_begin_scan(&scheduler);
+        for (uint8_t tier = 0; tier < SPLIT_SYNC_PRIORITY_COUNT; tier++) {
+            for (uint8_t pass = 0; pass < 2; pass++) {
+                for (uint8_t item = 0; item < SPLIT_SYNC_ITEM_COUNT; item++) {
+                    if (schedule[item].priority == tier && split_sync_in_turn(&scheduler, item, pass) && run(item, bytes)) {
+                        ran.push_back(item);
+                    }
+                }
+            }
+        }
+        split_sync_end_scan(&scheduler, now);
+        return ran;
+    }
+
+    split_sync_schedule_t  schedule[SPLIT_SYNC_ITEM_COUNT];
+    split_sync_scheduler_t scheduler;
+    uint32_t               now = 5000;
+};
+
+TEST_F(SyncScheduler, EverythingIsDueOnTheFirstScan) {
+    split_sync_begin_scan(&scheduler);
+    for (uint8_t item = 0; item < SPLIT_SYNC_ITEM_COUNT; item++) {
+        EXPECT_TRUE(run(item, 0)) << "item " << (int)item;
+    }
+}
+
+TEST_F(SyncScheduler, CriticalItemsRunEveryScanRegardlessOfBudget) {
+    for (int scan = 0; scan < 10; scan++) {
+        split_sync_begin_scan(&scheduler);
+        EXPECT_TRUE(run(SPLIT_SYNC_SLAVE_MATRIX, 100));
+        EXPECT_TRUE(run(SPLIT_SYNC_SLAVE_MATRIX, 100));
+        split_sync_end_scan(&scheduler, now);
+    }
+}
+
+TEST_F(SyncScheduler, MinimumIntervalLimitsRate) {
+    split_sync_begin_scan(&scheduler);
+    EXPECT_TRUE(run(SPLIT_SYNC_WPM, 1));
+
+    now += 99;
+    split_sync_begin_scan(&scheduler);
+    EXPECT_FALSE(run(SPLIT_SYNC_WPM, 1));
+
+    now += 1;
+    split_sync_begin_scan(&scheduler);
+    EXPECT_TRUE(run(SPLIT_SYNC_WPM, 1));
+}
+
+TEST_F(SyncScheduler, SpentBudgetDefersItemsToALaterScan) {
+    split_sync_begin_scan(&scheduler);
+    for (uint8_t item = 0; item < SPLIT_SYNC_ITEM_COUNT; item++) {
+        run(item, 0);
+    }
+
+    now += 10;
+    split_sync_begin_scan(&scheduler);
+    EXPECT_TRUE(run(SPLIT_SYNC_SLAVE_MATRIX, 10));
+    EXPECT_TRUE(run(SPLIT_SYNC_LAYER_STATE, 6));
+    EXPECT_FALSE(run(SPLIT_SYNC_RGB_MATRIX, 6));
+    EXPECT_FALSE(run(SPLIT_SYNC_MODS, 2));
+
+    now += 1;
+    split_sync_begin_scan(&scheduler);
+    EXPECT_TRUE(run(SPLIT_SYNC_SLAVE_MATRIX, 0));
+    EXPECT_TRUE(run(SPLIT_SYNC_RGB_MATRIX, 6));
+    EXPECT_TRUE(run(SPLIT_SYNC_MODS, 2));
+}
+
+TEST_F(SyncScheduler, ItemsCutOffByTheBudgetGoFirstNextScan) {
+    scan(0);
+
+    // the budget lets one item of the normal tier through per scan, after the matrix and layer state
+    now += 10;
+    EXPECT_EQ(scan(6), (std::vector<uint8_t>{SPLIT_SYNC_SLAVE_MATRIX, SPLIT_SYNC_LAYER_STATE, SPLIT_SYNC_MASTER_MATRIX}));
+    now += 10;
+    EXPECT_EQ(scan(6), (std::vector<uint8_t>{SPLIT_SYNC_SLAVE_MATRIX, SPLIT_SYNC_LAYER_STATE, SPLIT_SYNC_ENCODERS}));
+
+    // every normal item gets its turn before any of them runs again
+    std::vector<uint8_t> turns;
+    for (int i = 0; i < 13; i++) {
+        now += 10;
+        turns.push_back(scan(6).back());
+    }
+    EXPECT_EQ(turns, (std::vector<uint8_t>{SPLIT_SYNC_SYNC_TIMER, SPLIT_SYNC_LED_STATE, SPLIT_SYNC_MODS, SPLIT_SYNC_BACKLIGHT, SPLIT_SYNC_RGBLIGHT, SPLIT_SYNC_LED_MATRIX, SPLIT_SYNC_RGB_MATRIX, SPLIT_SYNC_OLED, SPLIT_SYNC_ST7565, SPLIT_SYNC_DISPLAY_STATE, SPLIT_SYNC_POINTING, SPLIT_SYNC_STREAM, SPLIT_SYNC_MASTER_MATRIX}));
+}
+
+TEST_F(SyncScheduler, OverdueItemsRunOverBudget) {
+    split_sync_begin_scan(&scheduler);
+    for (uint8_t item = 0; item < SPLIT_SYNC_ITEM_COUNT; item++) {
+        run(item, 0);
+    }
+
+    now += 499;
+    split_sync_begin_scan(&scheduler);
+    EXPECT_TRUE(run(SPLIT_SYNC_SLAVE_MATRIX, 50));
+    EXPECT_FALSE(run(SPLIT_SYNC_RGB_MATRIX, 6));
+
+    now += 1;
+    split_sync_begin_scan(&scheduler);
+    EXPECT_TRUE(run(SPLIT_SYNC_SLAVE_MATRIX, 50));
+    EXPECT_TRUE(run(SPLIT_SYNC_RGB_MATRIX, 6));
+}
+
+TEST_F(SyncScheduler, ReportsRatesAndBusUtilization) {
+    // one scan per millisecond, the matrix spends 4 bytes a scan, WPM 2 bytes when it runs
+    for (int scan = 0; scan < 1000; scan++) {
+        split_sync_begin_scan(&scheduler);
+        run(SPLIT_SYNC_SLAVE_MATRIX, 4);
+        run(SPLIT_SYNC_WPM, 2);
+        EXPECT_FALSE(split_sync_end_scan(&scheduler, now));
+        now++;
+    }
+    split_sync_begin_scan(&scheduler);
+    EXPECT_TRUE(split_sync_end_scan(&scheduler, now));
+
+    EXPECT_EQ(scheduler.rate[SPLIT_SYNC_SLAVE_MATRIX], 1000);
+    EXPECT_EQ(scheduler.rate[SPLIT_SYNC_WPM], 10);
+    EXPECT_EQ(scheduler.rate[SPLIT_SYNC_MODS], 0);
+    EXPECT_EQ(scheduler.bus_load, 4020);
+    // 4020 bytes over 1001 scans of a 16 byte budget
+    EXPECT_EQ(scheduler.bus_utilization, 25);
+}
+
+TEST_F(SyncScheduler, TimerWraparound) {
+    now = UINT32_MAX - 50;
+    split_sync_scheduler_init(&scheduler, schedule, 16, now);
+    split_sync_begin_scan(&scheduler);
+    EXPECT_TRUE(run(SPLIT_SYNC_WPM, 1));
+
+    now += 60;
+    split_sync_begin_scan(&scheduler);
+    EXPECT_FALSE(run(SPLIT_SYNC_WPM, 1));
+
+    now += 40;
+    split_sync_begin_scan(&scheduler);
+    EXPECT_TRUE(run(SPLIT_SYNC_WPM, 1));
+}
@@ -0,0 +1,12 @@
+TEST_LIST += \
+	transaction_batch \
+	matrix_delta \
+	input_queue \
+	sync_scheduler \
+	link_policy \
+	serial_frame \
+	transaction_stream \
+	split_sim \
+	split_sim_matrix_delta \
+	split_sim_batch \
+	split_sim_scheduler
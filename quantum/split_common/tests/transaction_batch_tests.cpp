@@ -0,0 +1,283 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <cstddef>
+#include <cstring>
+
+// transaction_id_define.h checks its size with the C keyword
+#define _Static_assert static_assert
+
+extern "C" {
+#include "crc.h"
+#include "transaction_batch.h"
+}
+
+struct shmem_t {
+    uint8_t  matrix_checksum;
+    uint8_t  matrix[5];
+    uint32_t layer_state;
+    uint8_t  mods[3];
+    uint8_t  rgb[12];
+    uint8_t  rpc[4];
+};
+
+enum { MATRIX_CHECKSUM, MATRIX_DATA, LAYER_STATE, MODS, RGB, RPC, ITEM_COUNT };
+
+#define I2T(member) \
+    { sizeof(((shmem_t *)0)->member), offsetof(shmem_t, member), 0, 0, NULL, false }
+#define T2I(member) \
+    { 0, 0, sizeof(((shmem_t *)0)->member), offsetof(shmem_t, member), NULL, false }
+
+static split_transaction_desc_t table[ITEM_COUNT] = {
+    [MATRIX_CHECKSUM] = T2I(matrix_checksum),
+    [MATRIX_DATA]     = T2I(matrix),
+    [LAYER_STATE]     = I2T(layer_state),
+    [MODS]            = I2T(mods),
+    [RGB]             = I2T(rgb),
+    [RPC]             = I2T(rpc),
+};
+
+#define BIT(id) (1UL << (id))
+
+class TransactionBatch : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        memset(&master, 0, sizeof(master));
+        memset(&slave, 0, sizeof(slave));
+        memset(frame, 0, sizeof(frame));
+    }
+
+    /* Moves a frame like a length prefixed transaction does: only the used
+     * part is sent, the rest of the receiving buffer keeps what it had. */
+    void wire(const uint8_t *source, uint8_t *destination) {
+        memcpy(destination, source, source[0]);
+    }
+
+    shmem_t master, slave;
+    uint8_t frame[SPLIT_BATCH_FRAME_SIZE];
+};
+
+TEST_F(TransactionBatch, CarriesOnlyRequestedItems) {
+    master.layer_state = 0x00040002;
+    master.mods[0]     = 0x02;
+    master.rgb[0]      = 0xAA;
+
+    uint32_t items  = BIT(LAYER_STATE) | BIT(MODS);
+    uint8_t  length = transaction_batch_encode(frame, sizeof(frame), 0, &items, table, ITEM_COUNT, true, &master);
+    EXPECT_EQ(length, TRANSACTION_BATCH_OVERHEAD + 4 + 3);
+    EXPECT_EQ(items, 0u);
+
+    uint8_t  received[SPLIT_BATCH_FRAME_SIZE];
+    uint8_t  flags;
+    uint32_t carried;
+    memset(received, 0xEE, sizeof(received));
+    wire(frame, received);
+    ASSERT_TRUE(transaction_batch_decode(received, sizeof(received), false, &flags, &carried, table, ITEM_COUNT, true, &slave));
+    EXPECT_EQ(carried, BIT(LAYER_STATE) | BIT(MODS));
+    EXPECT_EQ(flags, 0);
+    EXPECT_EQ(slave.layer_state, 0x00040002u);
+    EXPECT_EQ(slave.mods[0], 0x02);
+    EXPECT_EQ(slave.rgb[0], 0);
+}
+
+TEST_F(TransactionBatch, EmptyFrameStillCarriesFlags) {
+    uint32_t items  = 0;
+    uint8_t  length = transaction_batch_encode(frame, sizeof(frame), TRANSACTION_BATCH_FULL, &items, table, ITEM_COUNT, true, &master);
+    EXPECT_EQ(length, TRANSACTION_BATCH_OVERHEAD);
+
+    uint8_t  flags;
+    uint32_t carried = 0xFFFFFFFF;
+    ASSERT_TRUE(transaction_batch_decode(frame, sizeof(frame), false, &flags, &carried, table, ITEM_COUNT, true, &slave));
+    EXPECT_EQ(flags, TRANSACTION_BATCH_FULL);
+    EXPECT_EQ(carried, 0u);
+}
+
+TEST_F(TransactionBatch, ItemsThatDoNotFitStayPending) {
+    memset(master.rgb, 0x55, sizeof(master.rgb));
+    master.layer_state = 1;
+
+    // 7 bytes overhead, 4 for the layer state and 3 for mods leave no room for rgb
+    uint32_t items = BIT(LAYER_STATE) | BIT(MODS) | BIT(RGB);
+    transaction_batch_encode(frame, 20, 0, &items, table, ITEM_COUNT, true, &master);
+    EXPECT_EQ(items, BIT(RGB));
+
+    uint8_t  flags;
+    uint32_t carried;
+    ASSERT_TRUE(transaction_batch_decode(frame, 20, false, &flags, &carried, table, ITEM_COUNT, true, &slave));
+    EXPECT_EQ(carried, BIT(LAYER_STATE) | BIT(MODS));
+    EXPECT_EQ(slave.layer_state, 1u);
+
+    transaction_batch_encode(frame, 20, 0, &items, table, ITEM_COUNT, true, &master);
+    EXPECT_EQ(items, 0u);
+    ASSERT_TRUE(transaction_batch_decode(frame, 20, false, &flags, &carried, table, ITEM_COUNT, true, &slave));
+    EXPECT_EQ(carried, BIT(RGB));
+    EXPECT_EQ(slave.rgb[11], 0x55);
+}
+
+TEST_F(TransactionBatch, ItemsWithoutBufferInThisDirectionAreDropped) {
+    uint32_t items  = BIT(MATRIX_DATA) | BIT(MODS);
+    uint8_t  length = transaction_batch_encode(frame, sizeof(frame), 0, &items, table, ITEM_COUNT, true, &master);
+    EXPECT_EQ(length, TRANSACTION_BATCH_OVERHEAD + 3);
+    EXPECT_EQ(items, 0u);
+}
+
+TEST_F(TransactionBatch, CorruptFrameIsNotApplied) {
+    master.layer_state = 0x12345678;
+    uint32_t items     = BIT(LAYER_STATE);
+    uint8_t  length    = transaction_batch_encode(frame, sizeof(frame), 0, &items, table, ITEM_COUNT, true, &master);
+
+    uint8_t  flags;
+    uint32_t carried;
+    for (uint8_t i = 0; i < length; i++) {
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            frame[i] ^= 1 << bit;
+            EXPECT_FALSE(transaction_batch_decode(frame, sizeof(frame), false, &flags, &carried, table, ITEM_COUNT, true, &slave)) << "byte " << +i << " bit " << +bit;
+            frame[i] ^= 1 << bit;
+        }
+    }
+    EXPECT_EQ(slave.layer_state, 0u);
+    EXPECT_TRUE(transaction_batch_decode(frame, sizeof(frame), false, &flags, &carried, table, ITEM_COUNT, true, &slave));
+    EXPECT_EQ(slave.layer_state, 0x12345678u);
+}
+
+TEST_F(TransactionBatch, MismatchedTablesAreRejected) {
+    uint32_t items = BIT(MODS);
+    transaction_batch_encode(frame, sizeof(frame), 0, &items, table, ITEM_COUNT, true, &master);
+
+    split_transaction_desc_t other[ITEM_COUNT];
+    memcpy(other, table, sizeof(table));
+    other[MODS].initiator2target_buffer_size = 2;
+
+    uint8_t  flags;
+    uint32_t carried;
+    EXPECT_FALSE(transaction_batch_decode(frame, sizeof(frame), false, &flags, &carried, other, ITEM_COUNT, true, &slave));
+    // and an item the receiver does not know about
+    EXPECT_FALSE(transaction_batch_decode(frame, sizeof(frame), false, &flags, &carried, table, MODS, true, &slave));
+}
+
+TEST_F(TransactionBatch, FrameLongerThanBufferIsRejected) {
+    uint32_t items  = BIT(RGB);
+    uint8_t  length = transaction_batch_encode(frame, sizeof(frame), 0, &items, table, ITEM_COUNT, true, &master);
+
+    uint8_t  flags;
+    uint32_t carried;
+    EXPECT_FALSE(transaction_batch_decode(frame, length - 1, false, &flags, &carried, table, ITEM_COUNT, true, &slave));
+    frame[0] = 0;
+    EXPECT_FALSE(transaction_batch_decode(frame, sizeof(frame), false, &flags, &carried, table, ITEM_COUNT, true, &slave));
+}
+
+TEST_F(TransactionBatch, Crc16FrameCarriesItems) {
+    master.layer_state = 0x00040002;
+    master.mods[2]     = 0x40;
+
+    // 6 bytes header, 4 for the layer state and 2 of checksum leave no room for mods
+    uint32_t items  = BIT(LAYER_STATE) | BIT(MODS);
+    uint8_t  length = transaction_batch_encode(frame, 14, TRANSACTION_BATCH_CRC16, &items, table, ITEM_COUNT, true, &master);
+    EXPECT_EQ(length, TRANSACTION_BATCH_OVERHEAD + 1 + 4);
+    EXPECT_EQ(items, BIT(MODS));
+    EXPECT_EQ(crc16(frame, length - 2), frame[length - 2] << 8 | frame[length - 1]);
+
+    uint8_t  flags;
+    uint32_t carried;
+    ASSERT_TRUE(transaction_batch_decode(frame, 14, false, &flags, &carried, table, ITEM_COUNT, true, &slave));
+    EXPECT_EQ(flags, TRANSACTION_BATCH_CRC16);
+    EXPECT_EQ(carried, BIT(LAYER_STATE));
+    EXPECT_EQ(slave.layer_state, 0x00040002u);
+
+    transaction_batch_encode(frame, 14, TRANSACTION_BATCH_CRC16, &items, table, ITEM_COUNT, true, &master);
+    ASSERT_TRUE(transaction_batch_decode(frame, 14, false, &flags, &carried, table, ITEM_COUNT, true, &slave));
+    EXPECT_EQ(slave.mods[2], 0x40);
+}
+
+TEST_F(TransactionBatch, Crc16FrameRejectsBurstErrors) {
+    memset(master.rgb, 0xA5, sizeof(master.rgb));
+    uint32_t items  = BIT(RGB);
+    uint8_t  length = transaction_batch_encode(frame, sizeof(frame), TRANSACTION_BATCH_CRC16, &items, table, ITEM_COUNT, true, &master);
+
+    // Every burst of up to 16 bits, with a few patterns in between its first and last bit.
+    // The length byte is left alone, a frame of another length is caught by the item sizes.
+    uint8_t  flags;
+    uint32_t carried;
+    uint32_t random = 1;
+    for (uint16_t start = 8; start < length * 8; start++) {
+        for (uint8_t burst = 1; burst <= 16 && start + burst <= length * 8; burst++) {
+            for (uint8_t pattern = 0; pattern < 4; pattern++) {
+                random          = random * 1103515245 + 12345;
+                uint32_t errors = 1 | (1UL << (burst - 1)) | ((random >> 8) & ((1UL << burst) - 1));
+                uint8_t  copy[SPLIT_BATCH_FRAME_SIZE];
+                memcpy(copy, frame, length);
+                for (uint8_t bit = 0; bit < burst; bit++) {
+                    if (errors & (1UL << bit)) {
+                        copy[(start + bit) / 8] ^= 0x80 >> ((start + bit) % 8);
+                    }
+                }
+                ASSERT_FALSE(transaction_batch_decode(copy, sizeof(copy), false, &flags, &carried, table, ITEM_COUNT, true, &slave)) << "bit " << start << " burst " << +burst;
+            }
+        }
+    }
+    EXPECT_EQ(slave.rgb[0], 0);
+}
+
+TEST_F(TransactionBatch, Crc16OnlyRefusesPlainChecksums) {
+    master.layer_state = 0x00040002;
+    uint8_t  flags;
+    uint32_t carried;
+
+    // what a CRC-16 frame looks like if its flag bit flips and the crc8 happens to match
+    uint32_t items = BIT(LAYER_STATE);
+    transaction_batch_encode(frame, sizeof(frame), 0, &items, table, ITEM_COUNT, true, &master);
+    EXPECT_FALSE(transaction_batch_decode(frame, sizeof(frame), true, &flags, &carried, table, ITEM_COUNT, true, &slave));
+    EXPECT_EQ(slave.layer_state, 0u);
+    EXPECT_TRUE(transaction_batch_decode(frame, sizeof(frame), false, &flags, &carried, table, ITEM_COUNT, true, &slave));
+
+    items = BIT(LAYER_STATE);
+    transaction_batch_encode(frame, sizeof(frame), TRANSACTION_BATCH_CRC16, &items, table, ITEM_COUNT, true, &master);
+    EXPECT_TRUE(transaction_batch_decode(frame, sizeof(frame), true, &flags, &carried, table, ITEM_COUNT, true, &slave));
+}
+
+/* One scan worth of traffic in both directions, as transactions.c runs it. */
+TEST_F(TransactionBatch, LoopbackExchange) {
+    uint8_t  m2s[SPLIT_BATCH_FRAME_SIZE], s2m[SPLIT_BATCH_FRAME_SIZE];
+    uint8_t  flags;
+    uint32_t carried;
+
+    // slave publishes a key press
+    slave.matrix[2]       = 0x04;
+    slave.matrix_checksum = crc8(slave.matrix, sizeof(slave.matrix));
+    // master has a new layer and mods
+    master.layer_state = 0x8;
+    master.mods[1]     = 0x20;
+
+    uint32_t items = BIT(LAYER_STATE) | BIT(MODS);
+    transaction_batch_encode(frame, sizeof(frame), TRANSACTION_BATCH_FULL, &items, table, ITEM_COUNT, true, &master);
+    wire(frame, m2s);
+
+    ASSERT_TRUE(transaction_batch_decode(m2s, sizeof(m2s), false, &flags, &carried, table, ITEM_COUNT, true, &slave));
+    uint32_t reply = (flags & TRANSACTION_BATCH_FULL) ? BIT(MATRIX_CHECKSUM) | BIT(MATRIX_DATA) : 0;
+    transaction_batch_encode(frame, sizeof(frame), 0, &reply, table, ITEM_COUNT, false, &slave);
+    wire(frame, s2m);
+
+    ASSERT_TRUE(transaction_batch_decode(s2m, sizeof(s2m), false, &flags, &carried, table, ITEM_COUNT, false, &master));
+    EXPECT_EQ(carried, BIT(MATRIX_CHECKSUM) | BIT(MATRIX_DATA));
+    EXPECT_EQ(master.matrix[2], 0x04);
+    EXPECT_EQ(master.matrix_checksum, crc8(master.matrix, sizeof(master.matrix)));
+    EXPECT_EQ(slave.layer_state, 0x8u);
+    EXPECT_EQ(slave.mods[1], 0x20);
+    // items only travel in their own direction
+    EXPECT_EQ(master.rpc[0], 0);
+    EXPECT_EQ(slave.matrix_checksum, master.matrix_checksum);
+}
@@ -0,0 +1,250 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <cstring>
+
+#define _Static_assert static_assert
+
+extern "C" {
+#include "crc.h"
+#include "transaction_stream.h"
+}
+
+#define TEST_ID 20
+#define PAYLOAD_SIZE 100
+
+static uint8_t  received[PAYLOAD_SIZE];
+static uint16_t deliveries;
+static uint8_t  deliver_status;
+static uint8_t  done_calls;
+static bool     done_success;
+
+static uint8_t deliver(int8_t transaction_id, uint16_t total, uint16_t offset, const uint8_t *data, uint8_t length) {
+    EXPECT_EQ(transaction_id, TEST_ID);
+    EXPECT_EQ(total, PAYLOAD_SIZE);
+    if (deliver_status == TRANSACTION_STREAM_ACCEPTED) {
+        memcpy(&received[offset], data, length);
+        deliveries++;
+    }
+    return deliver_status;
+}
+
+static void done(int8_t transaction_id, bool success) {
+    EXPECT_EQ(transaction_id, TEST_ID);
+    done_calls++;
+    done_success = success;
+}
+
+class TransactionStream : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        memset(&sender, 0, sizeof(sender));
+        memset(&receiver, 0, sizeof(receiver));
+        memset(received, 0, sizeof(received));
+        for (uint8_t i = 0; i < PAYLOAD_SIZE; i++) {
+            payload[i] = i * 7 + 3;
+        }
+        deliveries     = 0;
+        deliver_status = TRANSACTION_STREAM_ACCEPTED;
+        done_calls     = 0;
+        done_success   = false;
+        now            = 0;
+        ASSERT_TRUE(transaction_stream_start(&sender, TEST_ID, payload, sizeof(payload), done, now));
+    }
+
+    // Runs one exchange, losing the chunk or the ack as asked
+    void exchange(bool lose_chunk = false, bool lose_ack = false) {
+        uint8_t frame[TRANSACTION_STREAM_FRAME_SIZE];
+        uint8_t ack[TRANSACTION_STREAM_ACK_SIZE];
+        transaction_stream_encode(&sender, frame);
+        if (!lose_chunk) {
+            transaction_stream_receive(&receiver, frame, sizeof(frame), ack, deliver);
+        }
+        transaction_stream_reply(&sender, lose_chunk || lose_ack ? NULL : ack, now);
+    }
+
+    // Runs exchanges until the stream is over, returns how many it took
+    uint16_t run(uint16_t limit = 100) {
+        uint16_t exchanges = 0;
+        while (transaction_stream_active(&sender) && exchanges < limit) {
+            exchange();
+            exchanges++;
+        }
+        return exchanges;
+    }
+
+    transaction_stream_sender_t   sender;
+    transaction_stream_receiver_t receiver;
+    uint8_t                       payload[PAYLOAD_SIZE];
+    uint32_t                      now;
+};
+
+TEST_F(TransactionStream, DeliversPayloadInChunks) {
+    EXPECT_EQ(run(), (PAYLOAD_SIZE + SPLIT_STREAM_CHUNK_SIZE - 1) / SPLIT_STREAM_CHUNK_SIZE);
+    EXPECT_EQ(memcmp(received, payload, sizeof(payload)), 0);
+    EXPECT_EQ(deliveries, (PAYLOAD_SIZE + SPLIT_STREAM_CHUNK_SIZE - 1) / SPLIT_STREAM_CHUNK_SIZE);
+    EXPECT_EQ(done_calls, 1);
+    EXPECT_TRUE(done_success);
+}
+
+TEST_F(TransactionStream, OnlyOneStreamAtATime) {
+    EXPECT_FALSE(transaction_stream_start(&sender, TEST_ID, payload, sizeof(payload), done, now));
+    run();
+    EXPECT_TRUE(transaction_stream_start(&sender, TEST_ID, payload, sizeof(payload), done, now));
+}
+
+TEST_F(TransactionStream, LostChunkIsSentAgain) {
+    exchange();
+    exchange(true);
+    EXPECT_EQ(sender.next, SPLIT_STREAM_CHUNK_SIZE);
+    run();
+    EXPECT_EQ(memcmp(received, payload, sizeof(payload)), 0);
+    EXPECT_TRUE(done_success);
+}
+
+TEST_F(TransactionStream, LostAckDoesNotDeliverTwice) {
+    exchange(false, true);
+    EXPECT_EQ(deliveries, 1);
+    EXPECT_EQ(sender.acked, 0);
+    run();
+    EXPECT_EQ(deliveries, (PAYLOAD_SIZE + SPLIT_STREAM_CHUNK_SIZE - 1) / SPLIT_STREAM_CHUNK_SIZE);
+    EXPECT_EQ(memcmp(received, payload, sizeof(payload)), 0);
+    EXPECT_TRUE(done_success);
+}
+
+TEST_F(TransactionStream, CorruptChunkIsIgnored) {
+    uint8_t frame[TRANSACTION_STREAM_FRAME_SIZE];
+    uint8_t ack[TRANSACTION_STREAM_ACK_SIZE];
+    transaction_stream_encode(&sender, frame);
+    frame[TRANSACTION_STREAM_HEADER_SIZE] ^= 0x10;
+    transaction_stream_receive(&receiver, frame, sizeof(frame), ack, deliver);
+    EXPECT_EQ(deliveries, 0);
+
+    // one chunk may be in flight beyond what the slave has, the next goes back
+    transaction_stream_reply(&sender, ack, now);
+    EXPECT_EQ(sender.next, SPLIT_STREAM_CHUNK_SIZE);
+    exchange();
+    EXPECT_EQ(sender.next, 0);
+    run();
+    EXPECT_EQ(memcmp(received, payload, sizeof(payload)), 0);
+}
+
+TEST_F(TransactionStream, CorruptAckIsIgnored) {
+    uint8_t frame[TRANSACTION_STREAM_FRAME_SIZE];
+    uint8_t ack[TRANSACTION_STREAM_ACK_SIZE];
+    transaction_stream_encode(&sender, frame);
+    transaction_stream_receive(&receiver, frame, sizeof(frame), ack, deliver);
+    ack[2] ^= 0x40;
+    transaction_stream_reply(&sender, ack, now);
+    EXPECT_EQ(sender.acked, 0);
+    EXPECT_TRUE(transaction_stream_active(&sender));
+}
+
+// Drivers that hand the slave a frame only after it answered
+TEST_F(TransactionStream, LateChunksKeepUp) {
+    uint8_t  pending[TRANSACTION_STREAM_FRAME_SIZE] = {0};
+    uint16_t exchanges                              = 0;
+    while (transaction_stream_active(&sender) && exchanges < 100) {
+        uint8_t frame[TRANSACTION_STREAM_FRAME_SIZE];
+        uint8_t ack[TRANSACTION_STREAM_ACK_SIZE];
+        transaction_stream_encode(&sender, frame);
+        transaction_stream_receive(&receiver, pending, sizeof(pending), ack, deliver);
+        memcpy(pending, frame, sizeof(frame));
+        transaction_stream_reply(&sender, ack, now);
+        exchanges++;
+    }
+
+    EXPECT_EQ(exchanges, (PAYLOAD_SIZE + SPLIT_STREAM_CHUNK_SIZE - 1) / SPLIT_STREAM_CHUNK_SIZE + 1);
+    EXPECT_EQ(memcmp(received, payload, sizeof(payload)), 0);
+    EXPECT_TRUE(done_success);
+}
+
+TEST_F(TransactionStream, BusyChunkIsSentAgain) {
+    deliver_status = TRANSACTION_STREAM_BUSY;
+    exchange();
+    exchange();
+    EXPECT_EQ(sender.acked, 0);
+    EXPECT_EQ(sender.next, 0);
+
+    deliver_status = TRANSACTION_STREAM_ACCEPTED;
+    run();
+    EXPECT_EQ(memcmp(received, payload, sizeof(payload)), 0);
+    EXPECT_TRUE(done_success);
+}
+
+TEST_F(TransactionStream, RefusedStreamFails) {
+    deliver_status = TRANSACTION_STREAM_REFUSED;
+    EXPECT_EQ(run(), 1);
+    EXPECT_EQ(done_calls, 1);
+    EXPECT_FALSE(done_success);
+}
+
+TEST_F(TransactionStream, NoReceiverRefuses) {
+    uint8_t frame[TRANSACTION_STREAM_FRAME_SIZE];
+    uint8_t ack[TRANSACTION_STREAM_ACK_SIZE];
+    transaction_stream_encode(&sender, frame);
+    transaction_stream_receive(&receiver, frame, sizeof(frame), ack, NULL);
+    EXPECT_EQ(ack[4], TRANSACTION_STREAM_REFUSED);
+}
+
+TEST_F(TransactionStream, TimesOutWithoutProgress) {
+    exchange();
+    now += SPLIT_STREAM_TIMEOUT - 1;
+    exchange(true);
+    EXPECT_TRUE(transaction_stream_active(&sender));
+
+    now += 1;
+    transaction_stream_expire(&sender, now);
+    EXPECT_FALSE(transaction_stream_active(&sender));
+    EXPECT_EQ(done_calls, 1);
+    EXPECT_FALSE(done_success);
+}
+
+TEST_F(TransactionStream, AbortFailsTheStream) {
+    exchange();
+    transaction_stream_abort(&sender);
+    EXPECT_FALSE(transaction_stream_active(&sender));
+    EXPECT_EQ(done_calls, 1);
+    EXPECT_FALSE(done_success);
+}
+
+TEST_F(TransactionStream, NewStreamRestartsReceiver) {
+    exchange();
+    transaction_stream_abort(&sender);
+
+    // an ack left over from the aborted stream says nothing about the new one
+    uint8_t consumed[TRANSACTION_STREAM_FRAME_SIZE] = {0};
+    uint8_t stale[TRANSACTION_STREAM_ACK_SIZE];
+    transaction_stream_receive(&receiver, consumed, sizeof(consumed), stale, deliver);
+    ASSERT_TRUE(transaction_stream_start(&sender, TEST_ID, payload, sizeof(payload), done, now));
+    transaction_stream_reply(&sender, stale, now);
+    EXPECT_EQ(sender.acked, 0);
+
+    memset(received, 0, sizeof(received));
+    run();
+    EXPECT_EQ(memcmp(received, payload, sizeof(payload)), 0);
+    EXPECT_EQ(done_calls, 2);
+    EXPECT_TRUE(done_success);
+}
+
+TEST_F(TransactionStream, EmptyPayloadCompletes) {
+    transaction_stream_abort(&sender);
+    ASSERT_TRUE(transaction_stream_start(&sender, TEST_ID, payload, 0, done, now));
+    EXPECT_EQ(run(), 1);
+    EXPECT_EQ(deliveries, 0);
+    EXPECT_TRUE(done_success);
+}
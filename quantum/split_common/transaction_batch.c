@@ -0,0 +1,124 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "crc.h"
+#include "transaction_batch.h"
+
+static inline uint8_t item_size(const split_transaction_desc_t *trans, bool initiator2target) {
+    return initiator2target ? trans->initiator2target_buffer_size : trans->target2initiator_buffer_size;
+}
+
+static inline uint16_t item_offset(const split_transaction_desc_t *trans, bool initiator2target) {
+    return initiator2target ? trans->initiator2target_offset : trans->target2initiator_offset;
+}
+
+static inline uint8_t checksum_size(uint8_t flags) {
+    return (flags & TRANSACTION_BATCH_CRC16) ? 2 : 1;
+}
+
+static bool checksum_valid(const uint8_t *frame, uint8_t length, uint8_t checksum) {
+    if (checksum == 2) {
+        return crc16(frame, length - 2) == ((uint16_t)frame[length - 2] << 8 | frame[length - 1]);
+    }
+    return crc8(frame, length - 1) == frame[length - 1];
+}
+
+uint8_t transaction_batch_encode(uint8_t *frame, uint8_t size, uint8_t flags, uint32_t *items, const split_transaction_desc_t *table, uint8_t count, bool initiator2target, const void *shmem) {
+    uint32_t carried  = 0;
+    uint8_t  length   = TRANSACTION_BATCH_HEADER_SIZE;
+    uint8_t  checksum = checksum_size(flags);
+
+    for (uint8_t id = 0; id < count; id++) {
+        if (!(*items & (1UL << id))) {
+            continue;
+        }
+        uint8_t len = item_size(&table[id], initiator2target);
+        if (len == 0) {
+            // nothing to carry in this direction
+            *items &= ~(1UL << id);
+            continue;
+        }
+        if (length + len + checksum > size) {
+            continue;
+        }
+        memcpy(&frame[length], (const uint8_t *)shmem + item_offset(&table[id], initiator2target), len);
+        length += len;
+        carried |= 1UL << id;
+    }
+
+    frame[0] = length + checksum;
+    frame[1] = flags;
+    frame[2] = carried & 0xFF;
+    frame[3] = (carried >> 8) & 0xFF;
+    frame[4] = (carried >> 16) & 0xFF;
+    frame[5] = (carried >> 24) & 0xFF;
+
+    if (flags & TRANSACTION_BATCH_CRC16) {
+        uint16_t crc      = crc16(frame, length);
+        frame[length]     = crc >> 8;
+        frame[length + 1] = crc & 0xFF;
+    } else {
+        frame[length] = crc8(frame, length);
+    }
+
+    *items &= ~carried;
+    return length + checksum;
+}
+
+bool transaction_batch_decode(const uint8_t *frame, uint8_t size, bool crc16_only, uint8_t *flags, uint32_t *items, const split_transaction_desc_t *table, uint8_t count, bool initiator2target, void *shmem) {
+    uint8_t length   = frame[0];
+    uint8_t checksum = checksum_size(frame[1]);
+    // the flags aren't checked yet, so they can't be trusted to pick the weaker checksum
+    if (crc16_only && checksum != 2) {
+        return false;
+    }
+    if (length < TRANSACTION_BATCH_HEADER_SIZE + checksum || length > size) {
+        return false;
+    }
+    if (!checksum_valid(frame, length, checksum)) {
+        return false;
+    }
+
+    uint32_t carried  = (uint32_t)frame[2] | ((uint32_t)frame[3] << 8) | ((uint32_t)frame[4] << 16) | ((uint32_t)frame[5] << 24);
+    uint16_t expected = TRANSACTION_BATCH_HEADER_SIZE + checksum;
+    for (uint8_t id = 0; id < 32; id++) {
+        if (carried & (1UL << id)) {
+            if (id >= count || item_size(&table[id], initiator2target) == 0) {
+                return false;
+            }
+            expected += item_size(&table[id], initiator2target);
+        }
+    }
+    // both halves must agree on every buffer size, or the items would shift
+    if (expected != length) {
+        return false;
+    }
+
+    const uint8_t *item = &frame[TRANSACTION_BATCH_HEADER_SIZE];
+    for (uint8_t id = 0; id < count; id++) {
+        if (carried & (1UL << id)) {
+            uint8_t len = item_size(&table[id], initiator2target);
+            memcpy((uint8_t *)shmem + item_offset(&table[id], initiator2target), item, len);
+            item += len;
+        }
+    }
+
+    *flags = frame[1];
+    *items = carried;
+    return true;
+}
@@ -0,0 +1,52 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "transactions.h"
+
+/* Batched sync frame, one per direction and exchange (SPLIT_BATCH_SYNC_ENABLE).
+ *
+ * [0]     frame length, including this byte and the checksum
+ * [1]     flags
+ * [2..5]  bit n set: transaction n is carried, little endian
+ * [6..]   the buffers of those transactions in ID order, each at its table size
+ * [len-1] crc8 of everything before it, or
+ * [len-2] CRC-16/CCITT of everything before it, big endian, with TRANSACTION_BATCH_CRC16
+ */
+#define TRANSACTION_BATCH_HEADER_SIZE 6
+#define TRANSACTION_BATCH_OVERHEAD (TRANSACTION_BATCH_HEADER_SIZE + 1)
+
+enum transaction_batch_flags {
+    TRANSACTION_BATCH_FULL         = (1 << 0), // initiator asks for every item, not just the changed ones
+    TRANSACTION_BATCH_REJECTED     = (1 << 1), // target dropped a corrupt frame
+    TRANSACTION_BATCH_CRC16        = (1 << 2), // this frame ends with a CRC-16 instead of a crc8
+    TRANSACTION_BATCH_CRC16_ACCEPT = (1 << 3), // sender checks CRC-16 frames, so the other half may switch to them
+};
+
+/* Packs the `*items` transaction buffers of one direction from `shmem` into
+ * `frame`. Items that do not fit in `size` bytes are left set in `*items` for
+ * the next frame, the others are cleared. Returns the frame length. */
+uint8_t transaction_batch_encode(uint8_t *frame, uint8_t size, uint8_t flags, uint32_t *items, const split_transaction_desc_t *table, uint8_t count, bool initiator2target, const void *shmem);
+
+/* Checks `frame` and, only if it is intact and matches `table`, copies the
+ * items it carries to `shmem`. Stores the carried items and the flags. Once
+ * both halves use CRC-16, `crc16_only` drops frames that claim a crc8, so a
+ * flipped flag bit can't weaken the check. */
+bool transaction_batch_decode(const uint8_t *frame, uint8_t size, bool crc16_only, uint8_t *flags, uint32_t *items, const split_transaction_desc_t *table, uint8_t count, bool initiator2target, void *shmem);
@@ -21,16 +21,24 @@ enum serial_transaction_id {
     I2C_EXECUTE_CALLBACK,
 #endif // USE_I2C
 
+#ifdef SPLIT_MATRIX_DELTA_ENABLE
+    GET_SLAVE_MATRIX_DELTA,
+#else // SPLIT_MATRIX_DELTA_ENABLE
     GET_SLAVE_MATRIX_CHECKSUM,
     GET_SLAVE_MATRIX_DATA,
+#endif // SPLIT_MATRIX_DELTA_ENABLE
 
 #ifdef SPLIT_TRANSPORT_MIRROR
     PUT_MASTER_MATRIX,
 #endif // SPLIT_TRANSPORT_MIRROR
 
 #ifdef ENCODER_ENABLE
+#    ifdef SPLIT_ENCODER_QUEUE_ENABLE
+    GET_ENCODERS_QUEUE,
+#    else // SPLIT_ENCODER_QUEUE_ENABLE
     GET_ENCODERS_CHECKSUM,
     GET_ENCODERS_DATA,
+#    endif // SPLIT_ENCODER_QUEUE_ENABLE
 #endif // ENCODER_ENABLE
 
 #ifndef DISABLE_SYNC_TIMER
@@ -78,12 +86,28 @@ enum serial_transaction_id {
     PUT_ST7565,
 #endif // defined(ST7565_ENABLE) && defined(SPLIT_ST7565_ENABLE)
 
+#ifdef SPLIT_DISPLAY_STATE_ENABLE
+    PUT_DISPLAY_STATE,
+#endif // SPLIT_DISPLAY_STATE_ENABLE
+
 #if defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
+#    ifdef SPLIT_POINTING_QUEUE_ENABLE
+    GET_POINTING_QUEUE,
+#    else // SPLIT_POINTING_QUEUE_ENABLE
     GET_POINTING_CHECKSUM,
     GET_POINTING_DATA,
+#    endif // SPLIT_POINTING_QUEUE_ENABLE
     PUT_POINTING_CPI,
 #endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
+#ifdef SPLIT_BATCH_SYNC_ENABLE
+    SYNC_BATCH,
+#endif // SPLIT_BATCH_SYNC_ENABLE
+
+#ifdef SPLIT_STREAM_ENABLE
+    STREAM_CHUNK,
+#endif // SPLIT_STREAM_ENABLE
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
     PUT_RPC_INFO,
     PUT_RPC_REQ_DATA,
@@ -0,0 +1,166 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "crc.h"
+#include "util.h"
+#include "transaction_stream.h"
+
+static void finish(transaction_stream_sender_t *sender, bool success) {
+    transaction_stream_done_t done = sender->done;
+    // cleared first, so that `done` can start the next stream
+    sender->active = false;
+    sender->data   = NULL;
+    sender->done   = NULL;
+    if (done) {
+        done(sender->transaction_id, success);
+    }
+}
+
+bool transaction_stream_start(transaction_stream_sender_t *sender, int8_t transaction_id, const void *data, uint16_t length, transaction_stream_done_t done, uint32_t now) {
+    if (sender->active) {
+        return false;
+    }
+
+    // tag 0 is what a receiver starts with, so it never names a stream
+    if (++sender->tag == 0) {
+        sender->tag = 1;
+    }
+    sender->data           = data;
+    sender->length         = length;
+    sender->acked          = 0;
+    sender->next           = 0;
+    sender->transaction_id = transaction_id;
+    sender->active         = true;
+    sender->last_progress  = now;
+    sender->done           = done;
+    return true;
+}
+
+bool transaction_stream_active(const transaction_stream_sender_t *sender) {
+    return sender->active;
+}
+
+uint8_t transaction_stream_encode(transaction_stream_sender_t *sender, uint8_t *frame) {
+    uint8_t length = MIN(sender->length - sender->next, SPLIT_STREAM_CHUNK_SIZE);
+
+    frame[0] = TRANSACTION_STREAM_HEADER_SIZE + length + 1;
+    frame[1] = sender->transaction_id;
+    frame[2] = sender->tag;
+    frame[3] = sender->next & 0xFF;
+    frame[4] = sender->next >> 8;
+    frame[5] = sender->length & 0xFF;
+    frame[6] = sender->length >> 8;
+    memcpy(&frame[TRANSACTION_STREAM_HEADER_SIZE], &sender->data[sender->next], length);
+    frame[TRANSACTION_STREAM_HEADER_SIZE + length] = crc8(frame, TRANSACTION_STREAM_HEADER_SIZE + length);
+
+    sender->next += length;
+    return frame[0];
+}
+
+void transaction_stream_reply(transaction_stream_sender_t *sender, const uint8_t *ack, uint32_t now) {
+    if (!sender->active) {
+        return;
+    }
+
+    // Acks of an earlier stream, or of a slave that has not seen this one yet, say nothing
+    bool valid = ack && ack[0] == TRANSACTION_STREAM_ACK_SIZE && crc8(ack, TRANSACTION_STREAM_ACK_SIZE - 1) == ack[TRANSACTION_STREAM_ACK_SIZE - 1] && ack[1] == sender->tag;
+    if (valid) {
+        uint16_t expected = ack[2] | (ack[3] << 8);
+        if ((ack[4] & TRANSACTION_STREAM_REFUSED) || expected > sender->length) {
+            finish(sender, false);
+            return;
+        }
+
+        if (expected != sender->acked) {
+            // usually progress, or a slave that restarted and wants it all again
+            sender->acked         = expected;
+            sender->last_progress = now;
+        }
+        if (sender->acked == sender->length) {
+            finish(sender, true);
+            return;
+        }
+    }
+
+    // Go back to what the slave has if the exchange failed, if it did not take
+    // the chunk, or if more than one chunk has gone unacknowledged
+    if (!ack || (valid && (ack[4] & TRANSACTION_STREAM_BUSY)) || sender->next < sender->acked || sender->next - sender->acked > SPLIT_STREAM_CHUNK_SIZE) {
+        sender->next = sender->acked;
+    }
+    transaction_stream_expire(sender, now);
+}
+
+void transaction_stream_expire(transaction_stream_sender_t *sender, uint32_t now) {
+    if (sender->active && now - sender->last_progress >= SPLIT_STREAM_TIMEOUT) {
+        finish(sender, false);
+    }
+}
+
+void transaction_stream_abort(transaction_stream_sender_t *sender) {
+    if (sender->active) {
+        finish(sender, false);
+    }
+}
+
+static bool frame_is_valid(const uint8_t *frame, uint8_t size) {
+    uint8_t length = frame[0];
+    if (length < TRANSACTION_STREAM_HEADER_SIZE + 1 || length > size || length > TRANSACTION_STREAM_FRAME_SIZE) {
+        return false;
+    }
+    if (crc8(frame, length - 1) != frame[length - 1]) {
+        return false;
+    }
+
+    uint16_t offset = frame[3] | (frame[4] << 8);
+    uint16_t total  = frame[5] | (frame[6] << 8);
+    return offset <= total && total - offset >= length - TRANSACTION_STREAM_HEADER_SIZE - 1;
+}
+
+void transaction_stream_receive(transaction_stream_receiver_t *receiver, const uint8_t *frame, uint8_t size, uint8_t *ack, transaction_stream_deliver_t deliver) {
+    uint8_t status = receiver->status;
+
+    if (frame_is_valid(frame, size)) {
+        uint8_t  tag    = frame[2];
+        uint16_t offset = frame[3] | (frame[4] << 8);
+        uint16_t total  = frame[5] | (frame[6] << 8);
+        uint8_t  length = frame[0] - TRANSACTION_STREAM_HEADER_SIZE - 1;
+
+        if (tag != receiver->tag) {
+            receiver->tag      = tag;
+            receiver->expected = 0;
+            receiver->status   = TRANSACTION_STREAM_ACCEPTED;
+        }
+
+        status = receiver->status;
+        if (offset == receiver->expected && length > 0 && status == TRANSACTION_STREAM_ACCEPTED) {
+            status = deliver ? deliver((int8_t)frame[1], total, offset, &frame[TRANSACTION_STREAM_HEADER_SIZE], length) : TRANSACTION_STREAM_REFUSED;
+            if (status == TRANSACTION_STREAM_ACCEPTED) {
+                receiver->expected += length;
+            } else if (status == TRANSACTION_STREAM_REFUSED) {
+                receiver->status = TRANSACTION_STREAM_REFUSED;
+            }
+        }
+    }
+
+    ack[0] = TRANSACTION_STREAM_ACK_SIZE;
+    ack[1] = receiver->tag;
+    ack[2] = receiver->expected & 0xFF;
+    ack[3] = receiver->expected >> 8;
+    ack[4] = status;
+    ack[5] = crc8(ack, TRANSACTION_STREAM_ACK_SIZE - 1);
+}
@@ -0,0 +1,111 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef SPLIT_STREAM_CHUNK_SIZE
+#    define SPLIT_STREAM_CHUNK_SIZE 32
+#endif // SPLIT_STREAM_CHUNK_SIZE
+
+#ifndef SPLIT_STREAM_TIMEOUT
+#    define SPLIT_STREAM_TIMEOUT 1000
+#endif // SPLIT_STREAM_TIMEOUT
+
+/* Streamed split RPC (SPLIT_STREAM_ENABLE).
+ *
+ * The master sends a payload one chunk per exchange, the slave acknowledges
+ * how much of it it has taken so far:
+ *
+ * chunk    [0]      frame length, including this byte and the checksum
+ *          [1]      transaction ID the payload is for
+ *          [2]      tag, different for every stream
+ *          [3..4]   offset of the chunk, little endian
+ *          [5..6]   length of the whole payload, little endian
+ *          [7..]    up to SPLIT_STREAM_CHUNK_SIZE bytes of the payload
+ *          [len-1]  crc8 of everything before it
+ *
+ * ack      [0]      TRANSACTION_STREAM_ACK_SIZE
+ *          [1]      tag of the stream
+ *          [2..3]   offset of the next byte the slave expects, little endian
+ *          [4]      TRANSACTION_STREAM_BUSY / TRANSACTION_STREAM_REFUSED
+ *          [5]      crc8 of everything before it
+ *
+ * The slave only takes the chunk at the offset it expects, so a lost chunk or
+ * ack makes the master go back to that offset. The master keeps at most one
+ * chunk in flight beyond what was acknowledged, which lets drivers that hand
+ * the slave a frame only after it answered keep up. A stream fails once it
+ * makes no progress for SPLIT_STREAM_TIMEOUT ms.
+ */
+#define TRANSACTION_STREAM_HEADER_SIZE 7
+#define TRANSACTION_STREAM_FRAME_SIZE (TRANSACTION_STREAM_HEADER_SIZE + SPLIT_STREAM_CHUNK_SIZE + 1)
+#define TRANSACTION_STREAM_ACK_SIZE 6
+
+#define TRANSACTION_STREAM_ACCEPTED 0x00
+#define TRANSACTION_STREAM_BUSY 0x01    // not taken now, send it again
+#define TRANSACTION_STREAM_REFUSED 0x02 // nobody takes this stream
+
+_Static_assert(TRANSACTION_STREAM_FRAME_SIZE <= UINT8_MAX, "SPLIT_STREAM_CHUNK_SIZE too large");
+
+typedef void (*transaction_stream_done_t)(int8_t transaction_id, bool success);
+
+/* Hands a chunk to whoever takes the stream. Returns one of the
+ * TRANSACTION_STREAM_ACCEPTED/BUSY/REFUSED values. */
+typedef uint8_t (*transaction_stream_deliver_t)(int8_t transaction_id, uint16_t total, uint16_t offset, const uint8_t *data, uint8_t length);
+
+typedef struct {
+    const uint8_t *           data;
+    uint16_t                  length;
+    uint16_t                  acked; // bytes the slave has taken
+    uint16_t                  next;  // offset of the next chunk to send
+    int8_t                    transaction_id;
+    uint8_t                   tag;
+    bool                      active;
+    uint32_t                  last_progress;
+    transaction_stream_done_t done;
+} transaction_stream_sender_t;
+
+typedef struct {
+    uint8_t  tag;
+    uint16_t expected; // offset of the next byte to take
+    uint8_t  status;   // TRANSACTION_STREAM_REFUSED once refused
+} transaction_stream_receiver_t;
+
+/* Starts sending `length` bytes of `data`, which must stay untouched until
+ * `done` is called. Returns false if a stream is already running. */
+bool transaction_stream_start(transaction_stream_sender_t *sender, int8_t transaction_id, const void *data, uint16_t length, transaction_stream_done_t done, uint32_t now);
+
+bool transaction_stream_active(const transaction_stream_sender_t *sender);
+
+/* Writes the next chunk to `frame`, which holds TRANSACTION_STREAM_FRAME_SIZE
+ * bytes. Returns the frame length. */
+uint8_t transaction_stream_encode(transaction_stream_sender_t *sender, uint8_t *frame);
+
+/* Takes the slave's answer to the last chunk, NULL if the exchange failed, and
+ * finishes the stream once it is complete, refused or out of time. */
+void transaction_stream_reply(transaction_stream_sender_t *sender, const uint8_t *ack, uint32_t now);
+
+/* Fails the stream if it made no progress for SPLIT_STREAM_TIMEOUT ms. */
+void transaction_stream_expire(transaction_stream_sender_t *sender, uint32_t now);
+
+/* Stops the stream, calling `done` with success = false. */
+void transaction_stream_abort(transaction_stream_sender_t *sender);
+
+/* Checks `frame` and, only if it is intact and the chunk the receiver expects,
+ * delivers it. Writes the ack for the receiver's state to `ack`. */
+void transaction_stream_receive(transaction_stream_receiver_t *receiver, const uint8_t *frame, uint8_t size, uint8_t *ack, transaction_stream_deliver_t deliver);
@@ -26,6 +26,11 @@
 #include "transaction_id_define.h"
 #include "split_util.h"
 #include "synchronization_util.h"
+#include "transaction_batch.h"
+#include "matrix_delta.h"
+#include "input_queue.h"
+#include "sync_scheduler.h"
+#include "link_policy.h"
 
 #define SYNC_TIMER_OFFSET 2
 
@@ -33,6 +38,80 @@
 #    define FORCED_SYNC_THROTTLE_MS 100
 #endif // FORCED_SYNC_THROTTLE_MS
 
+// Priority, min and max interval in ms of each sync item, see sync_scheduler.h
+#ifndef SPLIT_SYNC_SCHEDULE_SLAVE_MATRIX
+#    define SPLIT_SYNC_SCHEDULE_SLAVE_MATRIX SPLIT_SYNC_PRIORITY_CRITICAL, 0, FORCED_SYNC_THROTTLE_MS
+#endif // SPLIT_SYNC_SCHEDULE_SLAVE_MATRIX
+#ifndef SPLIT_SYNC_SCHEDULE_POINTING
+#    define SPLIT_SYNC_SCHEDULE_POINTING SPLIT_SYNC_PRIORITY_CRITICAL, 0, FORCED_SYNC_THROTTLE_MS
+#endif // SPLIT_SYNC_SCHEDULE_POINTING
+#ifndef SPLIT_SYNC_SCHEDULE_MASTER_MATRIX
+#    define SPLIT_SYNC_SCHEDULE_MASTER_MATRIX SPLIT_SYNC_PRIORITY_HIGH, 0, FORCED_SYNC_THROTTLE_MS
+#endif // SPLIT_SYNC_SCHEDULE_MASTER_MATRIX
+#ifndef SPLIT_SYNC_SCHEDULE_ENCODERS
+#    define SPLIT_SYNC_SCHEDULE_ENCODERS SPLIT_SYNC_PRIORITY_HIGH, 0, FORCED_SYNC_THROTTLE_MS
+#endif // SPLIT_SYNC_SCHEDULE_ENCODERS
+#ifndef SPLIT_SYNC_SCHEDULE_SYNC_TIMER
+#    define SPLIT_SYNC_SCHEDULE_SYNC_TIMER SPLIT_SYNC_PRIORITY_HIGH, 0, FORCED_SYNC_THROTTLE_MS
+#endif // SPLIT_SYNC_SCHEDULE_SYNC_TIMER
+#ifndef SPLIT_SYNC_SCHEDULE_LAYER_STATE
+#    define SPLIT_SYNC_SCHEDULE_LAYER_STATE SPLIT_SYNC_PRIORITY_HIGH, 0, FORCED_SYNC_THROTTLE_MS
+#endif // SPLIT_SYNC_SCHEDULE_LAYER_STATE
+#ifndef SPLIT_SYNC_SCHEDULE_LED_STATE
+#    define SPLIT_SYNC_SCHEDULE_LED_STATE SPLIT_SYNC_PRIORITY_HIGH, 0, FORCED_SYNC_THROTTLE_MS
+#endif // SPLIT_SYNC_SCHEDULE_LED_STATE
+#ifndef SPLIT_SYNC_SCHEDULE_MODS
+#    define SPLIT_SYNC_SCHEDULE_MODS SPLIT_SYNC_PRIORITY_HIGH, 0, FORCED_SYNC_THROTTLE_MS
+#endif // SPLIT_SYNC_SCHEDULE_MODS
+#ifndef SPLIT_SYNC_SCHEDULE_BACKLIGHT
+#    define SPLIT_SYNC_SCHEDULE_BACKLIGHT SPLIT_SYNC_PRIORITY_NORMAL, 10, 500
+#endif // SPLIT_SYNC_SCHEDULE_BACKLIGHT
+#ifndef SPLIT_SYNC_SCHEDULE_RGBLIGHT
+#    define SPLIT_SYNC_SCHEDULE_RGBLIGHT SPLIT_SYNC_PRIORITY_NORMAL, 10, 500
+#endif // SPLIT_SYNC_SCHEDULE_RGBLIGHT
+#ifndef SPLIT_SYNC_SCHEDULE_LED_MATRIX
+#    define SPLIT_SYNC_SCHEDULE_LED_MATRIX SPLIT_SYNC_PRIORITY_NORMAL, 10, 500
+#endif // SPLIT_SYNC_SCHEDULE_LED_MATRIX
+#ifndef SPLIT_SYNC_SCHEDULE_RGB_MATRIX
+#    define SPLIT_SYNC_SCHEDULE_RGB_MATRIX SPLIT_SYNC_PRIORITY_NORMAL, 10, 500
+#endif // SPLIT_SYNC_SCHEDULE_RGB_MATRIX
+#ifndef SPLIT_SYNC_SCHEDULE_WPM
+#    define SPLIT_SYNC_SCHEDULE_WPM SPLIT_SYNC_PRIORITY_LOW, 100, 1000
+#endif // SPLIT_SYNC_SCHEDULE_WPM
+#ifndef SPLIT_SYNC_SCHEDULE_OLED
+#    define SPLIT_SYNC_SCHEDULE_OLED SPLIT_SYNC_PRIORITY_LOW, 100, 1000
+#endif // SPLIT_SYNC_SCHEDULE_OLED
+#ifndef SPLIT_SYNC_SCHEDULE_ST7565
+#    define SPLIT_SYNC_SCHEDULE_ST7565 SPLIT_SYNC_PRIORITY_LOW, 100, 1000
+#endif // SPLIT_SYNC_SCHEDULE_ST7565
+#ifndef SPLIT_SYNC_SCHEDULE_DISPLAY_STATE
+#    define SPLIT_SYNC_SCHEDULE_DISPLAY_STATE SPLIT_SYNC_PRIORITY_LOW, 10, 1000
+#endif // SPLIT_SYNC_SCHEDULE_DISPLAY_STATE
+#ifndef SPLIT_SYNC_SCHEDULE_STREAM
+#    define SPLIT_SYNC_SCHEDULE_STREAM SPLIT_SYNC_PRIORITY_LOW, 0, 100
+#endif // SPLIT_SYNC_SCHEDULE_STREAM
+
+#define SYNC_SCHEDULE_PRIORITY_(priority, min_interval, max_interval) priority
+#define SYNC_SCHEDULE_PRIORITY(...) SYNC_SCHEDULE_PRIORITY_(__VA_ARGS__)
+
+#if defined(SPLIT_SYNC_SCHEDULER_ENABLE) && defined(SPLIT_BATCH_SYNC_ENABLE)
+#    error SPLIT_SYNC_SCHEDULER_ENABLE and SPLIT_BATCH_SYNC_ENABLE cannot be used together
+#endif
+
+#if defined(SPLIT_STREAM_ENABLE) && !defined(SPLIT_TRANSACTION_IDS_KB) && !defined(SPLIT_TRANSACTION_IDS_USER)
+#    error SPLIT_STREAM_ENABLE needs SPLIT_TRANSACTION_IDS_KB or SPLIT_TRANSACTION_IDS_USER
+#endif
+
+#ifdef SPLIT_SYNC_SCHEDULER_ENABLE
+static uint16_t sync_force_interval = FORCED_SYNC_THROTTLE_MS; // max_interval of the item being run
+static uint16_t sync_bus_bytes      = 0;                       // bus bytes spent by the item being run
+#    define SYNC_FORCE_INTERVAL sync_force_interval
+#else // SPLIT_SYNC_SCHEDULER_ENABLE
+#    define SYNC_FORCE_INTERVAL FORCED_SYNC_THROTTLE_MS
+#endif // SPLIT_SYNC_SCHEDULER_ENABLE
+
+static split_link_policy_t link_policy = {.quality = UINT16_MAX, .lowest_priority = SPLIT_SYNC_PRIORITY_LOW};
+
 #define sizeof_member(type, member) sizeof(((type *)NULL)->member)
 
 #define trans_initiator2target_initializer_cb(member, cb) \
@@ -43,39 +122,119 @@
     { 0, 0, sizeof_member(split_shared_memory_t, member), offsetof(split_shared_memory_t, member), cb }
 #define trans_target2initiator_initializer(member) trans_target2initiator_initializer_cb(member, NULL)
 
-#define transport_write(id, data, length) transport_execute_transaction(id, data, length, NULL, 0)
-#define transport_read(id, data, length) transport_execute_transaction(id, NULL, 0, data, length)
-
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 // Forward-declare the RPC callback handlers
 void slave_rpc_info_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
 void slave_rpc_exec_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
 #endif // defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 
-////////////////////////////////////////////////////
-// Helpers
+#ifdef SPLIT_BATCH_SYNC_ENABLE
 
-static bool transaction_handler_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[], const char *prefix, bool (*handler)(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])) {
-    int num_retries = is_transport_connected() ? 10 : 1;
-    for (int iter = 1; iter <= num_retries; ++iter) {
-        if (iter > 1) {
-            for (int i = 0; i < iter * iter; ++i) {
-                wait_us(10);
-            }
+void slave_batch_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
+
+// While the master gathers a batch, writes only land in split_shmem and reads are served from it
+static bool     batch_active  = false;
+static uint32_t batch_pending = 0; // initiator2target items not yet carried by a frame
+
+// Plain core sync items, without slave callback, can travel in a batch
+static bool is_batch_item(int8_t id, bool initiator2target) {
+#    ifdef USE_I2C
+    if (id == I2C_EXECUTE_CALLBACK) {
+        return false;
+    }
+#    endif // USE_I2C
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+    uint8_t                   size  = initiator2target ? trans->initiator2target_buffer_size : trans->target2initiator_buffer_size;
+    return id < SYNC_BATCH && size > 0 && !trans->slave_callback;
+}
+
+static uint32_t batch_items(bool initiator2target) {
+    uint32_t items = 0;
+    for (int8_t id = 0; id < SYNC_BATCH; id++) {
+        if (is_batch_item(id, initiator2target)) {
+            items |= 1UL << id;
         }
-        bool this_okay = true;
-        this_okay      = handler(master_matrix, slave_matrix);
-        if (this_okay) return true;
     }
-    dprintf("Failed to execute %s\n", prefix);
-    return false;
+    return items;
+}
+
+#endif // SPLIT_BATCH_SYNC_ENABLE
+
+#ifdef SPLIT_SYNC_SCHEDULER_ENABLE
+// Bytes of a buffer that go over the wire, a length prefixed one ends where its first byte says
+static uint16_t wire_length(int8_t id, const void *buf, uint16_t length) {
+    const uint8_t *bytes = buf;
+    return (length && split_transaction_table[id].length_prefixed && bytes[0] > 0 && bytes[0] < length) ? bytes[0] : length;
+}
+#endif // SPLIT_SYNC_SCHEDULER_ENABLE
+
+static bool transport_exchange(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+    bool okay = transport_execute_transaction(id, initiator2target_buf, initiator2target_length, target2initiator_buf, target2initiator_length);
+#ifdef SPLIT_SYNC_SCHEDULER_ENABLE
+    // estimated as the transaction ID and its acknowledgement plus the buffers
+    sync_bus_bytes += 2 + wire_length(id, initiator2target_buf, initiator2target_length) + wire_length(id, target2initiator_buf, target2initiator_length);
+#endif // SPLIT_SYNC_SCHEDULER_ENABLE
+    split_link_record(&link_policy, okay ? id : transport_failed_transaction(id), okay);
+    return okay;
 }
 
-#define TRANSACTION_HANDLER_MASTER(prefix)                                                                              \
-    do {                                                                                                                \
-        if (!transaction_handler_master(master_matrix, slave_matrix, #prefix, &prefix##_handlers_master)) return false; \
+static bool transport_write(int8_t id, const void *data, size_t length) {
+#ifdef SPLIT_BATCH_SYNC_ENABLE
+    if (batch_active && is_batch_item(id, true)) {
+        split_transaction_desc_t *trans = &split_transaction_table[id];
+        memcpy(split_trans_initiator2target_buffer(trans), data, MIN(length, trans->initiator2target_buffer_size));
+        batch_pending |= 1UL << id;
+        return true;
+    }
+#endif // SPLIT_BATCH_SYNC_ENABLE
+    return transport_exchange(id, data, length, NULL, 0);
+}
+
+static bool transport_read(int8_t id, void *data, size_t length) {
+#ifdef SPLIT_BATCH_SYNC_ENABLE
+    if (batch_active && is_batch_item(id, false)) {
+        split_transaction_desc_t *trans = &split_transaction_table[id];
+        memcpy(data, split_trans_target2initiator_buffer(trans), MIN(length, trans->target2initiator_buffer_size));
+        return true;
+    }
+#endif // SPLIT_BATCH_SYNC_ENABLE
+    return transport_exchange(id, NULL, 0, data, length);
+}
+
+////////////////////////////////////////////////////
+// Helpers
+
+static bool transaction_handler_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[], const char *prefix, uint8_t item, uint8_t priority, bool (*handler)(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])) {
+    return split_link_run(&link_policy, prefix, item, priority, is_transport_connected(), handler, master_matrix, slave_matrix);
+}
+
+#define TRANSACTION_HANDLER_LINK(prefix, item, priority)                                                                                \
+    do {                                                                                                                                \
+        if (!transaction_handler_master(master_matrix, slave_matrix, #prefix, item, priority, &prefix##_handlers_master)) return false; \
     } while (0)
 
+#define TRANSACTION_HANDLER_MASTER(prefix) TRANSACTION_HANDLER_LINK(prefix, SPLIT_SYNC_ITEM_COUNT, SPLIT_SYNC_PRIORITY_CRITICAL)
+
+#ifdef SPLIT_SYNC_SCHEDULER_ENABLE
+static split_sync_scheduler_t sync_scheduler;
+static uint8_t                sync_tier; // priority being run
+static uint8_t                sync_pass; // pass over the tier, see split_sync_in_turn()
+static uint32_t               sync_now;  // time of this scan
+
+#    define TRANSACTION_HANDLER_SCHEDULED(prefix, ITEM)                                                                                                  \
+        do {                                                                                                                                             \
+            if (sync_scheduler.schedule[SPLIT_SYNC_##ITEM].priority == sync_tier && split_sync_in_turn(&sync_scheduler, SPLIT_SYNC_##ITEM, sync_pass) && \
+                split_sync_due(&sync_scheduler, SPLIT_SYNC_##ITEM, sync_now)) {                                                                          \
+                sync_force_interval = sync_scheduler.schedule[SPLIT_SYNC_##ITEM].max_interval;                                                           \
+                sync_bus_bytes      = 0;                                                                                                                 \
+                TRANSACTION_HANDLER_LINK(prefix, SPLIT_SYNC_##ITEM, SYNC_SCHEDULE_PRIORITY(SPLIT_SYNC_SCHEDULE_##ITEM));                                 \
+                split_sync_done(&sync_scheduler, SPLIT_SYNC_##ITEM, sync_bus_bytes, sync_now);                                                           \
+            }                                                                                                                                            \
+        } while (0)
+#else // SPLIT_SYNC_SCHEDULER_ENABLE
+#    define TRANSACTION_HANDLER_SCHEDULED(prefix, ITEM) TRANSACTION_HANDLER_LINK(prefix, SPLIT_SYNC_##ITEM, SYNC_SCHEDULE_PRIORITY(SPLIT_SYNC_SCHEDULE_##ITEM))
+#endif // SPLIT_SYNC_SCHEDULER_ENABLE
+
 #define TRANSACTION_HANDLER_SLAVE(prefix)                     \
     do {                                                      \
         split_shared_memory_lock();                           \
@@ -86,7 +245,7 @@ static bool transaction_handler_master(matrix_row_t master_matrix[], matrix_row_
 inline static bool read_if_checksum_mismatch(int8_t trans_id_checksum, int8_t trans_id_retrieve, uint32_t *last_update, void *destination, const void *equiv_shmem, size_t length) {
     uint8_t curr_checksum;
     bool    okay = transport_read(trans_id_checksum, &curr_checksum, sizeof(curr_checksum));
-    if (okay && (timer_elapsed32(*last_update) >= FORCED_SYNC_THROTTLE_MS || curr_checksum != crc8(equiv_shmem, length))) {
+    if (okay && (timer_elapsed32(*last_update) >= SYNC_FORCE_INTERVAL || curr_checksum != crc8(equiv_shmem, length))) {
         okay &= transport_read(trans_id_retrieve, destination, length);
         okay &= curr_checksum == crc8(equiv_shmem, length);
         if (okay) {
@@ -100,7 +259,7 @@ inline static bool read_if_checksum_mismatch(int8_t trans_id_checksum, int8_t tr
 
 inline static bool send_if_condition(int8_t trans_id, uint32_t *last_update, bool condition, void *source, size_t length) {
     bool okay = true;
-    if (timer_elapsed32(*last_update) >= FORCED_SYNC_THROTTLE_MS || condition) {
+    if (timer_elapsed32(*last_update) >= SYNC_FORCE_INTERVAL || condition) {
         okay &= transport_write(trans_id, source, length);
         if (okay) {
             *last_update = timer_read32();
@@ -117,6 +276,70 @@ inline static bool send_if_data_mismatch(int8_t trans_id, uint32_t *last_update,
 ////////////////////////////////////////////////////
 // Slave matrix
 
+#ifdef SPLIT_MATRIX_DELTA_ENABLE
+
+void slave_matrix_delta_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
+
+static matrix_delta_log_t slave_matrix_log;
+
+static bool slave_matrix_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    static uint32_t     last_update                    = 0;
+    static bool         synced                         = false;
+    static uint8_t      applied_seq                    = 0;
+    static matrix_row_t last_matrix[(MATRIX_ROWS) / 2] = {0}; // last successfully-read matrix, so we can replicate if there are checksum errors
+    matrix_row_t        temp_matrix[(MATRIX_ROWS) / 2];       // holding area while we test whether or not checksum is correct
+    uint8_t             frame[MATRIX_DELTA_FRAME_SIZE];
+    uint8_t             seq;
+    bool                full;
+
+    // Ask for a snapshot until one arrives, and then every so often for safety
+    uint8_t request = applied_seq;
+    if (!synced || timer_elapsed32(last_update) >= SYNC_FORCE_INTERVAL) {
+        request |= MATRIX_DELTA_RESYNC;
+    }
+
+    memcpy(temp_matrix, last_matrix, sizeof(temp_matrix));
+    bool okay = transport_exchange(GET_SLAVE_MATRIX_DELTA, &request, sizeof(request), frame, sizeof(frame));
+    okay      = okay && matrix_delta_decode(frame, sizeof(frame), temp_matrix, &seq, &full);
+    if (okay) {
+        memcpy(last_matrix, temp_matrix, sizeof(temp_matrix));
+        applied_seq = seq;
+        if (full) {
+            synced      = true;
+            last_update = timer_read32();
+        }
+    } else {
+        synced = false;
+    }
+    // Copy out the last-known-good matrix state to the slave matrix
+    memcpy(slave_matrix, last_matrix, sizeof(last_matrix));
+    return okay;
+}
+
+static void slave_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    matrix_delta_record(&slave_matrix_log, slave_matrix);
+}
+
+/* Most drivers have received the master's request by the time this runs, the
+ * AVR bitbang driver receives it afterwards. Answering the previous request
+ * is still correct, the changes it adds are applied again in order. */
+void slave_matrix_delta_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    matrix_delta_encode(&slave_matrix_log, *(const uint8_t *)initiator2target_buffer, target2initiator_buffer);
+}
+
+// clang-format off
+#    define TRANSACTIONS_SLAVE_MATRIX_MASTER() TRANSACTION_HANDLER_SCHEDULED(slave_matrix, SLAVE_MATRIX)
+#    define TRANSACTIONS_SLAVE_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(slave_matrix)
+#    define TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS \
+    [GET_SLAVE_MATRIX_DELTA] = { \
+        sizeof_member(split_shared_memory_t, smatrix.request), offsetof(split_shared_memory_t, smatrix.request), \
+        sizeof_member(split_shared_memory_t, smatrix.frame), offsetof(split_shared_memory_t, smatrix.frame), \
+        slave_matrix_delta_callback, true \
+    },
+// clang-format on
+
+#else // SPLIT_MATRIX_DELTA_ENABLE
+
 static bool slave_matrix_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     static uint32_t     last_update                    = 0;
     static matrix_row_t last_matrix[(MATRIX_ROWS) / 2] = {0}; // last successfully-read matrix, so we can replicate if there are checksum errors
@@ -138,13 +361,15 @@ static void slave_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row
 }
 
 // clang-format off
-#define TRANSACTIONS_SLAVE_MATRIX_MASTER() TRANSACTION_HANDLER_MASTER(slave_matrix)
-#define TRANSACTIONS_SLAVE_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(slave_matrix)
-#define TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS \
+#    define TRANSACTIONS_SLAVE_MATRIX_MASTER() TRANSACTION_HANDLER_SCHEDULED(slave_matrix, SLAVE_MATRIX)
+#    define TRANSACTIONS_SLAVE_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(slave_matrix)
+#    define TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS \
     [GET_SLAVE_MATRIX_CHECKSUM] = trans_target2initiator_initializer(smatrix.checksum), \
     [GET_SLAVE_MATRIX_DATA]     = trans_target2initiator_initializer(smatrix.matrix),
 // clang-format on
 
+#endif // SPLIT_MATRIX_DELTA_ENABLE
+
 ////////////////////////////////////////////////////
 // Master matrix
 
@@ -160,7 +385,7 @@ static void master_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_ro
     memcpy(master_matrix, split_shmem->mmatrix.matrix, sizeof(split_shmem->mmatrix.matrix));
 }
 
-#    define TRANSACTIONS_MASTER_MATRIX_MASTER() TRANSACTION_HANDLER_MASTER(master_matrix)
+#    define TRANSACTIONS_MASTER_MATRIX_MASTER() TRANSACTION_HANDLER_SCHEDULED(master_matrix, MASTER_MATRIX)
 #    define TRANSACTIONS_MASTER_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(master_matrix)
 #    define TRANSACTIONS_MASTER_MATRIX_REGISTRATIONS [PUT_MASTER_MATRIX] = trans_initiator2target_initializer(mmatrix.matrix),
 
@@ -175,7 +400,59 @@ static void master_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_ro
 ////////////////////////////////////////////////////
 // Encoders
 
-#ifdef ENCODER_ENABLE
+#if defined(ENCODER_ENABLE) && defined(SPLIT_ENCODER_QUEUE_ENABLE)
+
+void slave_encoder_queue_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
+
+static encoder_queue_t       slave_encoder_queue;
+static input_queue_metrics_t encoder_queue_metrics; // master: the slave's queue as seen in its frames
+
+static bool encoder_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    static uint8_t        applied = 0;
+    encoder_queue_event_t events[SPLIT_ENCODER_QUEUE_SIZE];
+    uint8_t               frame[ENCODER_QUEUE_FRAME_SIZE];
+
+    bool   okay   = transport_exchange(GET_ENCODERS_QUEUE, &applied, sizeof(applied), frame, sizeof(frame));
+    int8_t stored = okay ? encoder_queue_decode(frame, sizeof(frame), &applied, events, SPLIT_ENCODER_QUEUE_SIZE, &encoder_queue_metrics) : -1;
+    for (int8_t i = 0; i < stored; i++) {
+        encoder_steps_raw(events[i].index, events[i].steps);
+    }
+    return stored >= 0;
+}
+
+static void encoder_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    static uint8_t queued_state[NUM_ENCODERS_MAX_PER_SIDE]  = {0}; // counters up to the last queued steps
+    uint8_t        encoder_state[NUM_ENCODERS_MAX_PER_SIDE] = {0};
+    encoder_state_raw(encoder_state);
+    for (uint8_t i = 0; i < NUM_ENCODERS_MAX_PER_SIDE; i++) {
+        int8_t steps = encoder_state[i] - queued_state[i];
+        // Steps that find no room stay in the counter until the next scan
+        if (steps && encoder_queue_push(&slave_encoder_queue, i, steps)) {
+            queued_state[i] = encoder_state[i];
+        }
+    }
+}
+
+void slave_encoder_queue_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    encoder_queue_encode(&slave_encoder_queue, *(const uint8_t *)initiator2target_buffer, target2initiator_buffer);
+}
+
+const input_queue_metrics_t *split_encoder_queue_get_metrics(void) {
+    return is_keyboard_master() ? &encoder_queue_metrics : &slave_encoder_queue.queue.metrics;
+}
+
+// clang-format off
+#    define TRANSACTIONS_ENCODERS_MASTER() TRANSACTION_HANDLER_SCHEDULED(encoder, ENCODERS)
+#    define TRANSACTIONS_ENCODERS_SLAVE() TRANSACTION_HANDLER_SLAVE(encoder)
+#    define TRANSACTIONS_ENCODERS_REGISTRATIONS \
+    [GET_ENCODERS_QUEUE] = { \
+        sizeof_member(split_shared_memory_t, encoders.request), offsetof(split_shared_memory_t, encoders.request), \
+        sizeof_member(split_shared_memory_t, encoders.frame), offsetof(split_shared_memory_t, encoders.frame), \
+        slave_encoder_queue_callback, true \
+    },
+// clang-format on
+
+#elif defined(ENCODER_ENABLE)
 
 static bool encoder_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     static uint32_t last_update = 0;
@@ -196,7 +473,7 @@ static void encoder_handlers_slave(matrix_row_t master_matrix[], matrix_row_t sl
 }
 
 // clang-format off
-#    define TRANSACTIONS_ENCODERS_MASTER() TRANSACTION_HANDLER_MASTER(encoder)
+#    define TRANSACTIONS_ENCODERS_MASTER() TRANSACTION_HANDLER_SCHEDULED(encoder, ENCODERS)
 #    define TRANSACTIONS_ENCODERS_SLAVE() TRANSACTION_HANDLER_SLAVE(encoder)
 #    define TRANSACTIONS_ENCODERS_REGISTRATIONS \
     [GET_ENCODERS_CHECKSUM] = trans_target2initiator_initializer(encoders.checksum), \
@@ -220,7 +497,7 @@ static bool sync_timer_handlers_master(matrix_row_t master_matrix[], matrix_row_
     static uint32_t last_update = 0;
 
     bool okay = true;
-    if (timer_elapsed32(last_update) >= FORCED_SYNC_THROTTLE_MS) {
+    if (timer_elapsed32(last_update) >= SYNC_FORCE_INTERVAL) {
         uint32_t sync_timer = sync_timer_read32() + SYNC_TIMER_OFFSET;
         okay &= transport_write(PUT_SYNC_TIMER, &sync_timer, sizeof(sync_timer));
         if (okay) {
@@ -238,7 +515,7 @@ static void sync_timer_handlers_slave(matrix_row_t master_matrix[], matrix_row_t
     }
 }
 
-#    define TRANSACTIONS_SYNC_TIMER_MASTER() TRANSACTION_HANDLER_MASTER(sync_timer)
+#    define TRANSACTIONS_SYNC_TIMER_MASTER() TRANSACTION_HANDLER_SCHEDULED(sync_timer, SYNC_TIMER)
 #    define TRANSACTIONS_SYNC_TIMER_SLAVE() TRANSACTION_HANDLER_SLAVE(sync_timer)
 #    define TRANSACTIONS_SYNC_TIMER_REGISTRATIONS [PUT_SYNC_TIMER] = trans_initiator2target_initializer(sync_timer),
 
@@ -272,7 +549,7 @@ static void layer_state_handlers_slave(matrix_row_t master_matrix[], matrix_row_
 }
 
 // clang-format off
-#    define TRANSACTIONS_LAYER_STATE_MASTER() TRANSACTION_HANDLER_MASTER(layer_state)
+#    define TRANSACTIONS_LAYER_STATE_MASTER() TRANSACTION_HANDLER_SCHEDULED(layer_state, LAYER_STATE)
 #    define TRANSACTIONS_LAYER_STATE_SLAVE() TRANSACTION_HANDLER_SLAVE(layer_state)
 #    define TRANSACTIONS_LAYER_STATE_REGISTRATIONS \
     [PUT_LAYER_STATE]         = trans_initiator2target_initializer(layers.layer_state), \
@@ -303,7 +580,7 @@ static void led_state_handlers_slave(matrix_row_t master_matrix[], matrix_row_t
     set_split_host_keyboard_leds(split_shmem->led_state);
 }
 
-#    define TRANSACTIONS_LED_STATE_MASTER() TRANSACTION_HANDLER_MASTER(led_state)
+#    define TRANSACTIONS_LED_STATE_MASTER() TRANSACTION_HANDLER_SCHEDULED(led_state, LED_STATE)
 #    define TRANSACTIONS_LED_STATE_SLAVE() TRANSACTION_HANDLER_SLAVE(led_state)
 #    define TRANSACTIONS_LED_STATE_REGISTRATIONS [PUT_LED_STATE] = trans_initiator2target_initializer(led_state),
 
@@ -322,7 +599,7 @@ static void led_state_handlers_slave(matrix_row_t master_matrix[], matrix_row_t
 
 static bool mods_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     static uint32_t   last_update    = 0;
-    bool              mods_need_sync = timer_elapsed32(last_update) >= FORCED_SYNC_THROTTLE_MS;
+    bool              mods_need_sync = timer_elapsed32(last_update) >= SYNC_FORCE_INTERVAL;
     split_mods_sync_t new_mods;
     new_mods.real_mods = get_mods();
     if (!mods_need_sync && new_mods.real_mods != split_shmem->mods.real_mods) {
@@ -360,7 +637,7 @@ static void mods_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave
 #    endif
 }
 
-#    define TRANSACTIONS_MODS_MASTER() TRANSACTION_HANDLER_MASTER(mods)
+#    define TRANSACTIONS_MODS_MASTER() TRANSACTION_HANDLER_SCHEDULED(mods, MODS)
 #    define TRANSACTIONS_MODS_SLAVE() TRANSACTION_HANDLER_SLAVE(mods)
 #    define TRANSACTIONS_MODS_REGISTRATIONS [PUT_MODS] = trans_initiator2target_initializer(mods),
 
@@ -387,7 +664,7 @@ static void backlight_handlers_slave(matrix_row_t master_matrix[], matrix_row_t
     backlight_set(split_shmem->backlight_level);
 }
 
-#    define TRANSACTIONS_BACKLIGHT_MASTER() TRANSACTION_HANDLER_MASTER(backlight)
+#    define TRANSACTIONS_BACKLIGHT_MASTER() TRANSACTION_HANDLER_SCHEDULED(backlight, BACKLIGHT)
 #    define TRANSACTIONS_BACKLIGHT_SLAVE() TRANSACTION_HANDLER_SLAVE(backlight)
 #    define TRANSACTIONS_BACKLIGHT_REGISTRATIONS [PUT_BACKLIGHT] = trans_initiator2target_initializer(backlight_level),
 
@@ -424,7 +701,7 @@ static void rgblight_handlers_slave(matrix_row_t master_matrix[], matrix_row_t s
     }
 }
 
-#    define TRANSACTIONS_RGBLIGHT_MASTER() TRANSACTION_HANDLER_MASTER(rgblight)
+#    define TRANSACTIONS_RGBLIGHT_MASTER() TRANSACTION_HANDLER_SCHEDULED(rgblight, RGBLIGHT)
 #    define TRANSACTIONS_RGBLIGHT_SLAVE() TRANSACTION_HANDLER_SLAVE(rgblight)
 #    define TRANSACTIONS_RGBLIGHT_REGISTRATIONS [PUT_RGBLIGHT] = trans_initiator2target_initializer(rgblight_sync),
 
@@ -454,7 +731,7 @@ static void led_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row_t
     led_matrix_set_suspend_state(split_shmem->led_matrix_sync.led_suspend_state);
 }
 
-#    define TRANSACTIONS_LED_MATRIX_MASTER() TRANSACTION_HANDLER_MASTER(led_matrix)
+#    define TRANSACTIONS_LED_MATRIX_MASTER() TRANSACTION_HANDLER_SCHEDULED(led_matrix, LED_MATRIX)
 #    define TRANSACTIONS_LED_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(led_matrix)
 #    define TRANSACTIONS_LED_MATRIX_REGISTRATIONS [PUT_LED_MATRIX] = trans_initiator2target_initializer(led_matrix_sync),
 
@@ -484,7 +761,7 @@ static void rgb_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row_t
     rgb_matrix_set_suspend_state(split_shmem->rgb_matrix_sync.rgb_suspend_state);
 }
 
-#    define TRANSACTIONS_RGB_MATRIX_MASTER() TRANSACTION_HANDLER_MASTER(rgb_matrix)
+#    define TRANSACTIONS_RGB_MATRIX_MASTER() TRANSACTION_HANDLER_SCHEDULED(rgb_matrix, RGB_MATRIX)
 #    define TRANSACTIONS_RGB_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(rgb_matrix)
 #    define TRANSACTIONS_RGB_MATRIX_REGISTRATIONS [PUT_RGB_MATRIX] = trans_initiator2target_initializer(rgb_matrix_sync),
 
@@ -511,7 +788,7 @@ static void wpm_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_
     set_current_wpm(split_shmem->current_wpm);
 }
 
-#    define TRANSACTIONS_WPM_MASTER() TRANSACTION_HANDLER_MASTER(wpm)
+#    define TRANSACTIONS_WPM_MASTER() TRANSACTION_HANDLER_SCHEDULED(wpm, WPM)
 #    define TRANSACTIONS_WPM_SLAVE() TRANSACTION_HANDLER_SLAVE(wpm)
 #    define TRANSACTIONS_WPM_REGISTRATIONS [PUT_WPM] = trans_initiator2target_initializer(current_wpm),
 
@@ -542,7 +819,7 @@ static void oled_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave
     }
 }
 
-#    define TRANSACTIONS_OLED_MASTER() TRANSACTION_HANDLER_MASTER(oled)
+#    define TRANSACTIONS_OLED_MASTER() TRANSACTION_HANDLER_SCHEDULED(oled, OLED)
 #    define TRANSACTIONS_OLED_SLAVE() TRANSACTION_HANDLER_SLAVE(oled)
 #    define TRANSACTIONS_OLED_REGISTRATIONS [PUT_OLED] = trans_initiator2target_initializer(current_oled_state),
 
@@ -573,7 +850,7 @@ static void st7565_handlers_slave(matrix_row_t master_matrix[], matrix_row_t sla
     }
 }
 
-#    define TRANSACTIONS_ST7565_MASTER() TRANSACTION_HANDLER_MASTER(st7565)
+#    define TRANSACTIONS_ST7565_MASTER() TRANSACTION_HANDLER_SCHEDULED(st7565, ST7565)
 #    define TRANSACTIONS_ST7565_SLAVE() TRANSACTION_HANDLER_SLAVE(st7565)
 #    define TRANSACTIONS_ST7565_REGISTRATIONS [PUT_ST7565] = trans_initiator2target_initializer(current_st7565_state),
 
@@ -585,11 +862,91 @@ static void st7565_handlers_slave(matrix_row_t master_matrix[], matrix_row_t sla
 
 #endif // defined(ST7565_ENABLE) && defined(SPLIT_ST7565_ENABLE)
 
+////////////////////////////////////////////////////
+// Display state
+
+#ifdef SPLIT_DISPLAY_STATE_ENABLE
+
+// The slave renders from a copy, as split_shmem can change under it while it does
+static split_display_state_t display_state;
+
+__attribute__((weak)) void split_display_state_collect_user(split_display_state_t *state) {}
+
+__attribute__((weak)) void split_display_state_collect_kb(split_display_state_t *state) {
+    split_display_state_collect_user(state);
+}
+
+__attribute__((weak)) void split_display_state_changed_user(const split_display_state_t *state) {}
+
+__attribute__((weak)) void split_display_state_changed_kb(const split_display_state_t *state) {
+    split_display_state_changed_user(state);
+}
+
+const split_display_state_t *split_display_state_get(void) {
+    return is_keyboard_master() ? &split_shmem->display_state : &display_state;
+}
+
+static bool display_state_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    static uint32_t       last_update = 0;
+    split_display_state_t state;
+
+    // cleared, as padding takes part in the comparisons
+    memset(&state, 0, sizeof(state));
+#    ifndef NO_ACTION_LAYER
+    state.layer_state         = layer_state;
+    state.default_layer_state = default_layer_state;
+#    endif // NO_ACTION_LAYER
+    state.mods = get_mods() | get_weak_mods();
+#    ifndef NO_ACTION_ONESHOT
+    state.mods |= get_oneshot_mods();
+#    endif // NO_ACTION_ONESHOT
+    state.led_state.raw = host_keyboard_leds();
+#    ifdef WPM_ENABLE
+    state.wpm = get_current_wpm();
+#    endif // WPM_ENABLE
+    split_display_state_collect_kb(&state);
+
+    // split_shmem keeps what was sent last, even if sending failed
+    bool changed = memcmp(&state, &split_shmem->display_state, sizeof(state)) != 0;
+    bool okay    = send_if_data_mismatch(PUT_DISPLAY_STATE, &last_update, &state, &split_shmem->display_state, sizeof(state));
+    if (changed) {
+        split_display_state_changed_kb(&split_shmem->display_state);
+    }
+    return okay;
+}
+
+static void display_state_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    if (memcmp(&split_shmem->display_state, &display_state, sizeof(display_state)) != 0) {
+        memcpy(&display_state, &split_shmem->display_state, sizeof(display_state));
+        split_display_state_changed_kb(&display_state);
+    }
+}
+
+#    define TRANSACTIONS_DISPLAY_STATE_MASTER() TRANSACTION_HANDLER_SCHEDULED(display_state, DISPLAY_STATE)
+#    define TRANSACTIONS_DISPLAY_STATE_SLAVE() TRANSACTION_HANDLER_SLAVE(display_state)
+#    define TRANSACTIONS_DISPLAY_STATE_REGISTRATIONS [PUT_DISPLAY_STATE] = trans_initiator2target_initializer(display_state),
+
+#else // SPLIT_DISPLAY_STATE_ENABLE
+
+#    define TRANSACTIONS_DISPLAY_STATE_MASTER()
+#    define TRANSACTIONS_DISPLAY_STATE_SLAVE()
+#    define TRANSACTIONS_DISPLAY_STATE_REGISTRATIONS
+
+#endif // SPLIT_DISPLAY_STATE_ENABLE
+
 ////////////////////////////////////////////////////
 // POINTING
 
 #if defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
+#    ifdef SPLIT_POINTING_QUEUE_ENABLE
+void slave_pointing_queue_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
+
+static pointing_queue_t      slave_pointing_queue;
+static pointing_queue_t      master_pointing_queue;  // motion received, until the pointing device task takes it
+static input_queue_metrics_t pointing_queue_metrics; // master: the slave's queue as seen in its frames
+#    endif // SPLIT_POINTING_QUEUE_ENABLE
+
 static bool pointing_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
 #    if defined(POINTING_DEVICE_LEFT)
     if (is_keyboard_left()) {
@@ -600,12 +957,29 @@ static bool pointing_handlers_master(matrix_row_t master_matrix[], matrix_row_t
         return true;
     }
 #    endif
+#    ifdef SPLIT_POINTING_QUEUE_ENABLE
+    static uint8_t         applied  = 0;
+    static uint16_t        last_cpi = 0;
+    pointing_queue_event_t events[SPLIT_POINTING_QUEUE_SIZE];
+    uint8_t                frame[POINTING_QUEUE_FRAME_SIZE];
+    uint16_t               temp_cpi;
+
+    // Only take what fits, the slave holds on to the rest
+    uint8_t room   = SPLIT_POINTING_QUEUE_SIZE - master_pointing_queue.queue.count;
+    bool    okay   = transport_exchange(GET_POINTING_QUEUE, &applied, sizeof(applied), frame, sizeof(frame));
+    int8_t  stored = okay ? pointing_queue_decode(frame, sizeof(frame), &applied, events, room, &pointing_queue_metrics) : -1;
+    for (int8_t i = 0; i < stored; i++) {
+        pointing_queue_push(&master_pointing_queue, &events[i]);
+    }
+    okay = stored >= 0;
+#    else // SPLIT_POINTING_QUEUE_ENABLE
     static uint32_t last_update = 0;
     static uint16_t last_cpi    = 0;
     report_mouse_t  temp_state;
     uint16_t        temp_cpi;
     bool            okay = read_if_checksum_mismatch(GET_POINTING_CHECKSUM, GET_POINTING_DATA, &last_update, &temp_state, &split_shmem->pointing.report, sizeof(temp_state));
     if (okay) pointing_device_set_shared_report(temp_state);
+#    endif // SPLIT_POINTING_QUEUE_ENABLE
     temp_cpi = pointing_device_get_shared_cpi();
     if (temp_cpi && memcmp(&last_cpi, &temp_cpi, sizeof(temp_cpi)) != 0) {
         memcpy(&split_shmem->pointing.cpi, &temp_cpi, sizeof(temp_cpi));
@@ -644,16 +1018,62 @@ static void pointing_handlers_slave(matrix_row_t master_matrix[], matrix_row_t s
             pointing_device_driver.set_cpi(split_shmem->pointing.cpi);
         }
     }
+#    ifdef SPLIT_POINTING_QUEUE_ENABLE
+    // Leave the driver's input with it until a waiting button change is queued
+    if (!pointing_queue_input(&slave_pointing_queue, NULL)) {
+        return;
+    }
+#    endif // SPLIT_POINTING_QUEUE_ENABLE
     memset(&temp_report, 0, sizeof(temp_report));
     temp_report = pointing_device_driver.get_report(temp_report);
+#    ifdef SPLIT_POINTING_QUEUE_ENABLE
+    pointing_queue_event_t event = {.buttons = temp_report.buttons, .x = temp_report.x, .y = temp_report.y, .h = temp_report.h, .v = temp_report.v};
+    pointing_queue_input(&slave_pointing_queue, &event);
+#    else // SPLIT_POINTING_QUEUE_ENABLE
     memcpy(&split_shmem->pointing.report, &temp_report, sizeof(temp_report));
     // Now update the checksum given that the pointing has been written to
     split_shmem->pointing.checksum = crc8(&temp_report, sizeof(temp_report));
+#    endif // SPLIT_POINTING_QUEUE_ENABLE
+}
+
+#    ifdef SPLIT_POINTING_QUEUE_ENABLE
+void slave_pointing_queue_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    pointing_queue_encode(&slave_pointing_queue, *(const uint8_t *)initiator2target_buffer, target2initiator_buffer);
+}
+
+void split_pointing_queue_take(report_mouse_t *report) {
+    pointing_queue_event_t event;
+    if (pointing_queue_take(&master_pointing_queue, XY_REPORT_MAX, INT8_MAX, &event)) {
+        report->buttons = event.buttons;
+        report->x       = event.x;
+        report->y       = event.y;
+        report->h       = event.h;
+        report->v       = event.v;
+    } else {
+        report->x = report->y = report->h = report->v = 0;
+    }
+}
+
+const input_queue_metrics_t *split_pointing_queue_get_metrics(void) {
+    return is_keyboard_master() ? &pointing_queue_metrics : &slave_pointing_queue.queue.metrics;
 }
+#    endif // SPLIT_POINTING_QUEUE_ENABLE
 
-#    define TRANSACTIONS_POINTING_MASTER() TRANSACTION_HANDLER_MASTER(pointing)
+#    define TRANSACTIONS_POINTING_MASTER() TRANSACTION_HANDLER_SCHEDULED(pointing, POINTING)
 #    define TRANSACTIONS_POINTING_SLAVE() TRANSACTION_HANDLER_SLAVE(pointing)
-#    define TRANSACTIONS_POINTING_REGISTRATIONS [GET_POINTING_CHECKSUM] = trans_target2initiator_initializer(pointing.checksum), [GET_POINTING_DATA] = trans_target2initiator_initializer(pointing.report), [PUT_POINTING_CPI] = trans_initiator2target_initializer(pointing.cpi),
+#    ifdef SPLIT_POINTING_QUEUE_ENABLE
+// clang-format off
+#        define TRANSACTIONS_POINTING_REGISTRATIONS \
+    [GET_POINTING_QUEUE] = { \
+        sizeof_member(split_shared_memory_t, pointing.request), offsetof(split_shared_memory_t, pointing.request), \
+        sizeof_member(split_shared_memory_t, pointing.frame), offsetof(split_shared_memory_t, pointing.frame), \
+        slave_pointing_queue_callback, true \
+    }, \
+    [PUT_POINTING_CPI] = trans_initiator2target_initializer(pointing.cpi),
+// clang-format on
+#    else // SPLIT_POINTING_QUEUE_ENABLE
+#        define TRANSACTIONS_POINTING_REGISTRATIONS [GET_POINTING_CHECKSUM] = trans_target2initiator_initializer(pointing.checksum), [GET_POINTING_DATA] = trans_target2initiator_initializer(pointing.report), [PUT_POINTING_CPI] = trans_initiator2target_initializer(pointing.cpi),
+#    endif // SPLIT_POINTING_QUEUE_ENABLE
 
 #else // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
@@ -663,6 +1083,208 @@ static void pointing_handlers_slave(matrix_row_t master_matrix[], matrix_row_t s
 
 #endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
+////////////////////////////////////////////////////
+// Batched sync
+
+#ifdef SPLIT_BATCH_SYNC_ENABLE
+
+static bool batch_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    static uint32_t last_full    = 0;
+    static bool     resync       = true;
+    static uint32_t last_carried = 0;
+    uint8_t         frame[SPLIT_BATCH_FRAME_SIZE];
+    uint8_t         reply[SPLIT_BATCH_FRAME_SIZE];
+    uint8_t         flags = 0;
+
+    if (resync || timer_elapsed32(last_full) >= FORCED_SYNC_THROTTLE_MS) {
+        flags |= TRANSACTION_BATCH_FULL;
+    }
+#    ifdef SPLIT_BATCH_CRC16_ENABLE
+    static bool     peer_crc16  = false;
+    static bool     reply_crc16 = false; // the slave answers with CRC-16, plain checksums are refused
+    static uint32_t last_reply  = 0;
+    flags |= TRANSACTION_BATCH_CRC16_ACCEPT | (peer_crc16 ? TRANSACTION_BATCH_CRC16 : 0);
+#    else
+    const bool reply_crc16 = false;
+#    endif
+
+    uint32_t items  = batch_pending;
+    uint8_t  length = transaction_batch_encode(frame, sizeof(frame), flags, &items, split_transaction_table, NUM_TOTAL_TRANSACTIONS, true, split_shmem);
+
+    uint8_t  reply_flags;
+    uint32_t received;
+    bool     okay = transport_exchange(SYNC_BATCH, frame, length, reply, sizeof(reply));
+    okay          = okay && transaction_batch_decode(reply, sizeof(reply), reply_crc16, &reply_flags, &received, split_transaction_table, NUM_TOTAL_TRANSACTIONS, false, split_shmem);
+    if (!okay) {
+        // keep everything pending, and ask for all of the slave's items once it answers again
+        resync = true;
+#    ifdef SPLIT_BATCH_CRC16_ENABLE
+        // the slave may have been reflashed without CRC-16, let it be heard again
+        if (timer_elapsed32(last_reply) >= FORCED_SYNC_THROTTLE_MS) {
+            reply_crc16 = false;
+        }
+#    endif
+        return false;
+    }
+
+#    ifdef SPLIT_BATCH_CRC16_ENABLE
+    // switch to CRC-16 once the slave can check it, and back if it is reflashed without
+    peer_crc16  = reply_flags & TRANSACTION_BATCH_CRC16_ACCEPT;
+    reply_crc16 = reply_flags & TRANSACTION_BATCH_CRC16;
+    last_reply  = timer_read32();
+#    endif
+
+    uint32_t carried = batch_pending & ~items;
+    batch_pending    = items;
+    if (reply_flags & TRANSACTION_BATCH_REJECTED) {
+        // the slave dropped a frame; depending on the driver that is this one or the one before
+        batch_pending |= carried | last_carried;
+    }
+    last_carried = carried;
+
+    if (flags & TRANSACTION_BATCH_FULL) {
+        last_full = timer_read32();
+    }
+    resync = false;
+    return true;
+}
+
+/* Runs before the slave sends its frame. Most drivers have received the
+ * master's frame by then, the AVR bitbang driver receives it afterwards, so
+ * that one is applied on the next exchange. */
+void slave_batch_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    static uint8_t sent_checksum[NUM_TOTAL_TRANSACTIONS] = {0};
+    uint8_t *      frame                                 = split_shmem->batch_m2s;
+    uint8_t        flags                                 = 0;
+    uint8_t        reply_flags                           = 0;
+    uint32_t       received;
+#    ifdef SPLIT_BATCH_CRC16_ENABLE
+    static bool     peer_crc16  = false;
+    static bool     frame_crc16 = false; // the master sends CRC-16, plain checksums are refused
+    static uint32_t last_frame  = 0;
+    if (timer_elapsed32(last_frame) >= FORCED_SYNC_THROTTLE_MS) {
+        // the master may have been reflashed without CRC-16, let it be heard again
+        frame_crc16 = false;
+    }
+#    else
+    const bool frame_crc16 = false;
+#    endif
+
+    if (frame[0] != 0) {
+        if (transaction_batch_decode(frame, initiator2target_buffer_size, frame_crc16, &flags, &received, split_transaction_table, NUM_TOTAL_TRANSACTIONS, true, split_shmem)) {
+#    ifdef SPLIT_BATCH_CRC16_ENABLE
+            // answer in CRC-16 as long as the master can check it
+            peer_crc16  = flags & TRANSACTION_BATCH_CRC16_ACCEPT;
+            frame_crc16 = flags & TRANSACTION_BATCH_CRC16;
+            last_frame  = timer_read32();
+#    endif
+        } else {
+            reply_flags |= TRANSACTION_BATCH_REJECTED;
+        }
+        // consumed, so that a frame is never applied twice
+        frame[0] = 0;
+    }
+#    ifdef SPLIT_BATCH_CRC16_ENABLE
+    reply_flags |= TRANSACTION_BATCH_CRC16_ACCEPT | (peer_crc16 ? TRANSACTION_BATCH_CRC16 : 0);
+#    endif
+
+    // Send whatever changed since it was last sent, or everything if asked to
+    uint32_t candidates = batch_items(false);
+    uint32_t items      = 0;
+    for (int8_t id = 0; id < SYNC_BATCH; id++) {
+        if (candidates & (1UL << id)) {
+            split_transaction_desc_t *trans = &split_transaction_table[id];
+            if ((flags & TRANSACTION_BATCH_FULL) || crc8(split_trans_target2initiator_buffer(trans), trans->target2initiator_buffer_size) != sent_checksum[id]) {
+                items |= 1UL << id;
+            }
+        }
+    }
+
+    uint32_t unsent = items;
+    transaction_batch_encode(target2initiator_buffer, target2initiator_buffer_size, reply_flags, &unsent, split_transaction_table, NUM_TOTAL_TRANSACTIONS, false, split_shmem);
+    for (int8_t id = 0; id < SYNC_BATCH; id++) {
+        if ((items & ~unsent) & (1UL << id)) {
+            split_transaction_desc_t *trans = &split_transaction_table[id];
+            sent_checksum[id]               = crc8(split_trans_target2initiator_buffer(trans), trans->target2initiator_buffer_size);
+        }
+    }
+}
+
+// clang-format off
+#    define TRANSACTIONS_BATCH_MASTER() TRANSACTION_HANDLER_MASTER(batch)
+#    define TRANSACTIONS_BATCH_REGISTRATIONS \
+    [SYNC_BATCH] = { \
+        sizeof_member(split_shared_memory_t, batch_m2s), offsetof(split_shared_memory_t, batch_m2s), \
+        sizeof_member(split_shared_memory_t, batch_s2m), offsetof(split_shared_memory_t, batch_s2m), \
+        slave_batch_callback, true \
+    },
+// clang-format on
+
+#else // SPLIT_BATCH_SYNC_ENABLE
+
+#    define TRANSACTIONS_BATCH_REGISTRATIONS
+
+#endif // SPLIT_BATCH_SYNC_ENABLE
+
+////////////////////////////////////////////////////
+// Streamed RPC
+
+#ifdef SPLIT_STREAM_ENABLE
+
+void slave_stream_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
+
+#    define STREAM_FIRST_USER_ID (GET_RPC_RESP_DATA + 1)
+
+static transaction_stream_sender_t   stream_sender;
+static transaction_stream_receiver_t stream_receiver;
+static split_stream_callback_t       stream_callbacks[NUM_TOTAL_TRANSACTIONS - STREAM_FIRST_USER_ID];
+
+// One chunk per run, and only while a stream is going
+static bool stream_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    if (!transaction_stream_active(&stream_sender)) {
+        return true;
+    }
+
+    uint8_t frame[TRANSACTION_STREAM_FRAME_SIZE];
+    uint8_t ack[TRANSACTION_STREAM_ACK_SIZE];
+    uint8_t length = transaction_stream_encode(&stream_sender, frame);
+    bool    okay   = transport_exchange(STREAM_CHUNK, frame, length, ack, sizeof(ack));
+    transaction_stream_reply(&stream_sender, okay ? ack : NULL, timer_read32());
+    return okay;
+}
+
+static uint8_t stream_deliver(int8_t transaction_id, uint16_t total, uint16_t offset, const uint8_t *data, uint8_t length) {
+    if (transaction_id < STREAM_FIRST_USER_ID || transaction_id >= NUM_TOTAL_TRANSACTIONS || !stream_callbacks[transaction_id - STREAM_FIRST_USER_ID]) {
+        return TRANSACTION_STREAM_REFUSED;
+    }
+    return stream_callbacks[transaction_id - STREAM_FIRST_USER_ID](total, offset, data, length) ? TRANSACTION_STREAM_ACCEPTED : TRANSACTION_STREAM_BUSY;
+}
+
+/* As with the batch, the AVR bitbang driver hands over the master's frame
+ * after this ran, so its chunks are taken one exchange late. */
+void slave_stream_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    transaction_stream_receive(&stream_receiver, split_shmem->stream_m2s, initiator2target_buffer_size, target2initiator_buffer, stream_deliver);
+    // consumed, so that a chunk is never looked at twice
+    split_shmem->stream_m2s[0] = 0;
+}
+
+// clang-format off
+#    define TRANSACTIONS_STREAM_MASTER() TRANSACTION_HANDLER_SCHEDULED(stream, STREAM)
+#    define TRANSACTIONS_STREAM_REGISTRATIONS \
+    [STREAM_CHUNK] = { \
+        sizeof_member(split_shared_memory_t, stream_m2s), offsetof(split_shared_memory_t, stream_m2s), \
+        sizeof_member(split_shared_memory_t, stream_s2m), offsetof(split_shared_memory_t, stream_s2m), \
+        slave_stream_callback, true \
+    },
+// clang-format on
+
+#else // SPLIT_STREAM_ENABLE
+
+#    define TRANSACTIONS_STREAM_MASTER()
+#    define TRANSACTIONS_STREAM_REGISTRATIONS
+
+#endif // SPLIT_STREAM_ENABLE
+
 ////////////////////////////////////////////////////
 
 split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
@@ -688,7 +1310,10 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
     TRANSACTIONS_WPM_REGISTRATIONS
     TRANSACTIONS_OLED_REGISTRATIONS
     TRANSACTIONS_ST7565_REGISTRATIONS
+    TRANSACTIONS_DISPLAY_STATE_REGISTRATIONS
     TRANSACTIONS_POINTING_REGISTRATIONS
+    TRANSACTIONS_BATCH_REGISTRATIONS
+    TRANSACTIONS_STREAM_REGISTRATIONS
 // clang-format on
 
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
@@ -699,6 +1324,123 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
 #endif // defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 };
 
+#ifdef SPLIT_BATCH_SYNC_ENABLE
+
+// Gathers the master's items, swaps them for the slave's in a single exchange, then reads those locally
+static bool transactions_master_batched(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    TRANSACTIONS_MASTER_MATRIX_MASTER();
+    TRANSACTIONS_SYNC_TIMER_MASTER();
+    TRANSACTIONS_LAYER_STATE_MASTER();
+    TRANSACTIONS_LED_STATE_MASTER();
+    TRANSACTIONS_MODS_MASTER();
+    TRANSACTIONS_BACKLIGHT_MASTER();
+    TRANSACTIONS_RGBLIGHT_MASTER();
+    TRANSACTIONS_LED_MATRIX_MASTER();
+    TRANSACTIONS_RGB_MATRIX_MASTER();
+    TRANSACTIONS_WPM_MASTER();
+    TRANSACTIONS_OLED_MASTER();
+    TRANSACTIONS_ST7565_MASTER();
+    TRANSACTIONS_DISPLAY_STATE_MASTER();
+    TRANSACTIONS_BATCH_MASTER();
+    TRANSACTIONS_SLAVE_MATRIX_MASTER();
+    TRANSACTIONS_ENCODERS_MASTER();
+    TRANSACTIONS_POINTING_MASTER();
+    TRANSACTIONS_STREAM_MASTER();
+    return true;
+}
+
+bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    batch_active = true;
+    bool okay    = transactions_master_batched(master_matrix, slave_matrix);
+    batch_active = false;
+    return okay;
+}
+
+#elif defined(SPLIT_SYNC_SCHEDULER_ENABLE)
+
+static const split_sync_schedule_t sync_schedule[SPLIT_SYNC_ITEM_COUNT] = {
+    [SPLIT_SYNC_SLAVE_MATRIX]  = {SPLIT_SYNC_SCHEDULE_SLAVE_MATRIX},
+    [SPLIT_SYNC_MASTER_MATRIX] = {SPLIT_SYNC_SCHEDULE_MASTER_MATRIX},
+    [SPLIT_SYNC_ENCODERS]      = {SPLIT_SYNC_SCHEDULE_ENCODERS},
+    [SPLIT_SYNC_SYNC_TIMER]    = {SPLIT_SYNC_SCHEDULE_SYNC_TIMER},
+    [SPLIT_SYNC_LAYER_STATE]   = {SPLIT_SYNC_SCHEDULE_LAYER_STATE},
+    [SPLIT_SYNC_LED_STATE]     = {SPLIT_SYNC_SCHEDULE_LED_STATE},
+    [SPLIT_SYNC_MODS]          = {SPLIT_SYNC_SCHEDULE_MODS},
+    [SPLIT_SYNC_BACKLIGHT]     = {SPLIT_SYNC_SCHEDULE_BACKLIGHT},
+    [SPLIT_SYNC_RGBLIGHT]      = {SPLIT_SYNC_SCHEDULE_RGBLIGHT},
+    [SPLIT_SYNC_LED_MATRIX]    = {SPLIT_SYNC_SCHEDULE_LED_MATRIX},
+    [SPLIT_SYNC_RGB_MATRIX]    = {SPLIT_SYNC_SCHEDULE_RGB_MATRIX},
+    [SPLIT_SYNC_WPM]           = {SPLIT_SYNC_SCHEDULE_WPM},
+    [SPLIT_SYNC_OLED]          = {SPLIT_SYNC_SCHEDULE_OLED},
+    [SPLIT_SYNC_ST7565]        = {SPLIT_SYNC_SCHEDULE_ST7565},
+    [SPLIT_SYNC_DISPLAY_STATE] = {SPLIT_SYNC_SCHEDULE_DISPLAY_STATE},
+    [SPLIT_SYNC_POINTING]      = {SPLIT_SYNC_SCHEDULE_POINTING},
+    [SPLIT_SYNC_STREAM]        = {SPLIT_SYNC_SCHEDULE_STREAM},
+};
+
+#    if defined(DEBUG_SPLIT_SYNC_RATE) && defined(CONSOLE_ENABLE)
+static void sync_stats_print(void) {
+    dprintf("split sync: %lu bytes/s, %u%% of budget\n", sync_scheduler.bus_load, sync_scheduler.bus_utilization);
+    for (uint8_t item = 0; item < SPLIT_SYNC_ITEM_COUNT; item++) {
+        if (sync_scheduler.rate[item]) {
+            dprintf("  item %u: %u/s\n", item, sync_scheduler.rate[item]);
+        }
+    }
+}
+#    else
+#        define sync_stats_print()
+#    endif
+
+uint16_t split_sync_get_rate(uint8_t item) {
+    return item < SPLIT_SYNC_ITEM_COUNT ? sync_scheduler.rate[item] : 0;
+}
+
+uint32_t split_sync_get_bus_load(void) {
+    return sync_scheduler.bus_load;
+}
+
+uint16_t split_sync_get_bus_utilization(void) {
+    return sync_scheduler.bus_utilization;
+}
+
+// Runs every tier in turn, each item of it only if the scheduler lets it
+bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    sync_now = timer_read32();
+    if (!sync_scheduler.schedule) {
+        split_sync_scheduler_init(&sync_scheduler, sync_schedule, SPLIT_SYNC_BUS_BUDGET, sync_now);
+    }
+
+    split_sync_begin_scan(&sync_scheduler);
+    for (sync_tier = 0; sync_tier < SPLIT_SYNC_PRIORITY_COUNT; sync_tier++) {
+        for (sync_pass = 0; sync_pass < 2; sync_pass++) {
+            TRANSACTIONS_SLAVE_MATRIX_MASTER();
+            TRANSACTIONS_MASTER_MATRIX_MASTER();
+            TRANSACTIONS_ENCODERS_MASTER();
+            TRANSACTIONS_SYNC_TIMER_MASTER();
+            TRANSACTIONS_LAYER_STATE_MASTER();
+            TRANSACTIONS_LED_STATE_MASTER();
+            TRANSACTIONS_MODS_MASTER();
+            TRANSACTIONS_BACKLIGHT_MASTER();
+            TRANSACTIONS_RGBLIGHT_MASTER();
+            TRANSACTIONS_LED_MATRIX_MASTER();
+            TRANSACTIONS_RGB_MATRIX_MASTER();
+            TRANSACTIONS_WPM_MASTER();
+            TRANSACTIONS_OLED_MASTER();
+            TRANSACTIONS_ST7565_MASTER();
+            TRANSACTIONS_DISPLAY_STATE_MASTER();
+            TRANSACTIONS_POINTING_MASTER();
+            TRANSACTIONS_STREAM_MASTER();
+        }
+    }
+
+    if (split_sync_end_scan(&sync_scheduler, sync_now)) {
+        sync_stats_print();
+    }
+    return true;
+}
+
+#else // SPLIT_BATCH_SYNC_ENABLE
+
 bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     TRANSACTIONS_SLAVE_MATRIX_MASTER();
     TRANSACTIONS_MASTER_MATRIX_MASTER();
@@ -714,10 +1456,14 @@ bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix
     TRANSACTIONS_WPM_MASTER();
     TRANSACTIONS_OLED_MASTER();
     TRANSACTIONS_ST7565_MASTER();
+    TRANSACTIONS_DISPLAY_STATE_MASTER();
     TRANSACTIONS_POINTING_MASTER();
+    TRANSACTIONS_STREAM_MASTER();
     return true;
 }
 
+#endif // SPLIT_BATCH_SYNC_ENABLE
+
 void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     TRANSACTIONS_SLAVE_MATRIX_SLAVE();
     TRANSACTIONS_MASTER_MATRIX_SLAVE();
@@ -733,9 +1479,30 @@ void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[
     TRANSACTIONS_WPM_SLAVE();
     TRANSACTIONS_OLED_SLAVE();
     TRANSACTIONS_ST7565_SLAVE();
+    TRANSACTIONS_DISPLAY_STATE_SLAVE();
     TRANSACTIONS_POINTING_SLAVE();
 }
 
+uint8_t split_link_get_quality(void) {
+    return split_link_quality_percent(&link_policy);
+}
+
+uint8_t split_link_get_lowest_priority(void) {
+    return link_policy.lowest_priority;
+}
+
+bool split_link_get_counters(int8_t id, split_link_counters_t *counters) {
+    if (id < 0 || id >= NUM_TOTAL_TRANSACTIONS) {
+        return false;
+    }
+    *counters = link_policy.counters[id];
+    return true;
+}
+
+void split_link_print(void) {
+    split_link_print_stats(&link_policy);
+}
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 
 void transaction_register_rpc(int8_t transaction_id, slave_callback_t callback) {
@@ -814,3 +1581,35 @@ void slave_rpc_exec_callback(uint8_t initiator2target_buffer_size, const void *i
 }
 
 #endif // defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
+
+#ifdef SPLIT_STREAM_ENABLE
+
+void transaction_register_rpc_stream(int8_t transaction_id, split_stream_callback_t callback) {
+    // Prevent streaming onto QMK core sync data
+    if (transaction_id < STREAM_FIRST_USER_ID || transaction_id >= NUM_TOTAL_TRANSACTIONS) return;
+
+    stream_callbacks[transaction_id - STREAM_FIRST_USER_ID] = callback;
+}
+
+bool transaction_rpc_stream(int8_t transaction_id, const void *data, uint16_t length, split_stream_done_t done) {
+    // Prevent transaction attempts while transport is disconnected
+    if (!is_transport_connected()) {
+        return false;
+    }
+    // Prevent streaming onto QMK core sync data
+    if (transaction_id < STREAM_FIRST_USER_ID || transaction_id >= NUM_TOTAL_TRANSACTIONS) return false;
+
+    return transaction_stream_start(&stream_sender, transaction_id, data, length, done, timer_read32());
+}
+
+bool transaction_rpc_stream_busy(void) {
+    // a stream can be stalled by the link shedding its tier, so it times out here too
+    transaction_stream_expire(&stream_sender, timer_read32());
+    return transaction_stream_active(&stream_sender);
+}
+
+void transaction_rpc_stream_cancel(void) {
+    transaction_stream_abort(&stream_sender);
+}
+
+#endif // SPLIT_STREAM_ENABLE
@@ -22,6 +22,7 @@
 #include "matrix.h"
 #include "transaction_id_define.h"
 #include "transport.h"
+#include "link_policy.h"
 
 typedef void (*slave_callback_t)(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
 
@@ -32,6 +33,7 @@ typedef struct _split_transaction_desc_t {
     uint8_t          target2initiator_buffer_size;
     uint16_t         target2initiator_offset;
     slave_callback_t slave_callback;
+    bool             length_prefixed; // only the first buffer[0] bytes of each buffer go over the wire
 } split_transaction_desc_t;
 
 // Forward declaration for the split transactions
@@ -45,9 +47,59 @@ extern split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS];
 bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
 void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
 
+#ifdef SPLIT_SYNC_SCHEDULER_ENABLE
+// Figures of the master's sync scheduler over the last second
+uint16_t split_sync_get_rate(uint8_t item);     // runs per second of a split_sync_item_t
+uint32_t split_sync_get_bus_load(void);         // estimated bus bytes per second
+uint16_t split_sync_get_bus_utilization(void); // percent of SPLIT_SYNC_BUS_BUDGET used per scan
+#endif // SPLIT_SYNC_SCHEDULER_ENABLE
+
+#ifdef SPLIT_DISPLAY_STATE_ENABLE
+// The master's display state; on the slave as last synced
+const split_display_state_t *split_display_state_get(void);
+
+// Master: fills in the state before it is compared and sent
+void split_display_state_collect_kb(split_display_state_t *state);
+void split_display_state_collect_user(split_display_state_t *state);
+
+// Either half: the state has changed, so displays rendering it are out of date
+void split_display_state_changed_kb(const split_display_state_t *state);
+void split_display_state_changed_user(const split_display_state_t *state);
+#endif // SPLIT_DISPLAY_STATE_ENABLE
+
+#if defined(ENCODER_ENABLE) && defined(SPLIT_ENCODER_QUEUE_ENABLE)
+// Slave: its encoder queue; master: the slave's queue as seen in its frames
+const input_queue_metrics_t *split_encoder_queue_get_metrics(void);
+#endif // defined(ENCODER_ENABLE) && defined(SPLIT_ENCODER_QUEUE_ENABLE)
+
+#if defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE) && defined(SPLIT_POINTING_QUEUE_ENABLE)
+// Master: fills in the next report's worth of the slave's motion, none if there is no more
+void                         split_pointing_queue_take(report_mouse_t *report);
+const input_queue_metrics_t *split_pointing_queue_get_metrics(void);
+#endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE) && defined(SPLIT_POINTING_QUEUE_ENABLE)
+
+// Health of the split link as seen by the master
+uint8_t split_link_get_quality(void);         // percent of recent attempts that succeeded
+uint8_t split_link_get_lowest_priority(void); // lowest split_sync_priority_t still synced
+bool    split_link_get_counters(int8_t id, split_link_counters_t *counters);
+void    split_link_print(void); // dumps the figures to the console
+
 void transaction_register_rpc(int8_t transaction_id, slave_callback_t callback);
 
 bool transaction_rpc_exec(int8_t transaction_id, uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
 
 #define transaction_rpc_send(transaction_id, initiator2target_buffer_size, initiator2target_buffer) transaction_rpc_exec(transaction_id, initiator2target_buffer_size, initiator2target_buffer, 0, NULL)
 #define transaction_rpc_recv(transaction_id, target2initiator_buffer_size, target2initiator_buffer) transaction_rpc_exec(transaction_id, 0, NULL, target2initiator_buffer_size, target2initiator_buffer)
+
+#ifdef SPLIT_STREAM_ENABLE
+// Takes a chunk of a streamed payload on the slave, returns false to have it sent again later
+typedef bool (*split_stream_callback_t)(uint16_t total, uint16_t offset, const uint8_t *data, uint8_t length);
+typedef void (*split_stream_done_t)(int8_t transaction_id, bool success);
+
+void transaction_register_rpc_stream(int8_t transaction_id, split_stream_callback_t callback);
+
+// Queues `data` to be streamed to the slave; it must stay untouched until `done` is called
+bool transaction_rpc_stream(int8_t transaction_id, const void *data, uint16_t length, split_stream_done_t done);
+bool transaction_rpc_stream_busy(void);
+void transaction_rpc_stream_cancel(void);
+#endif // SPLIT_STREAM_ENABLE
@@ -121,6 +121,14 @@ bool transport_execute_transaction(int8_t id, const void *initiator2target_buf,
 
 #endif // USE_I2C
 
+int8_t transport_failed_transaction(int8_t id) {
+#if !defined(USE_I2C) && defined(SERIAL_USART_PIPELINE)
+    return soft_serial_failed_transaction();
+#else
+    return id;
+#endif
+}
+
 bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     return transactions_master(master_matrix, slave_matrix);
 }
@@ -31,6 +31,14 @@
 #    define RPC_S2M_BUFFER_SIZE 32
 #endif // RPC_S2M_BUFFER_SIZE
 
+#ifndef SPLIT_DISPLAY_STATE_USER_SIZE
+#    define SPLIT_DISPLAY_STATE_USER_SIZE 0
+#endif // SPLIT_DISPLAY_STATE_USER_SIZE
+
+#ifndef SPLIT_BATCH_FRAME_SIZE
+#    define SPLIT_BATCH_FRAME_SIZE 64
+#endif // SPLIT_BATCH_FRAME_SIZE
+
 void transport_master_init(void);
 void transport_slave_init(void);
 
@@ -40,6 +48,9 @@ void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
 
 bool transport_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length);
 
+// transaction to blame when transport_execute_transaction(id, ...) failed, usually id itself
+int8_t transport_failed_transaction(int8_t id);
+
 #ifdef ENCODER_ENABLE
 #    include "encoder.h"
 #endif // ENCODER_ENABLE
@@ -52,10 +63,19 @@ bool transport_execute_transaction(int8_t id, const void *initiator2target_buf,
 #    include "rgblight.h"
 #endif // RGBLIGHT_ENABLE
 
+#ifdef SPLIT_MATRIX_DELTA_ENABLE
+#    include "matrix_delta.h"
+
+typedef struct _split_slave_matrix_sync_t {
+    uint8_t request;
+    uint8_t frame[MATRIX_DELTA_FRAME_SIZE];
+} split_slave_matrix_sync_t;
+#else // SPLIT_MATRIX_DELTA_ENABLE
 typedef struct _split_slave_matrix_sync_t {
     uint8_t      checksum;
     matrix_row_t matrix[(MATRIX_ROWS) / 2];
 } split_slave_matrix_sync_t;
+#endif // SPLIT_MATRIX_DELTA_ENABLE
 
 #ifdef SPLIT_TRANSPORT_MIRROR
 typedef struct _split_master_matrix_sync_t {
@@ -64,10 +84,19 @@ typedef struct _split_master_matrix_sync_t {
 #endif // SPLIT_TRANSPORT_MIRROR
 
 #ifdef ENCODER_ENABLE
+#    ifdef SPLIT_ENCODER_QUEUE_ENABLE
+#        include "input_queue.h"
+
+typedef struct _split_slave_encoder_sync_t {
+    uint8_t request;
+    uint8_t frame[ENCODER_QUEUE_FRAME_SIZE];
+} split_slave_encoder_sync_t;
+#    else // SPLIT_ENCODER_QUEUE_ENABLE
 typedef struct _split_slave_encoder_sync_t {
     uint8_t checksum;
     uint8_t state[NUM_ENCODERS_MAX_PER_SIDE];
 } split_slave_encoder_sync_t;
+#    endif // SPLIT_ENCODER_QUEUE_ENABLE
 #endif // ENCODER_ENABLE
 
 #if !defined(NO_ACTION_LAYER) && defined(SPLIT_LAYER_STATE_ENABLE)
@@ -105,15 +134,49 @@ typedef struct _split_mods_sync_t {
 } split_mods_sync_t;
 #endif // SPLIT_MODS_ENABLE
 
+#ifdef SPLIT_DISPLAY_STATE_ENABLE
+#    include "led.h"
+
+// What a display needs to know of the master, rendered on whichever half has the display
+typedef struct _split_display_state_t {
+#    ifndef NO_ACTION_LAYER
+    layer_state_t layer_state;
+    layer_state_t default_layer_state;
+#    endif // NO_ACTION_LAYER
+    uint8_t mods; // real, weak and oneshot
+    led_t   led_state;
+#    ifdef WPM_ENABLE
+    uint8_t wpm;
+#    endif // WPM_ENABLE
+#    if SPLIT_DISPLAY_STATE_USER_SIZE > 0
+    uint8_t user[SPLIT_DISPLAY_STATE_USER_SIZE]; // filled in by split_display_state_collect_user()
+#    endif // SPLIT_DISPLAY_STATE_USER_SIZE > 0
+} split_display_state_t;
+#endif // SPLIT_DISPLAY_STATE_ENABLE
+
 #if defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 #    include "pointing_device.h"
+#    ifdef SPLIT_POINTING_QUEUE_ENABLE
+#        include "input_queue.h"
+
+typedef struct _split_slave_pointing_sync_t {
+    uint8_t  request;
+    uint8_t  frame[POINTING_QUEUE_FRAME_SIZE];
+    uint16_t cpi;
+} split_slave_pointing_sync_t;
+#    else // SPLIT_POINTING_QUEUE_ENABLE
 typedef struct _split_slave_pointing_sync_t {
     uint8_t        checksum;
     report_mouse_t report;
     uint16_t       cpi;
 } split_slave_pointing_sync_t;
+#    endif // SPLIT_POINTING_QUEUE_ENABLE
 #endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
+#ifdef SPLIT_STREAM_ENABLE
+#    include "transaction_stream.h"
+#endif // SPLIT_STREAM_ENABLE
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 typedef struct _rpc_sync_info_t {
     uint8_t checksum;
@@ -184,10 +247,24 @@ typedef struct _split_shared_memory_t {
     uint8_t current_st7565_state;
 #endif // ST7565_ENABLE(OLED_ENABLE) && defined(SPLIT_ST7565_ENABLE)
 
+#ifdef SPLIT_DISPLAY_STATE_ENABLE
+    split_display_state_t display_state;
+#endif // SPLIT_DISPLAY_STATE_ENABLE
+
 #if defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
     split_slave_pointing_sync_t pointing;
 #endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
+#ifdef SPLIT_BATCH_SYNC_ENABLE
+    uint8_t batch_m2s[SPLIT_BATCH_FRAME_SIZE];
+    uint8_t batch_s2m[SPLIT_BATCH_FRAME_SIZE];
+#endif // SPLIT_BATCH_SYNC_ENABLE
+
+#ifdef SPLIT_STREAM_ENABLE
+    uint8_t stream_m2s[TRANSACTION_STREAM_FRAME_SIZE];
+    uint8_t stream_s2m[TRANSACTION_STREAM_ACK_SIZE];
+#endif // SPLIT_STREAM_ENABLE
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
     rpc_sync_info_t rpc_info;
     uint8_t         rpc_m2s_buffer[RPC_M2S_BUFFER_SIZE];
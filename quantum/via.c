@@ -45,6 +45,9 @@
 #include "quantum.h"
 
 #include "via.h"
+#include "via_bulk.h"
+#include "via_compress.h"
+#include "via_matrix_stream.h"
 
 #include "raw_hid.h"
 #include "dynamic_keymap.h"
@@ -52,6 +55,10 @@
 #include "version.h" // for QMK_BUILDDATE used in EEPROM magic
 #include "via_ensure_keycode.h"
 
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_COMMON_TRANSACTIONS)
+#    include "transactions.h"
+#endif
+
 // Forward declare some helpers.
 #if defined(VIA_QMK_BACKLIGHT_ENABLE)
 void via_qmk_backlight_set_value(uint8_t *data);
@@ -195,6 +202,12 @@ bool process_record_via(uint16_t keycode, keyrecord_t *record) {
     return true;
 }
 
+// Called from raw_hid_task() on every pass.
+void raw_hid_poll(void) {
+    via_bulk_task();
+    via_matrix_stream_task();
+}
+
 // Keyboard level code can override this to handle custom messages from VIA.
 // See raw_hid_receive() implementation.
 // DO NOT call raw_hid_send() in the override function.
@@ -256,6 +269,27 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
 #endif
                     break;
                 }
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_COMMON_TRANSACTIONS)
+                case id_split_link_stats: {
+                    // Link quality and lowest priority synced, then the counters of as many
+                    // transactions as fit, starting with the ID in command_data[1]
+                    int8_t id       = command_data[1];
+                    command_data[1] = split_link_get_quality();
+                    command_data[2] = split_link_get_lowest_priority();
+                    command_data[3] = NUM_TOTAL_TRANSACTIONS;
+                    command_data[4] = id;
+                    uint8_t i       = 5;
+                    for (split_link_counters_t counters; i + 6 <= length - 1 && split_link_get_counters(id, &counters); id++) {
+                        command_data[i++] = counters.successes >> 8;
+                        command_data[i++] = counters.successes & 0xFF;
+                        command_data[i++] = counters.failures >> 8;
+                        command_data[i++] = counters.failures & 0xFF;
+                        command_data[i++] = counters.retries >> 8;
+                        command_data[i++] = counters.retries & 0xFF;
+                    }
+                    break;
+                }
+#endif
                 default: {
                     raw_hid_receive_kb(data, length);
                     break;
@@ -409,6 +443,21 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
             break;
         }
 #endif
+        case id_dynamic_keymap_get_compressed:
+        case id_dynamic_keymap_set_compressed: {
+            via_compress_receive(data, length);
+            break;
+        }
+        case id_matrix_stream: {
+            via_matrix_stream_receive(data, length);
+            break;
+        }
+        case id_bulk_transfer: {
+            if (!via_bulk_receive(data, length)) {
+                return;
+            }
+            break;
+        }
         default: {
             // The command ID is not known
             // Return the unhandled state
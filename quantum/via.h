@@ -17,6 +17,7 @@
 #pragma once
 
 #include "eeconfig.h" // for EECONFIG_SIZE
+#include "action.h"   // for keyrecord_t
 
 // Keyboard level code can change where VIA stores the magic.
 // The magic is the build date YYMMDD encoded as BCD in 3 bytes,
@@ -82,13 +83,18 @@ enum via_command_id {
     id_dynamic_keymap_set_buffer            = 0x13,
     id_dynamic_keymap_get_encoder           = 0x14,
     id_dynamic_keymap_set_encoder           = 0x15,
+    id_bulk_transfer                        = 0x16,
+    id_dynamic_keymap_get_compressed        = 0x17,
+    id_dynamic_keymap_set_compressed        = 0x18,
+    id_matrix_stream                        = 0x19,
     id_unhandled                            = 0xFF,
 };
 
 enum via_keyboard_value_id {
     id_uptime              = 0x01, //
     id_layout_options      = 0x02,
-    id_switch_matrix_state = 0x03
+    id_switch_matrix_state = 0x03,
+    id_split_link_stats    = 0x04,
 };
 
 enum via_lighting_value {
@@ -0,0 +1,182 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "via_bulk.h"
+#include "via.h"
+#include "crc.h"
+#include "dynamic_keymap.h"
+#include "raw_hid.h"
+#include "util.h"
+
+// Bulk transfers stream a region as a run of sequence-numbered packets,
+// keeping at most `window` of them unacknowledged. The stream is pushed
+// from raw_hid_poll() rather than answered request by request, and the
+// host can rewind it to any offset it has not received yet.
+#define VIA_BULK_PACKET_SIZE 32
+#define VIA_BULK_HEADER_SIZE 6
+#define VIA_BULK_PAYLOAD_SIZE (VIA_BULK_PACKET_SIZE - VIA_BULK_HEADER_SIZE)
+
+_Static_assert(VIA_BULK_MAX_WINDOW >= 1 && VIA_BULK_MAX_WINDOW <= 127, "VIA_BULK_MAX_WINDOW must be between 1 and 127");
+
+typedef struct {
+    uint8_t  region; // 0 when no transfer is active
+    uint8_t  window;
+    uint8_t  seq;
+    bool     end_sent;
+    uint16_t end;
+    uint16_t acked;   // the host has everything before this offset
+    uint16_t next;    // offset of the next data packet
+    uint16_t crc_end; // crc covers the range start up to this offset
+    uint16_t crc;
+} via_bulk_state_t;
+
+static via_bulk_state_t via_bulk;
+
+static uint16_t via_bulk_region_size(uint8_t region) {
+    switch (region) {
+        case id_bulk_region_keymap:
+            return dynamic_keymap_get_layer_count() * MATRIX_ROWS * MATRIX_COLS * 2;
+        case id_bulk_region_macro:
+            return dynamic_keymap_macro_get_buffer_size();
+        default:
+            return 0;
+    }
+}
+
+static void via_bulk_read_region(uint8_t region, uint16_t offset, uint16_t size, uint8_t *data) {
+    switch (region) {
+        case id_bulk_region_keymap:
+            dynamic_keymap_get_buffer(offset, size, data);
+            break;
+        case id_bulk_region_macro:
+            dynamic_keymap_macro_get_buffer(offset, size, data);
+            break;
+    }
+}
+
+bool via_bulk_receive(uint8_t *data, uint8_t length) {
+    uint8_t *command_id   = &(data[0]);
+    uint8_t *command_data = &(data[1]);
+    switch (command_data[0]) {
+        case id_bulk_read: {
+            uint8_t  region = command_data[1];
+            uint16_t offset = (command_data[2] << 8) | command_data[3];
+            uint16_t total  = (command_data[4] << 8) | command_data[5];
+            uint8_t  window = command_data[6];
+            uint16_t size   = via_bulk_region_size(region);
+
+            if (offset >= size) {
+                total = 0;
+            } else if (total > size - offset) {
+                total = size - offset;
+            }
+            if (window == 0 || window > VIA_BULK_MAX_WINDOW) {
+                window = VIA_BULK_MAX_WINDOW;
+            }
+
+            via_bulk = (via_bulk_state_t){0};
+            if (total > 0) {
+                via_bulk.region  = region;
+                via_bulk.window  = window;
+                via_bulk.end     = offset + total;
+                via_bulk.acked   = offset;
+                via_bulk.next    = offset;
+                via_bulk.crc_end = offset;
+                via_bulk.crc     = CRC16_INIT;
+            }
+
+            command_data[4] = total >> 8;
+            command_data[5] = total & 0xFF;
+            command_data[6] = window;
+            return true;
+        }
+        case id_bulk_ack: {
+            uint16_t offset = (command_data[1] << 8) | command_data[2];
+            if (via_bulk.region && offset >= via_bulk.acked && offset <= via_bulk.next) {
+                via_bulk.acked = offset;
+                if (offset == via_bulk.end && via_bulk.end_sent) {
+                    via_bulk.region = 0;
+                }
+            }
+            return false;
+        }
+        case id_bulk_resume: {
+            // Everything before the resume offset has arrived, so it is also an ack.
+            // Offsets past what has been sent would leave a hole in the crc.
+            uint16_t offset = (command_data[1] << 8) | command_data[2];
+            if (via_bulk.region && offset >= via_bulk.acked && offset <= via_bulk.crc_end) {
+                via_bulk.acked    = offset;
+                via_bulk.next     = offset;
+                via_bulk.end_sent = false;
+            }
+            return false;
+        }
+        case id_bulk_abort: {
+            via_bulk.region = 0;
+            return true;
+        }
+        default: {
+            *command_id = id_unhandled;
+            return true;
+        }
+    }
+}
+
+void via_bulk_task(void) {
+    if (!via_bulk.region) {
+        return;
+    }
+
+    uint8_t packet[VIA_BULK_PACKET_SIZE];
+    while (via_bulk.next < via_bulk.end && (via_bulk.next - via_bulk.acked + VIA_BULK_PAYLOAD_SIZE - 1) / VIA_BULK_PAYLOAD_SIZE < via_bulk.window) {
+        uint16_t offset = via_bulk.next;
+        uint8_t  length = MIN(VIA_BULK_PAYLOAD_SIZE, via_bulk.end - offset);
+
+        memset(packet, 0, sizeof(packet));
+        packet[0] = id_bulk_transfer;
+        packet[1] = id_bulk_data;
+        packet[2] = via_bulk.seq++;
+        packet[3] = offset >> 8;
+        packet[4] = offset & 0xFF;
+        packet[5] = length;
+        via_bulk_read_region(via_bulk.region, offset, length, &packet[VIA_BULK_HEADER_SIZE]);
+
+        // Retransmitted bytes are already covered by the crc.
+        if (offset + length > via_bulk.crc_end) {
+            uint8_t covered  = via_bulk.crc_end - offset;
+            via_bulk.crc     = crc16_update(via_bulk.crc, &packet[VIA_BULK_HEADER_SIZE + covered], length - covered);
+            via_bulk.crc_end = offset + length;
+        }
+
+        via_bulk.next += length;
+        raw_hid_send(packet, sizeof(packet));
+    }
+
+    if (via_bulk.next == via_bulk.end && !via_bulk.end_sent) {
+        memset(packet, 0, sizeof(packet));
+        packet[0] = id_bulk_transfer;
+        packet[1] = id_bulk_end;
+        packet[2] = via_bulk.seq++;
+        packet[3] = via_bulk.end >> 8;
+        packet[4] = via_bulk.end & 0xFF;
+        packet[5] = via_bulk.crc >> 8;
+        packet[6] = via_bulk.crc & 0xFF;
+        via_bulk.end_sent = true;
+        raw_hid_send(packet, sizeof(packet));
+    }
+}
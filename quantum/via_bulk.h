@@ -0,0 +1,61 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Upper bound on the number of unacknowledged packets a bulk transfer
+// keeps in flight. Raising it past the raw HID IN queue depth
+// (RAW_IN_CAPACITY on ChibiOS) makes raw_hid_task() block on the host.
+#ifndef VIA_BULK_MAX_WINDOW
+#    define VIA_BULK_MAX_WINDOW 4
+#endif
+
+// Sub-commands of id_bulk_transfer, in data[1].
+//
+// Host -> keyboard:
+//   read:   [2] region, [3..4] offset, [5..6] length, [7] window
+//           answered with the same packet, length and window clamped
+//           (length 0 if the region is unknown)
+//   ack:    [2..3] offset the host has received everything before
+//   resume: [2..3] offset to retransmit from, also acknowledges it
+//   abort:  stops the transfer
+// Keyboard -> host, pushed from raw_hid_task():
+//   data:   [2] seq, [3..4] offset, [5] length, [6..] payload
+//   end:    [2] seq, [3..4] end offset, [5..6] CRC-16/CCITT of the range
+enum via_bulk_command_id {
+    id_bulk_read   = 0x01,
+    id_bulk_ack    = 0x02,
+    id_bulk_resume = 0x03,
+    id_bulk_abort  = 0x04,
+    id_bulk_data   = 0x81,
+    id_bulk_end    = 0x82,
+};
+
+enum via_bulk_region {
+    id_bulk_region_keymap = 0x01,
+    id_bulk_region_macro  = 0x02,
+};
+
+// Handles an id_bulk_transfer packet in place.
+// Returns false if no response should be sent, the stream itself being the answer.
+bool via_bulk_receive(uint8_t *data, uint8_t length);
+
+// Pushes as much of the active transfer as the window allows,
+// then the end packet. Called from raw_hid_poll().
+void via_bulk_task(void);
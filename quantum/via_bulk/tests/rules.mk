@@ -0,0 +1,7 @@
+via_bulk_DEFS := -DNO_DEBUG
+via_bulk_CONFIG := $(QUANTUM_PATH)/via_bulk/tests/config_mock.h
+
+via_bulk_SRC := \
+	$(QUANTUM_PATH)/via_bulk/tests/via_bulk_tests.cpp \
+	$(QUANTUM_PATH)/via_bulk.c \
+	$(QUANTUM_PATH)/crc.c
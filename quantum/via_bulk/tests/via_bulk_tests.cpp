@@ -0,0 +1,352 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <array>
+#include <deque>
+#include <functional>
+#include <vector>
+
+extern "C" {
+#include "crc.h"
+#include "dynamic_keymap.h"
+#include "raw_hid.h"
+#include "via.h"
+#include "via_bulk.h"
+}
+
+using Packet = std::array<uint8_t, 32>;
+
+static const uint8_t layer_count = 10;
+static const uint16_t keymap_size = layer_count * MATRIX_ROWS * MATRIX_COLS * 2;
+
+static std::vector<uint8_t> keymap(keymap_size);
+static std::vector<uint8_t> macros(400);
+static std::deque<Packet>   device_to_host;
+
+extern "C" {
+uint8_t dynamic_keymap_get_layer_count(void) {
+    return layer_count;
+}
+
+void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
+    for (uint16_t i = 0; i < size; i++) {
+        data[i] = offset + i < keymap.size() ? keymap[offset + i] : 0;
+    }
+}
+
+uint16_t dynamic_keymap_macro_get_buffer_size(void) {
+    return macros.size();
+}
+
+void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
+    for (uint16_t i = 0; i < size; i++) {
+        data[i] = offset + i < macros.size() ? macros[offset + i] : 0;
+    }
+}
+
+void raw_hid_send(uint8_t *data, uint8_t length) {
+    ASSERT_EQ(length, sizeof(Packet));
+    Packet packet;
+    std::copy(data, data + length, packet.begin());
+    device_to_host.push_back(packet);
+}
+
+// Same dispatch as via.c does for id_bulk_transfer.
+void raw_hid_receive(uint8_t *data, uint8_t length) {
+    if (via_bulk_receive(data, length)) {
+        raw_hid_send(data, length);
+    }
+}
+
+void raw_hid_poll(void) {
+    via_bulk_task();
+}
+}
+
+// Host side of the bulk protocol, looped back through raw_hid_receive()
+// and raw_hid_poll() the way raw_hid_task() calls them.
+class BulkHost {
+   public:
+    struct Result {
+        std::vector<uint8_t> data;
+        bool                 crc_ok       = false;
+        unsigned             host_packets = 0;
+        unsigned             data_packets = 0;
+        unsigned             resumes      = 0;
+    };
+
+    // Returns false for packets that get lost on the way to the host.
+    std::function<bool(const Packet &)> deliver = [](const Packet &) { return true; };
+
+    Packet request(Packet packet) {
+        command(packet);
+        EXPECT_FALSE(device_to_host.empty());
+        Packet response = device_to_host.front();
+        device_to_host.pop_front();
+        return response;
+    }
+
+    void command(Packet packet) {
+        raw_hid_receive(packet.data(), packet.size());
+        host_packets++;
+    }
+
+    void ack(uint16_t offset) {
+        command({id_bulk_transfer, id_bulk_ack, (uint8_t)(offset >> 8), (uint8_t)offset});
+    }
+
+    void resume(uint16_t offset) {
+        command({id_bulk_transfer, id_bulk_resume, (uint8_t)(offset >> 8), (uint8_t)offset});
+    }
+
+    Packet start(uint8_t region, uint16_t offset, uint16_t length, uint8_t window) {
+        return request({id_bulk_transfer, id_bulk_read, region, (uint8_t)(offset >> 8), (uint8_t)offset, (uint8_t)(length >> 8), (uint8_t)length, window});
+    }
+
+    std::vector<Packet> poll() {
+        raw_hid_poll();
+        std::vector<Packet> packets(device_to_host.begin(), device_to_host.end());
+        device_to_host.clear();
+        return packets;
+    }
+
+    Result read(uint8_t region, uint16_t offset, uint16_t length, uint8_t window) {
+        Result result;
+        host_packets    = 0;
+        Packet response = start(region, offset, length, window);
+        length          = (response[5] << 8) | response[6];
+        uint16_t end    = offset + length;
+        uint16_t next   = offset;
+        result.data.resize(length);
+
+        for (unsigned pass = 0; pass < 10000; pass++) {
+            bool gap = false;
+            for (const Packet &packet : poll()) {
+                if (!deliver(packet)) {
+                    gap = true;
+                    continue;
+                }
+                EXPECT_EQ(packet[0], id_bulk_transfer);
+                if (packet[1] == id_bulk_end) {
+                    if (gap || next != end) {
+                        continue;
+                    }
+                    EXPECT_EQ((packet[3] << 8) | packet[4], end);
+                    uint16_t crc  = (packet[5] << 8) | packet[6];
+                    result.crc_ok = crc == crc16(result.data.data(), result.data.size());
+                    ack(end);
+                    result.host_packets = host_packets;
+                    return result;
+                }
+                EXPECT_EQ(packet[1], id_bulk_data);
+                result.data_packets++;
+                uint16_t packet_offset = (packet[3] << 8) | packet[4];
+                if (gap || packet_offset != next) {
+                    gap = true;
+                    continue;
+                }
+                std::copy(&packet[6], &packet[6] + packet[5], result.data.begin() + (next - offset));
+                next += packet[5];
+            }
+            if (gap) {
+                resume(next);
+                result.resumes++;
+            } else {
+                ack(next);
+            }
+        }
+        ADD_FAILURE() << "bulk transfer did not finish";
+        return result;
+    }
+
+    unsigned host_packets = 0;
+};
+
+class ViaBulk : public testing::Test {
+   protected:
+    void SetUp() override {
+        device_to_host.clear();
+        for (uint16_t i = 0; i < keymap.size(); i++) {
+            keymap[i] = i * 7 + 3;
+        }
+        for (uint16_t i = 0; i < macros.size(); i++) {
+            macros[i] = i ^ 0x5A;
+        }
+    }
+
+    void TearDown() override {
+        host.command({id_bulk_transfer, id_bulk_abort});
+        device_to_host.clear();
+    }
+
+    static std::vector<uint8_t> slice(const std::vector<uint8_t> &data, uint16_t offset, uint16_t length) {
+        return std::vector<uint8_t>(data.begin() + offset, data.begin() + offset + length);
+    }
+
+    BulkHost host;
+};
+
+TEST_F(ViaBulk, Crc16MatchesCcittCheckValue) {
+    const char *check = "123456789";
+    EXPECT_EQ(crc16(check, 9), 0x29B1);
+    EXPECT_EQ(crc16_update(crc16(check, 4), check + 4, 5), 0x29B1);
+}
+
+TEST_F(ViaBulk, UnknownSubCommandIsUnhandled) {
+    Packet response = host.request({id_bulk_transfer, 0x7F});
+    EXPECT_EQ(response[0], id_unhandled);
+}
+
+TEST_F(ViaBulk, ReadsWholeKeymap) {
+    auto result = host.read(id_bulk_region_keymap, 0, keymap_size, 4);
+
+    EXPECT_EQ(result.data, keymap);
+    EXPECT_TRUE(result.crc_ok);
+    EXPECT_EQ(result.resumes, 0);
+    EXPECT_EQ(host.poll().size(), 0);
+}
+
+TEST_F(ViaBulk, NeedsFarFewerHostPacketsThanBufferRequests) {
+    auto result = host.read(id_bulk_region_keymap, 0, keymap_size, 4);
+
+    // id_dynamic_keymap_get_buffer moves at most 28 bytes per request.
+    unsigned round_trips = (keymap_size + 27) / 28;
+    EXPECT_EQ(result.data_packets, (keymap_size + 25) / 26);
+    EXPECT_LE(result.host_packets * 3, round_trips);
+}
+
+TEST_F(ViaBulk, ReadsMacroBufferRange) {
+    auto result = host.read(id_bulk_region_macro, 3, macros.size() - 10, 2);
+
+    EXPECT_EQ(result.data, slice(macros, 3, macros.size() - 10));
+    EXPECT_TRUE(result.crc_ok);
+}
+
+TEST_F(ViaBulk, StreamStopsAtWindowUntilAcked) {
+    Packet response = host.start(id_bulk_region_keymap, 0, keymap_size, 3);
+    EXPECT_EQ(response[7], 3);
+
+    auto packets = host.poll();
+    ASSERT_EQ(packets.size(), 3);
+    for (uint8_t i = 0; i < 3; i++) {
+        EXPECT_EQ(packets[i][1], id_bulk_data);
+        EXPECT_EQ(packets[i][2], i);
+        EXPECT_EQ((packets[i][3] << 8) | packets[i][4], i * 26);
+        EXPECT_EQ(packets[i][5], 26);
+    }
+    EXPECT_EQ(host.poll().size(), 0);
+
+    host.ack(26);
+    packets = host.poll();
+    ASSERT_EQ(packets.size(), 1);
+    EXPECT_EQ(packets[0][2], 3);
+    EXPECT_EQ((packets[0][3] << 8) | packets[0][4], 3 * 26);
+}
+
+TEST_F(ViaBulk, LengthAndWindowAreClamped) {
+    Packet response = host.start(id_bulk_region_keymap, keymap_size - 10, 1000, 200);
+    EXPECT_EQ((response[5] << 8) | response[6], 10);
+    EXPECT_EQ(response[7], VIA_BULK_MAX_WINDOW);
+
+    response = host.start(id_bulk_region_keymap, keymap_size, 10, 1);
+    EXPECT_EQ((response[5] << 8) | response[6], 0);
+    EXPECT_EQ(host.poll().size(), 0);
+
+    response = host.start(0x7F, 0, 10, 1);
+    EXPECT_EQ((response[5] << 8) | response[6], 0);
+    EXPECT_EQ(host.poll().size(), 0);
+}
+
+TEST_F(ViaBulk, RecoversFromLostPackets) {
+    // Drop about one packet in five, pseudo-randomly so the losses do not
+    // line up with the window.
+    uint32_t state = 0x12345678;
+    host.deliver   = [&state](const Packet &) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state % 5 != 0;
+    };
+
+    auto result = host.read(id_bulk_region_keymap, 0, keymap_size, 4);
+
+    EXPECT_EQ(result.data, keymap);
+    EXPECT_TRUE(result.crc_ok);
+    EXPECT_GT(result.resumes, 0);
+}
+
+TEST_F(ViaBulk, RecoversFromLostEndPacket) {
+    bool lost    = false;
+    host.deliver = [&lost](const Packet &packet) {
+        if (packet[1] == id_bulk_end && !lost) {
+            lost = true;
+            return false;
+        }
+        return true;
+    };
+
+    auto result = host.read(id_bulk_region_keymap, 0, 100, 4);
+
+    EXPECT_TRUE(lost);
+    EXPECT_EQ(result.data, slice(keymap, 0, 100));
+    EXPECT_TRUE(result.crc_ok);
+}
+
+TEST_F(ViaBulk, ResumesAtOffsetInNewTransfer) {
+    uint16_t half = keymap_size / 2;
+    host.start(id_bulk_region_keymap, 0, keymap_size, 2);
+    host.poll();
+    host.command({id_bulk_transfer, id_bulk_abort});
+    device_to_host.clear();
+    EXPECT_EQ(host.poll().size(), 0);
+
+    auto result = host.read(id_bulk_region_keymap, half, keymap_size - half, 4);
+
+    EXPECT_EQ(result.data, slice(keymap, half, keymap_size - half));
+    EXPECT_TRUE(result.crc_ok);
+}
+
+TEST_F(ViaBulk, ResumePastSentDataIsIgnored) {
+    host.start(id_bulk_region_keymap, 0, keymap_size, 2);
+    host.poll();
+
+    host.resume(200);
+    EXPECT_EQ(host.poll().size(), 0);
+
+    host.resume(26);
+    auto packets = host.poll();
+    ASSERT_EQ(packets.size(), 2);
+    EXPECT_EQ((packets[0][3] << 8) | packets[0][4], 26);
+}
+
+TEST_F(ViaBulk, CrcCatchesDataChangedBeforeRetransmission) {
+    Packet response = host.start(id_bulk_region_keymap, 0, 52, 4);
+    ASSERT_EQ((response[5] << 8) | response[6], 52);
+
+    auto packets = host.poll();
+    ASSERT_EQ(packets.size(), 3);
+    std::vector<uint8_t> data(&packets[0][6], &packets[0][6] + 26);
+
+    keymap[30] = 0xEE;
+    host.resume(26);
+    packets = host.poll();
+    ASSERT_EQ(packets.size(), 2);
+    data.insert(data.end(), &packets[0][6], &packets[0][6] + 26);
+
+    EXPECT_EQ(packets[1][1], id_bulk_end);
+    EXPECT_NE((packets[1][5] << 8) | packets[1][6], crc16(data.data(), data.size()));
+}
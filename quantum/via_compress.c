@@ -0,0 +1,181 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "via_compress.h"
+#include "via.h"
+#include "dynamic_keymap.h"
+#include "keycode.h"
+#include "util.h"
+
+#define VIA_COMPRESS_TAG_MASK 0xC0
+#define VIA_COMPRESS_RUN_MASK 0x3F
+
+static uint16_t via_compress_keycode_count(void) {
+    return dynamic_keymap_get_layer_count() * MATRIX_ROWS * MATRIX_COLS;
+}
+
+static uint16_t via_compress_read(uint16_t index) {
+    uint8_t keycode[2];
+    dynamic_keymap_get_buffer(index * 2, 2, keycode);
+    return (keycode[0] << 8) | keycode[1];
+}
+
+static void via_compress_write(uint16_t index, uint16_t keycode) {
+    uint8_t data[2] = {keycode >> 8, keycode & 0xFF};
+    dynamic_keymap_set_buffer(index * 2, 2, data);
+}
+
+uint16_t via_compress_encode(uint16_t index, uint16_t count, uint8_t *stream, uint8_t size, uint8_t *length) {
+    uint16_t coded = 0;
+    uint8_t  used  = 0;
+
+    while (coded < count && used < size) {
+        uint16_t keycode = via_compress_read(index + coded);
+        uint8_t  run     = 1;
+
+        if (keycode == KC_NO || keycode == KC_TRNS) {
+            while (run < VIA_COMPRESS_MAX_RUN && coded + run < count && via_compress_read(index + coded + run) == keycode) {
+                run++;
+            }
+            stream[used++] = (keycode == KC_NO ? via_compress_tag_no : via_compress_tag_trns) | (run - 1);
+            coded += run;
+            continue;
+        }
+
+        // Literals run until a keycode of the other width or a KC_NO/KC_TRNS,
+        // which code better as a run of their own.
+        bool    basic = keycode <= 0xFF;
+        uint8_t width = basic ? 1 : 2;
+        if (used + 1 + width > size) {
+            break;
+        }
+
+        uint8_t tag = used++;
+        run         = 0;
+        while (true) {
+            if (basic) {
+                stream[used++] = keycode;
+            } else {
+                stream[used++] = keycode >> 8;
+                stream[used++] = keycode & 0xFF;
+            }
+            run++;
+
+            if (run == VIA_COMPRESS_MAX_RUN || coded + run == count || used + width > size) {
+                break;
+            }
+            keycode = via_compress_read(index + coded + run);
+            if (keycode == KC_NO || keycode == KC_TRNS || (keycode <= 0xFF) != basic) {
+                break;
+            }
+        }
+        stream[tag] = (basic ? via_compress_tag_basic : via_compress_tag_keycode) | (run - 1);
+        coded += run;
+    }
+
+    *length = used;
+    return coded;
+}
+
+// Walks the stream, writing the keycodes if `write` is set.
+// Returns the number of keycodes in it, or 0xFFFF if it is malformed.
+static uint16_t via_compress_walk(uint16_t index, uint8_t *stream, uint8_t length, bool write) {
+    uint16_t count = 0;
+    uint8_t  pos   = 0;
+
+    while (pos < length) {
+        uint8_t tag = stream[pos] & VIA_COMPRESS_TAG_MASK;
+        uint8_t run = (stream[pos] & VIA_COMPRESS_RUN_MASK) + 1;
+        pos++;
+
+        switch (tag) {
+            case via_compress_tag_no:
+            case via_compress_tag_trns:
+                if (write) {
+                    for (uint8_t i = 0; i < run; i++) {
+                        via_compress_write(index + count + i, tag == via_compress_tag_no ? KC_NO : KC_TRNS);
+                    }
+                }
+                break;
+            case via_compress_tag_basic:
+                if (run > length - pos) {
+                    return 0xFFFF;
+                }
+                if (write) {
+                    for (uint8_t i = 0; i < run; i++) {
+                        via_compress_write(index + count + i, stream[pos + i]);
+                    }
+                }
+                pos += run;
+                break;
+            default:
+                // Already in dynamic keymap buffer layout.
+                if (run * 2 > length - pos) {
+                    return 0xFFFF;
+                }
+                if (write) {
+                    dynamic_keymap_set_buffer((index + count) * 2, run * 2, &stream[pos]);
+                }
+                pos += run * 2;
+                break;
+        }
+        count += run;
+    }
+
+    return count;
+}
+
+bool via_compress_decode(uint16_t index, uint16_t count, uint8_t *stream, uint8_t length) {
+    if (via_compress_walk(index, stream, length, false) != count) {
+        return false;
+    }
+    via_compress_walk(index, stream, length, true);
+    return true;
+}
+
+void via_compress_receive(uint8_t *data, uint8_t length) {
+    uint8_t *command_id   = &(data[0]);
+    uint8_t *command_data = &(data[1]);
+    uint16_t index        = (command_data[0] << 8) | command_data[1];
+    uint16_t count        = (command_data[2] << 8) | command_data[3];
+    uint16_t total        = via_compress_keycode_count();
+    uint8_t *stream       = &data[VIA_COMPRESS_HEADER_SIZE];
+    uint8_t  size         = length - VIA_COMPRESS_HEADER_SIZE;
+
+    switch (*command_id) {
+        case id_dynamic_keymap_get_compressed: {
+            if (index >= total) {
+                count = 0;
+            } else if (count > total - index) {
+                count = total - index;
+            }
+            memset(stream, 0, size);
+            count = via_compress_encode(index, count, stream, size, &command_data[4]);
+            break;
+        }
+        case id_dynamic_keymap_set_compressed: {
+            if (index > total || count > total - index || command_data[4] > size || !via_compress_decode(index, count, stream, command_data[4])) {
+                count = 0;
+            }
+            break;
+        }
+    }
+
+    command_data[2] = count >> 8;
+    command_data[3] = count & 0xFF;
+}
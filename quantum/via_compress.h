@@ -0,0 +1,58 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// id_dynamic_keymap_get_compressed / id_dynamic_keymap_set_compressed move
+// a range of the dynamic keymap as a token stream instead of raw big-endian
+// keycodes. Keycodes are addressed by index in dynamic_keymap_get_buffer()
+// order, i.e. the byte offset divided by two.
+//
+// Each token is a tag byte, followed by data for literals:
+//   0x00-0x3F: 1-64 KC_NO
+//   0x40-0x7F: 1-64 KC_TRNS
+//   0x80-0xBF: 1-64 keycodes up to 0x00FF, one low byte each
+//   0xC0-0xFF: 1-64 keycodes, two big-endian bytes each
+// The low six bits of the tag hold the count minus one. Every packet
+// carries a self-contained stream.
+//
+// get: host     [1..2] first index, [3..4] keycodes wanted
+//      keyboard [1..2] first index, [3..4] keycodes coded, [5] stream length, [6..] stream
+// set: host     [1..2] first index, [3..4] keycodes, [5] stream length, [6..] stream
+//      keyboard the same packet, keycodes 0 if the stream was rejected and nothing was written
+#define VIA_COMPRESS_HEADER_SIZE 6
+#define VIA_COMPRESS_MAX_RUN 64
+
+enum via_compress_tag {
+    via_compress_tag_no      = 0x00,
+    via_compress_tag_trns    = 0x40,
+    via_compress_tag_basic   = 0x80,
+    via_compress_tag_keycode = 0xC0,
+};
+
+// Codes up to `count` keycodes starting at `index` into at most `size` bytes.
+// Returns the number of keycodes coded, `length` receives the stream length.
+uint16_t via_compress_encode(uint16_t index, uint16_t count, uint8_t *stream, uint8_t size, uint8_t *length);
+
+// Writes the keycodes of a stream starting at `index`. Nothing is written
+// unless the stream is well formed and holds exactly `count` keycodes.
+bool via_compress_decode(uint16_t index, uint16_t count, uint8_t *stream, uint8_t length);
+
+// Handles an id_dynamic_keymap_get_compressed or _set_compressed packet in place.
+void via_compress_receive(uint8_t *data, uint8_t length);
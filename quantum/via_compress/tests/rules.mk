@@ -0,0 +1,6 @@
+via_compress_DEFS := -DNO_DEBUG
+via_compress_CONFIG := $(QUANTUM_PATH)/via_compress/tests/config_mock.h
+
+via_compress_SRC := \
+	$(QUANTUM_PATH)/via_compress/tests/via_compress_tests.cpp \
+	$(QUANTUM_PATH)/via_compress.c
@@ -0,0 +1,347 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <array>
+#include <vector>
+
+extern "C" {
+#include "dynamic_keymap.h"
+#include "keycode.h"
+#include "via.h"
+#include "via_compress.h"
+}
+
+using Packet   = std::array<uint8_t, 32>;
+using Keycodes = std::vector<uint16_t>;
+
+static const uint8_t  layer_count   = 4;
+static const uint16_t keycode_count = layer_count * MATRIX_ROWS * MATRIX_COLS;
+
+static std::vector<uint8_t> keymap(keycode_count * 2);
+static unsigned             buffer_writes;
+
+extern "C" {
+uint8_t dynamic_keymap_get_layer_count(void) {
+    return layer_count;
+}
+
+void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
+    for (uint16_t i = 0; i < size; i++) {
+        data[i] = offset + i < keymap.size() ? keymap[offset + i] : 0;
+    }
+}
+
+void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
+    for (uint16_t i = 0; i < size; i++) {
+        if (offset + i < keymap.size()) {
+            keymap[offset + i] = data[i];
+        }
+    }
+    buffer_writes++;
+}
+}
+
+static Keycodes get_keymap() {
+    Keycodes keycodes(keycode_count);
+    for (uint16_t i = 0; i < keycode_count; i++) {
+        keycodes[i] = (keymap[i * 2] << 8) | keymap[i * 2 + 1];
+    }
+    return keycodes;
+}
+
+static void set_keymap(const Keycodes &keycodes) {
+    for (uint16_t i = 0; i < keycode_count; i++) {
+        keymap[i * 2]     = keycodes[i] >> 8;
+        keymap[i * 2 + 1] = keycodes[i] & 0xFF;
+    }
+}
+
+// Host side of the codec, written against the format in via_compress.h
+// rather than sharing code with the keyboard side.
+static bool host_decode(const uint8_t *stream, uint8_t length, Keycodes &keycodes) {
+    for (uint8_t pos = 0; pos < length;) {
+        uint8_t tag = stream[pos] & 0xC0;
+        uint8_t run = (stream[pos++] & 0x3F) + 1;
+        for (uint8_t i = 0; i < run; i++) {
+            if (tag == via_compress_tag_no) {
+                keycodes.push_back(KC_NO);
+            } else if (tag == via_compress_tag_trns) {
+                keycodes.push_back(KC_TRNS);
+            } else if (tag == via_compress_tag_basic) {
+                if (pos + 1 > length) return false;
+                keycodes.push_back(stream[pos++]);
+            } else {
+                if (pos + 2 > length) return false;
+                keycodes.push_back((stream[pos] << 8) | stream[pos + 1]);
+                pos += 2;
+            }
+        }
+    }
+    return true;
+}
+
+// Greedy token by token encoder, a token never straddles two packets.
+static std::vector<std::vector<uint8_t>> host_encode(const Keycodes &keycodes, size_t size, std::vector<uint16_t> &counts) {
+    std::vector<std::vector<uint8_t>> streams(1);
+    counts.assign(1, 0);
+    for (size_t i = 0; i < keycodes.size();) {
+        uint16_t             keycode = keycodes[i];
+        std::vector<uint8_t> token{0};
+        size_t               run = 0;
+        if (keycode == KC_NO || keycode == KC_TRNS) {
+            while (run < 64 && i + run < keycodes.size() && keycodes[i + run] == keycode) run++;
+            token[0] = (keycode == KC_NO ? via_compress_tag_no : via_compress_tag_trns) | (run - 1);
+        } else {
+            bool basic = keycode <= 0xFF;
+            while (run < 64 && i + run < keycodes.size() && token.size() + (basic ? 1 : 2) <= size) {
+                uint16_t next = keycodes[i + run];
+                if (next == KC_NO || next == KC_TRNS || (next <= 0xFF) != basic) break;
+                if (!basic) token.push_back(next >> 8);
+                token.push_back(next & 0xFF);
+                run++;
+            }
+            token[0] = (basic ? via_compress_tag_basic : via_compress_tag_keycode) | (run - 1);
+        }
+        if (streams.back().size() + token.size() > size) {
+            streams.emplace_back();
+            counts.push_back(0);
+        }
+        streams.back().insert(streams.back().end(), token.begin(), token.end());
+        counts.back() += run;
+        i += run;
+    }
+    return streams;
+}
+
+static Packet request(Packet packet) {
+    via_compress_receive(packet.data(), packet.size());
+    return packet;
+}
+
+static Packet get_request(uint16_t index, uint16_t count) {
+    return request({id_dynamic_keymap_get_compressed, (uint8_t)(index >> 8), (uint8_t)index, (uint8_t)(count >> 8), (uint8_t)count});
+}
+
+static Packet set_request(uint16_t index, uint16_t count, const std::vector<uint8_t> &stream) {
+    Packet packet = {id_dynamic_keymap_set_compressed, (uint8_t)(index >> 8), (uint8_t)index, (uint8_t)(count >> 8), (uint8_t)count, (uint8_t)stream.size()};
+    std::copy(stream.begin(), stream.end(), packet.begin() + VIA_COMPRESS_HEADER_SIZE);
+    return request(packet);
+}
+
+static uint16_t packet_count(const Packet &packet) {
+    return (packet[3] << 8) | packet[4];
+}
+
+// Reads keycodes [index, index + count) the way a host would, returning the number of requests.
+static unsigned read_keymap(uint16_t index, uint16_t count, Keycodes &keycodes) {
+    unsigned requests = 0;
+    keycodes.clear();
+    while (keycodes.size() < count) {
+        uint16_t next     = index + keycodes.size();
+        Packet   response = get_request(next, count - keycodes.size());
+        requests++;
+        EXPECT_EQ((response[1] << 8) | response[2], next);
+        EXPECT_LE(response[5], sizeof(Packet) - VIA_COMPRESS_HEADER_SIZE);
+
+        size_t before = keycodes.size();
+        EXPECT_TRUE(host_decode(&response[VIA_COMPRESS_HEADER_SIZE], response[5], keycodes));
+        EXPECT_EQ(keycodes.size() - before, packet_count(response));
+        if (packet_count(response) == 0) {
+            ADD_FAILURE() << "no progress at " << next;
+            break;
+        }
+    }
+    return requests;
+}
+
+static unsigned write_keymap(uint16_t index, const Keycodes &keycodes) {
+    std::vector<uint16_t> counts;
+    auto                  streams = host_encode(keycodes, sizeof(Packet) - VIA_COMPRESS_HEADER_SIZE, counts);
+    for (size_t i = 0; i < streams.size(); i++) {
+        Packet response = set_request(index, counts[i], streams[i]);
+        EXPECT_EQ(packet_count(response), counts[i]);
+        index += counts[i];
+    }
+    return streams.size();
+}
+
+// A 61 key layout on a 5x15 matrix, a base layer and mostly transparent ones above it.
+static Keycodes typical_keymap() {
+    Keycodes keycodes;
+    for (uint8_t layer = 0; layer < layer_count; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                bool     present = col < 13 || (row == 0 && col == 13) || (row == 4 && col < 8);
+                uint16_t keycode = KC_NO;
+                if (present && layer == 0) {
+                    keycode = KC_A + row * 15 + col;
+                    if (row == 4 && col == 5) keycode = 0x5221; // a layer tap
+                } else if (present) {
+                    keycode = KC_TRNS;
+                    if (row == 0 && col < 12 && layer == 1) keycode = KC_F1 + col;
+                    if (row == 2 && col > 7 && layer == 1) keycode = 0x7C00 + col; // quantum keycodes
+                    if (row == 1 && col > 2 && col < 6 && layer == 2) keycode = 0x7800 + col;
+                }
+                keycodes.push_back(keycode);
+            }
+        }
+    }
+    return keycodes;
+}
+
+static Keycodes random_keymap(uint32_t seed) {
+    uint32_t state = seed;
+    Keycodes keycodes(keycode_count);
+    for (auto &keycode : keycodes) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        switch (state % 5) {
+            case 0:
+                keycode = KC_NO;
+                break;
+            case 1:
+                keycode = KC_TRNS;
+                break;
+            case 2:
+                keycode = state >> 24;
+                break;
+            default:
+                keycode = state >> 16;
+                break;
+        }
+    }
+    return keycodes;
+}
+
+class ViaCompress : public testing::Test {
+   protected:
+    void SetUp() override {
+        set_keymap(typical_keymap());
+        buffer_writes = 0;
+    }
+};
+
+TEST_F(ViaCompress, MatchesReferenceStream) {
+    // Same stream as lib/python/qmk/tests/test_qmk_via_compress.py
+    set_keymap(Keycodes(keycode_count, KC_TRNS));
+    Keycodes reference = {KC_NO, KC_NO, KC_NO, KC_A, KC_B, KC_TRNS, 0x5221, 0x7C00, KC_C};
+    for (size_t i = 0; i < reference.size(); i++) {
+        keymap[i * 2]     = reference[i] >> 8;
+        keymap[i * 2 + 1] = reference[i] & 0xFF;
+    }
+
+    Packet response = get_request(0, 80);
+    EXPECT_EQ(packet_count(response), 80);
+    std::vector<uint8_t> stream(&response[VIA_COMPRESS_HEADER_SIZE], &response[VIA_COMPRESS_HEADER_SIZE] + response[5]);
+    EXPECT_EQ(stream, std::vector<uint8_t>({0x02, 0x81, 0x04, 0x05, 0x40, 0xC1, 0x52, 0x21, 0x7C, 0x00, 0x80, 0x06, 0x7F, 0x46}));
+}
+
+TEST_F(ViaCompress, ReadsWholeKeymap) {
+    Keycodes keycodes;
+    read_keymap(0, keycode_count, keycodes);
+    EXPECT_EQ(keycodes, typical_keymap());
+}
+
+TEST_F(ViaCompress, NeedsFarFewerRequestsThanGetBuffer) {
+    Keycodes keycodes;
+    unsigned requests = read_keymap(0, keycode_count, keycodes);
+
+    // id_dynamic_keymap_get_buffer moves at most 28 bytes per request.
+    unsigned round_trips = (keycode_count * 2 + 27) / 28;
+    EXPECT_LE(requests * 3, round_trips);
+
+    buffer_writes = 0;
+    EXPECT_LE(write_keymap(0, keycodes) * 3, round_trips);
+}
+
+TEST_F(ViaCompress, WritesWholeKeymap) {
+    Keycodes target = random_keymap(0x9E3779B9);
+    write_keymap(0, target);
+    EXPECT_EQ(get_keymap(), target);
+}
+
+TEST_F(ViaCompress, RandomKeymapsRoundTrip) {
+    for (uint32_t seed = 1; seed < 200; seed++) {
+        Keycodes target = random_keymap(seed * 0x01000193);
+        set_keymap(target);
+
+        Keycodes keycodes;
+        read_keymap(0, keycode_count, keycodes);
+        ASSERT_EQ(keycodes, target) << "seed " << seed;
+
+        set_keymap(Keycodes(keycode_count, 0xFFFF));
+        write_keymap(0, keycodes);
+        ASSERT_EQ(get_keymap(), target) << "seed " << seed;
+    }
+}
+
+TEST_F(ViaCompress, ReadsAndWritesRange) {
+    Keycodes keycodes;
+    read_keymap(100, 50, keycodes);
+    Keycodes expected = typical_keymap();
+    EXPECT_EQ(keycodes, Keycodes(expected.begin() + 100, expected.begin() + 150));
+
+    Keycodes part(30, 0x1234);
+    write_keymap(200, part);
+    std::copy(part.begin(), part.end(), expected.begin() + 200);
+    EXPECT_EQ(get_keymap(), expected);
+}
+
+TEST_F(ViaCompress, LongRunsAreSplit) {
+    set_keymap(Keycodes(keycode_count, KC_TRNS));
+
+    Packet response = get_request(0, keycode_count);
+    EXPECT_EQ(packet_count(response), keycode_count);
+    EXPECT_EQ(response[5], (keycode_count + 63) / 64);
+    EXPECT_EQ(response[VIA_COMPRESS_HEADER_SIZE], via_compress_tag_trns | 63);
+}
+
+TEST_F(ViaCompress, GetIsClampedToKeymap) {
+    Packet response = get_request(keycode_count - 5, 100);
+    EXPECT_EQ(packet_count(response), 5);
+
+    response = get_request(keycode_count, 10);
+    EXPECT_EQ(packet_count(response), 0);
+    EXPECT_EQ(response[5], 0);
+}
+
+TEST_F(ViaCompress, RejectsBadStreams) {
+    Keycodes before = get_keymap();
+
+    // Literal cut short
+    EXPECT_EQ(packet_count(set_request(0, 3, {0x82, 0x04, 0x05})), 0);
+    EXPECT_EQ(packet_count(set_request(0, 2, {0xC1, 0x52, 0x21, 0x7C})), 0);
+    // Count does not match the stream
+    EXPECT_EQ(packet_count(set_request(0, 4, {0x02})), 0);
+    EXPECT_EQ(packet_count(set_request(0, 2, {0x02})), 0);
+    // Past the end of the keymap
+    EXPECT_EQ(packet_count(set_request(keycode_count - 2, 3, {0x42})), 0);
+    // Stream longer than the packet
+    EXPECT_EQ(packet_count(set_request(0, 1, {0x40})), 1);
+    Packet packet = {id_dynamic_keymap_set_compressed, 0, 0, 0, 1, 27, 0x40};
+    EXPECT_EQ(packet_count(request(packet)), 0);
+
+    before[0] = KC_TRNS;
+    EXPECT_EQ(get_keymap(), before);
+}
+
+TEST_F(ViaCompress, WideLiteralsWriteInOneCall) {
+    EXPECT_EQ(packet_count(set_request(10, 4, {0xC3, 0x52, 0x21, 0x52, 0x22, 0x52, 0x23, 0x52, 0x24})), 4);
+    EXPECT_EQ(buffer_writes, 1);
+    EXPECT_EQ(get_keymap()[13], 0x5224);
+}
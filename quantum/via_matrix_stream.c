@@ -0,0 +1,158 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "via_matrix_stream.h"
+#include "via.h"
+#include "matrix.h"
+#include "raw_hid.h"
+#include "timer.h"
+#include "util.h"
+
+// Switch events are queued as they come out of matrix_task() and pushed
+// to the host in packets, at most one every `interval` ms, so the stream
+// cannot starve the keyboard of USB bandwidth however fast keys change.
+#define VIA_MATRIX_STREAM_PACKET_SIZE 32
+#define VIA_MATRIX_STREAM_HEADER_SIZE 4
+#define VIA_MATRIX_STREAM_EVENT_SIZE 4
+#define VIA_MATRIX_STREAM_PACKET_EVENTS ((VIA_MATRIX_STREAM_PACKET_SIZE - VIA_MATRIX_STREAM_HEADER_SIZE) / VIA_MATRIX_STREAM_EVENT_SIZE)
+#define VIA_MATRIX_STREAM_PRESSED 0x80
+#define VIA_MATRIX_STREAM_DROPPED 0x80
+
+_Static_assert(VIA_MATRIX_STREAM_BUFFER_SIZE >= 1 && VIA_MATRIX_STREAM_BUFFER_SIZE <= 255, "VIA_MATRIX_STREAM_BUFFER_SIZE must be between 1 and 255");
+_Static_assert(VIA_MATRIX_STREAM_MIN_INTERVAL >= 1 && VIA_MATRIX_STREAM_MIN_INTERVAL <= VIA_MATRIX_STREAM_INTERVAL && VIA_MATRIX_STREAM_INTERVAL <= 255, "VIA_MATRIX_STREAM_INTERVAL must be between VIA_MATRIX_STREAM_MIN_INTERVAL and 255");
+_Static_assert(MATRIX_COLS <= 128, "Matrix stream events have 7 bits for the column");
+
+typedef struct {
+    uint8_t  row;
+    uint8_t  col; // VIA_MATRIX_STREAM_PRESSED set when pressed
+    uint16_t time;
+} via_matrix_stream_event_t;
+
+typedef struct {
+    bool                      subscribed;
+    bool                      dropped;
+    uint8_t                   interval;
+    uint8_t                   seq;
+    uint8_t                   head;
+    uint8_t                   count;
+    uint16_t                  renewed;
+    uint16_t                  sent;
+    via_matrix_stream_event_t events[VIA_MATRIX_STREAM_BUFFER_SIZE];
+} via_matrix_stream_state_t;
+
+static via_matrix_stream_state_t via_matrix_stream;
+
+static void via_matrix_stream_push(uint8_t row, uint8_t col, bool pressed) {
+    if (via_matrix_stream.count == VIA_MATRIX_STREAM_BUFFER_SIZE) {
+        via_matrix_stream.dropped = true;
+        return;
+    }
+
+    uint8_t index                        = (via_matrix_stream.head + via_matrix_stream.count++) % VIA_MATRIX_STREAM_BUFFER_SIZE;
+    via_matrix_stream.events[index].row  = row;
+    via_matrix_stream.events[index].col  = col | (pressed ? VIA_MATRIX_STREAM_PRESSED : 0);
+    via_matrix_stream.events[index].time = timer_read();
+}
+
+void via_matrix_stream_event(uint8_t row, uint8_t col, bool pressed) {
+    if (via_matrix_stream.subscribed) {
+        via_matrix_stream_push(row, col, pressed);
+    }
+}
+
+void via_matrix_stream_receive(uint8_t *data, uint8_t length) {
+    uint8_t *command_id   = &(data[0]);
+    uint8_t *command_data = &(data[1]);
+    switch (command_data[0]) {
+        case id_matrix_stream_subscribe: {
+            uint8_t interval = command_data[1];
+            if (interval == 0) {
+                interval = VIA_MATRIX_STREAM_INTERVAL;
+            } else if (interval < VIA_MATRIX_STREAM_MIN_INTERVAL) {
+                interval = VIA_MATRIX_STREAM_MIN_INTERVAL;
+            }
+
+            if (!via_matrix_stream.subscribed) {
+                via_matrix_stream            = (via_matrix_stream_state_t){0};
+                via_matrix_stream.subscribed = true;
+                via_matrix_stream.sent       = timer_read() - interval;
+                for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                    matrix_row_t value = matrix_get_row(row);
+                    for (uint8_t col = 0; value; col++, value >>= 1) {
+                        if (value & 1) {
+                            via_matrix_stream_push(row, col, true);
+                        }
+                    }
+                }
+            }
+            via_matrix_stream.interval = interval;
+            via_matrix_stream.renewed  = timer_read();
+
+            command_data[1] = interval;
+            command_data[2] = MATRIX_ROWS;
+            command_data[3] = MATRIX_COLS;
+            command_data[4] = VIA_MATRIX_STREAM_TIMEOUT >> 8;
+            command_data[5] = VIA_MATRIX_STREAM_TIMEOUT & 0xFF;
+            break;
+        }
+        case id_matrix_stream_unsubscribe: {
+            via_matrix_stream.subscribed = false;
+            break;
+        }
+        default: {
+            *command_id = id_unhandled;
+            break;
+        }
+    }
+}
+
+void via_matrix_stream_task(void) {
+    if (!via_matrix_stream.subscribed) {
+        return;
+    }
+    if (timer_elapsed(via_matrix_stream.renewed) > VIA_MATRIX_STREAM_TIMEOUT) {
+        via_matrix_stream.subscribed = false;
+        return;
+    }
+    if (!via_matrix_stream.count || timer_elapsed(via_matrix_stream.sent) < via_matrix_stream.interval) {
+        return;
+    }
+
+    uint8_t packet[VIA_MATRIX_STREAM_PACKET_SIZE] = {0};
+    uint8_t count                                 = MIN(via_matrix_stream.count, VIA_MATRIX_STREAM_PACKET_EVENTS);
+    packet[0]                                     = id_matrix_stream;
+    packet[1]                                     = id_matrix_stream_events;
+    packet[2]                                     = via_matrix_stream.seq++;
+    packet[3]                                     = count | (via_matrix_stream.dropped ? VIA_MATRIX_STREAM_DROPPED : 0);
+
+    uint8_t *event = &packet[VIA_MATRIX_STREAM_HEADER_SIZE];
+    for (uint8_t i = 0; i < count; i++) {
+        via_matrix_stream_event_t *source = &via_matrix_stream.events[via_matrix_stream.head];
+        event[0]                          = source->row;
+        event[1]                          = source->col;
+        event[2]                          = source->time >> 8;
+        event[3]                          = source->time & 0xFF;
+        event += VIA_MATRIX_STREAM_EVENT_SIZE;
+        via_matrix_stream.head = (via_matrix_stream.head + 1) % VIA_MATRIX_STREAM_BUFFER_SIZE;
+    }
+    via_matrix_stream.count -= count;
+    via_matrix_stream.dropped = false;
+    via_matrix_stream.sent    = timer_read();
+
+    raw_hid_send(packet, sizeof(packet));
+}
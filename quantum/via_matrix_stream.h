@@ -0,0 +1,67 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Switch events buffered between two stream packets.
+#ifndef VIA_MATRIX_STREAM_BUFFER_SIZE
+#    define VIA_MATRIX_STREAM_BUFFER_SIZE 16
+#endif
+
+// Milliseconds between stream packets, unless the host asks for more.
+#ifndef VIA_MATRIX_STREAM_INTERVAL
+#    define VIA_MATRIX_STREAM_INTERVAL 10
+#endif
+
+// Lower bound on the interval the host can ask for.
+#ifndef VIA_MATRIX_STREAM_MIN_INTERVAL
+#    define VIA_MATRIX_STREAM_MIN_INTERVAL 4
+#endif
+
+// A subscription ends unless renewed within this many milliseconds,
+// so a host that went away does not leave the stream running.
+#ifndef VIA_MATRIX_STREAM_TIMEOUT
+#    define VIA_MATRIX_STREAM_TIMEOUT 3000
+#endif
+
+// Sub-commands of id_matrix_stream, in data[1].
+//
+// Host -> keyboard:
+//   subscribe:   [2] interval in ms, 0 for the default
+//                answered with [2] interval, [3] rows, [4] cols, [5..6] timeout in ms.
+//                Subscribing again renews the subscription. A new one first
+//                reports the keys already pressed.
+//   unsubscribe: stops the stream
+// Keyboard -> host, pushed from raw_hid_task():
+//   events:      [2] seq, [3] event count, bit 7 set if events were dropped before these,
+//                [4..] events of 4 bytes: row, col with bit 7 set when pressed, timer_read() big-endian
+enum via_matrix_stream_command_id {
+    id_matrix_stream_subscribe   = 0x01,
+    id_matrix_stream_unsubscribe = 0x02,
+    id_matrix_stream_events      = 0x81,
+};
+
+// Handles an id_matrix_stream packet in place.
+void via_matrix_stream_receive(uint8_t *data, uint8_t length);
+
+// Records a switch event while a host is subscribed. Called from switch_events().
+void via_matrix_stream_event(uint8_t row, uint8_t col, bool pressed);
+
+// Sends buffered events at the subscribed rate. Called from raw_hid_poll().
+void via_matrix_stream_task(void);
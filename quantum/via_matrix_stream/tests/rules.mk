@@ -0,0 +1,7 @@
+via_matrix_stream_DEFS := -DNO_DEBUG
+via_matrix_stream_CONFIG := $(QUANTUM_PATH)/via_matrix_stream/tests/config_mock.h
+
+via_matrix_stream_SRC := \
+	$(QUANTUM_PATH)/via_matrix_stream/tests/via_matrix_stream_tests.cpp \
+	$(QUANTUM_PATH)/via_matrix_stream.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
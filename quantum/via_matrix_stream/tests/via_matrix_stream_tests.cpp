@@ -0,0 +1,230 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <array>
+#include <deque>
+#include <tuple>
+#include <vector>
+
+extern "C" {
+#include "matrix.h"
+#include "raw_hid.h"
+#include "timer.h"
+#include "via.h"
+#include "via_matrix_stream.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+using Packet = std::array<uint8_t, 32>;
+using Event  = std::tuple<uint8_t, uint8_t, bool, uint16_t>;
+
+static matrix_row_t       matrix[MATRIX_ROWS];
+static std::deque<Packet> device_to_host;
+
+extern "C" {
+matrix_row_t matrix_get_row(uint8_t row) {
+    return matrix[row];
+}
+
+void raw_hid_send(uint8_t *data, uint8_t length) {
+    ASSERT_EQ(length, sizeof(Packet));
+    Packet packet;
+    std::copy(data, data + length, packet.begin());
+    device_to_host.push_back(packet);
+}
+}
+
+// Same dispatch as via.c does for id_matrix_stream.
+static Packet request(Packet packet) {
+    via_matrix_stream_receive(packet.data(), packet.size());
+    return packet;
+}
+
+static Packet subscribe(uint8_t interval = 0) {
+    return request({id_matrix_stream, id_matrix_stream_subscribe, interval});
+}
+
+// Switch changes as matrix_task() reports them through switch_events().
+static void set_key(uint8_t row, uint8_t col, bool pressed) {
+    matrix_row_t mask = (matrix_row_t)1 << col;
+    matrix[row]       = pressed ? matrix[row] | mask : matrix[row] & ~mask;
+    via_matrix_stream_event(row, col, pressed);
+}
+
+static std::vector<Packet> poll() {
+    via_matrix_stream_task();
+    std::vector<Packet> packets(device_to_host.begin(), device_to_host.end());
+    device_to_host.clear();
+    return packets;
+}
+
+static std::vector<Event> events(const Packet &packet, bool *dropped = nullptr) {
+    EXPECT_EQ(packet[0], id_matrix_stream);
+    EXPECT_EQ(packet[1], id_matrix_stream_events);
+    if (dropped) *dropped = packet[3] & 0x80;
+
+    std::vector<Event> result;
+    for (uint8_t i = 0; i < (packet[3] & 0x7F); i++) {
+        const uint8_t *event = &packet[4 + i * 4];
+        result.emplace_back(event[0], event[1] & 0x7F, event[1] & 0x80, (event[2] << 8) | event[3]);
+    }
+    return result;
+}
+
+class ViaMatrixStream : public testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(1000);
+        std::fill(std::begin(matrix), std::end(matrix), 0);
+        device_to_host.clear();
+    }
+
+    void TearDown() override {
+        request({id_matrix_stream, id_matrix_stream_unsubscribe});
+    }
+};
+
+TEST_F(ViaMatrixStream, SubscribeReportsGeometry) {
+    Packet response = subscribe();
+    EXPECT_EQ(response[0], id_matrix_stream);
+    EXPECT_EQ(response[2], VIA_MATRIX_STREAM_INTERVAL);
+    EXPECT_EQ(response[3], MATRIX_ROWS);
+    EXPECT_EQ(response[4], MATRIX_COLS);
+    EXPECT_EQ((response[5] << 8) | response[6], VIA_MATRIX_STREAM_TIMEOUT);
+    EXPECT_EQ(poll().size(), 0);
+}
+
+TEST_F(ViaMatrixStream, NothingIsStreamedWithoutSubscription) {
+    set_key(0, 0, true);
+    advance_time(100);
+    EXPECT_EQ(poll().size(), 0);
+
+    subscribe();
+    advance_time(100);
+    EXPECT_EQ(poll().size(), 1); // the pressed key, not the event before
+}
+
+TEST_F(ViaMatrixStream, NewSubscriptionStartsWithPressedKeys) {
+    set_key(11, 19, true);
+    set_key(3, 0, true);
+    subscribe();
+
+    auto packets = poll();
+    ASSERT_EQ(packets.size(), 1);
+    EXPECT_EQ(events(packets[0]), (std::vector<Event>{{3, 0, true, 1000}, {11, 19, true, 1000}}));
+
+    // Renewing does not repeat them
+    subscribe();
+    advance_time(100);
+    EXPECT_EQ(poll().size(), 0);
+}
+
+TEST_F(ViaMatrixStream, StreamsEventsWithTimestamps) {
+    subscribe();
+    set_key(5, 17, true);
+    advance_time(1);
+    set_key(5, 17, false);
+
+    auto packets = poll();
+    ASSERT_EQ(packets.size(), 1);
+    EXPECT_EQ(packets[0][2], 0);
+    EXPECT_EQ(events(packets[0]), (std::vector<Event>{{5, 17, true, 1000}, {5, 17, false, 1001}}));
+}
+
+TEST_F(ViaMatrixStream, PacketsAreRateLimited) {
+    EXPECT_EQ(subscribe(20)[2], 20);
+
+    // Two full packets of events
+    for (uint8_t col = 0; col < 7; col++) {
+        set_key(1, col, true);
+        set_key(1, col, false);
+    }
+    auto packets = poll();
+    ASSERT_EQ(packets.size(), 1);
+    EXPECT_EQ(events(packets[0]).size(), 7);
+
+    advance_time(19);
+    EXPECT_EQ(poll().size(), 0);
+    advance_time(1);
+    packets = poll();
+    ASSERT_EQ(packets.size(), 1);
+    EXPECT_EQ(packets[0][2], 1);
+    EXPECT_EQ(events(packets[0]).size(), 7);
+    EXPECT_EQ(std::get<1>(events(packets[0])[6]), 6);
+}
+
+TEST_F(ViaMatrixStream, IntervalIsClamped) {
+    EXPECT_EQ(subscribe(1)[2], VIA_MATRIX_STREAM_MIN_INTERVAL);
+}
+
+TEST_F(ViaMatrixStream, OverflowIsFlagged) {
+    subscribe();
+    poll();
+    for (uint8_t col = 0; col < 20; col++) {
+        set_key(2, col, true);
+    }
+
+    std::vector<Event> received;
+    bool               dropped = false, any_dropped = false;
+    for (int i = 0; i < 5; i++) {
+        advance_time(VIA_MATRIX_STREAM_INTERVAL);
+        for (auto &packet : poll()) {
+            auto e = events(packet, &dropped);
+            any_dropped |= dropped;
+            received.insert(received.end(), e.begin(), e.end());
+        }
+    }
+    EXPECT_TRUE(any_dropped);
+    ASSERT_EQ(received.size(), VIA_MATRIX_STREAM_BUFFER_SIZE);
+    EXPECT_EQ(std::get<1>(received.back()), VIA_MATRIX_STREAM_BUFFER_SIZE - 1);
+
+    // The flag is cleared once reported
+    set_key(3, 3, true);
+    advance_time(VIA_MATRIX_STREAM_INTERVAL);
+    auto packets = poll();
+    ASSERT_EQ(packets.size(), 1);
+    events(packets[0], &dropped);
+    EXPECT_FALSE(dropped);
+}
+
+TEST_F(ViaMatrixStream, SubscriptionTimesOut) {
+    subscribe();
+    advance_time(VIA_MATRIX_STREAM_TIMEOUT / 2);
+    subscribe();
+    advance_time(VIA_MATRIX_STREAM_TIMEOUT);
+    set_key(0, 1, true);
+    EXPECT_EQ(poll().size(), 1);
+
+    advance_time(VIA_MATRIX_STREAM_TIMEOUT + 1);
+    poll();
+    set_key(0, 2, true);
+    advance_time(VIA_MATRIX_STREAM_INTERVAL);
+    EXPECT_EQ(poll().size(), 0);
+}
+
+TEST_F(ViaMatrixStream, Unsubscribe) {
+    subscribe();
+    request({id_matrix_stream, id_matrix_stream_unsubscribe});
+    set_key(0, 1, true);
+    EXPECT_EQ(poll().size(), 0);
+}
+
+TEST_F(ViaMatrixStream, UnknownSubCommandIsUnhandled) {
+    EXPECT_EQ(request({id_matrix_stream, 0x7F})[0], id_unhandled);
+}
@@ -121,3 +121,58 @@ TEST_F(Tapping, ANewTapWithinTappingTermIsBuggy) {
     key_shift_hold_p_tap.release();
     run_one_scan_loop();
 }
+
+TEST_F(Tapping, WaitingBufferTracksMaxDepth) {
+    TestDriver driver;
+    auto       mod_tap_hold_key = KeymapKey(0, 7, 0, SFT_T(KC_P));
+    auto       regular_key      = KeymapKey(0, 1, 0, KC_A);
+
+    set_keymap({mod_tap_hold_key, regular_key});
+    clear_waiting_buffer_stats();
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+
+    // Every event after the mod-tap press waits for its decision
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    regular_key.press();
+    run_one_scan_loop();
+    regular_key.release();
+    run_one_scan_loop();
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+
+    waiting_buffer_stats_t stats = get_waiting_buffer_stats();
+    EXPECT_EQ(stats.max_depth, 3);
+    EXPECT_EQ(stats.overflows, 0);
+}
+
+TEST_F(Tapping, WaitingBufferCountsOverflow) {
+    TestDriver driver;
+    auto       mod_tap_hold_key = KeymapKey(0, 7, 0, SFT_T(KC_P));
+    auto       key_a            = KeymapKey(0, 1, 0, KC_A);
+    auto       key_b            = KeymapKey(0, 2, 0, KC_B);
+    auto       key_c            = KeymapKey(0, 3, 0, KC_C);
+    auto       key_d            = KeymapKey(0, 4, 0, KC_D);
+
+    set_keymap({mod_tap_hold_key, key_a, key_b, key_c, key_d});
+    clear_waiting_buffer_stats();
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+
+    // Eight rolled events overrun the default buffer of WAITING_BUFFER_SIZE - 1 records
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    for (KeymapKey key : {key_a, key_b, key_c, key_d}) {
+        key.press();
+        run_one_scan_loop();
+        key.release();
+        run_one_scan_loop();
+    }
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+
+    waiting_buffer_stats_t stats = get_waiting_buffer_stats();
+    EXPECT_EQ(stats.max_depth, WAITING_BUFFER_SIZE - 1);
+    EXPECT_EQ(stats.overflows, 1);
+}
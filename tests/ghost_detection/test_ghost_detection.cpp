@@ -0,0 +1,126 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class GhostDetection : public TestFixture {};
+
+TEST_F(GhostDetection, RowCompletingRectangleIsIgnored) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+    auto       key_c = KeymapKey(0, 0, 1, KC_C);
+    auto       key_d = KeymapKey(0, 1, 1, KC_D);
+
+    set_keymap({key_a, key_b, key_c, key_d});
+
+    key_a.press();
+    key_b.press();
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_B));
+    run_one_scan_loop();
+
+    key_c.press();
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C));
+    run_one_scan_loop();
+
+    /* Row 1 now shares two columns with row 0, so it can't be trusted */
+    key_d.press();
+    EXPECT_NO_REPORT(driver);
+    run_one_scan_loop();
+
+    /* Once the ghost is gone the row is processed again */
+    key_a.release();
+    EXPECT_REPORT(driver, (KC_B, KC_C));
+    EXPECT_REPORT(driver, (KC_B, KC_C, KC_D));
+    run_one_scan_loop();
+
+    key_b.release();
+    key_c.release();
+    key_d.release();
+    EXPECT_REPORT(driver, (KC_C, KC_D));
+    EXPECT_REPORT(driver, (KC_D));
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+}
+
+TEST_F(GhostDetection, BlankPositionsDontCauseGhosts) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a     = KeymapKey(0, 0, 0, KC_A);
+    auto       key_blank = KeymapKey(0, 1, 0, KC_NO);
+    auto       key_c     = KeymapKey(0, 0, 1, KC_C);
+    auto       key_d     = KeymapKey(0, 1, 1, KC_D);
+
+    /* Row 0 column 1 is a blank in the keymap */
+    set_keymap({key_a, key_blank, key_c, key_d});
+
+    key_a.press();
+    key_blank.press();
+    EXPECT_REPORT(driver, (KC_A));
+    run_one_scan_loop();
+
+    key_c.press();
+    EXPECT_REPORT(driver, (KC_A, KC_C));
+    run_one_scan_loop();
+
+    key_d.press();
+    EXPECT_REPORT(driver, (KC_A, KC_C, KC_D));
+    run_one_scan_loop();
+
+    key_a.release();
+    key_blank.release();
+    key_c.release();
+    key_d.release();
+    EXPECT_REPORT(driver, (KC_C, KC_D));
+    EXPECT_REPORT(driver, (KC_D));
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+}
+
+TEST_F(GhostDetection, SingleKeyRowsNeverGhost) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_c = KeymapKey(0, 0, 1, KC_C);
+    auto       key_e = KeymapKey(0, 0, 2, KC_E);
+
+    set_keymap({key_a, key_c, key_e});
+
+    /* Keys sharing one column line can't produce a ghost */
+    key_a.press();
+    key_c.press();
+    key_e.press();
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_C));
+    EXPECT_REPORT(driver, (KC_A, KC_C, KC_E));
+    run_one_scan_loop();
+
+    key_a.release();
+    key_c.release();
+    key_e.release();
+    EXPECT_REPORT(driver, (KC_C, KC_E));
+    EXPECT_REPORT(driver, (KC_E));
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+}
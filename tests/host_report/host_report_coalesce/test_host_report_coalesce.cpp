@@ -0,0 +1,163 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include "action.h"
+#include "host.h"
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+#include "timer.h"
+
+using testing::_;
+using testing::InSequence;
+
+class HostReportCoalesce : public TestFixture {
+   protected:
+    void SetUp() override {
+        host_keyboard_clear_stats();
+    }
+};
+
+TEST_F(HostReportCoalesce, ChangesWithinOneScanAreCoalesced) {
+    TestDriver driver;
+
+    /* Establish a last sent report to coalesce against. */
+    EXPECT_EMPTY_REPORT(driver);
+    host_keyboard_resync();
+    send_keyboard_report();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_NO_REPORT(driver);
+    register_code(KC_LEFT_SHIFT);
+    register_code(KC_A);
+    register_code(KC_B);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_A, KC_B)).Times(1);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(host_keyboard_get_stats().coalesced, 2);
+
+    EXPECT_EMPTY_REPORT(driver).Times(1);
+    clear_keyboard();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(HostReportCoalesce, TapWithinOneScanIsNotMerged) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_EMPTY_REPORT(driver);
+    host_keyboard_resync();
+    send_keyboard_report();
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_code(KC_A);
+    tap_code(KC_A);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(host_keyboard_get_stats().coalesced, 0);
+}
+
+TEST_F(HostReportCoalesce, ReleaseAndNextPressAreCoalesced) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_EMPTY_REPORT(driver);
+    host_keyboard_resync();
+    send_keyboard_report();
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_code(KC_A);
+    tap_code(KC_B);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(host_keyboard_get_stats().coalesced, 1);
+}
+
+TEST_F(HostReportCoalesce, ModifierAfterKeyPressIsNotCoalesced) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_EMPTY_REPORT(driver);
+    host_keyboard_resync();
+    send_keyboard_report();
+
+    /* `a` then Shift types "a", as from a macro or a combo */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_LEFT_SHIFT));
+    register_code(KC_A);
+    register_code(KC_LEFT_SHIFT);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(host_keyboard_get_stats().coalesced, 0);
+
+    /* releasing Shift before the next key must reach the host first */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_B));
+    unregister_code(KC_LEFT_SHIFT);
+    register_code(KC_B);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    clear_keyboard();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(HostReportCoalesce, TapDelayIsVisibleToHost) {
+    TestDriver            driver;
+    std::vector<uint16_t> sent_at;
+
+    EXPECT_EMPTY_REPORT(driver);
+    host_keyboard_resync();
+    send_keyboard_report();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2).WillRepeatedly([&](report_keyboard_t &) { sent_at.push_back(timer_read()); });
+    tap_code_delay(KC_A, 10);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    ASSERT_EQ(sent_at.size(), 2);
+    EXPECT_GE(TIMER_DIFF_16(sent_at[1], sent_at[0]), 10);
+}
+
+TEST_F(HostReportCoalesce, KeyPressIsSentAtEndOfScan) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+
+    EXPECT_REPORT(driver, (KC_A));
+    key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
@@ -0,0 +1,101 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "action.h"
+#include "host.h"
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class HostReport : public TestFixture {
+   protected:
+    void SetUp() override {
+        host_keyboard_clear_stats();
+    }
+};
+
+TEST_F(HostReport, IdenticalReportIsSuppressed) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+
+    EXPECT_REPORT(driver, (KC_A)).Times(1);
+    key.press();
+    run_one_scan_loop();
+    send_keyboard_report();
+    send_keyboard_report();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(host_keyboard_get_stats().sent, 1);
+    EXPECT_EQ(host_keyboard_get_stats().suppressed, 2);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(HostReport, RedundantRegisterAndUnregisterAreSuppressed) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_EMPTY_REPORT(driver);
+    register_code(KC_LEFT_SHIFT);
+    register_code(KC_LEFT_SHIFT);
+    unregister_code(KC_B);
+    unregister_code(KC_LEFT_SHIFT);
+    unregister_code(KC_LEFT_SHIFT);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(host_keyboard_get_stats().sent, 2);
+    EXPECT_EQ(host_keyboard_get_stats().suppressed, 3);
+}
+
+TEST_F(HostReport, RepeatedTapsAreAllSent) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_code(KC_A);
+    tap_code(KC_A);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(host_keyboard_get_stats().suppressed, 0);
+}
+
+TEST_F(HostReport, ResyncSendsUnchangedReport) {
+    TestDriver driver;
+
+    EXPECT_EMPTY_REPORT(driver).Times(2);
+    host_keyboard_resync();
+    send_keyboard_report();
+    send_keyboard_report();
+    host_keyboard_resync();
+    send_keyboard_report();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(host_keyboard_get_stats().sent, 2);
+    EXPECT_EQ(host_keyboard_get_stats().suppressed, 1);
+}
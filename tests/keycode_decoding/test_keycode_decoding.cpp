@@ -0,0 +1,281 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "test_common.hpp"
+
+/* Reference copies of the switch-based keycode_config(), mod_config() and
+ * action_for_keycode(). The table-driven versions must match them exactly. */
+
+static uint16_t reference_keycode_config(uint16_t keycode) {
+    switch (keycode) {
+        case KC_CAPS_LOCK:
+        case KC_LOCKING_CAPS_LOCK:
+            if (keymap_config.swap_control_capslock || keymap_config.capslock_to_control) {
+                return KC_LEFT_CTRL;
+            } else if (keymap_config.swap_escape_capslock) {
+                return KC_ESCAPE;
+            }
+            return keycode;
+        case KC_LEFT_CTRL:
+            if (keymap_config.swap_control_capslock) {
+                return KC_CAPS_LOCK;
+            }
+            if (keymap_config.swap_lctl_lgui) {
+                if (keymap_config.no_gui) {
+                    return KC_NO;
+                }
+                return KC_LEFT_GUI;
+            }
+            return KC_LEFT_CTRL;
+        case KC_LEFT_ALT:
+            if (keymap_config.swap_lalt_lgui) {
+                if (keymap_config.no_gui) {
+                    return KC_NO;
+                }
+                return KC_LEFT_GUI;
+            }
+            return KC_LEFT_ALT;
+        case KC_LEFT_GUI:
+            if (keymap_config.swap_lalt_lgui) {
+                return KC_LEFT_ALT;
+            }
+            if (keymap_config.swap_lctl_lgui) {
+                return KC_LEFT_CTRL;
+            }
+            if (keymap_config.no_gui) {
+                return KC_NO;
+            }
+            return KC_LEFT_GUI;
+        case KC_RIGHT_CTRL:
+            if (keymap_config.swap_rctl_rgui) {
+                if (keymap_config.no_gui) {
+                    return KC_NO;
+                }
+                return KC_RIGHT_GUI;
+            }
+            return KC_RIGHT_CTRL;
+        case KC_RIGHT_ALT:
+            if (keymap_config.swap_ralt_rgui) {
+                if (keymap_config.no_gui) {
+                    return KC_NO;
+                }
+                return KC_RIGHT_GUI;
+            }
+            return KC_RIGHT_ALT;
+        case KC_RIGHT_GUI:
+            if (keymap_config.swap_ralt_rgui) {
+                return KC_RIGHT_ALT;
+            }
+            if (keymap_config.swap_rctl_rgui) {
+                return KC_RIGHT_CTRL;
+            }
+            if (keymap_config.no_gui) {
+                return KC_NO;
+            }
+            return KC_RIGHT_GUI;
+        case KC_GRAVE:
+            if (keymap_config.swap_grave_esc) {
+                return KC_ESCAPE;
+            }
+            return KC_GRAVE;
+        case KC_ESCAPE:
+            if (keymap_config.swap_grave_esc) {
+                return KC_GRAVE;
+            } else if (keymap_config.swap_escape_capslock) {
+                return KC_CAPS_LOCK;
+            }
+            return KC_ESCAPE;
+        case KC_BACKSLASH:
+            if (keymap_config.swap_backslash_backspace) {
+                return KC_BACKSPACE;
+            }
+            return KC_BACKSLASH;
+        case KC_BACKSPACE:
+            if (keymap_config.swap_backslash_backspace) {
+                return KC_BACKSLASH;
+            }
+            return KC_BACKSPACE;
+        default:
+            return keycode;
+    }
+}
+
+static uint8_t reference_mod_config(uint8_t mod) {
+    if (keymap_config.swap_lalt_lgui) {
+        if ((mod & MOD_RGUI) == MOD_LGUI) {
+            mod &= ~MOD_LGUI;
+            mod |= MOD_LALT;
+        } else if ((mod & MOD_RALT) == MOD_LALT) {
+            mod &= ~MOD_LALT;
+            mod |= MOD_LGUI;
+        }
+    }
+    if (keymap_config.swap_ralt_rgui) {
+        if ((mod & MOD_RGUI) == MOD_RGUI) {
+            mod &= ~MOD_RGUI;
+            mod |= MOD_RALT;
+        } else if ((mod & MOD_RALT) == MOD_RALT) {
+            mod &= ~MOD_RALT;
+            mod |= MOD_RGUI;
+        }
+    }
+    if (keymap_config.swap_lctl_lgui) {
+        if ((mod & MOD_RGUI) == MOD_LGUI) {
+            mod &= ~MOD_LGUI;
+            mod |= MOD_LCTL;
+        } else if ((mod & MOD_RCTL) == MOD_LCTL) {
+            mod &= ~MOD_LCTL;
+            mod |= MOD_LGUI;
+        }
+    }
+    if (keymap_config.swap_rctl_rgui) {
+        if ((mod & MOD_RGUI) == MOD_RGUI) {
+            mod &= ~MOD_RGUI;
+            mod |= MOD_RCTL;
+        } else if ((mod & MOD_RCTL) == MOD_RCTL) {
+            mod &= ~MOD_RCTL;
+            mod |= MOD_RGUI;
+        }
+    }
+    if (keymap_config.no_gui) {
+        mod &= ~MOD_LGUI;
+        mod &= ~MOD_RGUI;
+    }
+
+    return mod;
+}
+
+static action_t reference_action_for_keycode(uint16_t keycode) {
+    keycode = reference_keycode_config(keycode);
+
+    action_t action = {};
+    uint8_t  action_layer, when, mod;
+
+    switch (keycode) {
+        case KC_A ... KC_EXSEL:
+        case KC_LEFT_CTRL ... KC_RIGHT_GUI:
+            action.code = ACTION_KEY(keycode);
+            break;
+        case KC_SYSTEM_POWER ... KC_SYSTEM_WAKE:
+            action.code = ACTION_USAGE_SYSTEM(KEYCODE2SYSTEM(keycode));
+            break;
+        case KC_AUDIO_MUTE ... KC_BRIGHTNESS_DOWN:
+            action.code = ACTION_USAGE_CONSUMER(KEYCODE2CONSUMER(keycode));
+            break;
+        case KC_MS_UP ... KC_MS_ACCEL2:
+            action.code = ACTION_MOUSEKEY(keycode);
+            break;
+        case KC_TRANSPARENT:
+            action.code = ACTION_TRANSPARENT;
+            break;
+        case QK_MODS ... QK_MODS_MAX:
+            action.code = ACTION_MODS_KEY(keycode >> 8, keycode & 0xFF);
+            break;
+        case QK_LAYER_TAP ... QK_LAYER_TAP_MAX:
+            action.code = ACTION_LAYER_TAP_KEY((keycode >> 0x8) & 0xF, keycode & 0xFF);
+            break;
+        case QK_TO ... QK_TO_MAX:
+            when         = (keycode >> 0x4) & 0x3;
+            action_layer = keycode & 0xF;
+            action.code  = ACTION_LAYER_SET(action_layer, when);
+            break;
+        case QK_MOMENTARY ... QK_MOMENTARY_MAX:
+            action_layer = keycode & 0xFF;
+            action.code  = ACTION_LAYER_MOMENTARY(action_layer);
+            break;
+        case QK_DEF_LAYER ... QK_DEF_LAYER_MAX:
+            action_layer = keycode & 0xFF;
+            action.code  = ACTION_DEFAULT_LAYER_SET(action_layer);
+            break;
+        case QK_TOGGLE_LAYER ... QK_TOGGLE_LAYER_MAX:
+            action_layer = keycode & 0xFF;
+            action.code  = ACTION_LAYER_TOGGLE(action_layer);
+            break;
+        case QK_ONE_SHOT_LAYER ... QK_ONE_SHOT_LAYER_MAX:
+            action_layer = keycode & 0xFF;
+            action.code  = ACTION_LAYER_ONESHOT(action_layer);
+            break;
+        case QK_ONE_SHOT_MOD ... QK_ONE_SHOT_MOD_MAX:
+            mod         = reference_mod_config(keycode & 0xFF);
+            action.code = ACTION_MODS_ONESHOT(mod);
+            break;
+        case QK_LAYER_TAP_TOGGLE ... QK_LAYER_TAP_TOGGLE_MAX:
+            action.code = ACTION_LAYER_TAP_TOGGLE(keycode & 0xFF);
+            break;
+        case QK_LAYER_MOD ... QK_LAYER_MOD_MAX:
+            mod          = reference_mod_config(keycode & 0xF);
+            action_layer = (keycode >> 4) & 0xF;
+            action.code  = ACTION_LAYER_MODS(action_layer, mod);
+            break;
+        case QK_MOD_TAP ... QK_MOD_TAP_MAX:
+            mod         = reference_mod_config((keycode >> 0x8) & 0x1F);
+            action.code = ACTION_MODS_TAP_KEY(mod, keycode & 0xFF);
+            break;
+        default:
+            action.code = ACTION_NO;
+            break;
+    }
+    return action;
+}
+
+class KeycodeDecoding : public testing::Test {
+   protected:
+    void TearDown() override {
+        keymap_config.raw = 0;
+    }
+};
+
+// Every flag that changes keycode or mod remapping
+static const uint16_t remap_flags = ((keymap_config_t){.swap_control_capslock = true, .capslock_to_control = true, .swap_lalt_lgui = true, .swap_ralt_rgui = true, .no_gui = true, .swap_grave_esc = true, .swap_backslash_backspace = true, .swap_lctl_lgui = true, .swap_rctl_rgui = true, .swap_escape_capslock = true}).raw;
+
+TEST_F(KeycodeDecoding, RemapMatchesReferenceForAllConfigs) {
+    /* Walk every subset of the remapping flags */
+    uint16_t raw = 0;
+    do {
+        keymap_config.raw = raw;
+        for (uint32_t keycode = 0; keycode <= 0xFF; keycode++) {
+            ASSERT_EQ(keycode_config(keycode), reference_keycode_config(keycode)) << "keycode " << keycode << " config " << raw;
+        }
+        for (uint32_t mod = 0; mod <= 0xFF; mod++) {
+            ASSERT_EQ(mod_config(mod), reference_mod_config(mod)) << "mod " << mod << " config " << raw;
+        }
+        raw = (raw - remap_flags) & remap_flags;
+    } while (raw != 0);
+}
+
+TEST_F(KeycodeDecoding, ActionMatchesReferenceForAllKeycodes) {
+    uint16_t raw = 0;
+    do {
+        keymap_config.raw = raw;
+        for (uint32_t keycode = 0; keycode <= 0xFFFF; keycode++) {
+            ASSERT_EQ(action_for_keycode(keycode).code, reference_action_for_keycode(keycode).code) << "keycode " << keycode << " config " << raw;
+        }
+        raw = (raw - remap_flags) & remap_flags;
+    } while (raw != 0);
+}
+
+TEST_F(KeycodeDecoding, RemapFollowsConfigChanges) {
+    EXPECT_EQ(keycode_config(KC_ESCAPE), KC_ESCAPE);
+
+    keymap_config.swap_grave_esc = true;
+    EXPECT_EQ(keycode_config(KC_ESCAPE), KC_GRAVE);
+    EXPECT_EQ(action_for_keycode(KC_GRAVE).code, ACTION_KEY(KC_ESCAPE));
+
+    keymap_config.swap_grave_esc = false;
+    EXPECT_EQ(keycode_config(KC_ESCAPE), KC_ESCAPE);
+    EXPECT_EQ(action_for_keycode(KC_GRAVE).code, ACTION_KEY(KC_GRAVE));
+}
@@ -0,0 +1,151 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+#include "test_replay.hpp"
+
+class TraceReplayTest : public TestFixture {
+   protected:
+    void SetUp() override {
+        // clang-format off
+        set_keymap({
+            KeymapKey(0, 0, 0, KC_Q), KeymapKey(0, 1, 0, KC_W), KeymapKey(0, 2, 0, KC_E), KeymapKey(0, 3, 0, KC_R), KeymapKey(0, 4, 0, KC_T),
+            KeymapKey(0, 5, 0, KC_Y), KeymapKey(0, 6, 0, KC_U), KeymapKey(0, 7, 0, KC_I), KeymapKey(0, 8, 0, KC_O), KeymapKey(0, 9, 0, KC_P),
+            KeymapKey(0, 0, 1, LGUI_T(KC_A)), KeymapKey(0, 1, 1, LALT_T(KC_S)), KeymapKey(0, 2, 1, LCTL_T(KC_D)), KeymapKey(0, 3, 1, LSFT_T(KC_F)), KeymapKey(0, 4, 1, KC_G),
+            KeymapKey(0, 5, 1, KC_H), KeymapKey(0, 6, 1, RSFT_T(KC_J)), KeymapKey(0, 7, 1, RCTL_T(KC_K)), KeymapKey(0, 8, 1, RALT_T(KC_L)), KeymapKey(0, 9, 1, RGUI_T(KC_SCLN)),
+            KeymapKey(0, 0, 2, KC_Z), KeymapKey(0, 1, 2, KC_X), KeymapKey(0, 2, 2, KC_C), KeymapKey(0, 3, 2, KC_V), KeymapKey(0, 4, 2, KC_B),
+            KeymapKey(0, 5, 2, KC_N), KeymapKey(0, 6, 2, KC_M), KeymapKey(0, 7, 2, KC_COMM), KeymapKey(0, 8, 2, KC_DOT), KeymapKey(0, 9, 2, KC_SLSH),
+            KeymapKey(0, 0, 3, KC_ESC), KeymapKey(0, 1, 3, KC_TAB), KeymapKey(0, 2, 3, KC_LSFT), KeymapKey(0, 3, 3, KC_SPC), KeymapKey(0, 4, 3, KC_BSPC),
+            KeymapKey(0, 5, 3, KC_ENT), KeymapKey(0, 6, 3, KC_SPC), KeymapKey(0, 7, 3, KC_RSFT), KeymapKey(0, 8, 3, KC_DEL), KeymapKey(0, 9, 3, KC_GRV),
+        });
+        // clang-format on
+    }
+};
+
+// "hej" with the j rolled into the e, then a held home row shift on f for "H"
+static const char *sample_trace = R"(
+# time row col p|r
+0    1 5 p
+40   1 5 r
+60   0 2 p
+90   1 6 p
+110  0 2 r
+130  1 6 r
+400  1 3 p
+650  1 5 p
+700  1 5 r
+720  1 3 r
+)";
+
+TEST_F(TraceReplayTest, ParsesTrace) {
+    std::istringstream      input(sample_trace);
+    std::vector<TraceEvent> trace;
+    std::string             error;
+
+    ASSERT_TRUE(TraceReplay::parse(input, trace, error)) << error;
+    ASSERT_EQ(trace.size(), 10);
+    EXPECT_EQ(trace[2].time, 60);
+    EXPECT_EQ(trace[2].key.row, 0);
+    EXPECT_EQ(trace[2].key.col, 2);
+    EXPECT_TRUE(trace[2].pressed);
+    EXPECT_FALSE(trace[9].pressed);
+
+    std::istringstream bad("10 9 0 p\n");
+    EXPECT_FALSE(TraceReplay::parse(bad, trace, error));
+    EXPECT_EQ(error, "trace line 1: expected '<time> <row> <col> <p|r>' within the matrix");
+    std::istringstream backwards("10 0 0 p\n5 0 0 r\n");
+    EXPECT_FALSE(TraceReplay::parse(backwards, trace, error));
+    EXPECT_EQ(error, "trace line 2: timestamps must not go backwards");
+}
+
+TEST_F(TraceReplayTest, CapturesReportsWithTraceTime) {
+    TestDriver              driver;
+    TraceReplay             replay;
+    std::istringstream      input(sample_trace);
+    std::vector<TraceEvent> trace;
+    std::string             error;
+
+    ASSERT_TRUE(TraceReplay::parse(input, trace, error)) << error;
+    auto stats = replay.run(driver, trace);
+
+    std::ostringstream output;
+    replay.write_reports(output);
+    EXPECT_EQ(output.str(),
+              "0 Keyboard Report: Mods (0) Keys (11)\n"
+              "40 Keyboard Report: Mods (0) Keys ()\n"
+              "60 Keyboard Report: Mods (0) Keys (8)\n"
+              "110 Keyboard Report: Mods (0) Keys ()\n"
+              "130 Keyboard Report: Mods (0) Keys (13)\n"
+              "130 Keyboard Report: Mods (0) Keys ()\n"
+              "600 Keyboard Report: Mods (2) Keys ()\n"
+              "650 Keyboard Report: Mods (2) Keys (11)\n"
+              "700 Keyboard Report: Mods (2) Keys ()\n"
+              "720 Keyboard Report: Mods (0) Keys ()\n");
+
+    EXPECT_EQ(stats.events, 10);
+    EXPECT_EQ(stats.reports, 10);
+    EXPECT_DOUBLE_EQ(stats.report_amplification(), 1.0);
+    EXPECT_GT(stats.scans, 720);
+}
+
+TEST_F(TraceReplayTest, ReplayIsDeterministic) {
+    TestDriver  driver;
+    TraceReplay first, second;
+
+    std::istringstream      input(sample_trace);
+    std::vector<TraceEvent> trace;
+    std::string             error;
+    ASSERT_TRUE(TraceReplay::parse(input, trace, error)) << error;
+    first.run(driver, trace);
+    second.run(driver, trace);
+
+    std::ostringstream first_output, second_output;
+    first.write_reports(first_output);
+    second.write_reports(second_output);
+    EXPECT_EQ(first_output.str(), second_output.str());
+}
+
+/* Replays an external trace against this keymap:
+ *
+ *     QMK_REPLAY_TRACE=typing.trace QMK_REPLAY_OUTPUT=reports.txt .build/test/replay.elf
+ *
+ * Diff the report files from two builds to spot behaviour changes; the stats
+ * go to stdout. */
+TEST_F(TraceReplayTest, ReplayFromEnvironment) {
+    const char *trace_path = std::getenv("QMK_REPLAY_TRACE");
+    if (!trace_path) {
+        GTEST_SKIP() << "QMK_REPLAY_TRACE not set";
+    }
+
+    TestDriver              driver;
+    TraceReplay             replay;
+    std::vector<TraceEvent> trace;
+    std::string             error;
+    ASSERT_TRUE(TraceReplay::load(trace_path, trace, error)) << error;
+    replay.run(driver, trace);
+    replay.write_stats(std::cout);
+
+    if (const char *output_path = std::getenv("QMK_REPLAY_OUTPUT")) {
+        std::ofstream output(output_path);
+        replay.write_reports(output);
+    }
+}
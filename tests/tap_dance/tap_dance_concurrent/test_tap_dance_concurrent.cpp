@@ -0,0 +1,108 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_keymap_key.hpp"
+#include "../examples.h"
+
+using testing::_;
+using testing::InSequence;
+
+class TapDanceConcurrent : public TestFixture {};
+
+TEST_F(TapDanceConcurrent, DancesTimeOutIndependently) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_esc_caps = KeymapKey{0, 1, 0, TD(TD_ESC_CAPS)};
+    auto       key_quad     = KeymapKey{0, 2, 0, TD(X_CTL)};
+
+    set_keymap({key_esc_caps, key_quad});
+
+    uint16_t deadline;
+    EXPECT_FALSE(tap_dance_get_next_deadline(&deadline));
+
+    /* Starting a second dance doesn't settle the first one */
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_esc_caps);
+    idle_for(50);
+    tap_key(key_quad);
+    EXPECT_TRUE(tap_dance_get_next_deadline(&deadline));
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* The first dance times out on its own */
+    EXPECT_REPORT(driver, (KC_ESC));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(TAPPING_TERM - 50);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Followed by the second one */
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(60);
+    EXPECT_FALSE(tap_dance_get_next_deadline(&deadline));
+}
+
+TEST_F(TapDanceConcurrent, DoubleTapAcrossOtherDance) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_esc_caps = KeymapKey{0, 1, 0, TD(TD_ESC_CAPS)};
+    auto       key_quad     = KeymapKey{0, 2, 0, TD(X_CTL)};
+
+    set_keymap({key_esc_caps, key_quad});
+
+    tap_key(key_esc_caps);
+    tap_key(key_quad);
+
+    /* The second tap still counts towards the first dance */
+    key_esc_caps.press();
+    EXPECT_REPORT(driver, (KC_CAPS));
+    run_one_scan_loop();
+    key_esc_caps.release();
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(TAPPING_TERM);
+}
+
+TEST_F(TapDanceConcurrent, RegularKeyInterruptsAllDances) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_esc_caps = KeymapKey{0, 1, 0, TD(TD_ESC_CAPS)};
+    auto       key_quad     = KeymapKey{0, 2, 0, TD(X_CTL)};
+    auto       regular_key  = KeymapKey(0, 3, 0, KC_A);
+
+    set_keymap({key_esc_caps, key_quad, regular_key});
+
+    tap_key(key_esc_caps);
+    tap_key(key_quad);
+
+    /* Pending dances are settled in the order they started */
+    regular_key.press();
+    EXPECT_REPORT(driver, (KC_ESC));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_A));
+    run_one_scan_loop();
+    regular_key.release();
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+}
@@ -316,3 +316,25 @@ TEST_F(TapDance, QuadFunction) {
     EXPECT_EMPTY_REPORT(driver);
     run_one_scan_loop();
 }
+
+TEST_F(TapDance, TapDanceInterruptsOtherTapDance) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_esc_caps = KeymapKey{0, 1, 0, TD(TD_ESC_CAPS)};
+    auto       key_quad     = KeymapKey{0, 2, 0, TD(X_CTL)};
+
+    set_keymap({key_esc_caps, key_quad});
+
+    /* Starting another dance settles the first one right away */
+    tap_key(key_esc_caps);
+    key_quad.press();
+    EXPECT_REPORT(driver, (KC_ESC));
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    key_quad.release();
+    run_one_scan_loop();
+
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(TAPPING_TERM);
+}
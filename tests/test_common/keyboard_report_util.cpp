@@ -63,6 +63,7 @@ std::ostream& operator<<(std::ostream& stream, const report_keyboard_t& report)
 
 KeyboardReportMatcher::KeyboardReportMatcher(const std::vector<uint8_t>& keys) {
     memset(m_report.raw, 0, sizeof(m_report.raw));
+    clear_keys_from_report(&m_report);
     for (auto k : keys) {
         if (IS_MOD(k)) {
             m_report.mods |= MOD_BIT(k);
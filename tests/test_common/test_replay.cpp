@@ -0,0 +1,139 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_replay.hpp"
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include "gmock/gmock.h"
+#include "keyboard_report_util.hpp"
+#include "test_matrix.h"
+
+extern "C" {
+#include "timer.h"
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+
+double ReplayStats::events_per_second() const {
+    return wall_ns ? events * 1e9 / wall_ns : 0;
+}
+
+double ReplayStats::ns_per_event() const {
+    return events ? (double)wall_ns / events : 0;
+}
+
+double ReplayStats::report_amplification() const {
+    return events ? (double)reports / events : 0;
+}
+
+bool TraceReplay::parse(std::istream& input, std::vector<TraceEvent>& trace, std::string& error) {
+    std::string line;
+    unsigned    line_number = 0;
+
+    trace.clear();
+
+    while (std::getline(input, line)) {
+        line_number++;
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream fields(line);
+        uint32_t           time;
+        unsigned           row, col;
+        char               action;
+        if (!(fields >> time)) {
+            continue; // blank or comment line
+        }
+        if (!(fields >> row >> col >> action) || (action != 'p' && action != 'r') || row >= MATRIX_ROWS || col >= MATRIX_COLS) {
+            error = "trace line " + std::to_string(line_number) + ": expected '<time> <row> <col> <p|r>' within the matrix";
+            return false;
+        }
+        if (!trace.empty() && time < trace.back().time) {
+            error = "trace line " + std::to_string(line_number) + ": timestamps must not go backwards";
+            return false;
+        }
+        trace.push_back({time, {.col = (uint8_t)col, .row = (uint8_t)row}, action == 'p'});
+    }
+    return true;
+}
+
+bool TraceReplay::load(const std::string& path, std::vector<TraceEvent>& trace, std::string& error) {
+    std::ifstream input(path);
+    if (!input) {
+        error = "cannot open trace " + path;
+        return false;
+    }
+    return parse(input, trace, error);
+}
+
+ReplayStats TraceReplay::run(TestDriver& driver, const std::vector<TraceEvent>& trace, unsigned settle_ms) {
+    using clock = std::chrono::steady_clock;
+
+    m_reports.clear();
+    m_stats = ReplayStats();
+
+    /* Key events stamp their time as `timer_read() | 1`, so an odd start would
+     * shift every tapping decision by a millisecond compared to an even one. */
+    if (timer_read32() & 1) {
+        advance_time(1);
+    }
+    const uint32_t start = timer_read32();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly([this, start](report_keyboard_t& report) { m_reports.push_back({timer_read32() - start, report}); });
+
+    const uint32_t end  = (trace.empty() ? 0 : trace.back().time) + settle_ms;
+    auto           next = trace.cbegin();
+    for (uint32_t now = 0; now <= end; now++) {
+        size_t injected = 0;
+        for (; next != trace.cend() && next->time <= now; next++, injected++) {
+            if (next->pressed) {
+                press_key(next->key.col, next->key.row);
+            } else {
+                release_key(next->key.col, next->key.row);
+            }
+        }
+
+        const auto scan_start = clock::now();
+        keyboard_task();
+        const uint64_t scan_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - scan_start).count();
+
+        m_stats.scans++;
+        m_stats.wall_ns += scan_ns;
+        if (injected) {
+            m_stats.events += injected;
+            m_stats.max_event_scan_ns = std::max(m_stats.max_event_scan_ns, scan_ns);
+        }
+        advance_time(1);
+    }
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    m_stats.reports = m_reports.size();
+    return m_stats;
+}
+
+void TraceReplay::write_reports(std::ostream& output) const {
+    for (auto& entry : m_reports) {
+        output << entry.time << " " << entry.report;
+    }
+}
+
+void TraceReplay::write_stats(std::ostream& output) const {
+    output << "events: " << m_stats.events << "\n";
+    output << "scans: " << m_stats.scans << "\n";
+    output << "reports: " << m_stats.reports << " (" << m_stats.report_amplification() << " per event)\n";
+    output << "events/sec: " << m_stats.events_per_second() << "\n";
+    output << "ns/event: " << m_stats.ns_per_event() << " (slowest event scan " << m_stats.max_event_scan_ns << " ns)\n";
+}
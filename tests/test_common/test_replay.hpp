@@ -0,0 +1,98 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "keyboard.h"
+#include "report.h"
+#include "test_driver.hpp"
+
+/**
+ * @brief One matrix transition from a recorded typing trace.
+ */
+struct TraceEvent {
+    uint32_t time; // ms since the start of the trace
+    keypos_t key;
+    bool     pressed;
+};
+
+/**
+ * @brief A keyboard report emitted while replaying, stamped with trace time.
+ */
+struct ReplayReport {
+    uint32_t          time;
+    report_keyboard_t report;
+};
+
+struct ReplayStats {
+    size_t   events            = 0;
+    size_t   reports           = 0;
+    size_t   scans             = 0;
+    uint64_t wall_ns           = 0; // host time spent inside keyboard_task()
+    uint64_t max_event_scan_ns = 0; // slowest scan that had matrix events
+
+    double events_per_second() const;
+    double ns_per_event() const;
+    /* Reports sent per matrix event; 1.0 means one report per transition. */
+    double report_amplification() const;
+};
+
+/**
+ * @brief Replays a recorded trace through keyboard_task() on the virtual timer.
+ *
+ * Each millisecond of trace time is one scan loop, so a trace runs exactly as it
+ * did when it was recorded, only as fast as the host allows. The reports that
+ * come out are kept with their trace timestamps so two builds can be diffed.
+ *
+ * Trace format, one transition per line, `#` starts a comment:
+ *
+ *     <time ms> <row> <col> <p|r>
+ */
+class TraceReplay {
+   public:
+    /**
+     * @brief Parses a trace into `trace`. On a malformed line returns false and
+     * describes the problem in `error`; the test build has no exceptions.
+     */
+    static bool parse(std::istream& input, std::vector<TraceEvent>& trace, std::string& error);
+    static bool load(const std::string& path, std::vector<TraceEvent>& trace, std::string& error);
+
+    /**
+     * @brief Runs `trace`, then keeps scanning for `settle_ms` so pending tap
+     * decisions resolve. Every keyboard report sent to `driver` is captured.
+     */
+    ReplayStats run(TestDriver& driver, const std::vector<TraceEvent>& trace, unsigned settle_ms = 1000);
+
+    const std::vector<ReplayReport>& reports() const {
+        return m_reports;
+    }
+    const ReplayStats& stats() const {
+        return m_stats;
+    }
+
+    /* Deterministic: only depends on the firmware's behaviour, not host speed. */
+    void write_reports(std::ostream& output) const;
+    void write_stats(std::ostream& output) const;
+
+   private:
+    std::vector<ReplayReport> m_reports;
+    ReplayStats               m_stats;
+};
@@ -157,6 +157,10 @@ int8_t sendchar(uint8_t c) {
 }
 
 void main_subtask_console_flush(void) {
+#    ifdef TOKENIZED_LOGGING_ENABLE
+    tokenized_log_task();
+#    endif
+
     while (udi_hid_con_b_report_trans_ongoing) {
     } // Wait for any previous transfers to complete
 
@@ -262,8 +266,14 @@ void main_subtask_usb_extra_device(void) {
 }
 
 #ifdef RAW_ENABLE
+__attribute__((weak)) void raw_hid_poll(void) {
+    // Users can implement this to push packets to the host
+    // without waiting for a request from it.
+}
+
 void main_subtask_raw(void) {
     udi_hid_raw_receive_report();
+    raw_hid_poll();
 }
 #endif
 
@@ -3,12 +3,18 @@ CHIBIOS_DIR = $(PROTOCOL_DIR)/chibios
 
 
 SRC += $(CHIBIOS_DIR)/usb_main.c
+SRC += $(CHIBIOS_DIR)/usb_report_queue.c
+SRC += $(CHIBIOS_DIR)/usb_sof_sync.c
 SRC += $(CHIBIOS_DIR)/chibios.c
 SRC += usb_descriptor.c
 SRC += $(CHIBIOS_DIR)/usb_driver.c
 SRC += $(CHIBIOS_DIR)/usb_util.c
 SRC += $(LIBSRC)
 
+ifeq ($(strip $(CONSOLE_ENABLE)), yes)
+    SRC += $(PROTOCOL_DIR)/console_tx.c
+endif
+
 VPATH += $(TMK_PATH)/$(PROTOCOL_DIR)
 VPATH += $(TMK_PATH)/$(CHIBIOS_DIR)
 VPATH += $(TMK_PATH)/$(CHIBIOS_DIR)/lufa_utils
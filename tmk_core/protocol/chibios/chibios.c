@@ -80,6 +80,9 @@ void console_task(void);
 #ifdef MIDI_ENABLE
 void midi_ep_task(void);
 #endif
+#ifdef JOYSTICK_ENABLE
+void joystick_ep_task(void);
+#endif
 
 /* TESTING
  * Amber LED blinker thread, times are in milliseconds.
@@ -197,15 +200,23 @@ void protocol_pre_task(void) {
         }
         /* Woken up */
         // variables has been already cleared by the wakeup hook
+        host_keyboard_resync();
         send_keyboard_report();
 #    ifdef MOUSEKEY_ENABLE
         mousekey_send();
 #    endif /* MOUSEKEY_ENABLE */
     }
 #endif
+
+#ifdef USB_SOF_STATS_ENABLE
+    usb_sof_scan_start();
+#endif
 }
 
 void protocol_post_task(void) {
+#ifdef USB_SOF_STATS_ENABLE
+    usb_sof_scan_end();
+#endif
 #ifdef CONSOLE_ENABLE
     console_task();
 #endif
@@ -218,4 +229,7 @@ void protocol_post_task(void) {
 #ifdef RAW_ENABLE
     raw_hid_task();
 #endif
+#ifdef JOYSTICK_ENABLE
+    joystick_ep_task();
+#endif
 }
@@ -43,6 +43,7 @@
 #include "usb_device_state.h"
 #include "usb_descriptor.h"
 #include "usb_driver.h"
+#include "usb_report_queue.h"
 
 #ifdef NKRO_ENABLE
 #    include "keycode_config.h"
@@ -54,6 +55,14 @@ extern keymap_config_t keymap_config;
 #    include "joystick.h"
 #endif
 
+#ifdef CONSOLE_ENABLE
+#    include "console_tx.h"
+#endif
+
+#ifdef TOKENIZED_LOGGING_ENABLE
+#    include "tokenized_log.h"
+#endif
+
 /* ---------------------------------------------------------
  *       Global interface variables and declarations
  * ---------------------------------------------------------
@@ -73,6 +82,24 @@ uint8_t                keyboard_led_state                            = 0;
 volatile uint16_t      keyboard_idle_count                           = 0;
 static virtual_timer_t keyboard_idle_timer;
 
+#ifdef USB_SOF_STATS_ENABLE
+/* Most boards tick the system timer every 100 us or 1 ms, far too coarse
+ * within a 1 ms frame, so time with the realtime counter wait_us() uses:
+ * the DWT cycle counter on Cortex-M3 and up. */
+#    if PORT_SUPPORTS_RT == TRUE
+typedef rtcnt_t sof_clock_t;
+#        define sof_clock_now() chSysGetRealtimeCounterX()
+#    elif CH_CFG_ST_FREQUENCY >= 100000
+typedef systime_t sof_clock_t;
+#        define sof_clock_now() chVTGetSystemTimeX()
+#    else
+#        error "USB_SOF_STATS_ENABLE needs a realtime counter or a system tick of 10 us or less (CH_CFG_ST_FREQUENCY 100000)"
+#    endif
+static volatile sof_clock_t sof_time;
+static volatile uint16_t    sof_count;
+static sof_clock_t          scan_start_time;
+#endif
+
 #if CH_KERNEL_MAJOR >= 7
 static void keyboard_idle_timer_cb(struct ch_virtual_timer *, void *arg);
 #elif CH_KERNEL_MAJOR <= 6
@@ -87,6 +114,172 @@ report_mouse_t mouse_report_blank = {0};
 uint8_t extra_report_blank[3] = {0};
 #endif /* EXTRAKEY_ENABLE */
 
+/* ---------------------------------------------------------
+ *                     Report queues
+ * ---------------------------------------------------------
+ */
+
+/* Senders queue their report and return, the IN callbacks start the next
+ * transfer. Every report ID has its own queue, and the queues on a shared
+ * endpoint take turns. */
+enum report_queue_index {
+    REPORT_QUEUE_KEYBOARD,
+#ifdef NKRO_ENABLE
+    REPORT_QUEUE_NKRO,
+#endif
+#ifdef MOUSE_ENABLE
+    REPORT_QUEUE_MOUSE,
+#endif
+#ifdef EXTRAKEY_ENABLE
+    REPORT_QUEUE_SYSTEM,
+    REPORT_QUEUE_CONSUMER,
+#endif
+#ifdef PROGRAMMABLE_BUTTON_ENABLE
+    REPORT_QUEUE_PROGRAMMABLE_BUTTON,
+#endif
+#if defined(DIGITIZER_ENABLE) && defined(DIGITIZER_SHARED_EP)
+    REPORT_QUEUE_DIGITIZER,
+#endif
+#ifdef JOYSTICK_ENABLE
+    REPORT_QUEUE_JOYSTICK,
+#endif
+    REPORT_QUEUE_COUNT
+};
+
+_Static_assert(REPORT_QUEUE_COUNT <= 16, "usb_report_queue_arbitrate() takes a 16 bit member mask");
+
+static usb_report_queue_t report_queues[REPORT_QUEUE_COUNT];
+
+static const usbep_t report_queue_eps[REPORT_QUEUE_COUNT] = {
+    [REPORT_QUEUE_KEYBOARD] = KEYBOARD_IN_EPNUM,
+#ifdef NKRO_ENABLE
+    [REPORT_QUEUE_NKRO] = SHARED_IN_EPNUM,
+#endif
+#ifdef MOUSE_ENABLE
+    [REPORT_QUEUE_MOUSE] = MOUSE_IN_EPNUM,
+#endif
+#ifdef EXTRAKEY_ENABLE
+    [REPORT_QUEUE_SYSTEM]   = SHARED_IN_EPNUM,
+    [REPORT_QUEUE_CONSUMER] = SHARED_IN_EPNUM,
+#endif
+#ifdef PROGRAMMABLE_BUTTON_ENABLE
+    [REPORT_QUEUE_PROGRAMMABLE_BUTTON] = SHARED_IN_EPNUM,
+#endif
+#if defined(DIGITIZER_ENABLE) && defined(DIGITIZER_SHARED_EP)
+    [REPORT_QUEUE_DIGITIZER] = DIGITIZER_IN_EPNUM,
+#endif
+#ifdef JOYSTICK_ENABLE
+    [REPORT_QUEUE_JOYSTICK] = JOYSTICK_IN_EPNUM,
+#endif
+};
+
+/* Queue served last on each endpoint, where the round robin resumes. */
+static uint8_t report_queue_last[USB_MAX_ENDPOINTS + 1];
+
+static void report_queues_init(void) {
+    static uint8_t keyboard_slots[USB_REPORT_QUEUE_SLOTS(report_keyboard_t)] __attribute__((aligned(4)));
+    usb_report_queue_init(&report_queues[REPORT_QUEUE_KEYBOARD], keyboard_slots, sizeof(report_keyboard_t), usb_report_merge_keyboard);
+#ifdef NKRO_ENABLE
+    static uint8_t nkro_slots[USB_REPORT_QUEUE_SLOTS(struct nkro_report)] __attribute__((aligned(4)));
+    usb_report_queue_init(&report_queues[REPORT_QUEUE_NKRO], nkro_slots, sizeof(struct nkro_report), usb_report_merge_nkro);
+#endif
+#ifdef MOUSE_ENABLE
+    static uint8_t mouse_slots[USB_REPORT_QUEUE_SLOTS(report_mouse_t)] __attribute__((aligned(4)));
+    usb_report_queue_init(&report_queues[REPORT_QUEUE_MOUSE], mouse_slots, sizeof(report_mouse_t), usb_report_merge_mouse);
+#endif
+#ifdef EXTRAKEY_ENABLE
+    /* a usage can't be merged, every change is sent */
+    static uint8_t system_slots[USB_REPORT_QUEUE_SLOTS(report_extra_t)] __attribute__((aligned(4)));
+    usb_report_queue_init(&report_queues[REPORT_QUEUE_SYSTEM], system_slots, sizeof(report_extra_t), NULL);
+    static uint8_t consumer_slots[USB_REPORT_QUEUE_SLOTS(report_extra_t)] __attribute__((aligned(4)));
+    usb_report_queue_init(&report_queues[REPORT_QUEUE_CONSUMER], consumer_slots, sizeof(report_extra_t), NULL);
+#endif
+#ifdef PROGRAMMABLE_BUTTON_ENABLE
+    static uint8_t programmable_button_slots[USB_REPORT_QUEUE_SLOTS(report_programmable_button_t)] __attribute__((aligned(4)));
+    usb_report_queue_init(&report_queues[REPORT_QUEUE_PROGRAMMABLE_BUTTON], programmable_button_slots, sizeof(report_programmable_button_t), usb_report_merge_bitmap);
+#endif
+#if defined(DIGITIZER_ENABLE) && defined(DIGITIZER_SHARED_EP)
+    static uint8_t digitizer_slots[USB_REPORT_QUEUE_SLOTS(report_digitizer_t)] __attribute__((aligned(4)));
+    usb_report_queue_init(&report_queues[REPORT_QUEUE_DIGITIZER], digitizer_slots, sizeof(report_digitizer_t), NULL);
+#endif
+#ifdef JOYSTICK_ENABLE
+    static uint8_t joystick_slots[USB_REPORT_QUEUE_SLOTS(joystick_report_t)] __attribute__((aligned(4)));
+    usb_report_queue_init(&report_queues[REPORT_QUEUE_JOYSTICK], joystick_slots, sizeof(joystick_report_t), NULL);
+#endif
+}
+
+/* Transfers in flight are aborted on reset and suspend without an IN callback.
+ * Called with the system locked. */
+static void report_queues_clear_I(void) {
+    for (uint8_t i = 0; i < REPORT_QUEUE_COUNT; i++) {
+        usb_report_queue_clear(&report_queues[i]);
+    }
+}
+
+/* Starts the next queued report for `ep` unless the endpoint is busy. An idle
+ * endpoint has nothing in flight, so whatever was is retired first; that also
+ * covers the joystick endpoint, whose IN callback belongs to its serial driver.
+ * Called with the system locked. */
+static void report_queues_flush_I(USBDriver *usbp, usbep_t ep) {
+    uint16_t members = 0;
+
+    if (usbGetDriverStateI(usbp) != USB_ACTIVE || usbGetTransmitStatusI(usbp, ep)) {
+        return;
+    }
+    for (uint8_t i = 0; i < REPORT_QUEUE_COUNT; i++) {
+        if (report_queue_eps[i] == ep) {
+            usb_report_queue_complete(&report_queues[i]);
+            members |= 1U << i;
+        }
+    }
+
+    int8_t i = usb_report_queue_arbitrate(report_queues, REPORT_QUEUE_COUNT, members, &report_queue_last[ep]);
+    if (i < 0) {
+        return;
+    }
+    /* the slot itself is transmitted, it stays put until the IN callback */
+    uint8_t *report = usb_report_queue_start(&report_queues[i]);
+    size_t   size   = report_queues[i].size;
+    if (i == REPORT_QUEUE_KEYBOARD) {
+        if (keyboard_protocol) {
+            size = KEYBOARD_REPORT_SIZE;
+        } else { /* boot protocol */
+            report = &((report_keyboard_t *)report)->mods;
+            size   = 8;
+        }
+    }
+    usbStartTransmitI(usbp, ep, report, size);
+}
+
+/* Queues a report and starts it right away if `ep` is idle. Only blocks if
+ * the queue is full, until the report in flight on `ep` has made it through,
+ * so no state change is lost.
+ * not callable from ISR or locked state */
+static void report_queues_send(enum report_queue_index index, const void *report) {
+    usbep_t ep = report_queue_eps[index];
+
+    osalSysLock();
+    while (usbGetDriverStateI(&USB_DRIVER) == USB_ACTIVE && !usb_report_queue_push(&report_queues[index], report)) {
+        /* an idle endpoint frees a slot right away, e.g. the joystick one */
+        report_queues_flush_I(&USB_DRIVER, ep);
+        if (usbGetTransmitStatusI(&USB_DRIVER, ep)) {
+            /* Woken once the IN callback has retired the report in flight.
+             * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
+            osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[ep]->in_state->thread, TIME_MS2I(10));
+        }
+    }
+    report_queues_flush_I(&USB_DRIVER, ep);
+    osalSysUnlock();
+}
+
+/* IN callback: retires the report in flight on `ep` and starts the next one.
+ * Called from ISR, unlocked state. */
+static void report_queues_in_cb(USBDriver *usbp, usbep_t ep) {
+    osalSysLockFromISR();
+    report_queues_flush_I(usbp, ep);
+    osalSysUnlockFromISR();
+}
+
 /* ---------------------------------------------------------
  *            Descriptors and USB driver objects
  * ---------------------------------------------------------
@@ -511,6 +704,9 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
             /* Falls into.*/
         case USB_EVENT_RESET:
             usb_event_queue_enqueue(event);
+            osalSysLockFromISR();
+            report_queues_clear_I();
+            osalSysUnlockFromISR();
             for (int i = 0; i < NUM_USB_DRIVERS; i++) {
                 chSysLockFromISR();
                 /* Disconnection event on suspend.*/
@@ -737,6 +933,11 @@ void init_usb_driver(USBDriver *usbp) {
      * Note, a delay is inserted in order to not have to disconnect the cable
      * after a reset.
      */
+    report_queues_init();
+#ifdef USB_SOF_STATS_ENABLE
+    usb_sof_sync_init();
+#endif
+
     usbDisconnectBus(usbp);
     wait_ms(50);
     usbStart(usbp, &usbcfg);
@@ -770,9 +971,7 @@ __attribute__((weak)) void restart_usb_driver(USBDriver *usbp) {
 /* keyboard IN callback hander (a kbd report has made it IN) */
 #ifndef KEYBOARD_SHARED_EP
 void kbd_in_cb(USBDriver *usbp, usbep_t ep) {
-    /* STUB */
-    (void)usbp;
-    (void)ep;
+    report_queues_in_cb(usbp, ep);
 }
 #endif
 
@@ -781,8 +980,49 @@ void kbd_in_cb(USBDriver *usbp, usbep_t ep) {
  *  so that this is not going to have to be checked every 1ms */
 void kbd_sof_cb(USBDriver *usbp) {
     (void)usbp;
+#ifdef USB_SOF_STATS_ENABLE
+    sof_time = sof_clock_now();
+    sof_count++;
+#endif
+}
+
+#ifdef USB_SOF_STATS_ENABLE
+static uint16_t us_since(sof_clock_t start) {
+#    if PORT_SUPPORTS_RT == TRUE
+    uint32_t us = (rtcnt_t)(sof_clock_now() - start) / (REALTIME_COUNTER_CLOCK / 1000000U);
+#    else
+    time_conv_t us = TIME_I2US(chTimeDiffX(start, sof_clock_now()));
+#    endif
+
+    return us > UINT16_MAX ? UINT16_MAX : us;
+}
+
+/* called by the main loop right before the matrix scan */
+void usb_sof_scan_start(void) {
+#    ifdef USB_SOF_ALIGNED_SCAN
+    osalSysLock();
+    uint16_t frame     = sof_count;
+    uint16_t since_sof = us_since(sof_time);
+    bool     active    = usbGetDriverStateI(&USB_DRIVER) == USB_ACTIVE;
+    osalSysUnlock();
+
+    /* only align while SOFs are actually coming in */
+    if (active && since_sof < 2 * USB_SOF_FRAME_US) {
+        uint16_t delay = usb_sof_sync_scan_delay(frame, since_sof);
+        if (delay) {
+            wait_us(delay);
+        }
+    }
+#    endif
+    scan_start_time = sof_clock_now();
 }
 
+/* called by the main loop once keyboard_task() is done */
+void usb_sof_scan_end(void) {
+    usb_sof_sync_scan_end(us_since(scan_start_time));
+}
+#endif
+
 /* Idle requests timer code
  * callback (called from ISR, unlocked state) */
 #if CH_KERNEL_MAJOR >= 7
@@ -825,65 +1065,21 @@ uint8_t keyboard_leds(void) {
     return keyboard_led_state;
 }
 
-/* prepare and start sending a report IN
+/* queue a report IN, sent as soon as the endpoint is free
  * not callable from ISR or locked state */
 void send_keyboard(report_keyboard_t *report) {
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        goto unlock;
-    }
-
 #ifdef NKRO_ENABLE
     if (keymap_config.nkro && keyboard_protocol) { /* NKRO protocol */
-        /* need to wait until the previous packet has made it through */
-        /* can rewrite this using the synchronous API, then would wait
-         * until *after* the packet has been transmitted. I think
-         * this is more efficient */
-        /* busy wait, should be short and not very common */
-        if (usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM)) {
-            /* Need to either suspend, or loop and call unlock/lock during
-             * every iteration - otherwise the system will remain locked,
-             * no interrupts served, so USB not going through as well.
-             * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-            osalThreadSuspendS(&(&USB_DRIVER)->epc[SHARED_IN_EPNUM]->in_state->thread);
-
-            /* after osalThreadSuspendS returns USB status might have changed */
-            if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-                goto unlock;
-            }
-        }
-        usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)report, sizeof(struct nkro_report));
+        report_queues_send(REPORT_QUEUE_NKRO, &report->nkro);
     } else
 #endif /* NKRO_ENABLE */
     {  /* regular protocol */
-        /* need to wait until the previous packet has made it through */
-        /* busy wait, should be short and not very common */
-        if (usbGetTransmitStatusI(&USB_DRIVER, KEYBOARD_IN_EPNUM)) {
-            /* Need to either suspend, or loop and call unlock/lock during
-             * every iteration - otherwise the system will remain locked,
-             * no interrupts served, so USB not going through as well.
-             * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-            osalThreadSuspendS(&(&USB_DRIVER)->epc[KEYBOARD_IN_EPNUM]->in_state->thread);
-
-            /* after osalThreadSuspendS returns USB status might have changed */
-            if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-                goto unlock;
-            }
-        }
-        uint8_t *data, size;
-        if (keyboard_protocol) {
-            data = (uint8_t *)report;
-            size = KEYBOARD_REPORT_SIZE;
-        } else { /* boot protocol */
-            data = &report->mods;
-            size = 8;
-        }
-        usbStartTransmitI(&USB_DRIVER, KEYBOARD_IN_EPNUM, data, size);
+        report_queues_send(REPORT_QUEUE_KEYBOARD, report);
     }
     keyboard_report_sent = *report;
-
-unlock:
-    osalSysUnlock();
+#ifdef USB_SOF_STATS_ENABLE
+    usb_sof_sync_report_ready(us_since(sof_time), us_since(scan_start_time));
+#endif
 }
 
 /* ---------------------------------------------------------
@@ -896,30 +1092,12 @@ unlock:
 #    ifndef MOUSE_SHARED_EP
 /* mouse IN callback hander (a mouse report has made it IN) */
 void mouse_in_cb(USBDriver *usbp, usbep_t ep) {
-    (void)usbp;
-    (void)ep;
+    report_queues_in_cb(usbp, ep);
 }
 #    endif
 
 void send_mouse(report_mouse_t *report) {
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
-
-    if (usbGetTransmitStatusI(&USB_DRIVER, MOUSE_IN_EPNUM)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[MOUSE_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
-            return;
-        }
-    }
-    usbStartTransmitI(&USB_DRIVER, MOUSE_IN_EPNUM, (uint8_t *)report, sizeof(report_mouse_t));
-    osalSysUnlock();
+    report_queues_send(REPORT_QUEUE_MOUSE, report);
 }
 
 #else  /* MOUSE_ENABLE */
@@ -933,11 +1111,9 @@ void send_mouse(report_mouse_t *report) {
  * ---------------------------------------------------------
  */
 #ifdef SHARED_EP_ENABLE
-/* shared IN callback hander */
+/* shared IN callback hander, the report IDs on the endpoint take turns */
 void shared_in_cb(USBDriver *usbp, usbep_t ep) {
-    /* STUB */
-    (void)usbp;
-    (void)ep;
+    report_queues_in_cb(usbp, ep);
 }
 #endif
 
@@ -947,84 +1123,40 @@ void shared_in_cb(USBDriver *usbp, usbep_t ep) {
  */
 
 #ifdef EXTRAKEY_ENABLE
-static void send_extra(uint8_t report_id, uint16_t data) {
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
-
-    if (usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[SHARED_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
-            return;
-        }
-    }
+static void send_extra(enum report_queue_index index, uint8_t report_id, uint16_t data) {
+    report_extra_t report = {.report_id = report_id, .usage = data};
 
-    static report_extra_t report;
-    report = (report_extra_t){.report_id = report_id, .usage = data};
-
-    usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)&report, sizeof(report_extra_t));
-    osalSysUnlock();
+    report_queues_send(index, &report);
 }
 #endif
 
 void send_system(uint16_t data) {
 #ifdef EXTRAKEY_ENABLE
-    send_extra(REPORT_ID_SYSTEM, data);
+    send_extra(REPORT_QUEUE_SYSTEM, REPORT_ID_SYSTEM, data);
 #endif
 }
 
 void send_consumer(uint16_t data) {
 #ifdef EXTRAKEY_ENABLE
-    send_extra(REPORT_ID_CONSUMER, data);
+    send_extra(REPORT_QUEUE_CONSUMER, REPORT_ID_CONSUMER, data);
 #endif
 }
 
 void send_programmable_button(uint32_t data) {
 #ifdef PROGRAMMABLE_BUTTON_ENABLE
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
-
-    if (usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[SHARED_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
-            return;
-        }
-    }
-    static report_programmable_button_t report = {
+    report_programmable_button_t report = {
         .report_id = REPORT_ID_PROGRAMMABLE_BUTTON,
+        .usage     = data,
     };
 
-    report.usage = data;
-
-    usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)&report, sizeof(report));
-    osalSysUnlock();
+    report_queues_send(REPORT_QUEUE_PROGRAMMABLE_BUTTON, &report);
 #endif
 }
 
 void send_digitizer(report_digitizer_t *report) {
 #ifdef DIGITIZER_ENABLE
 #    ifdef DIGITIZER_SHARED_EP
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
-
-    usbStartTransmitI(&USB_DRIVER, DIGITIZER_IN_EPNUM, (uint8_t *)report, sizeof(report_digitizer_t));
-    osalSysUnlock();
+    report_queues_send(REPORT_QUEUE_DIGITIZER, report);
 #    else
     chnWrite(&drivers.digitizer_driver.driver, (uint8_t *)report, sizeof(report_digitizer_t));
 #    endif
@@ -1039,32 +1171,7 @@ void send_digitizer(report_digitizer_t *report) {
 #ifdef CONSOLE_ENABLE
 
 int8_t sendchar(uint8_t c) {
-    static bool timed_out = false;
-    /* The `timed_out` state is an approximation of the ideal `is_listener_disconnected?` state.
-     *
-     * When a 5ms timeout write has timed out, hid_listen is most likely not running, or not
-     * listening to this keyboard, so we go into the timed_out state. In this state we assume
-     * that hid_listen is most likely not gonna be connected to us any time soon, so it would
-     * be wasteful to write follow-up characters with a 5ms timeout, it would all add up and
-     * unncecessarily slow down the firmware. However instead of just dropping the characters,
-     * we write them with a TIME_IMMEDIATE timeout, which is a zero timeout,
-     * and this will succeed only if hid_listen gets connected again. When a write with
-     * TIME_IMMEDIATE timeout succeeds, we know that hid_listen is listening to us again, and
-     * we can go back to the timed_out = false state, and following writes will be executed
-     * with a 5ms timeout. The reason we don't just send all characters with the TIME_IMMEDIATE
-     * timeout is that this could cause bytes to be lost even if hid_listen is running, if there
-     * is a lot of data being sent over the console.
-     *
-     * This logic will work correctly as long as hid_listen is able to receive at least 200
-     * bytes per second. On a heavily overloaded machine that's so overloaded that it's
-     * unusable, and constantly swapping, hid_listen might have trouble receiving 200 bytes per
-     * second, so some bytes might be lost on the console.
-     */
-
-    const sysinterval_t timeout = timed_out ? TIME_IMMEDIATE : TIME_MS2I(5);
-    const size_t        result  = chnWriteTimeout(&drivers.console_driver.driver, &c, 1, timeout);
-    timed_out                   = (result == 0);
-    return result;
+    return console_tx_put(c) ? 0 : -1;
 }
 
 // Just a dummy function for now, this could be exposed as a weak function
@@ -1083,6 +1190,29 @@ void console_task(void) {
             console_receive(buffer, size);
         }
     } while (size > 0);
+
+#    ifdef TOKENIZED_LOGGING_ENABLE
+    tokenized_log_task();
+#    endif
+
+    // Move buffered output to the endpoint queue a packet at a time, without
+    // waiting; a packet the queue only took part of is finished next time.
+    static uint8_t packet[CONSOLE_EPSIZE];
+    static uint8_t packet_size = 0;
+    static uint8_t packet_sent = 0;
+    for (;;) {
+        if (packet_sent == packet_size) {
+            packet_size = console_tx_read(packet, sizeof(packet));
+            packet_sent = 0;
+            if (packet_size == 0) {
+                break;
+            }
+        }
+        packet_sent += chnWriteTimeout(&drivers.console_driver.driver, &packet[packet_sent], packet_size - packet_sent, TIME_IMMEDIATE);
+        if (packet_sent < packet_size) {
+            break;
+        }
+    }
 }
 
 #endif /* CONSOLE_ENABLE */
@@ -1102,6 +1232,11 @@ __attribute__((weak)) void raw_hid_receive(uint8_t *data, uint8_t length) {
     // so users can opt to not handle data coming in.
 }
 
+__attribute__((weak)) void raw_hid_poll(void) {
+    // Users can implement this to push packets to the host
+    // without waiting for a request from it.
+}
+
 void raw_hid_task(void) {
     uint8_t buffer[RAW_EPSIZE];
     size_t  size = 0;
@@ -1111,6 +1246,7 @@ void raw_hid_task(void) {
             raw_hid_receive(buffer, size);
         }
     } while (size > 0);
+    raw_hid_poll();
 }
 
 #endif
@@ -1166,8 +1302,7 @@ void virtser_task(void) {
 #ifdef JOYSTICK_ENABLE
 
 void send_joystick_packet(joystick_t *joystick) {
-    static joystick_report_t rep;
-    rep = (joystick_report_t) {
+    joystick_report_t rep = {
 #    if JOYSTICK_AXES_COUNT > 0
         .axes =
         { joystick->axes[0],
@@ -1207,14 +1342,14 @@ void send_joystick_packet(joystick_t *joystick) {
 #    endif // JOYSTICK_BUTTON_COUNT>0
     };
 
-    // chnWrite(&drivers.joystick_driver.driver, (uint8_t *)&rep, sizeof(rep));
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
+    report_queues_send(REPORT_QUEUE_JOYSTICK, &rep);
+}
 
-    usbStartTransmitI(&USB_DRIVER, JOYSTICK_IN_EPNUM, (uint8_t *)&rep, sizeof(joystick_report_t));
+/* The joystick IN callback belongs to its serial driver, so reports queued
+ * behind a busy endpoint are started from here. */
+void joystick_ep_task(void) {
+    osalSysLock();
+    report_queues_flush_I(&USB_DRIVER, JOYSTICK_IN_EPNUM);
     osalSysUnlock();
 }
 
@@ -23,6 +23,8 @@
 #include <ch.h>
 #include <hal.h>
 
+#include "usb_sof_sync.h"
+
 /* -------------------------
  * General USB driver header
  * -------------------------
@@ -61,6 +63,13 @@ void kbd_in_cb(USBDriver *usbp, usbep_t ep);
 /* start-of-frame handler */
 void kbd_sof_cb(USBDriver *usbp);
 
+#ifdef USB_SOF_STATS_ENABLE
+/* Bracket each scan so reports can be timed against the USB frame, and with
+ * USB_SOF_ALIGNED_SCAN delay the scan to end just before the next SOF */
+void usb_sof_scan_start(void);
+void usb_sof_scan_end(void);
+#endif
+
 #ifdef NKRO_ENABLE
 /* nkro IN callback hander */
 void nkro_in_cb(USBDriver *usbp, usbep_t ep);
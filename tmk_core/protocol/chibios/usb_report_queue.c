@@ -0,0 +1,211 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "usb_report_queue.h"
+#include <stddef.h>
+#include <string.h>
+#include "report.h"
+
+_Static_assert(USB_REPORT_QUEUE_DEPTH >= 2 && USB_REPORT_QUEUE_DEPTH <= 64, "USB_REPORT_QUEUE_DEPTH must be between 2 and 64");
+
+#define SLOT_COUNT (USB_REPORT_QUEUE_DEPTH + 1)
+
+#ifdef MOUSE_EXTENDED_REPORT
+#    define MOUSE_XY_LIMIT 32767
+#else
+#    define MOUSE_XY_LIMIT 127
+#endif
+#define MOUSE_WHEEL_LIMIT 127
+
+static inline uint8_t *slot(usb_report_queue_t *queue, uint8_t index) {
+    return &queue->slots[(index % SLOT_COUNT) * queue->size];
+}
+
+void usb_report_queue_init(usb_report_queue_t *queue, void *slots, uint8_t size, usb_report_merge_t merge) {
+    queue->slots = slots;
+    queue->size  = size;
+    queue->merge = merge;
+    usb_report_queue_clear(queue);
+    queue->coalesced = 0;
+    queue->refused   = 0;
+}
+
+void usb_report_queue_clear(usb_report_queue_t *queue) {
+    queue->head      = 1;
+    queue->count     = 0;
+    queue->in_flight = false;
+    // the host forgets everything on reset, so compare against a blank report
+    memset(queue->slots, 0, SLOT_COUNT * queue->size);
+}
+
+bool usb_report_queue_push(usb_report_queue_t *queue, const void *report) {
+    if (queue->count > (queue->in_flight ? 1 : 0)) {
+        uint8_t  tail     = queue->head + queue->count - 1;
+        uint8_t *pending  = slot(queue, tail);
+        uint8_t *previous = slot(queue, tail + SLOT_COUNT - 1);
+
+        if (queue->merge && queue->merge(pending, previous, report, queue->size)) {
+            queue->coalesced++;
+            return true;
+        }
+    }
+    if (queue->count == USB_REPORT_QUEUE_DEPTH) {
+        queue->refused++;
+        return false;
+    }
+    memcpy(slot(queue, queue->head + queue->count), report, queue->size);
+    queue->count++;
+    return true;
+}
+
+void *usb_report_queue_start(usb_report_queue_t *queue) {
+    if (queue->count == 0 || queue->in_flight) {
+        return NULL;
+    }
+    queue->in_flight = true;
+    return slot(queue, queue->head);
+}
+
+bool usb_report_queue_complete(usb_report_queue_t *queue) {
+    if (queue->in_flight) {
+        // the retired slot stays intact as the new `previous`
+        queue->head      = (queue->head + 1) % SLOT_COUNT;
+        queue->count     = queue->count - 1;
+        queue->in_flight = false;
+    }
+    return queue->count > 0;
+}
+
+int8_t usb_report_queue_arbitrate(usb_report_queue_t *queues, uint8_t count, uint16_t members, uint8_t *last) {
+    for (uint8_t n = 1; n <= count; n++) {
+        uint8_t i = (*last + n) % count;
+
+        if ((members & (1U << i)) && queues[i].count > 0 && !queues[i].in_flight) {
+            *last = i;
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* A bit that flipped from `previous` to `pending` must not flip back. */
+static inline bool bits_mergeable(uint8_t pending, uint8_t previous, uint8_t next) {
+    return ((pending ^ previous) & (next ^ pending)) == 0;
+}
+
+/* The modifiers in effect when a key goes down decide what it types, so a key
+ * press can't share a report with a modifier change that follows it, or with a
+ * modifier release that precedes it. */
+static inline bool mods_mergeable(bool pending_presses, uint8_t pending_mods, uint8_t previous_mods, bool next_presses, uint8_t next_mods) {
+    return !(pending_presses && next_mods != pending_mods) && !(next_presses && (previous_mods & ~pending_mods));
+}
+
+/* `mods` is the offset of the modifier byte, or `size` if there is none. */
+static bool merge_bits(uint8_t *p, const uint8_t *prev, const uint8_t *n, uint8_t size, uint8_t mods) {
+    bool pending_presses = false, next_presses = false;
+
+    for (uint8_t i = 0; i < size; i++) {
+        if (!bits_mergeable(p[i], prev[i], n[i])) {
+            return false;
+        }
+        if (i != mods) {
+            pending_presses |= (p[i] & ~prev[i]) != 0;
+            next_presses |= (n[i] & ~p[i]) != 0;
+        }
+    }
+    if (mods < size && !mods_mergeable(pending_presses, p[mods], prev[mods], next_presses, n[mods])) {
+        return false;
+    }
+    memcpy(p, n, size);
+    return true;
+}
+
+bool usb_report_merge_bitmap(void *pending, const void *previous, const void *next, uint8_t size) {
+    return merge_bits(pending, previous, next, size, size);
+}
+
+#ifdef NKRO_ENABLE
+bool usb_report_merge_nkro(void *pending, const void *previous, const void *next, uint8_t size) {
+    return merge_bits(pending, previous, next, size, offsetof(struct nkro_report, mods));
+}
+#endif
+
+static bool has_key(const report_keyboard_t *report, uint8_t key) {
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (report->keys[i] == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool usb_report_merge_keyboard(void *pending, const void *previous, const void *next, uint8_t size) {
+    report_keyboard_t *      p = pending;
+    const report_keyboard_t *prev = previous, *n = next;
+    bool                     pending_presses = false, next_presses = false;
+
+    if (!bits_mergeable(p->mods, prev->mods, n->mods)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (p->keys[i] && !has_key(prev, p->keys[i])) {
+            // a press in `pending` must still be held in `next`
+            if (!has_key(n, p->keys[i])) {
+                return false;
+            }
+            pending_presses = true;
+        }
+        // a release in `pending` must not be undone by `next`
+        if (prev->keys[i] && !has_key(p, prev->keys[i]) && has_key(n, prev->keys[i])) {
+            return false;
+        }
+        next_presses |= n->keys[i] && !has_key(p, n->keys[i]);
+    }
+    if (!mods_mergeable(pending_presses, p->mods, prev->mods, next_presses, n->mods)) {
+        return false;
+    }
+    memcpy(pending, next, size);
+    return true;
+}
+
+static inline bool add_motion(int32_t *sum, int32_t next, int32_t limit) {
+    *sum += next;
+    return *sum >= -limit && *sum <= limit;
+}
+
+bool usb_report_merge_mouse(void *pending, const void *previous, const void *next, uint8_t size) {
+    report_mouse_t *      p = pending;
+    const report_mouse_t *prev = previous, *n = next;
+    int32_t               x = p->x, y = p->y, v = p->v, h = p->h;
+
+    (void)size;
+    if (!bits_mergeable(p->buttons, prev->buttons, n->buttons)) {
+        return false;
+    }
+    if (!add_motion(&x, n->x, MOUSE_XY_LIMIT) || !add_motion(&y, n->y, MOUSE_XY_LIMIT) || !add_motion(&v, n->v, MOUSE_WHEEL_LIMIT) || !add_motion(&h, n->h, MOUSE_WHEEL_LIMIT)) {
+        return false;
+    }
+    p->buttons = n->buttons;
+    p->x       = x;
+    p->y       = y;
+    p->v       = v;
+    p->h       = h;
+#ifdef MOUSE_EXTENDED_REPORT
+    p->boot_x = (x > 127) ? 127 : ((x < -127) ? -127 : x);
+    p->boot_y = (y > 127) ? 127 : ((y < -127) ? -127 : y);
+#endif
+    return true;
+}
@@ -0,0 +1,92 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Reports that can wait behind the one in flight, per queue. */
+#ifndef USB_REPORT_QUEUE_DEPTH
+#    define USB_REPORT_QUEUE_DEPTH 4
+#endif
+
+/* One extra slot keeps the last report handed to the host, which the merge
+ * callbacks compare against. */
+#define USB_REPORT_QUEUE_SLOTS(report_type) ((USB_REPORT_QUEUE_DEPTH + 1) * sizeof(report_type))
+
+/** \brief Merge callback
+ *
+ * Folds `next` into the not yet transmitted report `pending`, which follows
+ * `previous` on the wire. Must return false without touching `pending` if the
+ * host would then miss a state change between `previous` and `pending`.
+ */
+typedef bool (*usb_report_merge_t)(void *pending, const void *previous, const void *next, uint8_t size);
+
+/** \brief USB report queue
+ *
+ * Non-blocking replacement for waiting on a busy IN endpoint: the caller pushes
+ * a report and returns, the IN completion callback starts the next one. Reports
+ * queued during one polling interval are merged as long as no state change is
+ * lost, so a press and release inside one interval still end up as two reports.
+ * A report that neither merges nor fits is refused, the caller has to wait
+ * for the report in flight to complete and push it again.
+ *
+ * Not thread safe; on ChibiOS every call happens with the system locked.
+ */
+typedef struct {
+    uint8_t *          slots;       // USB_REPORT_QUEUE_SLOTS(report) bytes
+    usb_report_merge_t merge;       // NULL never merges
+    uint8_t            size;        // bytes per report
+    uint8_t            head;        // slot of the oldest queued report
+    uint8_t            count;       // queued reports, including the one in flight
+    bool               in_flight;   // head has been handed to the endpoint
+    uint16_t           coalesced;   // reports merged into a pending one
+    uint16_t           refused;     // pushes that found the queue full
+} usb_report_queue_t;
+
+void usb_report_queue_init(usb_report_queue_t *queue, void *slots, uint8_t size, usb_report_merge_t merge);
+
+/* Drops everything queued, e.g. after a bus reset aborted the transfer in flight. */
+void usb_report_queue_clear(usb_report_queue_t *queue);
+
+/* Returns false, and queues nothing, if the queue is full. */
+bool usb_report_queue_push(usb_report_queue_t *queue, const void *report);
+
+/* Returns the report to transmit next and marks it in flight, or NULL if the
+ * queue is empty or a report is already in flight. */
+void *usb_report_queue_start(usb_report_queue_t *queue);
+
+/* Retires the report in flight, if any. Returns true if more reports are queued. */
+bool usb_report_queue_complete(usb_report_queue_t *queue);
+
+/** \brief Round robin arbiter for queues sharing one endpoint
+ *
+ * Returns the index of the next queue in `members` (bit n for queues[n]) with a
+ * report waiting, searching from the one after `*last`, and stores it in
+ * `*last`. Returns -1 if none of them has anything to send. Serving the queues
+ * in turn keeps a busy report ID, e.g. consumer keys, from starving the others.
+ */
+int8_t usb_report_queue_arbitrate(usb_report_queue_t *queues, uint8_t count, uint16_t members, uint8_t *last);
+
+/* Any report whose bytes are independent on/off flags, e.g. programmable buttons. */
+bool usb_report_merge_bitmap(void *pending, const void *previous, const void *next, uint8_t size);
+/* struct nkro_report; a bitmap, but modifiers don't merge with key presses. */
+bool usb_report_merge_nkro(void *pending, const void *previous, const void *next, uint8_t size);
+/* report_keyboard_t in 6KRO layout. */
+bool usb_report_merge_keyboard(void *pending, const void *previous, const void *next, uint8_t size);
+/* report_mouse_t; relative motion is summed until it would saturate. */
+bool usb_report_merge_mouse(void *pending, const void *previous, const void *next, uint8_t size);
@@ -0,0 +1,108 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "usb_sof_sync.h"
+
+_Static_assert(USB_SOF_GUARD_US < USB_SOF_FRAME_US, "USB_SOF_GUARD_US must be shorter than a frame");
+
+static usb_sof_stats_t stats;
+static uint32_t        ready_sum_us;
+static uint32_t        wire_sum_us;
+
+/* Work time is tracked like a TCP round trip time: a smoothed mean plus four
+ * times the mean deviation, so occasional slow scans push the start earlier. */
+static int32_t work_avg_x8;
+static int32_t work_dev_x4;
+static int32_t scan_work_us = -1; // slowest report of the current scan
+static int32_t last_scanned_frame = -1;
+
+static void update_offset(void) {
+    int32_t estimate = (work_avg_x8 >> 3) + work_dev_x4;
+    int32_t offset   = USB_SOF_FRAME_US - USB_SOF_GUARD_US - estimate;
+
+    stats.work_us        = estimate;
+    stats.scan_offset_us = offset < 0 ? 0 : offset;
+}
+
+void usb_sof_sync_init(void) {
+    work_avg_x8        = (USB_SOF_FRAME_US / 2) << 3;
+    work_dev_x4        = 0;
+    scan_work_us       = -1;
+    last_scanned_frame = -1;
+    usb_sof_sync_clear_stats();
+}
+
+void usb_sof_sync_clear_stats(void) {
+    stats        = (usb_sof_stats_t){.ready_min_us = UINT16_MAX};
+    ready_sum_us = 0;
+    wire_sum_us  = 0;
+    update_offset();
+}
+
+usb_sof_stats_t usb_sof_sync_get_stats(void) {
+    usb_sof_stats_t result = stats;
+
+    if (stats.reports) {
+        result.ready_avg_us = ready_sum_us / stats.reports;
+        result.wire_avg_us  = wire_sum_us / stats.reports;
+    }
+    return result;
+}
+
+uint16_t usb_sof_sync_scan_delay(uint16_t frame, uint16_t since_sof_us) {
+    uint16_t phase = since_sof_us % USB_SOF_FRAME_US;
+
+    if (last_scanned_frame == frame) {
+        // already scanned in this frame, aim for the next one
+        last_scanned_frame = (uint16_t)(frame + 1);
+        return USB_SOF_FRAME_US - phase + stats.scan_offset_us;
+    }
+    last_scanned_frame = frame;
+    // running late for this frame: scan now rather than waiting a whole frame
+    return phase < stats.scan_offset_us ? stats.scan_offset_us - phase : 0;
+}
+
+void usb_sof_sync_report_ready(uint16_t since_sof_us, uint16_t since_scan_us) {
+    uint16_t phase = since_sof_us % USB_SOF_FRAME_US;
+
+    stats.reports++;
+    if (phase > USB_SOF_FRAME_US - USB_SOF_GUARD_US) {
+        stats.late_reports++;
+    }
+    if (phase < stats.ready_min_us) {
+        stats.ready_min_us = phase;
+    }
+    if (phase > stats.ready_max_us) {
+        stats.ready_max_us = phase;
+    }
+    ready_sum_us += phase;
+    wire_sum_us += USB_SOF_FRAME_US - phase;
+
+    if (since_scan_us > scan_work_us) {
+        scan_work_us = since_scan_us;
+    }
+}
+
+void usb_sof_sync_scan_end(uint16_t since_scan_us) {
+    // scans that produced a report count up to the report, others as a whole
+    int32_t work = scan_work_us >= 0 ? scan_work_us : since_scan_us;
+    int32_t err  = work - (work_avg_x8 >> 3);
+
+    scan_work_us = -1;
+    work_avg_x8 += err;
+    work_dev_x4 += (err < 0 ? -err : err) - (work_dev_x4 >> 2);
+    update_offset();
+}
@@ -0,0 +1,67 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* USB_SOF_STATS_ENABLE measures when reports become ready relative to the
+ * USB frame, USB_SOF_ALIGNED_SCAN also moves the scan to finish just before
+ * the next frame starts. */
+#if defined(USB_SOF_ALIGNED_SCAN) && !defined(USB_SOF_STATS_ENABLE)
+#    define USB_SOF_STATS_ENABLE
+#endif
+
+/* 1000 for full speed frames, 125 for high speed microframes */
+#ifndef USB_SOF_FRAME_US
+#    define USB_SOF_FRAME_US 1000
+#endif
+
+/* Slack left between the report being ready and the next SOF. */
+#ifndef USB_SOF_GUARD_US
+#    define USB_SOF_GUARD_US 50
+#endif
+
+typedef struct {
+    uint32_t reports;        // keyboard reports measured
+    uint32_t late_reports;   // ready within the guard time before the next SOF, or later
+    uint16_t ready_min_us;   // SOF to report ready
+    uint16_t ready_max_us;   //
+    uint16_t ready_avg_us;   //
+    uint16_t wire_avg_us;    // report ready to the next SOF, when the host can fetch it
+    uint16_t work_us;        // estimated scan start to report ready
+    uint16_t scan_offset_us; // where in the frame aligned scans start
+} usb_sof_stats_t;
+
+void usb_sof_sync_init(void);
+
+/** \brief Scan delay
+ *
+ * Returns how long to wait before starting the next scan so that it is done
+ * just before the next SOF. `frame` is a running SOF count, `since_sof_us`
+ * the time since the last one. Scans at most once per frame.
+ */
+uint16_t usb_sof_sync_scan_delay(uint16_t frame, uint16_t since_sof_us);
+
+/* A keyboard report was handed to the USB stack. */
+void usb_sof_sync_report_ready(uint16_t since_sof_us, uint16_t since_scan_us);
+
+/* The scan loop finished; feeds the work estimate. */
+void usb_sof_sync_scan_end(uint16_t since_scan_us);
+
+usb_sof_stats_t usb_sof_sync_get_stats(void);
+void            usb_sof_sync_clear_stats(void);
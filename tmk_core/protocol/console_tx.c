@@ -0,0 +1,166 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "console_tx.h"
+#include "atomic_util.h"
+
+#ifdef TOKENIZED_LOGGING_ENABLE
+#    include "tokenized_log.h"
+#endif
+
+#ifdef __AVR__
+// USB interrupt handlers print too, leave the interrupt flag as it was
+#    define CONSOLE_TX_ATOMIC ATOMIC_BLOCK_RESTORESTATE
+#else
+#    define CONSOLE_TX_ATOMIC ATOMIC_BLOCK_FORCEON
+#endif
+
+_Static_assert(CONSOLE_TX_BUFFER_SIZE >= 8 && CONSOLE_TX_BUFFER_SIZE <= 32768, "CONSOLE_TX_BUFFER_SIZE must be between 8 and 32768");
+
+// Most bytes copied out per critical section, so draining a packet doesn't
+// hold interrupts off for the whole copy
+#define CONSOLE_TX_ATOMIC_RUN 8
+
+static uint8_t            buffer[CONSOLE_TX_BUFFER_SIZE];
+static uint16_t           head    = 0; // next byte to write
+static uint16_t           count   = 0;
+static uint16_t           claimed = 0; // start of the space console_tx_write() is filling
+static bool               filling = false;
+static console_tx_stats_t stats   = {0};
+
+static inline uint16_t tail(void) {
+    return head >= count ? head - count : head + CONSOLE_TX_BUFFER_SIZE - count;
+}
+
+static inline void put(uint8_t c) {
+    buffer[head] = c;
+    if (++head == CONSOLE_TX_BUFFER_SIZE) {
+        head = 0;
+    }
+    count++;
+}
+
+bool console_tx_put(uint8_t c) {
+    bool queued = true;
+    CONSOLE_TX_ATOMIC {
+        if (count == CONSOLE_TX_BUFFER_SIZE) {
+            stats.dropped++;
+#ifdef CONSOLE_TX_DROP_OLDEST
+            // the oldest byte can't go while console_tx_write() is still filling it in
+            if (filling && tail() == claimed) {
+                queued = false;
+            } else {
+                count--;
+            }
+#else
+            queued = false;
+#endif
+        }
+        if (queued) {
+            put(c);
+            stats.queued++;
+        }
+    }
+    return queued;
+}
+
+uint16_t console_tx_write(const uint8_t *data, uint16_t length) {
+    uint16_t index;
+    CONSOLE_TX_ATOMIC {
+        if (length > CONSOLE_TX_BUFFER_SIZE - count) {
+            length = CONSOLE_TX_BUFFER_SIZE - count;
+        }
+        // Claim the space up front, bytes put from interrupts meanwhile go after it
+        index   = head;
+        claimed = head;
+        filling = length > 0;
+        head += length;
+        if (head >= CONSOLE_TX_BUFFER_SIZE) {
+            head -= CONSOLE_TX_BUFFER_SIZE;
+        }
+        count += length;
+        stats.queued += length;
+    }
+    for (uint16_t i = 0; i < length; i++) {
+        buffer[index] = data[i];
+        if (++index == CONSOLE_TX_BUFFER_SIZE) {
+            index = 0;
+        }
+    }
+    CONSOLE_TX_ATOMIC {
+        filling = false;
+    }
+    return length;
+}
+
+uint16_t console_tx_read(uint8_t *data, uint16_t size) {
+    uint16_t copied = 0;
+    while (copied < size) {
+        uint16_t run = size - copied;
+        if (run > CONSOLE_TX_ATOMIC_RUN) {
+            run = CONSOLE_TX_ATOMIC_RUN;
+        }
+        CONSOLE_TX_ATOMIC {
+            if (run > count) {
+                run = count;
+            }
+            uint16_t index = tail();
+            for (uint16_t i = 0; i < run; i++) {
+                data[copied + i] = buffer[index];
+                if (++index == CONSOLE_TX_BUFFER_SIZE) {
+                    index = 0;
+                }
+            }
+            count -= run;
+        }
+        if (run == 0) {
+            break;
+        }
+        copied += run;
+    }
+    return copied;
+}
+
+uint16_t console_tx_count(void) {
+    uint16_t result;
+    CONSOLE_TX_ATOMIC {
+        result = count;
+    }
+    return result;
+}
+
+console_tx_stats_t console_tx_get_stats(void) {
+    console_tx_stats_t result;
+    CONSOLE_TX_ATOMIC {
+        result = stats;
+    }
+    return result;
+}
+
+void console_tx_clear_stats(void) {
+    CONSOLE_TX_ATOMIC {
+        stats.queued  = 0;
+        stats.dropped = 0;
+    }
+}
+
+#ifdef TOKENIZED_LOGGING_ENABLE
+// Never drops anything itself, so records stay whole unless later text pushes
+// them out with CONSOLE_TX_DROP_OLDEST.
+uint16_t tokenized_log_send(const uint8_t *data, uint16_t length) {
+    return console_tx_write(data, length);
+}
+#endif
@@ -0,0 +1,56 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Console transmit buffer
+ *
+ * sendchar() only queues bytes here, console_task() hands them to the console
+ * endpoint a packet at a time. When the buffer is full, the incoming byte is
+ * dropped, or with CONSOLE_TX_DROP_OLDEST the oldest queued byte makes
+ * room for it.
+ */
+
+#ifndef CONSOLE_TX_BUFFER_SIZE
+#    ifdef __AVR__
+#        define CONSOLE_TX_BUFFER_SIZE 128
+#    else
+#        define CONSOLE_TX_BUFFER_SIZE 512
+#    endif
+#endif
+
+typedef struct {
+    uint32_t queued;  // bytes accepted
+    uint32_t dropped; // bytes lost to a full buffer
+} console_tx_stats_t;
+
+bool console_tx_put(uint8_t c);
+
+/* Queues as much of data as fits without dropping anything, returns how much.
+ * The data is copied in with interrupts enabled, so it must not run alongside
+ * console_tx_read(); console_tx_put() from an interrupt is fine.
+ */
+uint16_t console_tx_write(const uint8_t *data, uint16_t length);
+
+/* Moves up to size of the oldest queued bytes out of the buffer */
+uint16_t console_tx_read(uint8_t *data, uint16_t size);
+uint16_t console_tx_count(void);
+
+console_tx_stats_t console_tx_get_stats(void);
+void               console_tx_clear_stats(void);
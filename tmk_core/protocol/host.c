@@ -16,6 +16,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <stdint.h>
+#include <string.h>
 //#include <avr/interrupt.h>
 #include "keyboard.h"
 #include "keycode.h"
@@ -34,6 +35,15 @@ static uint16_t       last_system_report              = 0;
 static uint16_t       last_consumer_report            = 0;
 static uint32_t       last_programmable_button_report = 0;
 
+static report_keyboard_t     last_keyboard_report;
+static bool                  last_keyboard_report_valid = false;
+static bool                  last_keyboard_report_nkro  = false;
+static host_keyboard_stats_t keyboard_stats;
+#ifdef KEYBOARD_REPORT_COALESCE
+static report_keyboard_t pending_keyboard_report;
+static bool              pending_keyboard_report_valid = false;
+#endif
+
 void host_set_driver(host_driver_t *d) {
     driver = d;
 }
@@ -61,16 +71,102 @@ led_t host_keyboard_led_state(void) {
     return (led_t)host_keyboard_leds();
 }
 
+#ifdef KEYBOARD_REPORT_COALESCE
+static inline bool bit_change_undone(uint8_t last, uint8_t pending, uint8_t next) {
+    return (pending ^ last) & (next ^ pending);
+}
+
+/* The modifiers held when a key goes down decide what it types, so a key press
+ * can't share a report with a later modifier change or an earlier release. */
+static inline bool mods_reorder_press(bool pending_presses, uint8_t last_mods, uint8_t pending_mods, bool next_presses, uint8_t next_mods) {
+    return (pending_presses && next_mods != pending_mods) || (next_presses && (last_mods & ~pending_mods));
+}
+
+static bool has_key(const report_keyboard_t *report, uint8_t key) {
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (report->keys[i] == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** \brief Check whether `next` can replace `pending`
+ *
+ * Sending `next` instead of `pending` is fine unless it reverts a change
+ * `pending` makes to `last`, e.g. a key tapped within one scan, or changes
+ * the modifiers a key press sees, e.g. `a` followed by Shift.
+ */
+static bool keyboard_report_supersedes(const report_keyboard_t *last, const report_keyboard_t *pending, const report_keyboard_t *next, bool nkro) {
+    bool pending_presses = false, next_presses = false;
+
+#    ifdef NKRO_ENABLE
+    if (nkro) {
+        if (bit_change_undone(last->nkro.mods, pending->nkro.mods, next->nkro.mods)) {
+            return false;
+        }
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_BITS; i++) {
+            if (bit_change_undone(last->nkro.bits[i], pending->nkro.bits[i], next->nkro.bits[i])) {
+                return false;
+            }
+            pending_presses |= (pending->nkro.bits[i] & ~last->nkro.bits[i]) != 0;
+            next_presses |= (next->nkro.bits[i] & ~pending->nkro.bits[i]) != 0;
+        }
+        return !mods_reorder_press(pending_presses, last->nkro.mods, pending->nkro.mods, next_presses, next->nkro.mods);
+    }
+#    endif
+    if (bit_change_undone(last->mods, pending->mods, next->mods)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (pending->keys[i] && !has_key(last, pending->keys[i])) {
+            // pressed in `pending`, released again in `next`
+            if (!has_key(next, pending->keys[i])) {
+                return false;
+            }
+            pending_presses = true;
+        }
+        // released in `pending`, pressed again in `next`
+        if (last->keys[i] && !has_key(pending, last->keys[i]) && has_key(next, last->keys[i])) {
+            return false;
+        }
+        next_presses |= next->keys[i] && !has_key(pending, next->keys[i]);
+    }
+    return !mods_reorder_press(pending_presses, last->mods, pending->mods, next_presses, next->mods);
+}
+#endif
+
+static void keyboard_report_transmit(report_keyboard_t *report, bool nkro) {
+    last_keyboard_report       = *report;
+    last_keyboard_report_valid = true;
+    last_keyboard_report_nkro  = nkro;
+    keyboard_stats.sent++;
+
+    (*driver->send_keyboard)(report);
+
+    if (debug_keyboard) {
+        dprint("keyboard_report: ");
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_SIZE; i++) {
+            dprintf("%02X ", report->raw[i]);
+        }
+        dprint("\n");
+    }
+}
+
 /* send report */
 void host_keyboard_send(report_keyboard_t *report) {
     if (!driver) return;
-#if defined(NKRO_ENABLE) && defined(NKRO_SHARED_EP)
+    bool nkro = false;
+#ifdef NKRO_ENABLE
     if (keyboard_protocol && keymap_config.nkro) {
         /* The callers of this function assume that report->mods is where mods go in.
          * But report->nkro.mods can be at a different offset if core keyboard does not have a report ID.
          */
-        report->nkro.mods      = report->mods;
+        report->nkro.mods = report->mods;
+#    ifdef NKRO_SHARED_EP
         report->nkro.report_id = REPORT_ID_NKRO;
+#    endif
+        nkro = true;
     } else
 #endif
     {
@@ -78,16 +174,51 @@ void host_keyboard_send(report_keyboard_t *report) {
         report->report_id = REPORT_ID_KEYBOARD;
 #endif
     }
-    (*driver->send_keyboard)(report);
 
-    if (debug_keyboard) {
-        dprint("keyboard_report: ");
-        for (uint8_t i = 0; i < KEYBOARD_REPORT_SIZE; i++) {
-            dprintf("%02X ", report->raw[i]);
+#ifdef KEYBOARD_REPORT_COALESCE
+    if (pending_keyboard_report_valid) {
+        if (memcmp(report, &pending_keyboard_report, sizeof(report_keyboard_t)) == 0) {
+            keyboard_stats.suppressed++;
+            return;
         }
-        dprint("\n");
+        if (nkro == last_keyboard_report_nkro && keyboard_report_supersedes(&last_keyboard_report, &pending_keyboard_report, report, nkro)) {
+            pending_keyboard_report = *report;
+            keyboard_stats.coalesced++;
+            return;
+        }
+        host_keyboard_flush();
     }
+#endif
+
+#ifndef PROTOCOL_VUSB
+    /* The host already has this state, don't spend a poll on it. V-USB drops
+     * reports when its buffer is full and relies on them being sent again. */
+    if (last_keyboard_report_valid && nkro == last_keyboard_report_nkro && memcmp(report, &last_keyboard_report, sizeof(report_keyboard_t)) == 0) {
+        keyboard_stats.suppressed++;
+        return;
+    }
+#endif
+
+#ifdef KEYBOARD_REPORT_COALESCE
+    /* hold it until the end of the scan, or until a change it can't absorb */
+    if (last_keyboard_report_valid && nkro == last_keyboard_report_nkro) {
+        pending_keyboard_report       = *report;
+        pending_keyboard_report_valid = true;
+        return;
+    }
+#endif
+    keyboard_report_transmit(report, nkro);
+}
+
+#ifdef KEYBOARD_REPORT_COALESCE
+void host_keyboard_flush(void) {
+    if (!pending_keyboard_report_valid) return;
+    pending_keyboard_report_valid = false;
+    if (!driver) return;
+
+    keyboard_report_transmit(&pending_keyboard_report, last_keyboard_report_nkro);
 }
+#endif
 
 void host_mouse_send(report_mouse_t *report) {
     if (!driver) return;
@@ -144,6 +275,21 @@ void host_programmable_button_send(uint32_t report) {
     (*driver->send_programmable_button)(report);
 }
 
+/* Forget the last keyboard report, so the next one is sent even if unchanged,
+ * e.g. when the host may have lost track of the keyboard state. */
+void host_keyboard_resync(void) {
+    host_keyboard_flush();
+    last_keyboard_report_valid = false;
+}
+
+host_keyboard_stats_t host_keyboard_get_stats(void) {
+    return keyboard_stats;
+}
+
+void host_keyboard_clear_stats(void) {
+    keyboard_stats = (host_keyboard_stats_t){0};
+}
+
 uint16_t host_last_system_report(void) {
     return last_system_report;
 }
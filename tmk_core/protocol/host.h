@@ -36,6 +36,12 @@ extern "C" {
 extern uint8_t keyboard_idle;
 extern uint8_t keyboard_protocol;
 
+typedef struct {
+    uint32_t sent;       // keyboard reports passed to the driver
+    uint32_t suppressed; // identical to the previous one, dropped
+    uint32_t coalesced;  // replaced a pending report within the same scan
+} host_keyboard_stats_t;
+
 /* host driver */
 void           host_set_driver(host_driver_t *driver);
 host_driver_t *host_get_driver(void);
@@ -53,6 +59,17 @@ uint16_t host_last_system_report(void);
 uint16_t host_last_consumer_report(void);
 uint32_t host_last_programmable_button_report(void);
 
+void                  host_keyboard_resync(void);
+#ifdef KEYBOARD_REPORT_COALESCE
+/* Sends the keyboard report held back for coalescing. Call before any delay
+ * that is meant to be visible to the host. */
+void host_keyboard_flush(void);
+#else
+static inline void host_keyboard_flush(void) {}
+#endif
+host_keyboard_stats_t host_keyboard_get_stats(void);
+void                  host_keyboard_clear_stats(void);
+
 #ifdef __cplusplus
 }
 #endif
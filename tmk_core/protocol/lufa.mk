@@ -28,6 +28,10 @@ endif
 SRC += $(LUFA_SRC)
 SRC += $(LUFA_DIR)/usb_util.c
 
+ifeq ($(strip $(CONSOLE_ENABLE)), yes)
+    SRC += $(PROTOCOL_DIR)/console_tx.c
+endif
+
 # Search Path
 VPATH += $(TMK_PATH)/$(LUFA_DIR)
 VPATH += $(LUFA_PATH)
@@ -90,6 +90,14 @@ extern keymap_config_t keymap_config;
 #    include "joystick.h"
 #endif
 
+#ifdef CONSOLE_ENABLE
+#    include "console_tx.h"
+#endif
+
+#ifdef TOKENIZED_LOGGING_ENABLE
+#    include "tokenized_log.h"
+#endif
+
 uint8_t keyboard_idle = 0;
 /* 0: Boot Protocol, 1: Report Protocol(default) */
 uint8_t        keyboard_protocol  = 1;
@@ -176,6 +184,15 @@ __attribute__((weak)) void raw_hid_receive(uint8_t *data, uint8_t length) {
     // so users can opt to not handle data coming in.
 }
 
+/** \brief Raw HID Poll
+ *
+ * Called at the end of every raw HID task pass while configured.
+ */
+__attribute__((weak)) void raw_hid_poll(void) {
+    // Users can implement this to push packets to the host
+    // without waiting for a request from it.
+}
+
 /** \brief Raw HID Task
  *
  * FIXME: Needs doc
@@ -206,6 +223,8 @@ static void raw_hid_task(void) {
             raw_hid_receive(data, sizeof(data));
         }
     }
+
+    raw_hid_poll();
 }
 #endif
 
@@ -215,12 +234,14 @@ static void raw_hid_task(void) {
 #ifdef CONSOLE_ENABLE
 /** \brief Console Task
  *
- * FIXME: Needs doc
+ * Sends the output sendchar() buffered, a full bank at a time.
  */
 static void Console_Task(void) {
     /* Device must be connected and configured for the task to run */
     if (USB_DeviceState != DEVICE_STATE_Configured) return;
 
+    if (!console_tx_count()) return;
+
     uint8_t ep = Endpoint_GetCurrentEndpoint();
 
 #    if 0
@@ -255,12 +276,12 @@ static void Console_Task(void) {
         return;
     }
 
-    // fill empty bank
-    while (Endpoint_IsReadWriteAllowed())
-        Endpoint_Write_8(0);
-
-    // flush sendchar packet
-    if (Endpoint_IsINReady()) {
+    while (Endpoint_IsINReady()) {
+        uint8_t data[CONSOLE_EPSIZE] = {0};
+        if (!console_tx_read(data, sizeof(data))) {
+            break;
+        }
+        Endpoint_Write_Stream_LE(data, sizeof(data), NULL);
         Endpoint_ClearIN();
     }
 
@@ -352,7 +373,6 @@ void EVENT_USB_Device_Connect(void) {
     if (!USB_IsInitialized) {
         USB_Disable();
         USB_Init();
-        USB_Device_EnableSOFEvents();
     }
 }
 
@@ -414,32 +434,6 @@ void EVENT_USB_Device_WakeUp() {
 #endif
 }
 
-#ifdef CONSOLE_ENABLE
-static bool console_flush = false;
-#    define CONSOLE_FLUSH_SET(b)                \
-        do {                                    \
-            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { \
-                console_flush = b;              \
-            }                                   \
-        } while (0)
-
-/** \brief Event USB Device Start Of Frame
- *
- * FIXME: Needs doc
- * called every 1ms
- */
-void EVENT_USB_Device_StartOfFrame(void) {
-    static uint8_t count;
-    if (++count % 50) return;
-    count = 0;
-
-    if (!console_flush) return;
-    Console_Task();
-    console_flush = false;
-}
-
-#endif
-
 /** \brief Event handler for the USB_ConfigurationChanged event.
  *
  * This is fired when the host sets the current configuration of the USB device after enumeration.
@@ -797,66 +791,12 @@ static void send_programmable_button(uint32_t data) {
  * sendchar
  ******************************************************************************/
 #ifdef CONSOLE_ENABLE
-#    define SEND_TIMEOUT 5
 /** \brief Send Char
  *
- * FIXME: Needs doc
+ * Only queues the character, Console_Task() sends it.
  */
 int8_t sendchar(uint8_t c) {
-    // Do not wait if the previous write has timed_out.
-    // Because sendchar() is called so many times, waiting each call causes big lag.
-    // The `timed_out` state is an approximation of the ideal `is_listener_disconnected?` state.
-    static bool timed_out = false;
-
-    // prevents Console_Task() from running during sendchar() runs.
-    // or char will be lost. These two function is mutually exclusive.
-    CONSOLE_FLUSH_SET(false);
-
-    if (USB_DeviceState != DEVICE_STATE_Configured) return -1;
-
-    uint8_t ep = Endpoint_GetCurrentEndpoint();
-    Endpoint_SelectEndpoint(CONSOLE_IN_EPNUM);
-    if (!Endpoint_IsEnabled() || !Endpoint_IsConfigured()) {
-        goto ERROR_EXIT;
-    }
-
-    if (timed_out && !Endpoint_IsReadWriteAllowed()) {
-        goto ERROR_EXIT;
-    }
-
-    timed_out = false;
-
-    uint8_t timeout = SEND_TIMEOUT;
-    while (!Endpoint_IsReadWriteAllowed()) {
-        if (USB_DeviceState != DEVICE_STATE_Configured) {
-            goto ERROR_EXIT;
-        }
-        if (Endpoint_IsStalled()) {
-            goto ERROR_EXIT;
-        }
-        if (!(timeout--)) {
-            timed_out = true;
-            goto ERROR_EXIT;
-        }
-        _delay_ms(1);
-    }
-
-    Endpoint_Write_8(c);
-
-    // send when bank is full
-    if (!Endpoint_IsReadWriteAllowed()) {
-        while (!(Endpoint_IsINReady()))
-            ;
-        Endpoint_ClearIN();
-    } else {
-        CONSOLE_FLUSH_SET(true);
-    }
-
-    Endpoint_SelectEndpoint(ep);
-    return 0;
-ERROR_EXIT:
-    Endpoint_SelectEndpoint(ep);
-    return -1;
+    return console_tx_put(c) ? 0 : -1;
 }
 #endif
 
@@ -1010,9 +950,6 @@ static void setup_usb(void) {
     USB_Disable();
 
     USB_Init();
-
-    // for Console_Task
-    USB_Device_EnableSOFEvents();
 }
 
 void protocol_setup(void) {
@@ -1096,6 +1033,14 @@ void protocol_post_task(void) {
     raw_hid_task();
 #endif
 
+#ifdef TOKENIZED_LOGGING_ENABLE
+    tokenized_log_task();
+#endif
+
+#ifdef CONSOLE_ENABLE
+    Console_Task();
+#endif
+
 #if !defined(INTERRUPT_CONTROL_ENDPOINT)
     USB_USBTask();
 #endif
@@ -26,53 +26,124 @@
 #    define RO_SUB(a, b) ((a - b + KEYBOARD_REPORT_KEYS) % KEYBOARD_REPORT_KEYS)
 #    define RO_INC(a) RO_ADD(a, 1)
 #    define RO_DEC(a) RO_SUB(a, 1)
-static int8_t cb_head  = 0;
-static int8_t cb_tail  = 0;
-static int8_t cb_count = 0;
+static int8_t cb_head = 0;
+static int8_t cb_tail = 0;
 #endif
 
+#define KEY_SLOTS_ALL ((1 << KEYBOARD_REPORT_KEYS) - 1)
+
+#ifdef NKRO_ENABLE
+_Static_assert(KEYBOARD_REPORT_BITS <= 32, "NKRO byte occupancy does not fit in 32 bits");
+#endif
+
+/* Bookkeeping for the report the key functions were last used on, so
+ * they don't have to scan it. It is rebuilt whenever they are called on
+ * another report or the NKRO mode changes, so reports must only be
+ * changed through these functions, or cleared with
+ * clear_keys_from_report() after being changed directly.
+ */
+static struct {
+    report_keyboard_t* report;
+    uint8_t            count; // keys in keys[]
+    uint8_t            slots; // bit n set when keys[n] is in use
+#ifdef NKRO_ENABLE
+    bool     nkro;
+    uint32_t bytes; // bit n set when nkro.bits[n] is not zero
+#endif
+} key_index;
+
+static void key_index_sync(report_keyboard_t* keyboard_report, bool nkro) {
+#ifdef NKRO_ENABLE
+    if (key_index.report == keyboard_report && key_index.nkro == nkro) {
+        return;
+    }
+    key_index.nkro  = nkro;
+    key_index.bytes = 0;
+    if (nkro) {
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_BITS; i++) {
+            if (keyboard_report->nkro.bits[i]) {
+                key_index.bytes |= 1UL << i;
+            }
+        }
+    }
+#else
+    if (key_index.report == keyboard_report) {
+        return;
+    }
+#endif
+    key_index.report = keyboard_report;
+    key_index.count  = 0;
+    key_index.slots  = 0;
+    if (!nkro) {
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+            if (keyboard_report->keys[i]) {
+                key_index.slots |= 1 << i;
+                key_index.count++;
+            }
+        }
+    }
+}
+
+static bool report_is_nkro(void) {
+#ifdef NKRO_ENABLE
+    return keyboard_protocol && keymap_config.nkro;
+#else
+    return false;
+#endif
+}
+
+/* Returns the slot holding code, or -1. Only looks at slots in use. */
+static int8_t key_slot(report_keyboard_t* keyboard_report, uint8_t code) {
+    uint8_t slots = key_index.slots;
+    for (int8_t i = 0; slots; i++, slots >>= 1) {
+        if ((slots & 1) && keyboard_report->keys[i] == code) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 /** \brief has_anykey
  *
- * FIXME: Needs doc
+ * Returns the number of keys in a 6KRO report, or of non-empty bytes in
+ * an NKRO report, so it is zero when no key is pressed.
  */
 uint8_t has_anykey(report_keyboard_t* keyboard_report) {
-    uint8_t  cnt = 0;
-    uint8_t* p   = keyboard_report->keys;
-    uint8_t  lp  = sizeof(keyboard_report->keys);
+    bool nkro = report_is_nkro();
+    key_index_sync(keyboard_report, nkro);
 #ifdef NKRO_ENABLE
-    if (keyboard_protocol && keymap_config.nkro) {
-        p  = keyboard_report->nkro.bits;
-        lp = sizeof(keyboard_report->nkro.bits);
+    if (nkro) {
+        return bitpop32(key_index.bytes);
     }
 #endif
-    while (lp--) {
-        if (*p++) cnt++;
-    }
-    return cnt;
+    return key_index.count;
 }
 
 /** \brief get_first_key
  *
- * FIXME: Needs doc
+ * Returns the first key of the report, 0 if it has none. In NKRO mode that
+ * is the highest key in the lowest non-empty byte, with ring buffered 6KRO
+ * the oldest key.
  */
 uint8_t get_first_key(report_keyboard_t* keyboard_report) {
+    bool nkro = report_is_nkro();
+    key_index_sync(keyboard_report, nkro);
 #ifdef NKRO_ENABLE
-    if (keyboard_protocol && keymap_config.nkro) {
-        uint8_t i = 0;
-        for (; i < KEYBOARD_REPORT_BITS && !keyboard_report->nkro.bits[i]; i++)
-            ;
+    if (nkro) {
+        if (!key_index.bytes) {
+            return 0;
+        }
+        uint8_t i = biton32(key_index.bytes & -key_index.bytes);
         return i << 3 | biton(keyboard_report->nkro.bits[i]);
     }
 #endif
 #ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
-    uint8_t i = cb_head;
-    do {
-        if (keyboard_report->keys[i] != 0) {
-            break;
-        }
-        i = RO_INC(i);
-    } while (i != cb_tail);
-    return keyboard_report->keys[i];
+    if (!key_index.count) {
+        return 0;
+    }
+    // Rotate the slots so the head comes first, then take the lowest one in use.
+    uint8_t slots = ((key_index.slots >> cb_head) | (key_index.slots << (KEYBOARD_REPORT_KEYS - cb_head))) & KEY_SLOTS_ALL;
+    return keyboard_report->keys[RO_ADD(cb_head, biton(slots & -slots))];
 #else
     return keyboard_report->keys[0];
 #endif
@@ -106,106 +177,79 @@ bool is_key_pressed(report_keyboard_t* keyboard_report, uint8_t key) {
 
 /** \brief add key byte
  *
- * FIXME: Needs doc
+ * Adds a key to the 6KRO part of the report, if it is not there yet.
+ * A full report drops the new key, or with ring buffered 6KRO the oldest one.
  */
 void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
+    key_index_sync(keyboard_report, false);
+    if (code == KC_NO || key_slot(keyboard_report, code) >= 0) {
+        return;
+    }
 #ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
-    int8_t i     = cb_head;
-    int8_t empty = -1;
-    if (cb_count) {
-        do {
-            if (keyboard_report->keys[i] == code) {
-                return;
-            }
-            if (empty == -1 && keyboard_report->keys[i] == 0) {
-                empty = i;
-            }
-            i = RO_INC(i);
-        } while (i != cb_tail);
-        if (i == cb_tail) {
-            if (cb_tail == cb_head) {
-                // buffer is full
-                if (empty == -1) {
-                    // pop head when has no empty space
-                    cb_head = RO_INC(cb_head);
-                    cb_count--;
-                } else {
-                    // left shift when has empty space
-                    uint8_t offset = 1;
-                    i              = RO_INC(empty);
-                    do {
-                        if (keyboard_report->keys[i] != 0) {
-                            keyboard_report->keys[empty] = keyboard_report->keys[i];
-                            keyboard_report->keys[i]     = 0;
-                            empty                        = RO_INC(empty);
-                        } else {
-                            offset++;
-                        }
-                        i = RO_INC(i);
-                    } while (i != cb_tail);
-                    cb_tail = RO_SUB(cb_tail, offset);
+    if (key_index.count && cb_tail == cb_head) {
+        // the ring spans the whole report
+        if (key_index.count == KEYBOARD_REPORT_KEYS) {
+            // pop head when has no empty space, the new key overwrites it
+            key_index.slots &= ~(1 << cb_head);
+            key_index.count--;
+            cb_head = RO_INC(cb_head);
+        } else {
+            // left shift when has empty space
+            int8_t  to    = cb_head;
+            uint8_t slots = 0;
+            for (uint8_t n = 0; n < KEYBOARD_REPORT_KEYS; n++) {
+                int8_t from = RO_ADD(cb_head, n);
+                if (keyboard_report->keys[from] != 0) {
+                    keyboard_report->keys[to] = keyboard_report->keys[from];
+                    slots |= 1 << to;
+                    to = RO_INC(to);
                 }
             }
+            for (int8_t i = to; i != cb_head; i = RO_INC(i)) {
+                keyboard_report->keys[i] = 0;
+            }
+            key_index.slots = slots;
+            cb_tail         = to;
         }
     }
     // add to tail
     keyboard_report->keys[cb_tail] = code;
-    cb_tail                        = RO_INC(cb_tail);
-    cb_count++;
+    key_index.slots |= 1 << cb_tail;
+    key_index.count++;
+    cb_tail = RO_INC(cb_tail);
 #else
-    int8_t i     = 0;
-    int8_t empty = -1;
-    for (; i < KEYBOARD_REPORT_KEYS; i++) {
-        if (keyboard_report->keys[i] == code) {
-            break;
-        }
-        if (empty == -1 && keyboard_report->keys[i] == 0) {
-            empty = i;
-        }
-    }
-    if (i == KEYBOARD_REPORT_KEYS) {
-        if (empty != -1) {
-            keyboard_report->keys[empty] = code;
-        }
+    uint8_t empty = ~key_index.slots & KEY_SLOTS_ALL;
+    if (empty) {
+        uint8_t i                = biton(empty & -empty);
+        keyboard_report->keys[i] = code;
+        key_index.slots |= 1 << i;
+        key_index.count++;
     }
 #endif
 }
 
 /** \brief del key byte
  *
- * FIXME: Needs doc
+ * Removes a key from the 6KRO part of the report.
  */
 void del_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
+    key_index_sync(keyboard_report, false);
+    int8_t i = code == KC_NO ? -1 : key_slot(keyboard_report, code);
+    if (i < 0) {
+        return;
+    }
+    keyboard_report->keys[i] = 0;
+    key_index.slots &= ~(1 << i);
+    key_index.count--;
 #ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
-    uint8_t i = cb_head;
-    if (cb_count) {
+    if (key_index.count == 0) {
+        // reset head and tail
+        cb_tail = cb_head = 0;
+    } else if (i == RO_DEC(cb_tail)) {
+        // pull the tail back to the newest key left
         do {
-            if (keyboard_report->keys[i] == code) {
-                keyboard_report->keys[i] = 0;
-                cb_count--;
-                if (cb_count == 0) {
-                    // reset head and tail
-                    cb_tail = cb_head = 0;
-                }
-                if (i == RO_DEC(cb_tail)) {
-                    // left shift when next to tail
-                    do {
-                        cb_tail = RO_DEC(cb_tail);
-                        if (keyboard_report->keys[RO_DEC(cb_tail)] != 0) {
-                            break;
-                        }
-                    } while (cb_tail != cb_head);
-                }
-                break;
-            }
-            i = RO_INC(i);
-        } while (i != cb_tail);
-    }
-#else
-    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
-        if (keyboard_report->keys[i] == code) {
-            keyboard_report->keys[i] = 0;
-        }
+            cb_tail = RO_DEC(cb_tail);
+        } while (!(key_index.slots & (1 << RO_DEC(cb_tail))));
     }
 #endif
 }
@@ -213,11 +257,13 @@ void del_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
 #ifdef NKRO_ENABLE
 /** \brief add key bit
  *
- * FIXME: Needs doc
+ * Sets the bit of a key in the NKRO report.
  */
 void add_key_bit(report_keyboard_t* keyboard_report, uint8_t code) {
     if ((code >> 3) < KEYBOARD_REPORT_BITS) {
+        key_index_sync(keyboard_report, true);
         keyboard_report->nkro.bits[code >> 3] |= 1 << (code & 7);
+        key_index.bytes |= 1UL << (code >> 3);
     } else {
         dprintf("add_key_bit: can't add: %02X\n", code);
     }
@@ -225,11 +271,15 @@ void add_key_bit(report_keyboard_t* keyboard_report, uint8_t code) {
 
 /** \brief del key bit
  *
- * FIXME: Needs doc
+ * Clears the bit of a key in the NKRO report.
  */
 void del_key_bit(report_keyboard_t* keyboard_report, uint8_t code) {
     if ((code >> 3) < KEYBOARD_REPORT_BITS) {
+        key_index_sync(keyboard_report, true);
         keyboard_report->nkro.bits[code >> 3] &= ~(1 << (code & 7));
+        if (!keyboard_report->nkro.bits[code >> 3]) {
+            key_index.bytes &= ~(1UL << (code >> 3));
+        }
     } else {
         dprintf("del_key_bit: can't del: %02X\n", code);
     }
@@ -266,12 +316,21 @@ void del_key_from_report(report_keyboard_t* keyboard_report, uint8_t key) {
 
 /** \brief clear key from report
  *
- * FIXME: Needs doc
+ * Removes all keys but not the modifiers, and resets the bookkeeping
+ * for the report.
  */
 void clear_keys_from_report(report_keyboard_t* keyboard_report) {
     // not clear mods
+    key_index.report = keyboard_report;
+    key_index.count  = 0;
+    key_index.slots  = 0;
+#ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
+    cb_tail = cb_head = 0;
+#endif
 #ifdef NKRO_ENABLE
-    if (keyboard_protocol && keymap_config.nkro) {
+    key_index.nkro  = report_is_nkro();
+    key_index.bytes = 0;
+    if (key_index.nkro) {
         memset(keyboard_report->nkro.bits, 0, sizeof(keyboard_report->nkro.bits));
         return;
     }
@@ -10,6 +10,10 @@ SRC += $(VUSB_DIR)/protocol.c \
 	$(VUSB_PATH)/usbdrv/usbdrvasm.S \
 	$(VUSB_PATH)/usbdrv/oddebug.c
 
+ifeq ($(strip $(CONSOLE_ENABLE)), yes)
+    SRC += $(PROTOCOL_DIR)/console_tx.c
+endif
+
 # Search Path
 VPATH += $(TMK_PATH)/$(VUSB_DIR)
 VPATH += $(VUSB_PATH)
@@ -16,6 +16,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <stdint.h>
+#include <string.h>
 
 #include <avr/wdt.h>
 
@@ -35,9 +36,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    include "raw_hid.h"
 #endif
 
-#if defined(CONSOLE_ENABLE)
-#    define RBUF_SIZE 128
-#    include "ring_buffer.h"
+#ifdef CONSOLE_ENABLE
+#    include "console_tx.h"
+#endif
+
+#ifdef TOKENIZED_LOGGING_ENABLE
+#    include "tokenized_log.h"
 #endif
 
 #define NEXT_INTERFACE __COUNTER__
@@ -156,11 +160,17 @@ __attribute__((weak)) void raw_hid_receive(uint8_t *data, uint8_t length) {
     // so users can opt to not handle data coming in.
 }
 
+__attribute__((weak)) void raw_hid_poll(void) {
+    // Users can implement this to push packets to the host
+    // without waiting for a request from it.
+}
+
 void raw_hid_task(void) {
     if (raw_output_received_bytes == RAW_BUFFER_SIZE) {
         raw_hid_receive(raw_output_buffer, RAW_BUFFER_SIZE);
         raw_output_received_bytes = 0;
     }
+    raw_hid_poll();
 }
 #endif
 
@@ -172,8 +182,7 @@ void raw_hid_task(void) {
 #    define CONSOLE_EPSIZE 8
 
 int8_t sendchar(uint8_t c) {
-    rbuf_enqueue(c);
-    return 0;
+    return console_tx_put(c) ? 0 : -1;
 }
 
 static inline bool usbSendData3(char *data, uint8_t len) {
@@ -194,23 +203,29 @@ void console_task(void) {
         return;
     }
 
-    if (!rbuf_has_data()) {
-        return;
-    }
+#    ifdef TOKENIZED_LOGGING_ENABLE
+    tokenized_log_task();
+#    endif
 
-    // Send in chunks of 8 padded to 32
-    char    send_buf[CONSOLE_BUFFER_SIZE] = {0};
-    uint8_t send_buf_count                = 0;
-    while (rbuf_has_data() && send_buf_count < CONSOLE_EPSIZE) {
-        send_buf[send_buf_count++] = rbuf_dequeue();
+    // Bytes stay here until the host has taken their chunk, a report that
+    // didn't go out in full is finished before new bytes are read
+    static char    send_buf[CONSOLE_BUFFER_SIZE];
+    static uint8_t send_pos = CONSOLE_BUFFER_SIZE;
+    if (send_pos == CONSOLE_BUFFER_SIZE) {
+        if (!console_tx_count()) {
+            return;
+        }
+        memset(send_buf, 0, sizeof(send_buf));
+        console_tx_read((uint8_t *)send_buf, sizeof(send_buf));
+        send_pos = 0;
     }
 
-    char *temp = send_buf;
-    for (uint8_t i = 0; i < 4; i++) {
-        if (!usbSendData3(temp, 8)) {
+    // Send a full report in chunks of 8, padded to 32
+    while (send_pos < CONSOLE_BUFFER_SIZE) {
+        if (!usbSendData3(&send_buf[send_pos], CONSOLE_EPSIZE)) {
             break;
         }
-        temp += 8;
+        send_pos += CONSOLE_EPSIZE;
     }
 
     usbSendData3(0, 0);